@@ -861,6 +861,126 @@ extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 * audio_buf);
 
+/**
+ * An opaque handle to a WAVE file that is decoded on demand.
+ *
+ * \since This struct is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ * \sa SDL_ReadWAVStream
+ * \sa SDL_SeekWAVStream
+ * \sa SDL_CloseWAVStream
+ */
+struct SDL_WAVStream;
+typedef struct SDL_WAVStream SDL_WAVStream;
+
+/**
+ * Open a WAVE file for streaming from a data source.
+ *
+ * Unlike SDL_LoadWAV_RW(), this function only parses the headers of the file.
+ * The sample data is read from `src` and decoded in small pieces as it is
+ * requested with SDL_ReadWAVStream(), so memory use stays bounded no matter
+ * how long the file is and playback can start right away. Compressed formats
+ * are decoded one block at a time.
+ *
+ * The same formats and hints as SDL_LoadWAV_RW() are supported, and `spec` is
+ * filled in the same way. Sample frames returned by SDL_ReadWAVStream() are
+ * in `spec->format`.
+ *
+ * The WAVE stream takes over `src` until it is closed; the application must
+ * not read from or seek in it in the meantime. It is required that the data
+ * source supports seeking.
+ *
+ * \param src The data source for the WAVE data
+ * \param freesrc If non-zero, SDL will _always_ free the data source, either
+ *                when this function fails or when the stream is closed
+ * \param spec An SDL_AudioSpec that will be filled in with the wave file's
+ *             format details
+ * \returns a new WAVE stream on success, or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_ReadWAVStream
+ * \sa SDL_SeekWAVStream
+ * \sa SDL_GetWAVStreamLength
+ * \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec * spec);
+
+/**
+ * Read and decode sample frames from a WAVE stream.
+ *
+ * A sample frame holds one sample for every channel, so `buf` must have room
+ * for `frames * channels * SDL_AUDIO_BITSIZE(spec->format) / 8` bytes, with
+ * `spec` as returned by SDL_OpenWAVStream_RW().
+ *
+ * \param stream the WAVE stream to read from
+ * \param buf the buffer that receives the decoded sample frames
+ * \param frames the maximum number of sample frames to read
+ * \returns the number of sample frames read, which is less than `frames` only
+ *          at the end of the data, or -1 on error; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ * \sa SDL_SeekWAVStream
+ */
+extern DECLSPEC int SDLCALL SDL_ReadWAVStream(SDL_WAVStream * stream,
+                                              void * buf, int frames);
+
+/**
+ * Move the read position of a WAVE stream to a sample frame.
+ *
+ * Positions past the end are clamped to the end of the data. The data
+ * source is not accessed until the next SDL_ReadWAVStream(), so seeking is
+ * cheap for all formats.
+ *
+ * \param stream the WAVE stream to seek in
+ * \param frame the sample frame that the next SDL_ReadWAVStream() starts at
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_ReadWAVStream
+ * \sa SDL_GetWAVStreamLength
+ */
+extern DECLSPEC int SDLCALL SDL_SeekWAVStream(SDL_WAVStream * stream, Sint64 frame);
+
+/**
+ * Get the number of sample frames in a WAVE stream.
+ *
+ * This is the length reported by the headers. If the data source turns out
+ * to be shorter while reading, the stream ends early.
+ *
+ * \param stream the WAVE stream to query
+ * \returns the number of sample frames, or -1 on error; call SDL_GetError()
+ *          for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_GetWAVStreamLength(SDL_WAVStream * stream);
+
+/**
+ * Close a WAVE stream and free its resources.
+ *
+ * The data source is closed as well if the stream was opened with `freesrc`
+ * set. It is safe to call this function with a NULL pointer.
+ *
+ * \param stream the WAVE stream to close
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream * stream);
+
 /**
  * Initialize an SDL_AudioCVT structure for conversion.
  *
@@ -952,6 +1072,23 @@ extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT * cvt);
 struct _SDL_AudioStream;
 typedef struct _SDL_AudioStream SDL_AudioStream;
 
+/**
+ * The built-in resamplers an SDL_AudioStream can use, from fastest to best
+ * quality.
+ *
+ * \since This enum is available since SDL 2.0.20.
+ *
+ * \sa SDL_AudioStreamSetResampleQuality
+ */
+typedef enum
+{
+    SDL_AUDIO_RESAMPLE_DEFAULT,     /**< Whatever SDL_HINT_AUDIO_RESAMPLING_MODE asks for */
+    SDL_AUDIO_RESAMPLE_LINEAR,      /**< Linear interpolation between neighboring frames */
+    SDL_AUDIO_RESAMPLE_CUBIC,       /**< 4-point cubic interpolation */
+    SDL_AUDIO_RESAMPLE_SINC_SHORT,  /**< Windowed sinc filter over 3 zero crossings */
+    SDL_AUDIO_RESAMPLE_SINC_LONG    /**< Windowed sinc filter over 5 zero crossings, what SDL_AudioCVT uses */
+} SDL_AudioResampleQuality;
+
 /**
  * Create a new audio stream.
  *
@@ -1068,6 +1205,30 @@ extern DECLSPEC int SDLCALL SDL_AudioStreamFlush(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
 
+/**
+ * Choose the resampler an audio stream uses.
+ *
+ * New streams use SDL_AUDIO_RESAMPLE_DEFAULT, which picks the resampler named
+ * by SDL_HINT_AUDIO_RESAMPLING_MODE when the stream is created. Linear and
+ * cubic interpolation cost a fraction of the CPU time of the sinc filters and
+ * are often good enough for sound effects.
+ *
+ * This can be called at any time, but changing resamplers while data is
+ * buffered in the stream might cause a short discontinuity in the output.
+ * Streams that don't change the sample rate ignore this.
+ *
+ * \param stream The stream to change
+ * \param quality One of the SDL_AudioResampleQuality values
+ * \returns 0 on success, or -1 on error.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_NewAudioStream
+ * \sa SDL_HINT_AUDIO_RESAMPLING_MODE
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream,
+                                                              SDL_AudioResampleQuality quality);
+
 /**
  * Free an audio stream
  *
@@ -1144,6 +1305,43 @@ extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 * dst,
                                                 SDL_AudioFormat format,
                                                 Uint32 len, int volume);
 
+/**
+ * Mix several audio buffers in a specified format in one pass.
+ *
+ * This mixes `num_srcs` audio buffers of `len` bytes of `format` data into
+ * `dst`, each with its own volume adjustment. The buffer pointed to by `dst`
+ * must also be `len` bytes of `format` data.
+ *
+ * Unlike calling SDL_MixAudioFormat() once per buffer, this sums every
+ * buffer in an accumulator with greater range than the samples and clips
+ * the result once, so loud passages in one source can be cancelled out by
+ * another instead of clipping early. It also only reads and writes `dst`
+ * once, no matter how many buffers are mixed into it. With a single source,
+ * the results are the same as SDL_MixAudioFormat().
+ *
+ * \param dst the destination for the mixed audio
+ * \param srcs an array of `num_srcs` source audio buffers to be mixed
+ * Nothing is mixed if any of the parameters is invalid, including a volume
+ * outside of 0 - 128; call SDL_GetError() for more information.
+ *
+ * \param volumes an array of `num_srcs` volumes, one per source buffer, each
+ *                ranging from 0 - 128
+ * \param num_srcs the number of source buffers
+ * \param format the SDL_AudioFormat structure representing the desired audio
+ *               format
+ * \param len the length of each audio buffer in bytes
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_MixAudioFormat
+ */
+extern DECLSPEC void SDLCALL SDL_MixAudioMulti(Uint8 * dst,
+                                               const Uint8 ** srcs,
+                                               const int * volumes,
+                                               int num_srcs,
+                                               SDL_AudioFormat format,
+                                               Uint32 len);
+
 /**
  * Queue more audio on non-callback devices.
  *
@@ -1308,6 +1506,119 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(SDL_AudioDeviceID dev);
  */
 extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(SDL_AudioDeviceID dev);
 
+/**
+ * The number of buckets in SDL_AudioDeviceStats::callback_histogram.
+ *
+ * Bucket 0 counts callbacks that took less than a microsecond, bucket n
+ * counts callbacks that took from 2^(n-1) up to 2^n microseconds, and the
+ * last bucket also counts anything longer than that.
+ */
+#define SDL_AUDIO_STATS_HISTOGRAM_BUCKETS 16
+
+/**
+ * Timing and health information about an open audio device.
+ *
+ * All counts and totals accumulate from the moment the device is opened.
+ * Times are in nanoseconds.
+ *
+ * \sa SDL_GetAudioDeviceStats
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    Uint64 callbacks;               /**< Number of times the audio callback ran */
+    Uint64 callback_ns_total;       /**< Total time spent in the audio callback */
+    Uint64 callback_ns_max;         /**< Longest single audio callback */
+    Uint32 callback_histogram[SDL_AUDIO_STATS_HISTOGRAM_BUCKETS];  /**< Callback durations, see SDL_AUDIO_STATS_HISTOGRAM_BUCKETS */
+    Uint64 conversion_ns_total;     /**< Total time spent converting between the callback and device formats */
+    Uint64 conversion_ns_max;       /**< Longest single conversion pass */
+    Uint32 queued_bytes;            /**< Bytes waiting in the SDL_QueueAudio()/SDL_DequeueAudio() queue */
+    Uint32 stream_bytes;            /**< Converted bytes left over in the device's conversion stream */
+    Uint64 underruns;               /**< Buffers filled with silence because the device or the converter had nothing ready */
+    Uint64 overruns;                /**< Captured buffers dropped because they couldn't be stored */
+    Uint64 wakeups;                 /**< Number of times the device thread woke up to service the device */
+    Uint64 wakeup_jitter_ns_total;  /**< Total difference between actual and expected wake-up intervals */
+    Uint64 wakeup_jitter_ns_max;    /**< Largest difference between actual and expected wake-up intervals */
+    Uint32 callback_samples;        /**< Sample frames the audio callback is asked for, see SDL_HINT_AUDIO_ADAPTIVE_PERIOD */
+} SDL_AudioDeviceStats;
+
+/**
+ * Get timing and health information about an open audio device.
+ *
+ * The device thread records this as it goes, with a couple of reads of
+ * SDL_GetPerformanceCounter() per buffer, so it's cheap enough to leave on
+ * all the time. This works with every audio driver, including "dummy" and
+ * "disk", so it can be checked without audio hardware.
+ *
+ * The wake-up jitter measures how far the time between two wake-ups of the
+ * device thread strays from the length of one device buffer.
+ *
+ * \param dev the device ID to query
+ * \param stats a pointer filled in with the device's statistics
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenAudioDevice
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev, SDL_AudioDeviceStats *stats);
+
+/**
+ * A buffer of captured audio, read in place from a capture device's ring.
+ *
+ * \sa SDL_AcquireCapturedAudio
+ */
+typedef struct SDL_CapturedAudio
+{
+    const void *data;   /**< The captured samples, in the device's obtained spec */
+    Uint32 len;         /**< Size of data, in bytes */
+    Uint64 timestamp;   /**< SDL_GetPerformanceCounter() when the device delivered the buffer's last frame */
+} SDL_CapturedAudio;
+
+/**
+ * Get the oldest captured buffer from a capture device without copying it.
+ *
+ * This only works on capture devices opened with a NULL callback while
+ * SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS was set to more than zero. The device
+ * thread writes (and, if needed, converts) captured audio directly into a
+ * ring of buffers, and this function hands you a pointer into that ring, so
+ * the data is never copied through a queue or a callback and no lock is
+ * shared with the device thread.
+ *
+ * The buffer stays valid and untouched until you call
+ * SDL_ReleaseCapturedAudio(), SDL_ClearQueuedAudio() or close the device.
+ * Only one buffer can be acquired at a time; hold on to it for as short as
+ * you can, since the device drops new audio while the ring is full.
+ *
+ * If you already read part of the oldest buffer with SDL_DequeueAudio(),
+ * you get the rest of it.
+ *
+ * \param dev the device ID from which to read captured audio
+ * \param buffer filled in with the captured buffer and its timestamp
+ * \returns 1 if a buffer was acquired, 0 if nothing has been captured yet,
+ *          or a negative error code on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_ReleaseCapturedAudio
+ * \sa SDL_DequeueAudio
+ */
+extern DECLSPEC int SDLCALL SDL_AcquireCapturedAudio(SDL_AudioDeviceID dev, SDL_CapturedAudio *buffer);
+
+/**
+ * Give the buffer from SDL_AcquireCapturedAudio() back to the device.
+ *
+ * \param dev the device ID that the buffer came from
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_AcquireCapturedAudio
+ */
+extern DECLSPEC int SDLCALL SDL_ReleaseCapturedAudio(SDL_AudioDeviceID dev);
+
 
 /**
  *  \name Audio lock functions
@@ -720,6 +720,43 @@ typedef enum
 extern DECLSPEC int SDLCALL SDL_PeepEvents(SDL_Event * events, int numevents,
                                            SDL_eventaction action,
                                            Uint32 minType, Uint32 maxType);
+
+/**
+ * Check the event queue for messages along with the time they were produced.
+ *
+ * This works exactly like SDL_PeepEvents(), but also fills `timestamps` with
+ * the high resolution time each event was produced, in nanoseconds on the
+ * SDL_GetPerformanceCounterNS() clock. For input events, this is stamped in
+ * the function that generated the event from device input, before any event
+ * filter or watcher runs, so it can be used to measure input latency.
+ *
+ * If `action` is SDL_ADDEVENT, `timestamps` provides the times to store with
+ * the added events instead, which is useful to replay recorded input.
+ *
+ * This function is thread-safe.
+ *
+ * \param events destination buffer for the retrieved events
+ * \param timestamps destination buffer for the nanosecond timestamps of the
+ *                   retrieved events, with room for `numevents` values
+ * \param numevents if action is SDL_ADDEVENT, the number of events to add
+ *                  back to the event queue; if action is SDL_PEEKEVENT or
+ *                  SDL_GETEVENT, the maximum number of events to retrieve
+ * \param action action to take; see SDL_PeepEvents() for details
+ * \param minType minimum value of the event type to be considered;
+ *                SDL_FIRSTEVENT is a safe choice
+ * \param maxType maximum value of the event type to be considered;
+ *                SDL_LASTEVENT is a safe choice
+ * \returns the number of events actually stored or a negative error code on
+ *          failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetPerformanceCounterNS
+ * \sa SDL_PeepEvents
+ */
+extern DECLSPEC int SDLCALL SDL_PeepEventsTimestamped(SDL_Event * events, Uint64 * timestamps,
+                                                      int numevents, SDL_eventaction action,
+                                                      Uint32 minType, Uint32 maxType);
 /* @} */
 
 /**
@@ -851,6 +888,80 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event * event);
 
+/**
+ * Poll for many currently pending events at once.
+ *
+ * This pumps the event loop a single time and then removes up to `numevents`
+ * events from the queue in one pass, storing them contiguously in `events`.
+ * This is cheaper than calling SDL_PollEvent() in a loop when an application
+ * handles many events per frame, since the event queue is only locked once.
+ *
+ * Since the event loop is only pumped once, there is no need for the poll
+ * sentinel used by SDL_PollEvent(), and SDL_POLLSENTINEL events are never
+ * returned by this function.
+ *
+ * As this function implicitly calls SDL_PumpEvents(), you can only call this
+ * function in the thread that set the video mode.
+ *
+ * ```c
+ * while (game_is_still_running) {
+ *     SDL_Event events[128];
+ *     int i, count;
+ *     while ((count = SDL_PollEvents(events, SDL_arraysize(events))) > 0) {
+ *         for (i = 0; i < count; ++i) {
+ *             // decide what to do with events[i].
+ *         }
+ *     }
+ *
+ *     // update game state, draw the current frame
+ * }
+ * ```
+ *
+ * \param events an array of SDL_Event structures to be filled with the next
+ *               events from the queue
+ * \param numevents the maximum number of events to retrieve
+ * \returns the number of events stored in `events`, 0 if there are none
+ *          available, or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_PeepEvents
+ * \sa SDL_PollEvent
+ * \sa SDL_PumpEvents
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event * events, int numevents);
+
+/**
+ * What the event queue has been through, see SDL_GetEventQueueStats().
+ *
+ * The counts cover the time since the event subsystem was last initialized.
+ */
+typedef struct SDL_EventQueueStats
+{
+    int queued_events;      /**< Events in the queue right now */
+    int max_queued_events;  /**< Most events that were in the queue at once */
+    int coalesced_events;   /**< Events merged into a queued one, see SDL_HINT_EVENT_COALESCING */
+} SDL_EventQueueStats;
+
+/**
+ * Get statistics about the event queue.
+ *
+ * This is useful to see how far behind an application falls when it pumps
+ * events, and how much SDL_HINT_EVENT_COALESCING saves.
+ *
+ * This function is thread-safe.
+ *
+ * \param stats a pointer filled in with the statistics
+ * eturns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_HINT_EVENT_COALESCING
+ */
+extern DECLSPEC int SDLCALL SDL_GetEventQueueStats(SDL_EventQueueStats * stats);
+
 /**
  * Wait indefinitely for the next available event.
  *
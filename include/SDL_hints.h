@@ -193,6 +193,50 @@ extern "C" {
  */
 #define SDL_HINT_APPLE_TV_REMOTE_ALLOW_ROTATION "SDL_APPLE_TV_REMOTE_ALLOW_ROTATION"
 
+/**
+ *  \brief  A variable letting SDL resize the audio callback's buffer while a playback device runs.
+ *
+ *  When this is set to "min,max" (in sample frames, like "256,4096"), SDL
+ *  times every call to the audio callback and watches how regularly the
+ *  device thread wakes up. If the callback plus that jitter take more than
+ *  half of the time the buffer lasts, or the device ran dry, the callback is
+ *  asked for twice as much audio next time; after a run of callbacks with
+ *  plenty of headroom, it's asked for half as much. The size always stays
+ *  between min and max, and starts at the obtained spec's samples (clamped
+ *  into that range). The callback's len can therefore change from one call
+ *  to the next; SDL_GetAudioDeviceStats() reports the current size.
+ *
+ *  The audio passes through SDL's conversion stream on its way to the
+ *  device, since the device's own buffer size can't change once it's open.
+ *
+ *  This variable can be set to the following values:
+ *    "0"        - Always use the obtained spec's size (default)
+ *    "min,max"  - Adapt the size within these bounds
+ *
+ *  This hint is checked when the audio device is opened.
+ */
+#define SDL_HINT_AUDIO_ADAPTIVE_PERIOD "SDL_AUDIO_ADAPTIVE_PERIOD"
+
+/**
+ *  \brief  A variable controlling how many buffers a capture device keeps for SDL_AcquireCapturedAudio().
+ *
+ *  When a capture device is opened without a callback and this is more than
+ *  zero, the device thread writes captured audio straight into a ring of
+ *  this many buffers (rounded up to a power of two, at most 1024) of the
+ *  obtained spec's size, instead of going through the SDL_DequeueAudio()
+ *  queue. The application can then read each buffer in place with
+ *  SDL_AcquireCapturedAudio(); SDL_DequeueAudio() still works and copies out
+ *  of the same ring. If the ring fills up, new buffers are dropped and
+ *  counted as overruns in SDL_GetAudioDeviceStats().
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use the SDL_DequeueAudio() queue (default)
+ *    "N"       - Keep N buffers in the capture ring
+ *
+ *  This hint is checked when the audio device is opened.
+ */
+#define SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS "SDL_AUDIO_CAPTURE_RING_BUFFERS"
+
 /**
  *  \brief  A variable controlling the audio category on iOS and Mac OS X
  *
@@ -268,6 +312,26 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_DEVICE_STREAM_ROLE "SDL_AUDIO_DEVICE_STREAM_ROLE"
 
+/**
+ *  \brief  A variable controlling whether the "disk" audio driver runs faster than realtime.
+ *
+ *  By default the disk driver sleeps for the length of each buffer (or for
+ *  SDL_DISKAUDIODELAY milliseconds), so it plays at the normal speed. When
+ *  this is enabled, it doesn't sleep at all and renders as fast as the audio
+ *  callback and format conversion allow. This is useful for offline rendering,
+ *  benchmarking the audio pipeline and producing golden files for tests.
+ *
+ *  Independent of this hint, if the output file name ends in ".wav", the disk
+ *  driver writes a WAV header and picks a sample format WAV can hold.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Play at the normal speed (default)
+ *    "1"       - Don't wait between buffers
+ *
+ *  This hint is checked when the audio device is opened.
+ */
+#define SDL_HINT_AUDIO_DISK_FREERUN "SDL_AUDIO_DISK_FREERUN"
+
 /**
  *  \brief  A variable controlling speed/quality tradeoff of audio resampling.
  *
@@ -283,7 +347,9 @@ extern "C" {
  *  for capture. SDL_AudioCVT always uses the default resampler (although this
  *  might change for SDL 2.1).
  *
- *  This hint is currently only checked at audio subsystem initialization.
+ *  The libsamplerate settings are currently only checked at audio subsystem
+ *  initialization, the built-in ones whenever an SDL_AudioStream is created.
+ *  SDL_AudioStreamSetResampleQuality() overrides this for a single stream.
  *
  *  This variable can be set to the following values:
  *
@@ -291,6 +357,10 @@ extern "C" {
  *    "1" or "fast"    - Use fast, slightly higher quality resampling, if available
  *    "2" or "medium"  - Use medium quality resampling, if available
  *    "3" or "best"    - Use high quality resampling, if available
+ *    "linear"         - Use SDL's internal linear interpolation, fastest and lowest quality
+ *    "cubic"          - Use SDL's internal 4-point cubic interpolation
+ *    "sinc_short"     - Use SDL's internal resampling with a shorter filter
+ *    "sinc_long"      - Same as "default"
  */
 #define SDL_HINT_AUDIO_RESAMPLING_MODE   "SDL_AUDIO_RESAMPLING_MODE"
 
@@ -391,6 +461,30 @@ extern "C" {
  */
 #define SDL_HINT_ENABLE_STEAM_CONTROLLERS "SDL_ENABLE_STEAM_CONTROLLERS"
 
+/**
+ *  \brief  A variable controlling whether SDL merges high frequency motion events in its internal queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Queue every event as it arrives (default)
+ *    "1"     - Merge new motion events with queued ones from the same source
+ *
+ *  When enabled, a new SDL_MOUSEMOTION, SDL_FINGERMOTION, SDL_JOYAXISMOTION,
+ *  SDL_CONTROLLERAXISMOTION, SDL_SENSORUPDATE or SDL_CONTROLLERSENSORUPDATE
+ *  event replaces a queued event of the same type from the same device, axis,
+ *  sensor or finger, as long as only other motion events were queued after it.
+ *  Relative mouse and finger motion is summed, so no movement is lost.
+ *
+ *  This keeps the queue small when the application can't pump events for a
+ *  while. With SDL_HINT_EVENT_QUEUE_LOCKFREE, adding a motion event takes the
+ *  queue lock while it looks for one to merge with.
+ *
+ *  SDL_GetEventQueueStats() reports how many events were merged.
+ *
+ *  This hint can be toggled on and off at runtime.
+ */
+#define SDL_HINT_EVENT_COALESCING   "SDL_EVENT_COALESCING"
+
 /**
  *  \brief  A variable controlling whether SDL logs all events pushed onto its internal queue.
  *
@@ -412,6 +506,24 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling whether SDL uses a lock-free ring buffer for its internal event queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Use a mutex-guarded linked list for the event queue (default)
+ *    "1"     - Use a bounded lock-free ring buffer for the event queue
+ *
+ *  With the ring buffer, threads pushing events never wait on each other or on
+ *  the thread pulling events off the queue, which helps when joystick, sensor
+ *  and touch events are generated from several threads at high rates. The ring
+ *  holds fewer events than the linked list, so SDL_PushEvent() will fail sooner
+ *  if the application stops pumping events.
+ *
+ *  This hint must be set before the events subsystem is initialized.
+ */
+#define SDL_HINT_EVENT_QUEUE_LOCKFREE   "SDL_EVENT_QUEUE_LOCKFREE"
+
 /**
  *  \brief  A variable controlling how 3D acceleration is used to accelerate the SDL screen surface.
  *
@@ -1035,6 +1147,32 @@ extern "C" {
  */
 #define SDL_HINT_QTWAYLAND_WINDOW_FLAGS "SDL_QTWAYLAND_WINDOW_FLAGS"
 
+/**
+ *  \brief  A variable controlling whether the renderer draws each frame on a thread of its own.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - SDL_RenderPresent() draws the frame before it returns (default)
+ *    "1"       - SDL_RenderPresent() hands the frame to a render thread and
+ *                returns, so the next frame is recorded while it is drawn
+ *
+ *  At most one frame is in flight: SDL_RenderPresent() waits for the previous
+ *  one first. Anything that needs the frame to be finished, like reading
+ *  pixels, changing the render target, SDL_RenderFlush(), or updating or
+ *  destroying a texture the frame uses, waits for the render thread.
+ *  The timings in SDL_RenderStats count a frame when it is waited for.
+ *
+ *  The render thread presents the frame as soon as it is drawn, so it
+ *  reaches the window without waiting for the next SDL_RenderPresent().
+ *
+ *  This only has an effect when batching is enabled, see
+ *  SDL_HINT_RENDER_BATCHING, and with render drivers that can draw and
+ *  present from another thread, which is currently the software renderer
+ *  on windows whose framebuffer the video driver provides.
+ *
+ *  This hint is checked when the renderer is created.
+ */
+#define SDL_HINT_RENDER_ASYNC_SUBMIT        "SDL_RENDER_ASYNC_SUBMIT"
+
 /**
  *  \brief  A variable controlling whether the 2D render API is compatible or efficient.
  *
@@ -1125,6 +1263,23 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_OPENGL_SHADERS      "SDL_RENDER_OPENGL_SHADERS"
 
+/**
+ *  \brief  A variable controlling whether batched render commands may be reordered and merged before they are drawn.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Draw commands in the order they were made (default)
+ *    "1"       - Merge consecutive geometry that shares a texture, blend mode
+ *                and color into a single draw, and move geometry ahead of
+ *                draws it doesn't overlap to join such a group
+ *
+ *  The result looks the same either way, but a scene that alternates
+ *  between textures needs far fewer draw calls. This only has an effect
+ *  when batching is enabled, see SDL_HINT_RENDER_BATCHING.
+ *
+ *  This hint is checked when the renderer is created.
+ */
+#define SDL_HINT_RENDER_REORDER_COMMANDS    "SDL_RENDER_REORDER_COMMANDS"
+
 /**
  *  \brief  A variable controlling the scaling quality
  *
@@ -1137,6 +1292,40 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_SCALE_QUALITY       "SDL_RENDER_SCALE_QUALITY"
 
+/**
+ *  \brief  Controls how many threads the software renderer draws with.
+ *
+ *  The target is split into tiles that are drawn in parallel; the result
+ *  is the same as drawing on one thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use one thread per CPU
+ *    "1"       - Draw on the rendering thread only (default)
+ *    "N"       - Use N threads
+ *
+ *  This hint is checked when the renderer is created.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS    "SDL_RENDER_SOFTWARE_THREADS"
+
+/**
+ *  \brief  A variable setting how many bytes of vertex data a renderer reserves up front.
+ *
+ *  Renderers keep the vertex data of a batch in one block that persists
+ *  between frames, and move it to a bigger block whenever a batch outgrows
+ *  it, which costs a copy of everything queued so far. With
+ *  SDL_HINT_RENDER_ASYNC_SUBMIT the block is used as a ring: the next frame
+ *  is recorded after the one the render thread is still drawing, so it
+ *  needs room for both. Programs that know their largest batch can reserve
+ *  that much, or about twice that with async submit, so it never has to
+ *  move. vertex_arena_high_water in SDL_RenderGetStats() tells how much is
+ *  needed.
+ *
+ *  By default nothing is reserved and the block starts small.
+ *
+ *  This hint is checked when the renderer is created.
+ */
+#define SDL_HINT_RENDER_VERTEX_ARENA_SIZE   "SDL_RENDER_VERTEX_ARENA_SIZE"
+
 /**
  *  \brief  A variable controlling whether updates to the SDL screen surface should be synchronized with the vertical refresh, to avoid tearing.
  *
@@ -1485,6 +1674,19 @@ extern "C" {
  */
 #define SDL_HINT_VIDEO_X11_XVIDMODE         "SDL_VIDEO_X11_XVIDMODE"
 
+/**
+ *  \brief  Controls how many threads decode compressed WAVE files.
+ *
+ *  MS ADPCM and IMA ADPCM data is made of independent blocks, so
+ *  SDL_LoadWAV_RW() can split large files across several threads.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use up to one thread per CPU for large files (default)
+ *    "1"       - Decode on the calling thread only
+ *    "N"       - Use up to N threads for large files
+ */
+#define SDL_HINT_WAVE_DECODE_THREADS   "SDL_WAVE_DECODE_THREADS"
+
 /**
  *  \brief  Controls how the fact chunk affects the loading of a WAVE file.
  *
@@ -95,6 +95,40 @@ typedef struct SDL_Vertex
     SDL_FPoint tex_coord;       /**< Normalized texture coordinates, if needed */
 } SDL_Vertex;
 
+/**
+ * What a renderer did over one frame, see SDL_RenderGetStats().
+ *
+ * Command counts are taken from the queue as it's handed to the backend, so
+ * the viewport, clip rect and color changes SDL queues along with draws are
+ * included. Times are in nanoseconds.
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 commands;              /**< Render commands queued, of all types */
+    Uint32 submitted_commands;    /**< Commands the backend ran, after merging, see SDL_HINT_RENDER_REORDER_COMMANDS */
+    Uint32 viewport_commands;     /**< Viewport changes */
+    Uint32 cliprect_commands;     /**< Clip rectangle changes */
+    Uint32 color_commands;        /**< Draw color changes */
+    Uint32 clear_commands;        /**< SDL_RenderClear() calls */
+    Uint32 point_commands;        /**< Batches of points */
+    Uint32 line_commands;         /**< Batches of lines */
+    Uint32 rect_commands;         /**< Batches of filled rectangles */
+    Uint32 copy_commands;         /**< Texture copies */
+    Uint32 copy_ex_commands;      /**< Rotated or flipped texture copies */
+    Uint32 geometry_commands;     /**< Geometry draws, which is also how many backends queue copies */
+    Uint64 vertex_bytes;          /**< Vertex data handed to the backend */
+    Uint32 texture_uploads;       /**< Texture updates and unlocks of streaming textures */
+    Uint64 texture_upload_bytes;  /**< Pixel data sent with those uploads */
+    Uint32 target_changes;        /**< Render target switches */
+    Uint32 flushes;               /**< Times the command queue was run */
+    Uint64 command_queue_ns;      /**< Time spent running the command queue */
+    Uint64 present_ns;            /**< Time spent presenting */
+    Uint64 vertex_bytes_max;      /**< Most vertex data handed to the backend in a single flush */
+    Uint32 vertex_arena_grows;    /**< Times the vertex arena had to move to a bigger block */
+    Uint64 vertex_arena_size;     /**< Size of the vertex arena at the end of the frame */
+    Uint64 vertex_arena_high_water; /**< Most vertex data in use at once since the renderer was created, counting a frame still being drawn on the render thread */
+} SDL_RenderStats;
+
 /**
  * The scaling mode for a texture.
  */
@@ -1598,6 +1632,68 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyExF(SDL_Renderer * renderer,
                                             const SDL_FPoint *center,
                                             const SDL_RendererFlip flip);
 
+/**
+ * Copy many portions of a texture to the current rendering target at once.
+ *
+ * This draws the same as calling SDL_RenderCopyF() once for each pair of
+ * rectangles, in order, but the renderer queues them as a single draw with
+ * all of their vertices next to each other.
+ *
+ * \param renderer The renderer which should copy parts of a texture.
+ * \param texture The source texture.
+ * \param srcrects An array of `count` source rectangles, or NULL to use the
+ *                 entire texture for every copy.
+ * \param dstrects An array of `count` destination rectangles.
+ * \param count The number of copies to make.
+ * \return 0 on success, or -1 on error
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderCopyF
+ * \sa SDL_RenderCopyBatchEx
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyBatch(SDL_Renderer * renderer,
+                                                SDL_Texture * texture,
+                                                const SDL_Rect * srcrects,
+                                                const SDL_FRect * dstrects,
+                                                int count);
+
+/**
+ * Copy many portions of a texture to the current rendering target at once,
+ * with rotation and flipping.
+ *
+ * This draws the same as calling SDL_RenderCopyExF() once for each copy, in
+ * order, but the renderer queues them as a single draw.
+ *
+ * \param renderer The renderer which should copy parts of a texture.
+ * \param texture The source texture.
+ * \param srcrects An array of `count` source rectangles, or NULL to use the
+ *                 entire texture for every copy.
+ * \param dstrects An array of `count` destination rectangles.
+ * \param angles An array of `count` angles in degrees, or NULL to not rotate
+ *               any of the copies.
+ * \param centers An array of `count` points to rotate each copy around, or
+ *                NULL to rotate around the center of each destination
+ *                rectangle.
+ * \param flips An array of `count` SDL_RendererFlip values, or NULL to not
+ *              flip any of the copies.
+ * \param count The number of copies to make.
+ * \return 0 on success, or -1 on error
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderCopyExF
+ * \sa SDL_RenderCopyBatch
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyBatchEx(SDL_Renderer * renderer,
+                                                  SDL_Texture * texture,
+                                                  const SDL_Rect * srcrects,
+                                                  const SDL_FRect * dstrects,
+                                                  const double *angles,
+                                                  const SDL_FPoint *centers,
+                                                  const SDL_RendererFlip *flips,
+                                                  int count);
+
 /**
  * Render a list of triangles, optionally using a texture and indices into the
  * vertex array Color and alpha modulation is done per vertex
@@ -1875,6 +1971,51 @@ extern DECLSPEC void *SDLCALL SDL_RenderGetMetalCommandEncoder(SDL_Renderer * re
  */
 extern DECLSPEC int SDLCALL SDL_RenderSetVSync(SDL_Renderer* renderer, int vsync);
 
+/**
+ * Get how many render commands the last frame queued, and how many of them
+ * were left for the backend to run after merging.
+ *
+ * The counts cover everything between the last two calls to
+ * SDL_RenderPresent(), draws as well as the viewport, clip rect and color
+ * changes that go with them. Draws are only merged when
+ * SDL_HINT_RENDER_REORDER_COMMANDS is enabled; otherwise both counts are the
+ * same.
+ *
+ * \param renderer the rendering context
+ * \param queued a pointer filled in with the number of commands queued, may
+ *               be NULL
+ * \param submitted a pointer filled in with the number of commands handed
+ *                  to the backend, may be NULL
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderPresent
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetCommandCounts(SDL_Renderer * renderer, Uint32 *queued, Uint32 *submitted);
+
+/**
+ * Get statistics about the last frame a renderer drew.
+ *
+ * The numbers cover everything between the last two calls to
+ * SDL_RenderPresent(), including the time spent in the last one. Counting is
+ * always on and cheap enough to leave on in release builds; it adds a walk
+ * over the command queue and a couple of reads of
+ * SDL_GetPerformanceCounter() per flush.
+ *
+ * \param renderer the rendering context
+ * \param stats a pointer filled in with the statistics
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderGetCommandCounts
+ * \sa SDL_RenderPresent
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats *stats);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -133,6 +133,23 @@ extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceCounter(void);
  */
 extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
 
+/**
+ * Get the current value of the high resolution counter, in nanoseconds.
+ *
+ * This is SDL_GetPerformanceCounter() converted to nanoseconds, so like the
+ * counter, the values are only meaningful relative to each other. This is
+ * the clock used for event timestamps returned by
+ * SDL_PeepEventsTimestamped().
+ *
+ * \returns the current counter value in nanoseconds.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetPerformanceCounter
+ * \sa SDL_PeepEventsTimestamped
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceCounterNS(void);
+
 /**
  * Wait a specified number of milliseconds before returning.
  *
@@ -28,6 +28,7 @@ typedef struct SDL_DataQueuePacket
     size_t datalen;  /* bytes currently in use in this packet. */
     size_t startpos;  /* bytes currently consumed in this packet. */
     struct SDL_DataQueuePacket *next;  /* next item in linked list. */
+    void *padding;  /* keeps data 16-byte aligned for SIMD converters working in place. */
     Uint8 data[SDL_VARIABLE_LENGTH_ARRAY];  /* packet data */
 } SDL_DataQueuePacket;
 
@@ -311,7 +312,7 @@ SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
         return NULL;
     }
 
-    packet = queue->head;
+    packet = queue->tail;
     if (packet) {
         const size_t avail = queue->packet_size - packet->datalen;
         if (len <= avail) {  /* we can use the space at end of this packet. */
@@ -334,5 +335,340 @@ SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
     return packet->data;
 }
 
+void
+SDL_UnreserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
+{
+    SDL_DataQueuePacket *packet = queue ? queue->tail : NULL;
+
+    if (!packet || (len == 0)) {
+        return;
+    }
+
+    SDL_assert(len <= (packet->datalen - packet->startpos));
+    packet->datalen -= len;
+    queue->queued_bytes -= len;
+
+    if (packet->datalen == packet->startpos) {
+        /* tail packet is empty now, unlink it and put it back in the pool. */
+        SDL_DataQueuePacket *prev = NULL;
+        if (queue->head != packet) {
+            for (prev = queue->head; prev->next != packet; prev = prev->next) { /* spin */ }
+        }
+
+        if (prev) {
+            prev->next = NULL;
+        } else {
+            queue->head = NULL;
+        }
+        queue->tail = prev;
+        packet->next = queue->pool;
+        queue->pool = packet;
+    }
+
+    SDL_assert((queue->head != NULL) == (queue->queued_bytes != 0));
+}
+
+size_t
+SDL_GetDataQueueTailSpace(SDL_DataQueue *queue)
+{
+    if (!queue || !queue->tail) {
+        return 0;
+    }
+    return queue->packet_size - queue->tail->datalen;
+}
+
+/* Single-producer/single-consumer lock-free variant.
+
+   This is an unbounded linked list of packets that always holds at least one
+   packet. The consumer owns `head` and each packet's `startpos`; the producer
+   owns `tail`, `first`, and `head_copy`. A packet's `datalen` and `next` are
+   written by the producer and published with a release barrier, so the
+   consumer can read everything up to them once it sees them change.
+
+   Packets from `first` up to (but not including) the consumer's current head
+   have been fully read, so the producer recycles them instead of calling
+   malloc; this only needs a peek at the consumer's head now and then. */
+
+typedef struct SDL_LockFreeDataQueuePacket
+{
+    SDL_atomic_t datalen;  /* bytes currently in use in this packet (producer writes). */
+    int startpos;  /* bytes currently consumed in this packet (consumer writes). */
+    struct SDL_LockFreeDataQueuePacket *next;  /* next item in linked list (producer writes). */
+    void *padding;  /* keeps data 16-byte aligned, like SDL_DataQueuePacket. */
+    Uint8 data[SDL_VARIABLE_LENGTH_ARRAY];  /* packet data */
+} SDL_LockFreeDataQueuePacket;
+
+struct SDL_LockFreeDataQueue
+{
+    /* consumer side. */
+    SDL_LockFreeDataQueuePacket *head;  /* read from here. Producer peeks at it. */
+
+    /* producer side. */
+    SDL_LockFreeDataQueuePacket *tail;  /* write to here. */
+    SDL_LockFreeDataQueuePacket *first;  /* oldest packet, maybe ready for recycling. */
+    SDL_LockFreeDataQueuePacket *head_copy;  /* producer's last look at head. */
+
+    /* shared. */
+    SDL_atomic_t queued_bytes;  /* number of bytes of data in the queue. */
+    int packet_size;  /* size of new packets */
+};
+
+static SDL_LockFreeDataQueuePacket *
+AllocateLockFreeDataQueuePacket(const int packet_size)
+{
+    SDL_LockFreeDataQueuePacket *packet = (SDL_LockFreeDataQueuePacket *) SDL_malloc(sizeof (SDL_LockFreeDataQueuePacket) + packet_size);
+    if (packet) {
+        SDL_AtomicSet(&packet->datalen, 0);
+        packet->startpos = 0;
+        packet->next = NULL;
+    }
+    return packet;
+}
+
+SDL_LockFreeDataQueue *
+SDL_NewLockFreeDataQueue(const size_t _packetlen, const size_t initialslack)
+{
+    SDL_LockFreeDataQueue *queue = (SDL_LockFreeDataQueue *) SDL_calloc(1, sizeof (SDL_LockFreeDataQueue));
+    const size_t packetlen = _packetlen ? _packetlen : 1024;
+    const size_t wantpackets = (initialslack + (packetlen - 1)) / packetlen;
+    size_t i;
+
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    } else if (packetlen > SDL_MAX_SINT32) {
+        SDL_free(queue);
+        SDL_InvalidParamError("packetlen");
+        return NULL;
+    }
+
+    queue->packet_size = (int) packetlen;
+    queue->head = queue->tail = queue->first = queue->head_copy = AllocateLockFreeDataQueuePacket(queue->packet_size);
+    if (!queue->head) {
+        SDL_free(queue);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* slack goes in front of the head, where the producer will recycle it. */
+    for (i = 0; i < wantpackets; i++) {
+        SDL_LockFreeDataQueuePacket *packet = AllocateLockFreeDataQueuePacket(queue->packet_size);
+        if (packet) { /* don't care if this fails, we'll deal later. */
+            packet->next = queue->first;
+            queue->first = packet;
+        }
+    }
+
+    return queue;
+}
+
+void
+SDL_FreeLockFreeDataQueue(SDL_LockFreeDataQueue *queue)
+{
+    if (queue) {
+        SDL_LockFreeDataQueuePacket *packet = queue->first;
+        while (packet) {
+            SDL_LockFreeDataQueuePacket *next = packet->next;
+            SDL_free(packet);
+            packet = next;
+        }
+        SDL_free(queue);
+    }
+}
+
+void
+SDL_ClearLockFreeDataQueue(SDL_LockFreeDataQueue *queue, const size_t slack)
+{
+    size_t slackpackets;
+    SDL_LockFreeDataQueuePacket *packet;
+    SDL_LockFreeDataQueuePacket *keep = NULL;
+    SDL_LockFreeDataQueuePacket *stub;
+    size_t i = 0;
+
+    if (!queue) {
+        return;
+    }
+
+    /* the caller guarantees neither side is running, so everything is ours. */
+    slackpackets = (slack + (queue->packet_size - 1)) / queue->packet_size;
+    stub = queue->tail;
+    packet = queue->first;
+    while (packet != stub) {
+        SDL_LockFreeDataQueuePacket *next = packet->next;
+        if (i++ < slackpackets) {
+            packet->next = keep;
+            keep = packet;
+        } else {
+            SDL_free(packet);
+        }
+        packet = next;
+    }
+
+    SDL_AtomicSet(&stub->datalen, 0);
+    stub->startpos = 0;
+    stub->next = NULL;
+
+    queue->head = queue->tail = queue->head_copy = stub;
+    queue->first = stub;
+    while (keep) {
+        SDL_LockFreeDataQueuePacket *next = keep->next;
+        keep->next = queue->first;
+        queue->first = keep;
+        keep = next;
+    }
+    SDL_AtomicSet(&queue->queued_bytes, 0);
+}
+
+/* producer only: get a packet the consumer is done with, or a new one. */
+static SDL_LockFreeDataQueuePacket *
+RecycleLockFreeDataQueuePacket(SDL_LockFreeDataQueue *queue)
+{
+    SDL_LockFreeDataQueuePacket *packet;
+
+    if (queue->first == queue->head_copy) {
+        queue->head_copy = (SDL_LockFreeDataQueuePacket *) SDL_AtomicGetPtr((void **) &queue->head);
+        SDL_MemoryBarrierAcquire();
+    }
+
+    if (queue->first != queue->head_copy) {
+        packet = queue->first;
+        queue->first = packet->next;
+        SDL_AtomicSet(&packet->datalen, 0);
+        packet->startpos = 0;
+        packet->next = NULL;
+        return packet;
+    }
+
+    return AllocateLockFreeDataQueuePacket(queue->packet_size);
+}
+
+int
+SDL_WriteToLockFreeDataQueue(SDL_LockFreeDataQueue *queue, const void *_data, const size_t _len)
+{
+    const Uint8 *data = (const Uint8 *) _data;
+    SDL_LockFreeDataQueuePacket *tail;
+    SDL_LockFreeDataQueuePacket *chain = NULL;
+    SDL_LockFreeDataQueuePacket *chaintail = NULL;
+    size_t len = _len;
+    size_t datalen;
+    int taillen;
+
+    if (!queue) {
+        return SDL_InvalidParamError("queue");
+    } else if (_len > (size_t) (SDL_MAX_SINT32 - SDL_AtomicGet(&queue->queued_bytes))) {
+        return SDL_SetError("Too much data queued");
+    } else if (len == 0) {
+        return 0;
+    }
+
+    tail = queue->tail;
+    taillen = SDL_AtomicGet(&tail->datalen);
+    len -= SDL_min(len, (size_t) (queue->packet_size - taillen));
+
+    /* get every packet we need before publishing anything, so running out of
+       memory leaves the queue untouched, like SDL_WriteToDataQueue. */
+    while (len > 0) {
+        SDL_LockFreeDataQueuePacket *packet = RecycleLockFreeDataQueuePacket(queue);
+        if (!packet) {
+            while (chain) {  /* put them back where they'll be recycled. */
+                SDL_LockFreeDataQueuePacket *next = chain->next;
+                chain->next = queue->first;
+                queue->first = chain;
+                chain = next;
+            }
+            return SDL_OutOfMemory();
+        }
+
+        datalen = SDL_min(len, (size_t) queue->packet_size);
+        len -= datalen;
+        if (chaintail) {
+            chaintail->next = packet;
+        } else {
+            chain = packet;
+        }
+        chaintail = packet;
+    }
+
+    /* top off the tail packet; the consumer might be reading the front of it. */
+    datalen = SDL_min(_len, (size_t) (queue->packet_size - taillen));
+    SDL_memcpy(tail->data + taillen, data, datalen);
+    data += datalen;
+    len = _len - datalen;
+
+    /* fill the rest in private, then publish it all at once. */
+    for (tail = chain; tail; tail = tail->next) {
+        datalen = SDL_min(len, (size_t) queue->packet_size);
+        SDL_memcpy(tail->data, data, datalen);
+        SDL_AtomicSet(&tail->datalen, (int) datalen);
+        data += datalen;
+        len -= datalen;
+    }
+
+    /* count it first, so a reader can't see the count go below zero. */
+    SDL_AtomicAdd(&queue->queued_bytes, (int) _len);
+
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue->tail->datalen, taillen + (int) SDL_min(_len, (size_t) (queue->packet_size - taillen)));
+    if (chain) {
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSetPtr((void **) &queue->tail->next, chain);
+        queue->tail = chaintail;
+    }
+
+    return 0;
+}
+
+size_t
+SDL_ReadFromLockFreeDataQueue(SDL_LockFreeDataQueue *queue, void *_buf, const size_t _len)
+{
+    size_t len = _len;
+    Uint8 *buf = (Uint8 *) _buf;
+    Uint8 *ptr = buf;
+    SDL_LockFreeDataQueuePacket *packet;
+
+    if (!queue) {
+        return 0;
+    }
+
+    packet = queue->head;
+    while (len > 0) {
+        const int datalen = SDL_AtomicGet(&packet->datalen);
+        SDL_MemoryBarrierAcquire();
+
+        if (datalen > packet->startpos) {
+            const size_t cpy = SDL_min(len, (size_t) (datalen - packet->startpos));
+            SDL_memcpy(ptr, packet->data + packet->startpos, cpy);
+            packet->startpos += (int) cpy;
+            ptr += cpy;
+            len -= cpy;
+        } else {
+            SDL_LockFreeDataQueuePacket *next = (SDL_LockFreeDataQueuePacket *) SDL_AtomicGetPtr((void **) &packet->next);
+            SDL_MemoryBarrierAcquire();
+            if (!next) {
+                break;  /* drained everything the producer has published. */
+            } else if (SDL_AtomicGet(&packet->datalen) != packet->startpos) {
+                continue;  /* producer topped this one off before moving on. */
+            }
+
+            /* done with this packet; hand it back to the producer. */
+            SDL_MemoryBarrierRelease();
+            SDL_AtomicSetPtr((void **) &queue->head, next);
+            packet = next;
+        }
+    }
+
+    if (ptr != buf) {
+        SDL_AtomicAdd(&queue->queued_bytes, -((int) (ptr - buf)));
+    }
+
+    return (size_t) (ptr - buf);
+}
+
+size_t
+SDL_CountLockFreeDataQueue(SDL_LockFreeDataQueue *queue)
+{
+    return queue ? (size_t) SDL_AtomicGet(&queue->queued_bytes) : 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
 
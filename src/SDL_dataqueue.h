@@ -49,6 +49,31 @@ size_t SDL_CountDataQueue(SDL_DataQueue *queue);
 */
 void *SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len);
 
+/* this gives back the last (len) bytes of the most recent reservation, for
+   when you reserved a worst-case amount of space and ended up using less of
+   it. Nothing may have been written or reserved since that reservation. */
+void SDL_UnreserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len);
+
+/* number of bytes SDL_ReserveSpaceInDataQueue() can hand out without
+   starting a fresh packet. */
+size_t SDL_GetDataQueueTailSpace(SDL_DataQueue *queue);
+
+/* A lock-free variant for exactly one producer thread and one consumer thread.
+   Writes and reads may run at the same time without any locking; the count is
+   safe to query from anywhere, but may be stale by the time you look at it.
+   Clearing and freeing need both sides stopped, like everything above.
+   Packets the consumer has finished with are recycled by the producer, so a
+   queue that isn't growing doesn't allocate. */
+struct SDL_LockFreeDataQueue;
+typedef struct SDL_LockFreeDataQueue SDL_LockFreeDataQueue;
+
+SDL_LockFreeDataQueue *SDL_NewLockFreeDataQueue(const size_t packetlen, const size_t initialslack);
+void SDL_FreeLockFreeDataQueue(SDL_LockFreeDataQueue *queue);
+void SDL_ClearLockFreeDataQueue(SDL_LockFreeDataQueue *queue, const size_t slack);
+int SDL_WriteToLockFreeDataQueue(SDL_LockFreeDataQueue *queue, const void *data, const size_t len);  /* producer only */
+size_t SDL_ReadFromLockFreeDataQueue(SDL_LockFreeDataQueue *queue, void *buf, const size_t len);  /* consumer only */
+size_t SDL_CountLockFreeDataQueue(SDL_LockFreeDataQueue *queue);
+
 #endif /* SDL_dataqueue_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -572,6 +572,167 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
 
 
 
+/* device statistics. The record_* functions only run on the device thread. */
+
+static Uint64
+record_callback_time(SDL_AudioDevice *device, const Uint64 start)
+{
+    const Uint64 ns = SDL_GetPerformanceCounterNS() - start;
+    Uint64 us = ns / 1000;
+    int bucket = 0;
+
+    while (us && (bucket < (SDL_AUDIO_STATS_HISTOGRAM_BUCKETS - 1))) {
+        us >>= 1;
+        bucket++;
+    }
+
+    SDL_AtomicLock(&device->stats_lock);
+    device->stats.callbacks++;
+    device->stats.callback_ns_total += ns;
+    device->stats.callback_ns_max = SDL_max(device->stats.callback_ns_max, ns);
+    device->stats.callback_histogram[bucket]++;
+    SDL_AtomicUnlock(&device->stats_lock);
+
+    return ns;
+}
+
+static void
+record_conversion_time(SDL_AudioDevice *device, const Uint64 start)
+{
+    const Uint64 ns = SDL_GetPerformanceCounterNS() - start;
+    const Uint32 available = (Uint32) SDL_AudioStreamAvailable(device->stream);
+
+    SDL_AtomicLock(&device->stats_lock);
+    device->stats.conversion_ns_total += ns;
+    device->stats.conversion_ns_max = SDL_max(device->stats.conversion_ns_max, ns);
+    device->stats.stream_bytes = available;
+    SDL_AtomicUnlock(&device->stats_lock);
+}
+
+static void
+record_wakeup(SDL_AudioDevice *device)
+{
+    const Uint64 now = SDL_GetPerformanceCounterNS();
+    const Uint64 last = device->stats_last_wakeup;
+
+    device->stats_last_wakeup = now;
+    if (last) {
+        const Uint64 interval = now - last;
+        const Uint64 expected = (((Uint64) device->spec.samples) * 1000000000) / device->spec.freq;
+        const Uint64 jitter = (interval > expected) ? (interval - expected) : (expected - interval);
+
+        device->period_jitter_ns = ((device->period_jitter_ns * 7) + jitter) / 8;
+
+        SDL_AtomicLock(&device->stats_lock);
+        device->stats.wakeups++;
+        device->stats.wakeup_jitter_ns_total += jitter;
+        device->stats.wakeup_jitter_ns_max = SDL_max(device->stats.wakeup_jitter_ns_max, jitter);
+        SDL_AtomicUnlock(&device->stats_lock);
+    }
+}
+
+static void
+record_underrun(SDL_AudioDevice *device)
+{
+    device->period_underrun = SDL_TRUE;
+
+    SDL_AtomicLock(&device->stats_lock);
+    device->stats.underruns++;
+    SDL_AtomicUnlock(&device->stats_lock);
+}
+
+static void
+record_overrun(SDL_AudioDevice *device)
+{
+    SDL_AtomicLock(&device->stats_lock);
+    device->stats.overruns++;
+    SDL_AtomicUnlock(&device->stats_lock);
+}
+
+
+/* device thread scheduling... */
+
+/* How many callbacks in a row must fit comfortably before the period shrinks. */
+#define ADAPTIVE_PERIOD_CALM_CALLBACKS 16
+
+/* Doubles the callback period when the callback and the wake-up jitter use
+   more than half of it or the device ran dry, and halves it again after a
+   run of callbacks that would still use less than a quarter of the smaller
+   period. Device thread only. */
+static void
+adapt_callback_period(SDL_AudioDevice *device, const Uint64 callback_ns)
+{
+    const Uint64 period_ns = (((Uint64) device->period) * 1000000000) / device->callbackspec.freq;
+    Uint32 period = device->period;
+
+    if (device->period_underrun || ((callback_ns + device->period_jitter_ns) > (period_ns / 2))) {
+        period = SDL_min(period * 2, device->period_max);
+        device->period_calm = 0;
+    } else if (((callback_ns / 2) + device->period_jitter_ns) < (period_ns / 8)) {
+        if (++device->period_calm >= ADAPTIVE_PERIOD_CALM_CALLBACKS) {
+            period = SDL_max(period / 2, device->period_min);
+            device->period_calm = 0;
+        }
+    } else {
+        device->period_calm = 0;
+    }
+    device->period_underrun = SDL_FALSE;
+
+    if (period != device->period) {
+        device->period = period;
+        SDL_AtomicLock(&device->stats_lock);
+        device->stats.callback_samples = period;
+        SDL_AtomicUnlock(&device->stats_lock);
+    }
+}
+
+/* Sleeps until the device would have gone through one more buffer. The
+   deadline moves ahead by exactly one buffer each time, so SDL_Delay()'s
+   millisecond rounding doesn't add up over time: the sleep is rounded up to
+   the deadline, and waking a little late just makes the next wait shorter.
+   If we fell more than a buffer behind (a slow callback, a debugger), start
+   over from now instead of rushing to catch up. Device thread only. */
+static void
+wait_for_next_buffer(SDL_AudioDevice *device)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 ticks = (((Uint64) device->spec.samples) * frequency) + device->wait_remainder;
+    const Uint64 buffer_ticks = ticks / device->spec.freq;
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    device->wait_remainder = ticks % device->spec.freq;
+    if ((device->wait_deadline + buffer_ticks) < now) {
+        device->wait_deadline = now;
+    }
+    device->wait_deadline += buffer_ticks;
+
+    while (now < device->wait_deadline) {
+        const Uint64 ms = (((device->wait_deadline - now) * 1000) + frequency - 1) / frequency;
+        SDL_Delay((Uint32) ms);
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
+int
+SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_AtomicLock(&device->stats_lock);
+    SDL_memcpy(stats, &device->stats, sizeof (*stats));
+    SDL_AtomicUnlock(&device->stats_lock);
+
+    stats->queued_bytes = SDL_GetQueuedAudioSize(devid);
+    return 0;
+}
+
+
 /* buffer queueing support... */
 
 static void SDLCALL
@@ -585,12 +746,12 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
     SDL_assert(!device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
-    dequeued = SDL_ReadFromDataQueue(device->buffer_queue, stream, len);
+    /* the app may be queueing more right now; the lock-free queue lets it. */
+    dequeued = SDL_ReadFromLockFreeDataQueue(device->buffer_queue, stream, len);
     stream += dequeued;
     len -= (int) dequeued;
 
     if (len > 0) {  /* fill any remaining space in the stream with silence. */
-        SDL_assert(SDL_CountDataQueue(device->buffer_queue) == 0);
         SDL_memset(stream, device->callbackspec.silence, len);
     }
 }
@@ -608,7 +769,139 @@ SDL_BufferQueueFillCallback(void *userdata, Uint8 *stream, int len)
     /* note that if this needs to allocate more space and run out of memory,
        we have no choice but to quietly drop the data and hope it works out
        later, but you probably have bigger problems in this case anyhow. */
-    SDL_WriteToDataQueue(device->buffer_queue, stream, len);
+    if (SDL_WriteToLockFreeDataQueue(device->buffer_queue, stream, len) < 0) {
+        record_overrun(device);
+    }
+}
+
+
+/* capture ring support... */
+
+/* Returns the slot the device thread should capture into next, or NULL if
+   the app hasn't released enough of the ring yet. Device thread only. */
+static Uint8 *
+get_capture_ring_slot(SDL_AudioDevice *device)
+{
+    const Uint32 head = (Uint32) SDL_AtomicGet(&device->capture_ring_head);
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&device->capture_ring_tail);
+
+    if ((head - tail) >= device->capture_ring_slots) {
+        return NULL;
+    }
+
+    /* don't touch the slot until we've seen the app let go of it. */
+    SDL_MemoryBarrierAcquire();
+    return device->capture_ring + (head & (device->capture_ring_slots - 1)) * device->callbackspec.size;
+}
+
+/* Hands the slot from get_capture_ring_slot() to the app. Device thread only. */
+static void
+publish_capture_ring_slot(SDL_AudioDevice *device, Uint64 timestamp)
+{
+    const Uint32 head = (Uint32) SDL_AtomicGet(&device->capture_ring_head);
+
+    device->capture_ring_timestamps[head & (device->capture_ring_slots - 1)] = timestamp;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&device->capture_ring_head, (int) (head + 1));
+}
+
+/* One device buffer can convert into several slots, and only the last of
+   them ends when the device delivered. Back the timestamp off by however
+   many converted frames are still queued behind the slot just drained, so
+   consecutive slots step by their own length. Device thread only. */
+static Uint64
+capture_ring_stream_timestamp(SDL_AudioDevice *device, Uint64 timestamp)
+{
+    const int framesize = (SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8) * device->callbackspec.channels;
+    const Uint64 frames = (Uint64) SDL_AudioStreamAvailable(device->stream) / framesize;
+    return timestamp - ((frames * SDL_GetPerformanceFrequency()) / device->callbackspec.freq);
+}
+
+/* Returns the oldest unreleased slot and how many bytes of it are left, or
+   NULL if the ring is empty. Call with buffer_queue_lock held. */
+static Uint8 *
+peek_capture_ring(SDL_AudioDevice *device, Uint32 *len, Uint64 *timestamp)
+{
+    const Uint32 head = (Uint32) SDL_AtomicGet(&device->capture_ring_head);
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&device->capture_ring_tail);
+    const Uint32 slot = tail & (device->capture_ring_slots - 1);
+
+    if (head == tail) {
+        return NULL;
+    }
+
+    /* don't read the slot before we've seen the device thread finish it. */
+    SDL_MemoryBarrierAcquire();
+    *len = device->callbackspec.size - device->capture_ring_offset;
+    if (timestamp) {
+        *timestamp = device->capture_ring_timestamps[slot];
+    }
+    return device->capture_ring + (slot * device->callbackspec.size) + device->capture_ring_offset;
+}
+
+/* Gives the oldest slot back to the device thread. Call with buffer_queue_lock held. */
+static void
+release_capture_ring(SDL_AudioDevice *device)
+{
+    device->capture_ring_offset = 0;
+    device->capture_ring_acquired = SDL_FALSE;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicAdd(&device->capture_ring_tail, 1);
+}
+
+int
+SDL_AcquireCapturedAudio(SDL_AudioDeviceID devid, SDL_CapturedAudio *buffer)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    int retval = 0;
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!buffer) {
+        return SDL_InvalidParamError("buffer");
+    } else if (!device->capture_ring) {
+        return SDL_SetError("Audio device wasn't opened with a capture ring");
+    }
+
+    SDL_LockMutex(device->buffer_queue_lock);
+    if (device->capture_ring_acquired) {
+        retval = SDL_SetError("A captured buffer is already acquired");
+    } else {
+        buffer->data = peek_capture_ring(device, &buffer->len, &buffer->timestamp);
+        if (buffer->data) {
+            device->capture_ring_acquired = SDL_TRUE;
+            retval = 1;
+        } else {
+            buffer->len = 0;
+            buffer->timestamp = 0;
+        }
+    }
+    SDL_UnlockMutex(device->buffer_queue_lock);
+
+    return retval;
+}
+
+int
+SDL_ReleaseCapturedAudio(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    int retval = 0;
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!device->capture_ring) {
+        return SDL_SetError("Audio device wasn't opened with a capture ring");
+    }
+
+    SDL_LockMutex(device->buffer_queue_lock);
+    if (!device->capture_ring_acquired) {
+        retval = SDL_SetError("No captured buffer is acquired");
+    } else {
+        release_capture_ring(device);
+    }
+    SDL_UnlockMutex(device->buffer_queue_lock);
+
+    return retval;
 }
 
 int
@@ -625,10 +918,11 @@ SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
         return SDL_SetError("Audio device has a callback, queueing not allowed");
     }
 
+    /* no need to lock the device; the audio thread only reads from the other end. */
     if (len > 0) {
-        current_audio.impl.LockDevice(device);
-        rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
-        current_audio.impl.UnlockDevice(device);
+        SDL_LockMutex(device->buffer_queue_lock);
+        rc = SDL_WriteToLockFreeDataQueue(device->buffer_queue, data, len);
+        SDL_UnlockMutex(device->buffer_queue_lock);
     }
 
     return rc;
@@ -647,9 +941,32 @@ SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
         return 0;  /* just report zero bytes dequeued. */
     }
 
-    current_audio.impl.LockDevice(device);
-    rc = (Uint32) SDL_ReadFromDataQueue(device->buffer_queue, data, len);
-    current_audio.impl.UnlockDevice(device);
+    /* no need to lock the device; the audio thread only writes to the other end. */
+    SDL_LockMutex(device->buffer_queue_lock);
+    if (!device->capture_ring) {
+        rc = (Uint32) SDL_ReadFromLockFreeDataQueue(device->buffer_queue, data, len);
+    } else if (device->capture_ring_acquired) {
+        rc = 0;  /* the app is reading the oldest buffer in place; don't pull it out from under it. */
+    } else {
+        Uint8 *dst = (Uint8 *) data;
+        Uint32 avail;
+        const Uint8 *src;
+
+        rc = 0;
+        while ((len > 0) && ((src = peek_capture_ring(device, &avail, NULL)) != NULL)) {
+            const Uint32 cpy = SDL_min(len, avail);
+            SDL_memcpy(dst, src, cpy);
+            dst += cpy;
+            len -= cpy;
+            rc += cpy;
+            if (cpy == avail) {
+                release_capture_ring(device);
+            } else {
+                device->capture_ring_offset += cpy;
+            }
+        }
+    }
+    SDL_UnlockMutex(device->buffer_queue_lock);
     return rc;
 }
 
@@ -667,9 +984,16 @@ SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
     if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
         device->callbackspec.callback == SDL_BufferQueueFillCallback)
     {
-        current_audio.impl.LockDevice(device);
-        retval = (Uint32) SDL_CountDataQueue(device->buffer_queue);
-        current_audio.impl.UnlockDevice(device);
+        if (device->capture_ring) {
+            const Uint32 head = (Uint32) SDL_AtomicGet(&device->capture_ring_head);
+            const Uint32 tail = (Uint32) SDL_AtomicGet(&device->capture_ring_tail);
+            /* the offset can be a step ahead of tail here; that only makes this a lower bound. */
+            if (head != tail) {
+                retval = ((head - tail) * device->callbackspec.size) - device->capture_ring_offset;
+            }
+        } else {
+            retval = (Uint32) SDL_CountLockFreeDataQueue(device->buffer_queue);
+        }
     }
 
     return retval;
@@ -684,13 +1008,36 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
         return;  /* nothing to do. */
     }
 
-    /* Blank out the device and release the mutex. Free it afterwards. */
+    if (device->capture_ring) {
+        /* The device thread publishes slots and drains its stream with the
+           device locked, so nothing converted before this call shows up after it. */
+        SDL_LockMutex(device->buffer_queue_lock);
+        current_audio.impl.LockDevice(device);
+        if (device->stream) {
+            SDL_AudioStreamClear(device->stream);
+        }
+        device->capture_ring_offset = 0;
+        device->capture_ring_acquired = SDL_FALSE;
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&device->capture_ring_tail, SDL_AtomicGet(&device->capture_ring_head));
+        current_audio.impl.UnlockDevice(device);
+        SDL_UnlockMutex(device->buffer_queue_lock);
+        return;
+    }
+
+    if (!device->buffer_queue) {
+        return;  /* not set up for queueing. */
+    }
+
+    /* Clearing touches both ends of the queue, so stop both sides. */
+    SDL_LockMutex(device->buffer_queue_lock);
     current_audio.impl.LockDevice(device);
 
     /* Keep up to two packets in the pool to reduce future memory allocation pressure. */
-    SDL_ClearDataQueue(device->buffer_queue, SDL_AUDIOBUFFERQUEUE_PACKETLEN * 2);
+    SDL_ClearLockFreeDataQueue(device->buffer_queue, SDL_AUDIOBUFFERQUEUE_PACKETLEN * 2);
 
     current_audio.impl.UnlockDevice(device);
+    SDL_UnlockMutex(device->buffer_queue_lock);
 }
 
 
@@ -701,6 +1048,9 @@ SDL_RunAudio(void *devicep)
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    /* drivers without device buffers (like "dummy") always hand back NULL; that's not an underrun. */
+    const SDL_bool has_device_buf = (current_audio.impl.GetDeviceBuf != SDL_AudioGetDeviceBuf_Default);
+    const int frame_size = (SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8) * device->callbackspec.channels;
     int data_len = 0;
     Uint8 *data;
 
@@ -724,12 +1074,15 @@ SDL_RunAudio(void *devicep)
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
         current_audio.impl.BeginLoopIteration(device);
-        data_len = device->callbackspec.size;
+        data_len = device->period ? (int) (device->period * frame_size) : (int) device->callbackspec.size;
 
         /* Fill the current buffer with sound */
         if (!device->stream && SDL_AtomicGet(&device->enabled)) {
             SDL_assert(data_len == device->spec.size);
             data = current_audio.impl.GetDeviceBuf(device);
+            if (!data && has_device_buf) {
+                record_underrun(device);
+            }
         } else {
             /* if the device isn't enabled, we still write to the
                work_buffer, so the app's callback will fire with
@@ -749,40 +1102,55 @@ SDL_RunAudio(void *devicep)
         if (SDL_AtomicGet(&device->paused)) {
             SDL_memset(data, device->callbackspec.silence, data_len);
         } else {
+            const Uint64 start = SDL_GetPerformanceCounterNS();
             callback(udata, data, data_len);
+            if (device->period) {
+                adapt_callback_period(device, record_callback_time(device, start));
+            } else {
+                record_callback_time(device, start);
+            }
         }
         SDL_UnlockMutex(device->mixer_lock);
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
             /* if this fails...oh well. We'll play silence here. */
+            Uint64 start = SDL_GetPerformanceCounterNS();
             SDL_AudioStreamPut(device->stream, data, data_len);
+            record_conversion_time(device, start);
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->spec.size)) {
                 int got;
                 data = SDL_AtomicGet(&device->enabled) ? current_audio.impl.GetDeviceBuf(device) : NULL;
+                start = SDL_GetPerformanceCounterNS();
                 got = SDL_AudioStreamGet(device->stream, data ? data : device->work_buffer, device->spec.size);
+                record_conversion_time(device, start);
                 SDL_assert((got <= 0) || (got == device->spec.size));
 
                 if (data == NULL) {  /* device is having issues... */
-                    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-                    SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
+                    if (has_device_buf) {
+                        record_underrun(device);
+                    }
+                    wait_for_next_buffer(device);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
                 } else {
                     if (got != device->spec.size) {
                         SDL_memset(data, device->spec.silence, device->spec.size);
+                        record_underrun(device);
                     }
                     current_audio.impl.PlayDevice(device);
                     current_audio.impl.WaitDevice(device);
                 }
+                record_wakeup(device);
             }
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
-            const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-            SDL_Delay(delay);
+            wait_for_next_buffer(device);
+            record_wakeup(device);
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
             current_audio.impl.PlayDevice(device);
             current_audio.impl.WaitDevice(device);
+            record_wakeup(device);
         }
     }
 
@@ -803,7 +1171,6 @@ SDL_CaptureAudio(void *devicep)
 {
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     const int silence = (int) device->spec.silence;
-    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
     const int data_len = device->spec.size;
     Uint8 *data;
     void *udata = device->callbackspec.userdata;
@@ -830,23 +1197,39 @@ SDL_CaptureAudio(void *devicep)
     while (!SDL_AtomicGet(&device->shutdown)) {
         int still_need;
         Uint8 *ptr;
+        Uint8 *slot = NULL;
+        Uint64 timestamp = 0;
 
         current_audio.impl.BeginLoopIteration(device);
 
         if (SDL_AtomicGet(&device->paused)) {
-            SDL_Delay(delay);  /* just so we don't cook the CPU. */
+            device->stats_last_wakeup = 0;  /* don't count the pause as jitter. */
+            wait_for_next_buffer(device);  /* just so we don't cook the CPU. */
             if (device->stream) {
+                current_audio.impl.LockDevice(device);
                 SDL_AudioStreamClear(device->stream);
+                current_audio.impl.UnlockDevice(device);
             }
             current_audio.impl.FlushCapture(device);  /* dump anything pending. */
             continue;
         }
 
+        record_wakeup(device);
+
         /* Fill the current buffer with sound */
         still_need = data_len;
 
-        /* Use the work_buffer to hold data read from the device. */
+        /* Use the work_buffer to hold data read from the device, unless
+           there's no conversion to do and a capture ring slot is free, in
+           which case the device writes right where the app will read it. */
         data = device->work_buffer;
+        if (device->capture_ring && !device->stream) {
+            SDL_assert(device->callbackspec.size == data_len);
+            slot = get_capture_ring_slot(device);
+            if (slot) {
+                data = slot;
+            }
+        }
         SDL_assert(data != NULL);
 
         ptr = data;
@@ -856,7 +1239,7 @@ SDL_CaptureAudio(void *devicep)
            But we don't process it further or call the app's callback. */
 
         if (!SDL_AtomicGet(&device->enabled)) {
-            SDL_Delay(delay);  /* try to keep callback firing at normal pace. */
+            wait_for_next_buffer(device);  /* try to keep callback firing at normal pace. */
         } else {
             while (still_need > 0) {
                 const int rc = current_audio.impl.CaptureFromDevice(device, ptr, still_need);
@@ -871,34 +1254,86 @@ SDL_CaptureAudio(void *devicep)
             }
         }
 
+        if (device->capture_ring) {
+            timestamp = SDL_GetPerformanceCounter();
+        }
+
         if (still_need > 0) {
             /* Keep any data we already read, silence the rest. */
             SDL_memset(ptr, silence, still_need);
+            record_underrun(device);
         }
 
-        if (device->stream) {
+        if (device->capture_ring && !device->stream) {
+            if (!slot) {
+                record_overrun(device);  /* the app is behind; drop this one. */
+            } else {
+                /* under the lock, so nothing lands after a pause or a clear. */
+                current_audio.impl.LockDevice(device);
+                if (!SDL_AtomicGet(&device->paused)) {
+                    publish_capture_ring_slot(device, timestamp);
+                }
+                current_audio.impl.UnlockDevice(device);
+            }
+        } else if (device->stream) {
             /* if this fails...oh well. */
-            SDL_AudioStreamPut(device->stream, data, data_len);
+            Uint64 start;
+            if (device->capture_ring) {
+                current_audio.impl.LockDevice(device);  /* SDL_ClearQueuedAudio() clears the stream too. */
+            }
+            start = SDL_GetPerformanceCounterNS();
+            if (SDL_AudioStreamPut(device->stream, data, data_len) < 0) {
+                record_overrun(device);
+            }
+            record_conversion_time(device, start);
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->callbackspec.size)) {
-                const int got = SDL_AudioStreamGet(device->stream, device->work_buffer, device->callbackspec.size);
+                int got;
+                data = device->work_buffer;
+                if (device->capture_ring) {
+                    /* convert straight into the ring, or drain into the work_buffer if it's full. */
+                    slot = get_capture_ring_slot(device);
+                    if (slot) {
+                        data = slot;
+                    } else {
+                        record_overrun(device);
+                    }
+                }
+                start = SDL_GetPerformanceCounterNS();
+                got = SDL_AudioStreamGet(device->stream, data, device->callbackspec.size);
+                record_conversion_time(device, start);
                 SDL_assert((got < 0) || (got == device->callbackspec.size));
                 if (got != device->callbackspec.size) {
-                    SDL_memset(device->work_buffer, device->spec.silence, device->callbackspec.size);
+                    SDL_memset(data, device->spec.silence, device->callbackspec.size);
+                }
+
+                if (device->capture_ring) {
+                    if (slot && !SDL_AtomicGet(&device->paused)) {
+                        publish_capture_ring_slot(device, capture_ring_stream_timestamp(device, timestamp));
+                    }
+                    continue;
                 }
 
                 /* !!! FIXME: this should be LockDevice. */
                 SDL_LockMutex(device->mixer_lock);
                 if (!SDL_AtomicGet(&device->paused)) {
+                    start = SDL_GetPerformanceCounterNS();
                     callback(udata, device->work_buffer, device->callbackspec.size);
+                    record_callback_time(device, start);
                 }
                 SDL_UnlockMutex(device->mixer_lock);
             }
+
+            if (device->capture_ring) {
+                current_audio.impl.UnlockDevice(device);
+            }
         } else {  /* feeding user callback directly without streaming. */
             /* !!! FIXME: this should be LockDevice. */
             SDL_LockMutex(device->mixer_lock);
             if (!SDL_AtomicGet(&device->paused)) {
+                const Uint64 start = SDL_GetPerformanceCounterNS();
                 callback(udata, data, device->callbackspec.size);
+                record_callback_time(device, start);
             }
             SDL_UnlockMutex(device->mixer_lock);
         }
@@ -1226,7 +1661,12 @@ close_audio_device(SDL_AudioDevice * device)
         current_audio.impl.CloseDevice(device);
     }
 
-    SDL_FreeDataQueue(device->buffer_queue);
+    SDL_FreeLockFreeDataQueue(device->buffer_queue);
+    SDL_free(device->capture_ring);
+    SDL_free(device->capture_ring_timestamps);
+    if (device->buffer_queue_lock != NULL) {
+        SDL_DestroyMutex(device->buffer_queue_lock);
+    }
 
     SDL_free(device);
 }
@@ -1474,6 +1914,20 @@ open_audio_device(const char *devname, int iscapture,
 
     device->callbackspec = *obtained;
 
+    if (!iscapture) {
+        const char *hint = SDL_GetHint(SDL_HINT_AUDIO_ADAPTIVE_PERIOD);
+        unsigned int period_min = 0, period_max = 0;
+        if (hint && (SDL_sscanf(hint, "%u,%u", &period_min, &period_max) == 2) &&
+            (period_min > 0) && (period_min <= period_max)) {
+            /* the callback's size changes, the device's can't; the stream goes between them. */
+            device->period_min = (Uint32) SDL_min(period_min, 0xFFFF);
+            device->period_max = (Uint32) SDL_min(period_max, 0xFFFF);
+            device->period = SDL_clamp((Uint32) obtained->samples, device->period_min, device->period_max);
+            build_stream = SDL_TRUE;
+        }
+    }
+    device->stats.callback_samples = device->period ? device->period : obtained->samples;
+
     if (build_stream) {
         if (iscapture) {
             device->stream = SDL_NewAudioStream(device->spec.format,
@@ -1492,11 +1946,35 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
-        /* pool a few packets to start. Enough for two callbacks. */
-        device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
-        if (!device->buffer_queue) {
+        const char *hint = iscapture ? SDL_GetHint(SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS) : NULL;
+        const int ring_slots = hint ? SDL_atoi(hint) : 0;
+        if (ring_slots > 0) {
+            /* a power of two, so the slot index survives the counters wrapping. */
+            Uint32 slots = 1;
+            while ((slots < (Uint32) ring_slots) && (slots < SDL_AUDIO_CAPTURE_RING_MAX_SLOTS)) {
+                slots <<= 1;
+            }
+            device->capture_ring_slots = slots;
+            device->capture_ring = (Uint8 *) SDL_malloc((size_t) slots * obtained->size);
+            device->capture_ring_timestamps = (Uint64 *) SDL_calloc(slots, sizeof (Uint64));
+            if (!device->capture_ring || !device->capture_ring_timestamps) {
+                close_audio_device(device);
+                SDL_OutOfMemory();
+                return 0;
+            }
+        } else {
+            /* pool a few packets to start. Enough for two callbacks. */
+            device->buffer_queue = SDL_NewLockFreeDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
+            if (!device->buffer_queue) {
+                close_audio_device(device);
+                SDL_SetError("Couldn't create audio buffer queue");
+                return 0;
+            }
+        }
+        device->buffer_queue_lock = SDL_CreateMutex();
+        if (device->buffer_queue_lock == NULL) {
             close_audio_device(device);
-            SDL_SetError("Couldn't create audio buffer queue");
+            SDL_SetError("Couldn't create audio buffer queue lock");
             return 0;
         }
         device->callbackspec.callback = iscapture ? SDL_BufferQueueFillCallback : SDL_BufferQueueDrainCallback;
@@ -1508,6 +1986,10 @@ open_audio_device(const char *devname, int iscapture,
     if (device->spec.size > device->work_buffer_len) {
         device->work_buffer_len = device->spec.size;
     }
+    if (device->period_max) {
+        const Uint32 period_len = device->period_max * (SDL_AUDIO_BITSIZE(obtained->format) / 8) * obtained->channels;
+        device->work_buffer_len = SDL_max(device->work_buffer_len, period_len);
+    }
     SDL_assert(device->work_buffer_len > 0);
 
     device->work_buffer = (Uint8 *) SDL_malloc(device->work_buffer_len);
@@ -43,6 +43,10 @@
 #define HAVE_SSE_INTRINSICS 1
 #endif
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
 #ifdef __SSE3__
 #define HAVE_SSE3_INTRINSICS 1
 #endif
@@ -80,7 +84,7 @@ SDL_ConvertStereoToMono_SSE3(SDL_AudioCVT * cvt, SDL_AudioFormat format)
        Just use unaligned load/stores, if the memory at runtime is
        aligned it'll be just as fast on modern processors */
     while (i >= 4) {   /* 4 * float32 */
-        _mm_storeu_ps(dst, _mm_mul_ps(_mm_hadd_ps(_mm_load_ps(src), _mm_loadu_ps(src+4)), divby2));
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_hadd_ps(_mm_loadu_ps(src), _mm_loadu_ps(src+4)), divby2));
         i -= 4; src += 8; dst += 4;
     }
 
@@ -396,14 +400,17 @@ SDL_Convert71To61(SDL_AudioCVT * cvt, SDL_AudioFormat format)
     LOG_DEBUG_CONVERT("7.1", "6.1");
     SDL_assert(format == AUDIO_F32SYS);
 
+    /* Read the whole frame first; the output overlaps it. */
     for (i = cvt->len_cvt / (sizeof (float) * 8); i; --i, src += 8, dst += 7) {
-        dst[0] = src[3]; /* LFE */
-        dst[1] = src[2]; /* FC */ 
-        dst[2] = src[1]; /* FR */
-        dst[3] = src[7]; /* SR */
-        dst[4] = (src[4] + src[5]) / 0.2f;  /* BackSurround */
-        dst[5] = src[6]; /* SL */
-        dst[6] = src[0];  /* FL */
+        const float fl = src[0], fr = src[1], fc = src[2], lfe = src[3];
+        const float bl = src[4], br = src[5], sl = src[6], sr = src[7];
+        dst[0] = lfe; /* LFE */
+        dst[1] = fc; /* FC */
+        dst[2] = fr; /* FR */
+        dst[3] = sr; /* SR */
+        dst[4] = (bl + br) / 0.2f;  /* BackSurround */
+        dst[5] = sl; /* SL */
+        dst[6] = fl;  /* FL */
     }
 
     cvt->len_cvt /= 8;
@@ -419,22 +426,28 @@ SDL_Convert71To61(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 static void SDLCALL
 SDL_Convert61To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 {
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt / 7 * 8);
     int i;
 
     LOG_DEBUG_CONVERT("6.1", "7.1");
     SDL_assert(format == AUDIO_F32SYS);
 
-    for (i = cvt->len_cvt / (sizeof (float) * 7); i; --i, src += 7, dst += 8) {
-        dst[0] = src[6]; /* FL */
-        dst[1] = src[2]; /* FR */ 
-        dst[2] = src[1]; /* FC */
-        dst[3] = src[0]; /* LFE */
-        dst[4] = src[4]; /* BL */
-        dst[5] = src[4]; /* BR */
-        dst[6] = src[5];  /* SL */
-        dst[7] = src[3];  /* SR */
+    /* Work back to front, reading the whole frame first; the output overlaps it. */
+    for (i = cvt->len_cvt / (sizeof (float) * 7); i; --i) {
+        float lfe, fc, fr, sr, bs, sl, fl;
+        dst -= 8;
+        src -= 7;
+        lfe = src[0]; fc = src[1]; fr = src[2]; sr = src[3];
+        bs = src[4]; sl = src[5]; fl = src[6];
+        dst[0] = fl; /* FL */
+        dst[1] = fr; /* FR */
+        dst[2] = fc; /* FC */
+        dst[3] = lfe; /* LFE */
+        dst[4] = bs; /* BL */
+        dst[5] = bs; /* BR */
+        dst[6] = sl;  /* SL */
+        dst[7] = sr;  /* SR */
     }
 
     cvt->len_cvt /= 7;
@@ -450,21 +463,27 @@ SDL_Convert61To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 static void SDLCALL
 SDL_Convert51To61(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 {
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt / 6 * 7);
     int i;
 
     LOG_DEBUG_CONVERT("5.1", "6.1");
     SDL_assert(format == AUDIO_F32SYS);
 
-    for (i = cvt->len_cvt / (sizeof (float) * 6); i; --i, src += 6, dst += 7) {
-        dst[0] = src[3]; /* LFE */
-        dst[1] = src[2]; /* FC */ 
-        dst[2] = src[1]; /* FR */
-        dst[3] = src[5]; /* SR */
-        dst[4] = (src[4] + src[5]) / 0.2f;  /* BackSurround */
-        dst[5] = src[4]; /* SL */
-        dst[6] = src[0];  /* FL */
+    /* Work back to front, reading the whole frame first; the output overlaps it. */
+    for (i = cvt->len_cvt / (sizeof (float) * 6); i; --i) {
+        float fl, fr, fc, lfe, bl, br;
+        dst -= 7;
+        src -= 6;
+        fl = src[0]; fr = src[1]; fc = src[2]; lfe = src[3];
+        bl = src[4]; br = src[5];
+        dst[0] = lfe; /* LFE */
+        dst[1] = fc; /* FC */
+        dst[2] = fr; /* FR */
+        dst[3] = br; /* SR */
+        dst[4] = (bl + br) / 0.2f;  /* BackSurround */
+        dst[5] = bl; /* SL */
+        dst[6] = fl;  /* FL */
     }
 
     cvt->len_cvt /= 6;
@@ -487,13 +506,16 @@ SDL_Convert61To51(SDL_AudioCVT * cvt, SDL_AudioFormat format)
     LOG_DEBUG_CONVERT("6.1", "5.1");
     SDL_assert(format == AUDIO_F32SYS);
 
+    /* Read the whole frame first; the output overlaps it. */
     for (i = cvt->len_cvt / (sizeof (float) * 7); i; --i, src += 7, dst += 6) {
-        dst[0] = src[6]; /* FL */
-        dst[1] = src[2]; /* FR */ 
-        dst[2] = src[1]; /* FC */
-        dst[3] = src[0]; /* LFE */
-        dst[4] = src[5]; /* BL */
-        dst[5] = src[3]; /* BR */
+        const float lfe = src[0], fc = src[1], fr = src[2], sr = src[3];
+        const float sl = src[5], fl = src[6];
+        dst[0] = fl; /* FL */
+        dst[1] = fr; /* FR */
+        dst[2] = fc; /* FC */
+        dst[3] = lfe; /* LFE */
+        dst[4] = sl; /* BL */
+        dst[5] = sr; /* BR */
     }
 
     cvt->len_cvt /= 7;
@@ -701,6 +723,618 @@ SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
     }
 }
 
+/* Fused type/channel conversion. A channel converter sitting next to the
+   S16 <-> float converters makes the chain walk the whole buffer two or
+   three times; these do the conversion and the mix in one pass per frame.
+   The mixing math is the same as the scalar channel converters above. */
+
+/* These convert a block of samples the same way SDL_Convert_S16_to_F32 and
+   SDL_Convert_F32_to_S16 would, including the SIMD paths they pick. */
+static const float *
+SDL_FusedLoadS16(const Sint16 *src, float *dst, const int samples, const SDL_bool simd)
+{
+    int i = 0;
+
+    #if HAVE_SSE2_INTRINSICS
+    if (simd) {
+        const __m128 divby32768 = _mm_set1_ps(1.0f / 32768.0f);
+        for (; i + 8 <= samples; i += 8) {
+            const __m128i ints = _mm_loadu_si128((const __m128i *) &src[i]);
+            /* sign-extend to two sets of four sint32, convert to float, normalize. */
+            _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(ints, ints), 16)), divby32768));
+            _mm_storeu_ps(&dst[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(ints, ints), 16)), divby32768));
+        }
+    }
+    #elif HAVE_NEON_INTRINSICS
+    if (simd) {
+        const float32x4_t divby32768 = vdupq_n_f32(1.0f / 32768.0f);
+        for (; i + 8 <= samples; i += 8) {
+            const int16x8_t ints = vld1q_s16((int16_t const *) &src[i]);
+            vst1q_f32(&dst[i], vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(ints))), divby32768));
+            vst1q_f32(&dst[i + 4], vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(ints))), divby32768));
+        }
+    }
+    #endif
+
+    for (; i < samples; i++) {
+        dst[i] = ((float) src[i]) * (1.0f / 32768.0f);
+    }
+    return dst;
+}
+
+/* Float input is mixed straight from the buffer. */
+static const float *
+SDL_FusedLoadF32(const float *src, float *dst, const int samples, const SDL_bool simd)
+{
+    return src;
+}
+
+static void
+SDL_FusedStoreS16(const float *src, Sint16 *dst, const int samples, const SDL_bool simd)
+{
+    int i = 0;
+
+    #if HAVE_SSE2_INTRINSICS
+    if (simd) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 negone = _mm_set1_ps(-1.0f);
+        const __m128 mulby32767 = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= samples; i += 8) {
+            const __m128i ints1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(negone, _mm_loadu_ps(&src[i])), one), mulby32767));
+            const __m128i ints2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(negone, _mm_loadu_ps(&src[i + 4])), one), mulby32767));
+            _mm_storeu_si128((__m128i *) &dst[i], _mm_packs_epi32(ints1, ints2));
+        }
+    }
+    #elif HAVE_NEON_INTRINSICS
+    if (simd) {
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
+        for (; i + 8 <= samples; i += 8) {
+            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(&src[i])), one), mulby32767));
+            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(&src[i + 4])), one), mulby32767));
+            vst1q_s16((int16_t *) &dst[i], vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2)));
+        }
+    }
+    #endif
+
+    for (; i < samples; i++) {
+        const float sample = src[i];
+        if (sample >= 1.0f) {
+            dst[i] = 32767;
+        } else if (sample <= -1.0f) {
+            dst[i] = -32768;
+        } else {
+            dst[i] = (Sint16) (sample * 32767.0f);
+        }
+    }
+}
+
+/* Float output is mixed straight into the buffer; that is only fused after
+   SDL_FusedLoadS16, which has already copied the block out of the way. */
+static float *
+SDL_FusedTargetF32(float *dst, float *buf)
+{
+    return dst;
+}
+
+static float *
+SDL_FusedTargetS16(Sint16 *dst, float *buf)
+{
+    return buf;
+}
+
+static void
+SDL_FusedStoreF32(const float *src, float *dst, const int samples, const SDL_bool simd)
+{
+    SDL_assert(src == dst);  /* mixed in place, nothing to do. */
+}
+
+static SDL_bool
+SDL_FusedHasSIMD(void)
+{
+    #if HAVE_SSE2_INTRINSICS
+    return SDL_HasSSE2();
+    #elif HAVE_NEON_INTRINSICS
+    return SDL_HasNEON();
+    #else
+    return SDL_FALSE;
+    #endif
+}
+
+static SDL_INLINE void
+SDL_FusedMixMonoToStereo(const float *src, float *dst)
+{
+    dst[0] = dst[1] = src[0];
+}
+
+static SDL_INLINE void
+SDL_FusedMixStereoToMono(const float *src, float *dst)
+{
+    dst[0] = (src[0] + src[1]) * 0.5f;
+}
+
+static SDL_INLINE void
+SDL_FusedMixStereoTo51(const float *src, float *dst)
+{
+    const float lf = src[0];
+    const float rf = src[1];
+    const float ce = (lf + rf) * 0.5f;
+    dst[0] = 0.571f * (lf + (lf - 0.5f * ce));  /* FL */
+    dst[1] = 0.571f * (rf + (rf - 0.5f * ce));  /* FR */
+    dst[2] = ce;  /* FC */
+    dst[3] = 0;   /* LFE */
+    dst[4] = lf;  /* BL */
+    dst[5] = rf;  /* BR */
+}
+
+static SDL_INLINE void
+SDL_FusedMix51ToStereo(const float *src, float *dst)
+{
+    const float two_fifths = 1.0f / 2.5f;
+    const float front_center_distributed = src[2] * 0.5f;
+    dst[0] = (src[0] + front_center_distributed + src[4]) * two_fifths;  /* left */
+    dst[1] = (src[1] + front_center_distributed + src[5]) * two_fifths;  /* right */
+}
+
+/* Work in blocks of FUSED_CVT_BLOCK_FRAMES frames, staging S16 data through
+   float buffers on the stack so the intermediate floats stay in L1. Frames
+   that grow are converted back to front and frames that shrink front to
+   back, so the conversion can still run in place like every other filter:
+   each block is read completely before its output is written. */
+#define FUSED_CVT_BLOCK_FRAMES 64
+
+#define FUSED_CVT_FUNCS(name, srctype, srcfmt, srcchans, load, mix, dsttype, dstfmt, dstchans, target, store, from, to) \
+    static void \
+    SDL_ConvertFusedBlock_##name(const srctype *src, dsttype *dst, const int frames, const SDL_bool simd) { \
+        float inbuf[FUSED_CVT_BLOCK_FRAMES * srcchans]; \
+        float outbuf[FUSED_CVT_BLOCK_FRAMES * dstchans]; \
+        const float *in = load(src, inbuf, frames * srcchans, simd); \
+        float *out = target(dst, outbuf); \
+        int i; \
+        for (i = 0; i < frames; i++) { \
+            mix(&in[i * srcchans], &out[i * dstchans]); \
+        } \
+        store(out, dst, frames * dstchans, simd); \
+    } \
+    static void SDLCALL \
+    SDL_ConvertFused_##name(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+        const srctype *src = (const srctype *) cvt->buf; \
+        dsttype *dst = (dsttype *) cvt->buf; \
+        const int frames = cvt->len_cvt / (int) (sizeof (srctype) * srcchans); \
+        const SDL_bool simd = SDL_FusedHasSIMD(); \
+        int first, count; \
+        LOG_DEBUG_CONVERT(from, to); \
+        SDL_assert(format == srcfmt); \
+        if (sizeof (dsttype) * dstchans > sizeof (srctype) * srcchans) { \
+            for (first = frames; first > 0; first -= count) { \
+                count = SDL_min(first, FUSED_CVT_BLOCK_FRAMES); \
+                SDL_ConvertFusedBlock_##name(src + (first - count) * srcchans, dst + (first - count) * dstchans, count, simd); \
+            } \
+        } else { \
+            for (first = 0; first < frames; first += count) { \
+                count = SDL_min(frames - first, FUSED_CVT_BLOCK_FRAMES); \
+                SDL_ConvertFusedBlock_##name(src + first * srcchans, dst + first * dstchans, count, simd); \
+            } \
+        } \
+        cvt->len_cvt = frames * (int) (sizeof (dsttype) * dstchans); \
+        if (cvt->filters[++cvt->filter_index]) { \
+            cvt->filters[cvt->filter_index](cvt, dstfmt); \
+        } \
+    }
+
+#define FUSED_CVT_MIX_FUNCS(name, srcchans, mix, dstchans, from, to) \
+    FUSED_CVT_FUNCS(S16_##name##_F32, Sint16, AUDIO_S16SYS, srcchans, SDL_FusedLoadS16, mix, float, AUDIO_F32SYS, dstchans, SDL_FusedTargetF32, SDL_FusedStoreF32, "AUDIO_S16 " from, "AUDIO_F32 " to) \
+    FUSED_CVT_FUNCS(F32_##name##_S16, float, AUDIO_F32SYS, srcchans, SDL_FusedLoadF32, mix, Sint16, AUDIO_S16SYS, dstchans, SDL_FusedTargetS16, SDL_FusedStoreS16, "AUDIO_F32 " from, "AUDIO_S16 " to) \
+    FUSED_CVT_FUNCS(S16_##name##_S16, Sint16, AUDIO_S16SYS, srcchans, SDL_FusedLoadS16, mix, Sint16, AUDIO_S16SYS, dstchans, SDL_FusedTargetS16, SDL_FusedStoreS16, "AUDIO_S16 " from, "AUDIO_S16 " to)
+
+FUSED_CVT_MIX_FUNCS(MonoToStereo, 1, SDL_FusedMixMonoToStereo, 2, "mono", "stereo")
+FUSED_CVT_MIX_FUNCS(StereoToMono, 2, SDL_FusedMixStereoToMono, 1, "stereo", "mono")
+FUSED_CVT_MIX_FUNCS(StereoTo51, 2, SDL_FusedMixStereoTo51, 6, "stereo", "5.1")
+FUSED_CVT_MIX_FUNCS(51ToStereo, 6, SDL_FusedMix51ToStereo, 2, "5.1", "stereo")
+#undef FUSED_CVT_MIX_FUNCS
+#undef FUSED_CVT_FUNCS
+#undef FUSED_CVT_BLOCK_FRAMES
+
+/* Channel matrix mixing. Every channel converter above maps each frame to a
+   weighted sum of the input channels, so a run of them in the filter list
+   (stereo -> 5.1 -> 7.1, say) can be replaced by one matrix that reads and
+   writes the buffer once. The SIMD kernels build each output frame as a sum
+   of coefficient vectors scaled by the input samples, which works the same
+   for every pair of layouts. */
+
+#define CHANNEL_MIX_MAX_CHANNELS 8
+#define CHANNEL_MIX_BLOCK_FRAMES 64
+
+/* A channel converter and the matrix it applies, as matrix[dst][src]. */
+typedef struct
+{
+    SDL_AudioFilter filter;
+    int src_channels;
+    int dst_channels;
+    float matrix[CHANNEL_MIX_MAX_CHANNELS][CHANNEL_MIX_MAX_CHANNELS];
+} SDL_ChannelMixStep;
+
+/* SDL's 4.0 layout: FL+FR+BL+BR */
+/* SDL's 5.1 layout: FL+FR+FC+LFE+BL+BR */
+/* SDL's 6.1 layout: LFE+FC+FR+SR+BackSurround+SL+FL */
+/* SDL's 7.1 layout: FL+FR+FC+LFE+BL+BR+SL+SR */
+static const SDL_ChannelMixStep channel_mix_steps[] = {
+    { SDL_ConvertStereoToMono, 2, 1, {
+        { 0.5f, 0.5f } } },
+    { SDL_Convert51ToStereo, 6, 2, {
+        { 1.0f / 2.5f, 0.0f, 0.5f / 2.5f, 0.0f, 1.0f / 2.5f, 0.0f },
+        { 0.0f, 1.0f / 2.5f, 0.5f / 2.5f, 0.0f, 0.0f, 1.0f / 2.5f } } },
+    { SDL_ConvertQuadToStereo, 4, 2, {
+        { 0.5f, 0.0f, 0.5f, 0.0f },
+        { 0.0f, 0.5f, 0.0f, 0.5f } } },
+    { SDL_Convert71To51, 8, 6, {
+        { 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f, 0.0f },
+        { 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f },
+        { 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f } } },
+    { SDL_Convert71To61, 8, 7, {
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 0.2f, 1.0f / 0.2f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+        { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } } },
+    { SDL_Convert61To71, 7, 8, {
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f } } },
+    { SDL_Convert51To61, 6, 7, {
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 0.2f, 1.0f / 0.2f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+        { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } } },
+    { SDL_Convert61To51, 7, 6, {
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f } } },
+    { SDL_Convert51ToQuad, 6, 4, {
+        { 1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f / 1.5f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f } } },
+    { SDL_ConvertMonoToStereo, 1, 2, {
+        { 1.0f },
+        { 1.0f } } },
+    /* FL = 0.571 * (L + (L - 0.5 * (L + R) * 0.5)), and so on. */
+    { SDL_ConvertStereoTo51, 2, 6, {
+        { 0.571f * 1.75f, 0.571f * -0.25f },
+        { 0.571f * -0.25f, 0.571f * 1.75f },
+        { 0.5f, 0.5f },
+        { 0.0f, 0.0f },
+        { 1.0f, 0.0f },
+        { 0.0f, 1.0f } } },
+    { SDL_ConvertQuadTo51, 4, 6, {
+        { 0.571f * 1.75f, 0.571f * -0.25f, 0.0f, 0.0f },
+        { 0.571f * -0.25f, 0.571f * 1.75f, 0.0f, 0.0f },
+        { 0.5f, 0.5f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f } } },
+    { SDL_ConvertStereoToQuad, 2, 4, {
+        { 1.0f, 0.0f },
+        { 0.0f, 1.0f },
+        { 1.0f, 0.0f },
+        { 0.0f, 1.0f } } },
+    /* FL = 0.5 * (FL + (FL - SL)) with SL = (FL + BL) * 0.5, and so on. */
+    { SDL_Convert51To71, 6, 8, {
+        { 0.75f, 0.0f, 0.0f, 0.0f, -0.25f, 0.0f },
+        { 0.0f, 0.75f, 0.0f, 0.0f, 0.0f, -0.25f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+        { -0.25f, 0.0f, 0.0f, 0.0f, 0.75f, 0.0f },
+        { 0.0f, -0.25f, 0.0f, 0.0f, 0.0f, 0.75f },
+        { 0.5f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f },
+        { 0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.5f } } }
+};
+
+/* The mix for one pair of channel counts, as columns[src][dst]: what each
+   input channel adds to every output channel, padded with zeroes to a full
+   vector. */
+typedef struct
+{
+    SDL_bool ready;
+    float columns[CHANNEL_MIX_MAX_CHANNELS][CHANNEL_MIX_MAX_CHANNELS];
+} SDL_ChannelMix;
+
+/* Indexed by SDL_ChannelMixIndex(). The channel converters SDL_BuildAudioCVT
+   picks only depend on the two channel counts, so one mix per pair covers
+   every filter list. Filled in on first use under channel_mix_lock. */
+static SDL_ChannelMix channel_mixes[6][6];
+static SDL_SpinLock channel_mix_lock;
+
+static int
+SDL_ChannelMixIndex(const int channels)
+{
+    switch (channels) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 6: return 3;
+        case 7: return 4;
+        default: SDL_assert(channels == 8); return 5;
+    }
+}
+
+/* Scalar and SIMD versions of the mixer's inner loop. Each writes a whole
+   vector per frame into dst, so dst needs room for a vector past the last
+   frame; the extra lanes are overwritten by the next frame. */
+static void
+SDL_MixChannelsBlock_Scalar(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    int i, c, d;
+
+    for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+        for (d = 0; d < dstchans; d++) {
+            float sample = 0.0f;
+            for (c = 0; c < srcchans; c++) {
+                sample += src[c] * mix->columns[c][d];
+            }
+            dst[d] = sample;
+        }
+    }
+}
+
+#if HAVE_AVX_INTRINSICS
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx")))
+#endif
+SDL_FORCE_INLINE void
+SDL_MixChannelFrames_AVX(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    __m256 columns[CHANNEL_MIX_MAX_CHANNELS];
+    int i, c;
+
+    for (c = 0; c < srcchans; c++) {
+        columns[c] = _mm256_loadu_ps(mix->columns[c]);
+    }
+
+    for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+        __m256 out = _mm256_mul_ps(_mm256_broadcast_ss(&src[0]), columns[0]);
+        for (c = 1; c < srcchans; c++) {
+            out = _mm256_add_ps(out, _mm256_mul_ps(_mm256_broadcast_ss(&src[c]), columns[c]));
+        }
+        _mm256_storeu_ps(dst, out);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx")))
+#endif
+static void
+SDL_MixChannelsBlock_AVX(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    /* Spell out the channel count so the loops over it get unrolled. */
+    switch (srcchans) {
+        case 1: SDL_MixChannelFrames_AVX(src, dst, frames, 1, dstchans, mix); break;
+        case 2: SDL_MixChannelFrames_AVX(src, dst, frames, 2, dstchans, mix); break;
+        case 4: SDL_MixChannelFrames_AVX(src, dst, frames, 4, dstchans, mix); break;
+        case 6: SDL_MixChannelFrames_AVX(src, dst, frames, 6, dstchans, mix); break;
+        case 7: SDL_MixChannelFrames_AVX(src, dst, frames, 7, dstchans, mix); break;
+        default: SDL_MixChannelFrames_AVX(src, dst, frames, 8, dstchans, mix); break;
+    }
+}
+#endif
+
+#if HAVE_SSE_INTRINSICS
+SDL_FORCE_INLINE void
+SDL_MixChannelFrames_SSE(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    __m128 lo[CHANNEL_MIX_MAX_CHANNELS], hi[CHANNEL_MIX_MAX_CHANNELS];
+    int i, c;
+
+    for (c = 0; c < srcchans; c++) {
+        lo[c] = _mm_loadu_ps(&mix->columns[c][0]);
+        hi[c] = _mm_loadu_ps(&mix->columns[c][4]);
+    }
+
+    if (dstchans <= 4) {
+        for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+            __m128 out = _mm_mul_ps(_mm_set1_ps(src[0]), lo[0]);
+            for (c = 1; c < srcchans; c++) {
+                out = _mm_add_ps(out, _mm_mul_ps(_mm_set1_ps(src[c]), lo[c]));
+            }
+            _mm_storeu_ps(dst, out);
+        }
+    } else {
+        for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+            __m128 sample = _mm_set1_ps(src[0]);
+            __m128 out0 = _mm_mul_ps(sample, lo[0]);
+            __m128 out1 = _mm_mul_ps(sample, hi[0]);
+            for (c = 1; c < srcchans; c++) {
+                sample = _mm_set1_ps(src[c]);
+                out0 = _mm_add_ps(out0, _mm_mul_ps(sample, lo[c]));
+                out1 = _mm_add_ps(out1, _mm_mul_ps(sample, hi[c]));
+            }
+            _mm_storeu_ps(dst, out0);
+            _mm_storeu_ps(dst + 4, out1);
+        }
+    }
+}
+
+static void
+SDL_MixChannelsBlock_SSE(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    /* Spell out the channel count so the loops over it get unrolled. */
+    switch (srcchans) {
+        case 1: SDL_MixChannelFrames_SSE(src, dst, frames, 1, dstchans, mix); break;
+        case 2: SDL_MixChannelFrames_SSE(src, dst, frames, 2, dstchans, mix); break;
+        case 4: SDL_MixChannelFrames_SSE(src, dst, frames, 4, dstchans, mix); break;
+        case 6: SDL_MixChannelFrames_SSE(src, dst, frames, 6, dstchans, mix); break;
+        case 7: SDL_MixChannelFrames_SSE(src, dst, frames, 7, dstchans, mix); break;
+        default: SDL_MixChannelFrames_SSE(src, dst, frames, 8, dstchans, mix); break;
+    }
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+SDL_FORCE_INLINE void
+SDL_MixChannelFrames_NEON(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    float32x4_t lo[CHANNEL_MIX_MAX_CHANNELS], hi[CHANNEL_MIX_MAX_CHANNELS];
+    int i, c;
+
+    for (c = 0; c < srcchans; c++) {
+        lo[c] = vld1q_f32(&mix->columns[c][0]);
+        hi[c] = vld1q_f32(&mix->columns[c][4]);
+    }
+
+    if (dstchans <= 4) {
+        for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+            float32x4_t out = vmulq_n_f32(lo[0], src[0]);
+            for (c = 1; c < srcchans; c++) {
+                out = vmlaq_n_f32(out, lo[c], src[c]);
+            }
+            vst1q_f32(dst, out);
+        }
+    } else {
+        for (i = 0; i < frames; i++, src += srcchans, dst += dstchans) {
+            float32x4_t out0 = vmulq_n_f32(lo[0], src[0]);
+            float32x4_t out1 = vmulq_n_f32(hi[0], src[0]);
+            for (c = 1; c < srcchans; c++) {
+                out0 = vmlaq_n_f32(out0, lo[c], src[c]);
+                out1 = vmlaq_n_f32(out1, hi[c], src[c]);
+            }
+            vst1q_f32(dst, out0);
+            vst1q_f32(dst + 4, out1);
+        }
+    }
+}
+
+static void
+SDL_MixChannelsBlock_NEON(const float *src, float *dst, const int frames, const int srcchans, const int dstchans, const SDL_ChannelMix *mix)
+{
+    /* Spell out the channel count so the loops over it get unrolled. */
+    switch (srcchans) {
+        case 1: SDL_MixChannelFrames_NEON(src, dst, frames, 1, dstchans, mix); break;
+        case 2: SDL_MixChannelFrames_NEON(src, dst, frames, 2, dstchans, mix); break;
+        case 4: SDL_MixChannelFrames_NEON(src, dst, frames, 4, dstchans, mix); break;
+        case 6: SDL_MixChannelFrames_NEON(src, dst, frames, 6, dstchans, mix); break;
+        case 7: SDL_MixChannelFrames_NEON(src, dst, frames, 7, dstchans, mix); break;
+        default: SDL_MixChannelFrames_NEON(src, dst, frames, 8, dstchans, mix); break;
+    }
+}
+#endif
+
+static SDL_bool
+SDL_ChannelMixHasSIMD(void)
+{
+    #if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        return SDL_TRUE;
+    }
+    #endif
+    #if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return SDL_TRUE;
+    }
+    #endif
+    return SDL_FALSE;
+}
+
+/* Mix each block into a staging buffer and copy it over the input. Growing
+   conversions work back to front and shrinking ones front to back, so a
+   block never overwrites input that hasn't been read yet. */
+static void
+SDL_MixChannels(SDL_AudioCVT *cvt, SDL_AudioFormat format, const int srcchans, const int dstchans)
+{
+    const SDL_ChannelMix *mix = &channel_mixes[SDL_ChannelMixIndex(srcchans)][SDL_ChannelMixIndex(dstchans)];
+    const float *src = (const float *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const int frames = cvt->len_cvt / (int) (sizeof (float) * srcchans);
+    float block[(CHANNEL_MIX_BLOCK_FRAMES + 1) * CHANNEL_MIX_MAX_CHANNELS];
+    void (*mixblock)(const float *, float *, const int, const int, const int, const SDL_ChannelMix *) = SDL_MixChannelsBlock_Scalar;
+    int first, count;
+
+#if DEBUG_CONVERT
+    printf("Mixing %d channels to %d\n", srcchans, dstchans);
+#endif
+    SDL_assert(format == AUDIO_F32SYS);
+    SDL_assert(mix->ready);
+
+    #if HAVE_AVX_INTRINSICS
+    if (SDL_HasAVX()) {
+        mixblock = SDL_MixChannelsBlock_AVX;
+    }
+    #endif
+    #if HAVE_SSE_INTRINSICS
+    if (mixblock == SDL_MixChannelsBlock_Scalar && SDL_HasSSE()) {
+        mixblock = SDL_MixChannelsBlock_SSE;
+    }
+    #endif
+    #if HAVE_NEON_INTRINSICS
+    if (mixblock == SDL_MixChannelsBlock_Scalar && SDL_HasNEON()) {
+        mixblock = SDL_MixChannelsBlock_NEON;
+    }
+    #endif
+
+    if (dstchans > srcchans) {
+        for (first = frames; first > 0; first -= count) {
+            count = SDL_min(first, CHANNEL_MIX_BLOCK_FRAMES);
+            mixblock(src + (first - count) * srcchans, block, count, srcchans, dstchans, mix);
+            SDL_memcpy(dst + (first - count) * dstchans, block, count * dstchans * sizeof (float));
+        }
+    } else {
+        for (first = 0; first < frames; first += count) {
+            count = SDL_min(frames - first, CHANNEL_MIX_BLOCK_FRAMES);
+            mixblock(src + first * srcchans, block, count, srcchans, dstchans, mix);
+            SDL_memcpy(dst + first * dstchans, block, count * dstchans * sizeof (float));
+        }
+    }
+
+    cvt->len_cvt = frames * (int) (sizeof (float) * dstchans);
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+#define CHANNEL_MIX_FUNC(srcchans, dstchans) \
+    static void SDLCALL \
+    SDL_MixChannels_##srcchans##_##dstchans(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+        SDL_MixChannels(cvt, format, srcchans, dstchans); \
+    }
+#define CHANNEL_MIX_FUNCS(srcchans) \
+    CHANNEL_MIX_FUNC(srcchans, 1) CHANNEL_MIX_FUNC(srcchans, 2) CHANNEL_MIX_FUNC(srcchans, 4) \
+    CHANNEL_MIX_FUNC(srcchans, 6) CHANNEL_MIX_FUNC(srcchans, 7) CHANNEL_MIX_FUNC(srcchans, 8)
+CHANNEL_MIX_FUNCS(1)
+CHANNEL_MIX_FUNCS(2)
+CHANNEL_MIX_FUNCS(4)
+CHANNEL_MIX_FUNCS(6)
+CHANNEL_MIX_FUNCS(7)
+CHANNEL_MIX_FUNCS(8)
+#undef CHANNEL_MIX_FUNCS
+#undef CHANNEL_MIX_FUNC
+
+/* Indexed like channel_mixes; the diagonal is never used. */
+#define CHANNEL_MIX_FUNC_ROW(srcchans) \
+    { SDL_MixChannels_##srcchans##_1, SDL_MixChannels_##srcchans##_2, SDL_MixChannels_##srcchans##_4, \
+      SDL_MixChannels_##srcchans##_6, SDL_MixChannels_##srcchans##_7, SDL_MixChannels_##srcchans##_8 }
+static const SDL_AudioFilter channel_mix_filters[6][6] = {
+    CHANNEL_MIX_FUNC_ROW(1), CHANNEL_MIX_FUNC_ROW(2), CHANNEL_MIX_FUNC_ROW(4),
+    CHANNEL_MIX_FUNC_ROW(6), CHANNEL_MIX_FUNC_ROW(7), CHANNEL_MIX_FUNC_ROW(8)
+};
+#undef CHANNEL_MIX_FUNC_ROW
+
+
 /* SDL's resampler uses a "bandlimited interpolation" algorithm:
      https://ccrma.stanford.edu/~jos/resample/ */
 
@@ -723,146 +1357,703 @@ bessel(const double x)
         if (diff < 1.0e-21f) {
             break;
         }
-        i0 += diff;
-        i++;
-        f *= (double) i;
+        i0 += diff;
+        i++;
+        f *= (double) i;
+    }
+
+    return i0;
+}
+
+/* build kaiser table with cardinal sine applied to it, and array of differences between elements. */
+static void
+kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double beta)
+{
+    const int lenm1 = tablelen - 1;
+    const int lenm1div2 = lenm1 / 2;
+    int i;
+
+    table[0] = 1.0f;
+    for (i = 1; i < tablelen; i++) {
+        const double kaiser = bessel(beta * SDL_sqrt(1.0 - SDL_pow(((i - lenm1) / 2.0) / lenm1div2, 2.0))) / bessel(beta);
+        table[tablelen - i] = (float) kaiser;
+    }
+
+    for (i = 1; i < tablelen; i++) {
+        const float x = (((float) i) / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) * ((float) M_PI);
+        table[i] *= SDL_sinf(x) / x;
+        diffs[i - 1] = table[i] - table[i - 1];
+    }
+    diffs[lenm1] = 0.0f;
+}
+
+
+/* Besides the full filter above, SDL_AudioStream can trade quality for speed
+   with a shorter sinc window, 4-point cubic or linear interpolation. */
+#define RESAMPLER_SHORT_ZERO_CROSSINGS 3
+#define RESAMPLER_SHORT_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_SHORT_ZERO_CROSSINGS) + 1)
+#define RESAMPLER_MAX_TAPS (2 * (RESAMPLER_ZERO_CROSSINGS + 1))
+
+/* Every output frame is a dot product of (taps) input frames, centered on
+   the input frame it falls after, against coefficients that only depend on
+   how far past that frame it falls. When the rates reduce to a small
+   fraction, there are only a handful of those "phases", so we precompute the
+   coefficients for each of them once instead of for every output frame. */
+#define RESAMPLER_POLYPHASE_MAX_PHASES 1024
+
+typedef struct SDL_ResamplePhaseTable
+{
+    SDL_AudioResampleQuality quality;
+    int inrate;
+    int outrate;
+    int phases;  /* outrate divided by gcd(inrate, outrate) */
+    int step_frames;  /* whole input frames to advance per output frame... */
+    int step_phase;  /* ...and the phases to advance on top of that. */
+    int taps;  /* coefficients per phase, always even. */
+    float *coeffs;  /* phases * taps, NULL if we compute them as we go. */
+    float *coeffs2;  /* same as coeffs, with each coefficient repeated twice for interleaved stereo. */
+    struct SDL_ResamplePhaseTable *next;
+} SDL_ResamplePhaseTable;
+
+static SDL_SpinLock ResampleFilterSpinlock = 0;
+static float *ResamplerFilter = NULL;
+static float *ResamplerFilterDifference = NULL;
+static float *ResamplerShortFilter = NULL;
+static float *ResamplerShortFilterDifference = NULL;
+static SDL_ResamplePhaseTable *ResamplePhaseTables = NULL;
+
+static int
+BuildResampleFilter(float **filter, float **diffs, const int tablelen, const double dB)
+{
+    /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
+    const double beta = 0.1102 * (dB - 8.7);
+    const size_t alloclen = tablelen * sizeof (float);
+
+    *filter = (float *) SDL_malloc(alloclen);
+    if (!*filter) {
+        return SDL_OutOfMemory();
+    }
+
+    *diffs = (float *) SDL_malloc(alloclen);
+    if (!*diffs) {
+        SDL_free(*filter);
+        *filter = NULL;
+        return SDL_OutOfMemory();
+    }
+    kaiser_and_sinc(*filter, *diffs, tablelen, beta);
+    return 0;
+}
+
+int
+SDL_PrepareResampleFilter(void)
+{
+    int retval = 0;
+
+    SDL_AtomicLock(&ResampleFilterSpinlock);
+    if (!ResamplerFilter) {
+        retval = BuildResampleFilter(&ResamplerFilter, &ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, 80.0);
+    }
+    if ((retval == 0) && !ResamplerShortFilter) {
+        retval = BuildResampleFilter(&ResamplerShortFilter, &ResamplerShortFilterDifference, RESAMPLER_SHORT_FILTER_SIZE, 60.0);
+    }
+    SDL_AtomicUnlock(&ResampleFilterSpinlock);
+    return retval;
+}
+
+void
+SDL_FreeResampleFilter(void)
+{
+    SDL_ResamplePhaseTable *table = ResamplePhaseTables;
+    while (table) {
+        SDL_ResamplePhaseTable *next = table->next;
+        SDL_free(table->coeffs);
+        SDL_free(table->coeffs2);
+        SDL_free(table);
+        table = next;
+    }
+    ResamplePhaseTables = NULL;
+
+    SDL_free(ResamplerFilter);
+    SDL_free(ResamplerFilterDifference);
+    SDL_free(ResamplerShortFilter);
+    SDL_free(ResamplerShortFilterDifference);
+    ResamplerFilter = NULL;
+    ResamplerFilterDifference = NULL;
+    ResamplerShortFilter = NULL;
+    ResamplerShortFilterDifference = NULL;
+}
+
+static int
+ResamplerPadding(const int inrate, const int outrate)
+{
+    if (inrate == outrate) {
+        return 0;
+    } else if (inrate > outrate) {
+        return (int) SDL_ceil(((float) (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * inrate) / ((float) outrate)));
+    }
+    return RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
+}
+
+static int
+ResamplerTaps(const SDL_AudioResampleQuality quality)
+{
+    switch (quality) {
+        case SDL_AUDIO_RESAMPLE_LINEAR: return 2;
+        case SDL_AUDIO_RESAMPLE_CUBIC: return 4;
+        case SDL_AUDIO_RESAMPLE_SINC_SHORT: return 2 * (RESAMPLER_SHORT_ZERO_CROSSINGS + 1);
+        default: break;
+    }
+    return RESAMPLER_MAX_TAPS;
+}
+
+/* Walk a kaiser_and_sinc() table for the output frame (position) of the way
+   from one input frame to the next, interpolating between table entries by
+   how far between them that lands. The left wing lands on input frames
+   (srcindex - half + 1) through srcindex, the right wing on (srcindex + 1)
+   onwards. */
+static void
+SincCoefficients(const float *filter, const float *diffs, const int filterlen,
+                 const int half, const double position, float *coeffs)
+{
+    const double position1 = position * RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
+    const int filterindex1 = (int) position1;
+    const double interpolation1 = position1 - filterindex1;
+    const double position2 = RESAMPLER_SAMPLES_PER_ZERO_CROSSING - position1;
+    const int filterindex2 = (int) position2;
+    const double interpolation2 = position2 - filterindex2;
+    int j;
+
+    for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < filterlen; j++) {
+        const int k = filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        coeffs[half - 1 - j] = (float) (filter[k] + (interpolation1 * diffs[k]));
+    }
+
+    for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < filterlen; j++) {
+        const int k = filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        coeffs[half + j] = (float) (filter[k] + (interpolation2 * diffs[k]));
+    }
+}
+
+/* You need to call SDL_PrepareResampleFilter() before using this. */
+static void
+ResamplerCoefficients(const SDL_AudioResampleQuality quality, const double position, float *coeffs)
+{
+    const int taps = ResamplerTaps(quality);
+
+    SDL_memset(coeffs, '\0', taps * sizeof (float));
+
+    switch (quality) {
+        case SDL_AUDIO_RESAMPLE_LINEAR:
+            coeffs[0] = (float) (1.0 - position);
+            coeffs[1] = (float) position;
+            break;
+
+        case SDL_AUDIO_RESAMPLE_CUBIC: {
+            /* Catmull-Rom spline through the two frames on either side. */
+            const double t = position;
+            const double t2 = t * t;
+            const double t3 = t2 * t;
+            coeffs[0] = (float) (0.5 * (-t3 + (2.0 * t2) - t));
+            coeffs[1] = (float) (0.5 * ((3.0 * t3) - (5.0 * t2) + 2.0));
+            coeffs[2] = (float) (0.5 * ((-3.0 * t3) + (4.0 * t2) + t));
+            coeffs[3] = (float) (0.5 * (t3 - t2));
+            break;
+        }
+
+        case SDL_AUDIO_RESAMPLE_SINC_SHORT:
+            SincCoefficients(ResamplerShortFilter, ResamplerShortFilterDifference, RESAMPLER_SHORT_FILTER_SIZE, taps / 2, position, coeffs);
+            break;
+
+        default:
+            SincCoefficients(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, taps / 2, position, coeffs);
+            break;
+    }
+}
+
+static int
+GreatestCommonDivisor(int a, int b)
+{
+    while (b) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void
+InitResamplePhaseTable(SDL_ResamplePhaseTable *table, const SDL_AudioResampleQuality quality,
+                       const int inrate, const int outrate)
+{
+    const int gcd = GreatestCommonDivisor(inrate, outrate);
+    const int step = inrate / gcd;
+
+    SDL_zerop(table);
+    table->quality = quality;
+    table->inrate = inrate;
+    table->outrate = outrate;
+    table->phases = outrate / gcd;
+    table->step_frames = step / table->phases;
+    table->step_phase = step % table->phases;
+    table->taps = ResamplerTaps(quality);
+}
+
+/* Build the phase table for this rate pair, if it's worth it. This never
+   fails outright; without a table we just compute the coefficients for each
+   output frame as we go. You need to call SDL_PrepareResampleFilter() first. */
+static void
+SDL_PrepareResamplePhaseTable(const SDL_AudioResampleQuality quality, const int inrate, const int outrate)
+{
+    SDL_ResamplePhaseTable *table;
+    int i;
+
+    if ((inrate <= 0) || (outrate <= 0) || (inrate == outrate) ||
+        ((outrate / GreatestCommonDivisor(inrate, outrate)) > RESAMPLER_POLYPHASE_MAX_PHASES)) {
+        return;
+    }
+
+    SDL_AtomicLock(&ResampleFilterSpinlock);
+    for (table = ResamplePhaseTables; table; table = table->next) {
+        if ((table->quality == quality) && (table->inrate == inrate) && (table->outrate == outrate)) {
+            SDL_AtomicUnlock(&ResampleFilterSpinlock);
+            return;  /* already have one. */
+        }
+    }
+
+    table = (SDL_ResamplePhaseTable *) SDL_malloc(sizeof (SDL_ResamplePhaseTable));
+    if (!table) {
+        SDL_AtomicUnlock(&ResampleFilterSpinlock);
+        return;
+    }
+    InitResamplePhaseTable(table, quality, inrate, outrate);
+
+    table->coeffs = (float *) SDL_malloc(table->phases * table->taps * sizeof (float));
+    table->coeffs2 = (float *) SDL_malloc(table->phases * table->taps * 2 * sizeof (float));
+    if (!table->coeffs || !table->coeffs2) {
+        SDL_free(table->coeffs);
+        SDL_free(table->coeffs2);
+        SDL_free(table);
+        SDL_AtomicUnlock(&ResampleFilterSpinlock);
+        return;
+    }
+
+    for (i = 0; i < table->phases; i++) {
+        ResamplerCoefficients(quality, ((double) i) / ((double) table->phases), table->coeffs + (i * table->taps));
+    }
+
+    for (i = 0; i < table->phases * table->taps; i++) {
+        table->coeffs2[(i * 2) + 0] = table->coeffs[i];
+        table->coeffs2[(i * 2) + 1] = table->coeffs[i];
+    }
+
+    table->next = ResamplePhaseTables;
+    ResamplePhaseTables = table;
+    SDL_AtomicUnlock(&ResampleFilterSpinlock);
+}
+
+static const SDL_ResamplePhaseTable *
+SDL_GetResamplePhaseTable(const SDL_AudioResampleQuality quality, const int inrate, const int outrate)
+{
+    const SDL_ResamplePhaseTable *table;
+
+    SDL_AtomicLock(&ResampleFilterSpinlock);
+    for (table = ResamplePhaseTables; table; table = table->next) {
+        if ((table->quality == quality) && (table->inrate == inrate) && (table->outrate == outrate)) {
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&ResampleFilterSpinlock);
+    return table;
+}
+
+/* Polyphase kernels run output frames until they're done or the filter would
+   read past input frame (srclimit + half), and return the number of frames
+   they wrote. (srcindex) and (phase) are updated as they go. */
+typedef int (*SDL_ResamplePolyphaseFunc)(const SDL_ResamplePhaseTable *table, const int chans,
+                                         const float *inbuf, float *dst,
+                                         int *_srcindex, int *_phase,
+                                         const int srclimit, const int outframes);
+
+#define POLYPHASE_NEXT_FRAME() \
+    srcindex += table->step_frames; \
+    phase += table->step_phase; \
+    if (phase >= table->phases) { \
+        phase -= table->phases; \
+        srcindex++; \
+    }
+
+static int
+SDL_ResamplePolyphase_Scalar(const SDL_ResamplePhaseTable *table, const int chans,
+                             const float *inbuf, float *dst,
+                             int *_srcindex, int *_phase,
+                             const int srclimit, const int outframes)
+{
+    const int taps = table->taps;
+    const int half = taps / 2;
+    int srcindex = *_srcindex;
+    int phase = *_phase;
+    int i, j, chan;
+
+    for (i = 0; (i < outframes) && (srcindex <= srclimit); i++) {
+        const float *coeffs = table->coeffs + (phase * taps);
+        const float *src = inbuf + ((srcindex - half + 1) * chans);
+        for (chan = 0; chan < chans; chan++) {
+            float outsample = 0.0f;
+            for (j = 0; j < taps; j++) {
+                outsample += src[(j * chans) + chan] * coeffs[j];
+            }
+            *(dst++) = outsample;
+        }
+        POLYPHASE_NEXT_FRAME();
+    }
+
+    *_srcindex = srcindex;
+    *_phase = phase;
+    return i;
+}
+
+#if HAVE_AVX_INTRINSICS
+/* MSVC will always accept AVX intrinsics when compiling for x64 */
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx")))
+#endif
+static int
+SDL_ResamplePolyphase_AVX(const SDL_ResamplePhaseTable *table, const int chans,
+                          const float *inbuf, float *dst,
+                          int *_srcindex, int *_phase,
+                          const int srclimit, const int outframes)
+{
+    const int taps = table->taps;
+    const int half = taps / 2;
+    const __m256i mask6 = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+    int srcindex = *_srcindex;
+    int phase = *_phase;
+    int i, j;
+
+    SDL_assert((chans == 1) || (chans == 2) || (chans == 6) || (chans == 8));
+
+    for (i = 0; (i < outframes) && (srcindex <= srclimit); i++) {
+        const float *src = inbuf + ((srcindex - half + 1) * chans);
+        __m256 sum = _mm256_setzero_ps();
+
+        if (chans <= 2) {
+            /* mono and stereo are a straight dot product against the
+               (duplicated, for stereo) coefficients. */
+            const int len = taps * chans;
+            const float *coeffs = ((chans == 1) ? table->coeffs : table->coeffs2) + (phase * len);
+            __m128 sum4;
+            for (j = 0; j + 8 <= len; j += 8) {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(coeffs + j), _mm256_loadu_ps(src + j)));
+            }
+            sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+            if (j + 4 <= len) {
+                sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(coeffs + j), _mm_loadu_ps(src + j)));
+                j += 4;
+            }
+            if (j < len) {  /* taps is even, so there's at most a pair left. */
+                const __m128 zero = _mm_setzero_ps();
+                sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadl_pi(zero, (const __m64 *) (coeffs + j)), _mm_loadl_pi(zero, (const __m64 *) (src + j))));
+            }
+            sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+            if (chans == 1) {
+                sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, _MM_SHUFFLE(1, 1, 1, 1)));
+                _mm_store_ss(dst, sum4);
+            } else {
+                _mm_storel_pi((__m64 *) dst, sum4);
+            }
+        } else {
+            /* 5.1 and 7.1 have a whole frame per register. */
+            const float *coeffs = table->coeffs + (phase * taps);
+            if (chans == 8) {
+                for (j = 0; j < taps; j++, src += 8) {
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_broadcast_ss(coeffs + j), _mm256_loadu_ps(src)));
+                }
+                _mm256_storeu_ps(dst, sum);
+            } else {
+                for (j = 0; j < taps; j++, src += 6) {
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_broadcast_ss(coeffs + j), _mm256_maskload_ps(src, mask6)));
+                }
+                _mm256_maskstore_ps(dst, mask6, sum);
+            }
+        }
+
+        dst += chans;
+        POLYPHASE_NEXT_FRAME();
+    }
+
+    *_srcindex = srcindex;
+    *_phase = phase;
+    return i;
+}
+#endif
+
+#if HAVE_SSE_INTRINSICS
+static int
+SDL_ResamplePolyphase_SSE(const SDL_ResamplePhaseTable *table, const int chans,
+                          const float *inbuf, float *dst,
+                          int *_srcindex, int *_phase,
+                          const int srclimit, const int outframes)
+{
+    const int taps = table->taps;
+    const int half = taps / 2;
+    const __m128 zero = _mm_setzero_ps();
+    int srcindex = *_srcindex;
+    int phase = *_phase;
+    int i, j;
+
+    SDL_assert((chans == 1) || (chans == 2) || (chans == 6) || (chans == 8));
+
+    /* Just use unaligned loads, if the memory at runtime is
+       aligned it'll be just as fast on modern processors */
+    for (i = 0; (i < outframes) && (srcindex <= srclimit); i++) {
+        const float *src = inbuf + ((srcindex - half + 1) * chans);
+        __m128 sum0 = zero;
+        __m128 sum1 = zero;
+
+        if (chans <= 2) {
+            /* mono and stereo are a straight dot product against the
+               (duplicated, for stereo) coefficients. */
+            const int len = taps * chans;
+            const float *coeffs = ((chans == 1) ? table->coeffs : table->coeffs2) + (phase * len);
+            for (j = 0; j + 4 <= len; j += 4) {
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(coeffs + j), _mm_loadu_ps(src + j)));
+            }
+            if (j < len) {  /* taps is even, so there's at most a pair left. */
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadl_pi(zero, (const __m64 *) (coeffs + j)), _mm_loadl_pi(zero, (const __m64 *) (src + j))));
+            }
+            sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+            if (chans == 1) {
+                sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, _MM_SHUFFLE(1, 1, 1, 1)));
+                _mm_store_ss(dst, sum0);
+            } else {
+                _mm_storel_pi((__m64 *) dst, sum0);
+            }
+        } else {
+            /* 5.1 and 7.1 split each frame over two registers. */
+            const float *coeffs = table->coeffs + (phase * taps);
+            if (chans == 8) {
+                for (j = 0; j < taps; j++, src += 8) {
+                    const __m128 coeff = _mm_set1_ps(coeffs[j]);
+                    sum0 = _mm_add_ps(sum0, _mm_mul_ps(coeff, _mm_loadu_ps(src)));
+                    sum1 = _mm_add_ps(sum1, _mm_mul_ps(coeff, _mm_loadu_ps(src + 4)));
+                }
+                _mm_storeu_ps(dst, sum0);
+                _mm_storeu_ps(dst + 4, sum1);
+            } else {
+                for (j = 0; j < taps; j++, src += 6) {
+                    const __m128 coeff = _mm_set1_ps(coeffs[j]);
+                    sum0 = _mm_add_ps(sum0, _mm_mul_ps(coeff, _mm_loadu_ps(src)));
+                    sum1 = _mm_add_ps(sum1, _mm_mul_ps(coeff, _mm_loadl_pi(zero, (const __m64 *) (src + 4))));
+                }
+                _mm_storeu_ps(dst, sum0);
+                _mm_storel_pi((__m64 *) (dst + 4), sum1);
+            }
+        }
+
+        dst += chans;
+        POLYPHASE_NEXT_FRAME();
     }
 
-    return i0;
+    *_srcindex = srcindex;
+    *_phase = phase;
+    return i;
 }
+#endif
 
-/* build kaiser table with cardinal sine applied to it, and array of differences between elements. */
-static void
-kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double beta)
+#if HAVE_NEON_INTRINSICS
+static int
+SDL_ResamplePolyphase_NEON(const SDL_ResamplePhaseTable *table, const int chans,
+                           const float *inbuf, float *dst,
+                           int *_srcindex, int *_phase,
+                           const int srclimit, const int outframes)
 {
-    const int lenm1 = tablelen - 1;
-    const int lenm1div2 = lenm1 / 2;
-    int i;
+    const int taps = table->taps;
+    const int half = taps / 2;
+    int srcindex = *_srcindex;
+    int phase = *_phase;
+    int i, j;
+
+    SDL_assert((chans == 1) || (chans == 2) || (chans == 6) || (chans == 8));
+
+    for (i = 0; (i < outframes) && (srcindex <= srclimit); i++) {
+        const float *src = inbuf + ((srcindex - half + 1) * chans);
+
+        if (chans <= 2) {
+            /* mono and stereo are a straight dot product against the
+               (duplicated, for stereo) coefficients. */
+            const int len = taps * chans;
+            const float *coeffs = ((chans == 1) ? table->coeffs : table->coeffs2) + (phase * len);
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            float32x2_t sum2;
+            for (j = 0; j + 4 <= len; j += 4) {
+                sum = vmlaq_f32(sum, vld1q_f32(coeffs + j), vld1q_f32(src + j));
+            }
+            sum2 = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+            if (j < len) {  /* taps is even, so there's at most a pair left. */
+                sum2 = vmla_f32(sum2, vld1_f32(coeffs + j), vld1_f32(src + j));
+            }
+            if (chans == 1) {
+                vst1_lane_f32(dst, vpadd_f32(sum2, sum2), 0);
+            } else {
+                vst1_f32(dst, sum2);
+            }
+        } else {
+            /* 5.1 and 7.1 split each frame over two registers. */
+            const float *coeffs = table->coeffs + (phase * taps);
+            float32x4_t sum0 = vdupq_n_f32(0.0f);
+            if (chans == 8) {
+                float32x4_t sum1 = vdupq_n_f32(0.0f);
+                for (j = 0; j < taps; j++, src += 8) {
+                    sum0 = vmlaq_n_f32(sum0, vld1q_f32(src), coeffs[j]);
+                    sum1 = vmlaq_n_f32(sum1, vld1q_f32(src + 4), coeffs[j]);
+                }
+                vst1q_f32(dst, sum0);
+                vst1q_f32(dst + 4, sum1);
+            } else {
+                float32x2_t sum1 = vdup_n_f32(0.0f);
+                for (j = 0; j < taps; j++, src += 6) {
+                    sum0 = vmlaq_n_f32(sum0, vld1q_f32(src), coeffs[j]);
+                    sum1 = vmla_n_f32(sum1, vld1_f32(src + 4), coeffs[j]);
+                }
+                vst1q_f32(dst, sum0);
+                vst1_f32(dst + 4, sum1);
+            }
+        }
 
-    table[0] = 1.0f;
-    for (i = 1; i < tablelen; i++) {
-        const double kaiser = bessel(beta * SDL_sqrt(1.0 - SDL_pow(((i - lenm1) / 2.0) / lenm1div2, 2.0))) / bessel(beta);
-        table[tablelen - i] = (float) kaiser;
+        dst += chans;
+        POLYPHASE_NEXT_FRAME();
     }
 
-    for (i = 1; i < tablelen; i++) {
-        const float x = (((float) i) / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) * ((float) M_PI);
-        table[i] *= SDL_sinf(x) / x;
-        diffs[i - 1] = table[i] - table[i - 1];
-    }
-    diffs[lenm1] = 0.0f;
+    *_srcindex = srcindex;
+    *_phase = phase;
+    return i;
 }
+#endif
 
-
-static SDL_SpinLock ResampleFilterSpinlock = 0;
-static float *ResamplerFilter = NULL;
-static float *ResamplerFilterDifference = NULL;
-
-int
-SDL_PrepareResampleFilter(void)
+static SDL_ResamplePolyphaseFunc
+ChoosePolyphaseKernel(const int chans)
 {
-    SDL_AtomicLock(&ResampleFilterSpinlock);
-    if (!ResamplerFilter) {
-        /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
-        const double dB = 80.0;
-        const double beta = 0.1102 * (dB - 8.7);
-        const size_t alloclen = RESAMPLER_FILTER_SIZE * sizeof (float);
-
-        ResamplerFilter = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilter) {
-            SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+    if ((chans == 1) || (chans == 2) || (chans == 6) || (chans == 8)) {
+        #if HAVE_AVX_INTRINSICS
+        if (SDL_HasAVX()) {
+            return SDL_ResamplePolyphase_AVX;
         }
-
-        ResamplerFilterDifference = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilterDifference) {
-            SDL_free(ResamplerFilter);
-            ResamplerFilter = NULL;
-            SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+        #endif
+        #if HAVE_SSE_INTRINSICS
+        if (SDL_HasSSE()) {
+            return SDL_ResamplePolyphase_SSE;
+        }
+        #endif
+        #if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_ResamplePolyphase_NEON;
         }
-        kaiser_and_sinc(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, beta);
+        #endif
     }
-    SDL_AtomicUnlock(&ResampleFilterSpinlock);
-    return 0;
-}
-
-void
-SDL_FreeResampleFilter(void)
-{
-    SDL_free(ResamplerFilter);
-    SDL_free(ResamplerFilterDifference);
-    ResamplerFilter = NULL;
-    ResamplerFilterDifference = NULL;
+    return SDL_ResamplePolyphase_Scalar;
 }
 
-static int
-ResamplerPadding(const int inrate, const int outrate)
+/* Output frames whose filter reaches into the padding go through here, so
+   the kernels never have to check their bounds, and so does everything when
+   there's no phase table. */
+static void
+SDL_ResampleFrame(const int taps, const float *coeffs, const int chans,
+                  const float *lpadding, const float *rpadding, const int paddinglen,
+                  const float *inbuf, const int inframes,
+                  const int srcindex, float *dst)
 {
-    if (inrate == outrate) {
-        return 0;
-    } else if (inrate > outrate) {
-        return (int) SDL_ceil(((float) (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * inrate) / ((float) outrate)));
+    const int first = srcindex - (taps / 2) + 1;
+    int j, chan;
+
+    for (chan = 0; chan < chans; chan++) {
+        float outsample = 0.0f;
+        for (j = 0; j < taps; j++) {
+            const int srcframe = first + j;
+            float insample;
+            if (srcframe < 0) {
+                insample = lpadding[((paddinglen + srcframe) * chans) + chan];
+            } else if (srcframe >= inframes) {
+                insample = rpadding[((srcframe - inframes) * chans) + chan];
+            } else {
+                insample = inbuf[(srcframe * chans) + chan];
+            }
+            outsample += insample * coeffs[j];
+        }
+        *(dst++) = outsample;
     }
-    return RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
 }
 
 /* lpadding and rpadding are expected to be buffers of (ResamplePadding(inrate, outrate) * chans * sizeof (float)) bytes. */
 static int
-SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
-                        const float *lpadding, const float *rpadding,
-                        const float *inbuf, const int inbuflen,
-                        float *outbuf, const int outbuflen)
-{
-    const double finrate = (double) inrate;
-    const double outtimeincr = 1.0 / ((float) outrate);
-    const double  ratio = ((float) outrate) / ((float) inrate);
+SDL_ResampleAudio(const SDL_AudioResampleQuality quality,
+                  const int chans, const int inrate, const int outrate,
+                  const float *lpadding, const float *rpadding,
+                  const float *inbuf, const int inbuflen,
+                  float *outbuf, const int outbuflen)
+{
+    const double ratio = ((float) outrate) / ((float) inrate);
     const int paddinglen = ResamplerPadding(inrate, outrate);
     const int framelen = chans * (int)sizeof (float);
     const int inframes = inbuflen / framelen;
     const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
     const int maxoutframes = outbuflen / framelen;
     const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    const SDL_ResamplePhaseTable *table = SDL_GetResamplePhaseTable(quality, inrate, outrate);
+    SDL_ResamplePhaseTable ondemand;
+    float coeffs[RESAMPLER_MAX_TAPS];
     float *dst = outbuf;
-    double outtime = 0.0;
-    int i, j, chan;
-
-    for (i = 0; i < outframes; i++) {
-        const int srcindex = (int) (outtime * inrate);
-        const double intime = ((double) srcindex) / finrate;
-        const double innexttime = ((double) (srcindex + 1)) / finrate;
-        const double interpolation1 = 1.0 - ((innexttime - outtime) / (innexttime - intime));
-        const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
-        const double interpolation2 = 1.0 - interpolation1;
-        const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
-
-        for (chan = 0; chan < chans; chan++) {
-            float outsample = 0.0f;
+    int srcindex = 0;
+    int phase = 0;
+    int half;
+    int i = 0;
+
+    if (!table) {
+        InitResamplePhaseTable(&ondemand, quality, inrate, outrate);
+        table = &ondemand;
+    }
+    half = table->taps / 2;
+
+    SDL_assert(paddinglen >= half);
+
+    if (!table->coeffs) {
+        /* no table for this rate pair, do it the slow way. */
+        for (i = 0; i < outframes; i++) {
+            ResamplerCoefficients(quality, ((double) phase) / ((double) table->phases), coeffs);
+            SDL_ResampleFrame(table->taps, coeffs, chans, lpadding, rpadding, paddinglen, inbuf, inframes, srcindex, dst);
+            POLYPHASE_NEXT_FRAME();
+            dst += chans;
+        }
+        return outframes * chans * sizeof (float);
+    }
 
-            /* do this twice to calculate the sample, once for the "left wing" and then same for the right. */
-            /* !!! FIXME: do both wings in one loop */
-            for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex - j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a pre loop. */
-                const float insample = (srcframe < 0) ? lpadding[((paddinglen + srcframe) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation1 * ResamplerFilterDifference[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
-            }
+    /* the first few frames read the left padding... */
+    while ((i < outframes) && (srcindex < (half - 1))) {
+        SDL_ResampleFrame(table->taps, table->coeffs + (phase * table->taps), chans, lpadding, rpadding, paddinglen, inbuf, inframes, srcindex, dst);
+        POLYPHASE_NEXT_FRAME();
+        dst += chans;
+        i++;
+    }
 
-            for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex + 1 + j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a post loop. */
-                const float insample = (srcframe >= inframes) ? rpadding[((srcframe - inframes) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation2 * ResamplerFilterDifference[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
-            }
-            *(dst++) = outsample;
-        }
+    /* ...then everything that stays inside the input buffer... */
+    if (i < outframes) {
+        const int done = ChoosePolyphaseKernel(chans)(table, chans, inbuf, dst, &srcindex, &phase, inframes - 1 - half, outframes - i);
+        dst += done * chans;
+        i += done;
+    }
 
-        outtime += outtimeincr;
+    /* ...and the last few read the right padding. */
+    while (i < outframes) {
+        SDL_ResampleFrame(table->taps, table->coeffs + (phase * table->taps), chans, lpadding, rpadding, paddinglen, inbuf, inframes, srcindex, dst);
+        POLYPHASE_NEXT_FRAME();
+        dst += chans;
+        i++;
     }
 
     return outframes * chans * sizeof (float);
 }
 
+#undef POLYPHASE_NEXT_FRAME
+
 int
 SDL_ConvertAudio(SDL_AudioCVT * cvt)
 {
@@ -1063,7 +2254,7 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
         return;
     }
 
-    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    cvt->len_cvt = SDL_ResampleAudio(SDL_AUDIO_RESAMPLE_SINC_LONG, chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
 
     SDL_free(padding);
 
@@ -1123,6 +2314,7 @@ SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
     if (SDL_PrepareResampleFilter() < 0) {
         return -1;
     }
+    SDL_PrepareResamplePhaseTable(SDL_AUDIO_RESAMPLE_SINC_LONG, src_rate, dst_rate);
 
     /* Update (cvt) with filter details... */
     if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
@@ -1197,6 +2389,206 @@ SDL_SupportedChannelCount(const int channels)
 }
 
 
+/* Which fused converter replaces a channel converter, depending on whether
+   it is preceded by SDL_Convert_S16_to_F32, followed by
+   SDL_Convert_F32_to_S16, or both. Returns NULL if it has no fused form. */
+static SDL_AudioFilter
+SDL_ChooseFusedCVTFilter(const SDL_AudioFilter mix, const SDL_bool from_s16, const SDL_bool to_s16)
+{
+    #define CHOOSE_FUSED_CVT(name) \
+        return (from_s16 && to_s16) ? SDL_ConvertFused_S16_##name##_S16 : \
+               from_s16 ? SDL_ConvertFused_S16_##name##_F32 : SDL_ConvertFused_F32_##name##_S16
+
+    if (mix == SDL_ConvertMonoToStereo) {
+        CHOOSE_FUSED_CVT(MonoToStereo);
+    }
+    if (mix == SDL_ConvertStereoTo51) {
+        CHOOSE_FUSED_CVT(StereoTo51);
+    }
+    if (mix == SDL_ConvertStereoToMono
+        #if HAVE_SSE3_INTRINSICS
+        || mix == SDL_ConvertStereoToMono_SSE3
+        #endif
+        ) {
+        CHOOSE_FUSED_CVT(StereoToMono);
+    }
+    if (mix == SDL_Convert51ToStereo
+        #if HAVE_AVX_INTRINSICS
+        || mix == SDL_Convert51ToStereo_AVX
+        #endif
+        #if HAVE_SSE_INTRINSICS
+        || mix == SDL_Convert51ToStereo_SSE
+        #endif
+        #if HAVE_NEON_INTRINSICS
+        || mix == SDL_Convert51ToStereo_NEON
+        #endif
+        ) {
+        CHOOSE_FUSED_CVT(51ToStereo);
+    }
+
+    #undef CHOOSE_FUSED_CVT
+    return NULL;
+}
+
+/* Replace S16 -> float -> channel mix [-> S16] runs in the filter list with
+   a single fused converter. The resampler's rates in the last two slots are
+   left alone. */
+static void
+SDL_FuseAudioCVTFilters(SDL_AudioCVT *cvt)
+{
+    const int count = cvt->filter_index;
+    int src = 0;
+    int dst = 0;
+
+    while (src < count) {
+        const SDL_bool from_s16 = (cvt->filters[src] == SDL_Convert_S16_to_F32) ? SDL_TRUE : SDL_FALSE;
+        const int mix = from_s16 ? (src + 1) : src;
+        const SDL_bool to_s16 = ((mix + 1) < count && cvt->filters[mix + 1] == SDL_Convert_F32_to_S16) ? SDL_TRUE : SDL_FALSE;
+        SDL_AudioFilter fused = NULL;
+
+        if (mix < count && (from_s16 || to_s16)) {
+            fused = SDL_ChooseFusedCVTFilter(cvt->filters[mix], from_s16, to_s16);
+        }
+
+        if (fused) {
+            cvt->filters[dst++] = fused;
+            src = mix + (to_s16 ? 2 : 1);
+        } else {
+            cvt->filters[dst++] = cvt->filters[src++];
+        }
+    }
+
+    cvt->filter_index = dst;
+    while (dst < count) {
+        cvt->filters[dst++] = NULL;
+    }
+}
+
+/* Which matrix a channel converter applies, or NULL if it isn't one. The
+   SIMD variants map to the scalar converter they stand in for. */
+static const SDL_ChannelMixStep *
+SDL_GetChannelMixStep(SDL_AudioFilter filter)
+{
+    int i;
+
+    #if HAVE_SSE3_INTRINSICS
+    if (filter == SDL_ConvertStereoToMono_SSE3) {
+        filter = SDL_ConvertStereoToMono;
+    }
+    #endif
+    #if HAVE_AVX_INTRINSICS
+    if (filter == SDL_Convert51ToStereo_AVX) {
+        filter = SDL_Convert51ToStereo;
+    }
+    #endif
+    #if HAVE_SSE_INTRINSICS
+    if (filter == SDL_Convert51ToStereo_SSE) {
+        filter = SDL_Convert51ToStereo;
+    }
+    #endif
+    #if HAVE_NEON_INTRINSICS
+    if (filter == SDL_Convert51ToStereo_NEON) {
+        filter = SDL_Convert51ToStereo;
+    }
+    #endif
+
+    for (i = 0; i < SDL_arraysize(channel_mix_steps); i++) {
+        if (channel_mix_steps[i].filter == filter) {
+            return &channel_mix_steps[i];
+        }
+    }
+    return NULL;
+}
+
+/* Multiply out the matrices of the channel converters in filters[first]
+   through filters[last - 1] into the mix for that pair of channel counts,
+   unless an earlier call already did. */
+static void
+SDL_BuildChannelMix(const SDL_AudioCVT *cvt, const int first, const int last, const int srcchans, const int dstchans)
+{
+    SDL_ChannelMix *mix = &channel_mixes[SDL_ChannelMixIndex(srcchans)][SDL_ChannelMixIndex(dstchans)];
+
+    SDL_AtomicLock(&channel_mix_lock);
+    if (!mix->ready) {
+        float matrix[CHANNEL_MIX_MAX_CHANNELS][CHANNEL_MIX_MAX_CHANNELS];
+        float product[CHANNEL_MIX_MAX_CHANNELS][CHANNEL_MIX_MAX_CHANNELS];
+        int i, s, d, m;
+
+        SDL_zeroa(matrix);
+        for (s = 0; s < srcchans; s++) {
+            matrix[s][s] = 1.0f;
+        }
+
+        for (i = first; i < last; i++) {
+            const SDL_ChannelMixStep *step = SDL_GetChannelMixStep(cvt->filters[i]);
+            for (d = 0; d < step->dst_channels; d++) {
+                for (s = 0; s < srcchans; s++) {
+                    float sum = 0.0f;
+                    for (m = 0; m < step->src_channels; m++) {
+                        sum += step->matrix[d][m] * matrix[m][s];
+                    }
+                    product[d][s] = sum;
+                }
+            }
+            SDL_memcpy(matrix, product, sizeof (matrix));
+        }
+
+        SDL_zeroa(mix->columns);
+        for (s = 0; s < srcchans; s++) {
+            for (d = 0; d < dstchans; d++) {
+                mix->columns[s][d] = matrix[d][s];
+            }
+        }
+        mix->ready = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&channel_mix_lock);
+}
+
+/* Replace runs of upmixing channel converters in the filter list with a
+   single matrix mix. The mixer reads few input channels there and writes
+   each output frame with one or two stores, so it beats two or three passes
+   of the scalar converters; a single converter, or a downmix from many
+   channels, is cheaper as it is. Without SSE or NEON the list is left
+   alone. */
+static void
+SDL_CollapseChannelCVTFilters(SDL_AudioCVT *cvt)
+{
+    const int count = cvt->filter_index;
+    int src = 0;
+    int dst = 0;
+
+    if (!SDL_ChannelMixHasSIMD()) {
+        return;
+    }
+
+    while (src < count) {
+        const SDL_ChannelMixStep *step = SDL_GetChannelMixStep(cvt->filters[src]);
+        int end = src + 1;
+
+        if (step) {
+            while (end < count && SDL_GetChannelMixStep(cvt->filters[end])) {
+                end++;
+            }
+        }
+
+        if (step && (end - src) > 1 && SDL_GetChannelMixStep(cvt->filters[end - 1])->dst_channels > step->src_channels) {
+            const int srcchans = step->src_channels;
+            const int dstchans = SDL_GetChannelMixStep(cvt->filters[end - 1])->dst_channels;
+            SDL_BuildChannelMix(cvt, src, end, srcchans, dstchans);
+            cvt->filters[dst++] = channel_mix_filters[SDL_ChannelMixIndex(srcchans)][SDL_ChannelMixIndex(dstchans)];
+            src = end;
+        } else {
+            cvt->filters[dst++] = cvt->filters[src++];
+        }
+    }
+
+    cvt->filter_index = dst;
+    while (dst < count) {
+        cvt->filters[dst++] = NULL;
+    }
+}
+
+
 /* Creates a set of audio filters to convert from one format to another.
    Returns 0 if no conversion is needed, 1 if the audio filter is set up,
    or -1 if an error like invalid parameter, unsupported format, etc. occurred.
@@ -1469,6 +2861,13 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
         return -1;              /* shouldn't happen, but just in case... */
     }
 
+    /* Mix runs of channel conversions in one pass, then fold the type
+       conversions into whatever common channel conversions are left. This
+       order matters: a fused filter no longer looks like a channel
+       converter to the collapse pass. */
+    SDL_CollapseChannelCVTFilters(cvt);
+    SDL_FuseAudioCVTFilters(cvt);
+
     cvt->needed = (cvt->filter_index != 0);
     return (cvt->needed);
 }
@@ -1502,6 +2901,7 @@ struct _SDL_AudioStream
     int resampler_padding_samples;
     float *resampler_padding;
     void *resampler_state;
+    SDL_AudioResampleQuality resample_quality;
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
     SDL_CleanupAudioStreamResamplerFunc cleanup_resampler_func;
@@ -1631,7 +3031,7 @@ SDL_ResampleAudioStream(SDL_AudioStream *stream, const void *_inbuf, const int i
 
     SDL_assert(inbuf != ((const float *) outbuf));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
 
-    retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    retval = SDL_ResampleAudio(stream->resample_quality, chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
 
     /* update our left padding with end of current input, for next run. */
     SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
@@ -1652,6 +3052,65 @@ SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
     SDL_free(stream->resampler_state);
 }
 
+static SDL_AudioResampleQuality
+GetDefaultResampleQuality(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_RESAMPLING_MODE);
+
+    if (hint) {
+        if (SDL_strcasecmp(hint, "linear") == 0) {
+            return SDL_AUDIO_RESAMPLE_LINEAR;
+        } else if (SDL_strcasecmp(hint, "cubic") == 0) {
+            return SDL_AUDIO_RESAMPLE_CUBIC;
+        } else if (SDL_strcasecmp(hint, "sinc_short") == 0) {
+            return SDL_AUDIO_RESAMPLE_SINC_SHORT;
+        }
+    }
+    return SDL_AUDIO_RESAMPLE_SINC_LONG;
+}
+
+/* the internal resampler's history buffer for this stream. */
+static float *
+AllocateResamplerPadding(SDL_AudioStream *stream)
+{
+    float *padding = (float *) SDL_calloc(stream->resampler_padding_samples, sizeof (float));
+    if (!padding) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    if (SDL_PrepareResampleFilter() < 0) {
+        SDL_free(padding);
+        return NULL;
+    }
+
+    return padding;
+}
+
+/* (padding) is the stream's history buffer for the internal resampler,
+   from AllocateResamplerPadding(), this takes ownership of it. */
+static void
+SetupAudioStreamResampler(SDL_AudioStream *stream, SDL_AudioResampleQuality quality, float *padding)
+{
+    if (quality == SDL_AUDIO_RESAMPLE_DEFAULT) {
+#ifdef HAVE_LIBSAMPLERATE_H
+        if (SetupLibSampleRateResampling(stream)) {
+            SDL_free(padding);
+            return;
+        }
+#endif
+        quality = GetDefaultResampleQuality();
+    }
+
+    SDL_PrepareResamplePhaseTable(quality, stream->src_rate, stream->dst_rate);
+
+    stream->resample_quality = quality;
+    stream->resampler_state = padding;
+    stream->resampler_func = SDL_ResampleAudioStream;
+    stream->reset_resampler_func = SDL_ResetAudioStreamResampler;
+    stream->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
+}
+
 SDL_AudioStream *
 SDL_NewAudioStream(const SDL_AudioFormat src_format,
                    const Uint8 src_channels,
@@ -1663,6 +3122,7 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     const int packetlen = 4096;  /* !!! FIXME: good enough for now. */
     Uint8 pre_resample_channels;
     SDL_AudioStream *retval;
+    float *padding;
 
     retval = (SDL_AudioStream *) SDL_calloc(1, sizeof (SDL_AudioStream));
     if (!retval) {
@@ -1721,29 +3181,12 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
             return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
         }
 
-#ifdef HAVE_LIBSAMPLERATE_H
-        SetupLibSampleRateResampling(retval);
-#endif
-
-        if (!retval->resampler_func) {
-            retval->resampler_state = SDL_calloc(retval->resampler_padding_samples, sizeof (float));
-            if (!retval->resampler_state) {
-                SDL_FreeAudioStream(retval);
-                SDL_OutOfMemory();
-                return NULL;
-            }
-
-            if (SDL_PrepareResampleFilter() < 0) {
-                SDL_free(retval->resampler_state);
-                retval->resampler_state = NULL;
-                SDL_FreeAudioStream(retval);
-                return NULL;
-            }
-
-            retval->resampler_func = SDL_ResampleAudioStream;
-            retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
-            retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
+        padding = AllocateResamplerPadding(retval);
+        if (!padding) {
+            SDL_FreeAudioStream(retval);
+            return NULL;
         }
+        SetupAudioStreamResampler(retval, SDL_AUDIO_RESAMPLE_DEFAULT, padding);
 
         /* Convert us to the final format after resampling. */
         if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, AUDIO_F32SYS, pre_resample_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
@@ -1890,6 +3333,83 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
     return buflen ? SDL_WriteToDataQueue(stream->queue, resamplebuf, buflen) : 0;
 }
 
+/* Streams that don't resample have no staging buffer or resampler padding, so
+   there's no reason to go through the work buffer: copy each chunk straight
+   into space reserved at the end of the queue and convert it in place there. */
+static int
+SDL_AudioStreamPutDirect(SDL_AudioStream *stream, const void *buf, int len)
+{
+    SDL_AudioCVT *cvt = &stream->cvt_after_resampling;
+    const Uint8 *src = (const Uint8 *) buf;
+    const int framesize = stream->src_sample_frame_size;
+    int granularity;
+    int maxchunk;
+
+    SDL_assert(!stream->cvt_before_resampling.needed);
+
+    if (!cvt->needed) {
+        #if DEBUG_AUDIOSTREAM
+        printf("AUDIOSTREAM: no conversion needed at all, queueing %d bytes.\n", len);
+        #endif
+        return SDL_WriteToDataQueue(stream->queue, buf, len);
+    }
+
+    /* the conversion needs len_mult times the input to work in, and a
+       reservation can't be larger than a packet. Work in blocks of 16 frames
+       when possible so every chunk (and its output) stays 16-byte aligned
+       and the SIMD converters don't drop to their scalar loops. */
+    maxchunk = stream->packetlen / cvt->len_mult;
+    granularity = (maxchunk >= (framesize * 16)) ? (framesize * 16) : framesize;
+    maxchunk -= maxchunk % granularity;
+    if (maxchunk <= 0) {
+        return SDL_AudioStreamPutInternal(stream, buf, len, NULL);
+    }
+
+    while (len > 0) {
+        int chunk = SDL_min(len, maxchunk);
+        int reserved;
+        Uint8 *dst;
+
+        /* top off the current tail packet if a reasonable chunk fits there,
+           so shrinking conversions don't leave every packet partially empty. */
+        {
+            int tailchunk = ((int) SDL_GetDataQueueTailSpace(stream->queue)) / cvt->len_mult;
+            tailchunk -= tailchunk % granularity;
+            if ((tailchunk < chunk) && (tailchunk >= (maxchunk / 4)) && (tailchunk > 0)) {
+                chunk = tailchunk;
+            }
+        }
+
+        reserved = chunk * cvt->len_mult;
+        dst = (Uint8 *) SDL_ReserveSpaceInDataQueue(stream->queue, reserved);
+        if (!dst) {
+            return -1;
+        }
+
+        SDL_memcpy(dst, src, chunk);
+        cvt->buf = dst;
+        cvt->len = chunk;
+        if (SDL_ConvertAudio(cvt) == -1) {
+            SDL_UnreserveSpaceInDataQueue(stream->queue, reserved);
+            return -1;   /* uhoh! */
+        }
+
+        SDL_assert(cvt->len_cvt <= reserved);
+        if (cvt->len_cvt < reserved) {
+            SDL_UnreserveSpaceInDataQueue(stream->queue, reserved - cvt->len_cvt);
+        }
+
+        #if DEBUG_AUDIOSTREAM
+        printf("AUDIOSTREAM: converted %d bytes directly into %d queued bytes\n", chunk, cvt->len_cvt);
+        #endif
+
+        src += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
 int
 SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
 {
@@ -1915,13 +3435,8 @@ SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
         return SDL_SetError("Can't add partial sample frames");
     }
 
-    if (!stream->cvt_before_resampling.needed &&
-        (stream->dst_rate == stream->src_rate) &&
-        !stream->cvt_after_resampling.needed) {
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: no conversion needed at all, queueing %d bytes.\n", len);
-        #endif
-        return SDL_WriteToDataQueue(stream->queue, buf, len);
+    if (stream->dst_rate == stream->src_rate) {
+        return SDL_AudioStreamPutDirect(stream, buf, len);
     }
 
     while (len > 0) {
@@ -2035,6 +3550,37 @@ SDL_AudioStreamAvailable(SDL_AudioStream *stream)
     return stream ? (int) SDL_CountDataQueue(stream->queue) : 0;
 }
 
+int
+SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream, SDL_AudioResampleQuality quality)
+{
+    float *padding;
+
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if ((quality < SDL_AUDIO_RESAMPLE_DEFAULT) || (quality > SDL_AUDIO_RESAMPLE_SINC_LONG)) {
+        return SDL_InvalidParamError("quality");
+    } else if (stream->src_rate == stream->dst_rate) {
+        return 0;  /* not resampling, nothing to change. */
+    }
+
+    /* get everything that can fail out of the way before we touch the current resampler. */
+    padding = AllocateResamplerPadding(stream);
+    if (!padding) {
+        return -1;
+    }
+
+    if (stream->cleanup_resampler_func) {
+        stream->cleanup_resampler_func(stream);
+    }
+    stream->resampler_state = NULL;
+    stream->resampler_func = NULL;
+    stream->reset_resampler_func = NULL;
+    stream->cleanup_resampler_func = NULL;
+
+    SetupAudioStreamResampler(stream, quality, padding);
+    return 0;
+}
+
 void
 SDL_AudioStreamClear(SDL_AudioStream *stream)
 {
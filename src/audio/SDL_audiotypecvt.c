@@ -32,6 +32,28 @@
 #define HAVE_SSE2_INTRINSICS 1
 #endif
 
+#if defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX2_INTRINSICS 1
+#define HAVE_AVX512F_INTRINSICS 1
+#endif
+#if defined __clang__
+# if (!__has_attribute(target))
+#   undef HAVE_AVX2_INTRINSICS
+#   undef HAVE_AVX512F_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX2__)
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX512F__)
+#   undef HAVE_AVX512F_INTRINSICS
+# endif
+#elif defined __GNUC__
+# if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#   undef HAVE_AVX2_INTRINSICS
+#   undef HAVE_AVX512F_INTRINSICS
+# endif
+#endif
+
 #if defined(__x86_64__) && HAVE_SSE2_INTRINSICS
 #define NEED_SCALAR_CONVERTER_FALLBACKS 0  /* x86_64 guarantees SSE2. */
 #elif __MACOSX__ && HAVE_SSE2_INTRINSICS
@@ -850,6 +872,733 @@ SDL_Convert_F32_to_S32_SSE2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 #endif
 
 
+/* The AVX2 and AVX-512 converters clamp and round to nearest like the SSE2
+   ones (and the fused S16 store in SDL_audiocvt.c), so they all give the
+   same samples, and finish off the leftovers with the same truncating scalar
+   code. They use unaligned loads and stores throughout. Growing conversions
+   work back to front and load a whole block before storing any of it, since
+   the output overlaps the input. */
+#if HAVE_AVX2_INTRINSICS || HAVE_AVX512F_INTRINSICS
+static SDL_INLINE Sint8
+SDL_Convert_F32_to_S8_Sample(const float sample)
+{
+    return (sample >= 1.0f) ? 127 : (sample <= -1.0f) ? -128 : (Sint8) (sample * 127.0f);
+}
+
+static SDL_INLINE Uint8
+SDL_Convert_F32_to_U8_Sample(const float sample)
+{
+    return (sample >= 1.0f) ? 255 : (sample <= -1.0f) ? 0 : (Uint8) ((sample + 1.0f) * 127.0f);
+}
+
+static SDL_INLINE Sint16
+SDL_Convert_F32_to_S16_Sample(const float sample)
+{
+    return (sample >= 1.0f) ? 32767 : (sample <= -1.0f) ? -32768 : (Sint16) (sample * 32767.0f);
+}
+
+static SDL_INLINE Uint16
+SDL_Convert_F32_to_U16_Sample(const float sample)
+{
+    return (sample >= 1.0f) ? 65535 : (sample <= -1.0f) ? 0 : (Uint16) ((sample + 1.0f) * 32767.0f);
+}
+
+static SDL_INLINE Sint32
+SDL_Convert_F32_to_S32_Sample(const float sample)
+{
+    return (sample >= 1.0f) ? 2147483647 : (sample <= -1.0f) ? (Sint32) -2147483648LL : (((Sint32) (sample * 8388607.0f)) << 8);
+}
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+/* round((clamp(x, -1, 1) + offset) * scale) << shift, like the SSE2 converters. */
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static SDL_INLINE __m256i
+SDL_ConvertClamped_AVX2(const __m256 x, const __m256 offset, const __m256 scale, const int shift)
+{
+    const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    return _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(clamped, offset), scale)), shift);
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_S8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = (const Sint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using AVX2)");
+
+    while (i >= 32) {   /* 32 * 8-bit */
+        const __m256i ints1 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 32]));
+        const __m256i ints2 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 24]));
+        const __m256i ints3 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 16]));
+        const __m256i ints4 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 8]));
+        _mm256_storeu_ps(&dst[i - 8], _mm256_mul_ps(_mm256_cvtepi32_ps(ints4), divby128));
+        _mm256_storeu_ps(&dst[i - 16], _mm256_mul_ps(_mm256_cvtepi32_ps(ints3), divby128));
+        _mm256_storeu_ps(&dst[i - 24], _mm256_mul_ps(_mm256_cvtepi32_ps(ints2), divby128));
+        _mm256_storeu_ps(&dst[i - 32], _mm256_mul_ps(_mm256_cvtepi32_ps(ints1), divby128));
+        i -= 32;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = ((float) src[i]) * DIVBY128;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_U8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = (const Uint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+    const __m256 minus1 = _mm256_set1_ps(-1.0f);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using AVX2)");
+
+    while (i >= 32) {   /* 32 * 8-bit */
+        const __m256i ints1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 32]));
+        const __m256i ints2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 24]));
+        const __m256i ints3 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 16]));
+        const __m256i ints4 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) &src[i - 8]));
+        _mm256_storeu_ps(&dst[i - 8], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints4), divby128), minus1));
+        _mm256_storeu_ps(&dst[i - 16], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints3), divby128), minus1));
+        _mm256_storeu_ps(&dst[i - 24], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints2), divby128), minus1));
+        _mm256_storeu_ps(&dst[i - 32], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints1), divby128), minus1));
+        i -= 32;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = (((float) src[i]) * DIVBY128) - 1.0f;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_S16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+    int i = cvt->len_cvt / sizeof (Sint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using AVX2)");
+
+    while (i >= 16) {   /* 16 * 16-bit */
+        const __m256i ints1 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) &src[i - 16]));
+        const __m256i ints2 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) &src[i - 8]));
+        _mm256_storeu_ps(&dst[i - 8], _mm256_mul_ps(_mm256_cvtepi32_ps(ints2), divby32768));
+        _mm256_storeu_ps(&dst[i - 16], _mm256_mul_ps(_mm256_cvtepi32_ps(ints1), divby32768));
+        i -= 16;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = ((float) src[i]) * DIVBY32768;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_U16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+    const __m256 minus1 = _mm256_set1_ps(-1.0f);
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using AVX2)");
+
+    while (i >= 16) {   /* 16 * 16-bit */
+        const __m256i ints1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &src[i - 16]));
+        const __m256i ints2 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &src[i - 8]));
+        _mm256_storeu_ps(&dst[i - 8], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints2), divby32768), minus1));
+        _mm256_storeu_ps(&dst[i - 16], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ints1), divby32768), minus1));
+        i -= 16;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = (((float) src[i]) * DIVBY32768) - 1.0f;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_S32_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m256 divby8388607 = _mm256_set1_ps(DIVBY8388607);
+    const int count = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using AVX2)");
+
+    for (i = 0; i + 16 <= count; i += 16) {   /* 16 * sint32 */
+        /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+        const __m256i ints1 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *) &src[i]), 8);
+        const __m256i ints2 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *) &src[i + 8]), 8);
+        _mm256_storeu_ps(&dst[i], _mm256_mul_ps(_mm256_cvtepi32_ps(ints1), divby8388607));
+        _mm256_storeu_ps(&dst[i + 8], _mm256_mul_ps(_mm256_cvtepi32_ps(ints2), divby8388607));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = ((float) (src[i] >> 8)) * DIVBY8388607;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
+    /* packing works within 128-bit lanes, this puts the dwords back in order. */
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using AVX2)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m256i ints1 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i]), zero, mulby127, 0);
+        const __m256i ints2 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 8]), zero, mulby127, 0);
+        const __m256i ints3 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 16]), zero, mulby127, 0);
+        const __m256i ints4 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 24]), zero, mulby127, 0);
+        const __m256i bytes = _mm256_packs_epi16(_mm256_packs_epi32(ints1, ints2), _mm256_packs_epi32(ints3, ints4));
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_permutevar8x32_epi32(bytes, order));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S8_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_U8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using AVX2)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m256i ints1 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i]), one, mulby127, 0);
+        const __m256i ints2 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 8]), one, mulby127, 0);
+        const __m256i ints3 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 16]), one, mulby127, 0);
+        const __m256i ints4 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 24]), one, mulby127, 0);
+        const __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(ints1, ints2), _mm256_packs_epi32(ints3, ints4));
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_permutevar8x32_epi32(bytes, order));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_U8_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 mulby32767 = _mm256_set1_ps(32767.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using AVX2)");
+
+    for (i = 0; i + 16 <= count; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i]), zero, mulby32767, 0);
+        const __m256i ints2 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 8]), zero, mulby32767, 0);
+        /* packing works within 128-bit lanes, this puts the qwords back in order. */
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_permute4x64_epi64(_mm256_packs_epi32(ints1, ints2), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S16_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_U16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 mulby32767 = _mm256_set1_ps(32767.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using AVX2)");
+
+    for (i = 0; i + 16 <= count; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i]), one, mulby32767, 0);
+        const __m256i ints2 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 8]), one, mulby32767, 0);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_permute4x64_epi64(_mm256_packus_epi32(ints1, ints2), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_U16_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 mulby8388607 = _mm256_set1_ps(8388607.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using AVX2)");
+
+    for (i = 0; i + 16 <= count; i += 16) {   /* 16 * float32 */
+        const __m256i ints1 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i]), zero, mulby8388607, 8);
+        const __m256i ints2 = SDL_ConvertClamped_AVX2(_mm256_loadu_ps(&src[i + 8]), zero, mulby8388607, 8);
+        _mm256_storeu_si256((__m256i *) &dst[i], ints1);
+        _mm256_storeu_si256((__m256i *) &dst[i + 8], ints2);
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S32_Sample(src[i]);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
+    }
+}
+#endif
+
+#if HAVE_AVX512F_INTRINSICS
+/* round((clamp(x, -1, 1) + offset) * scale) << shift, like the SSE2 converters. */
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static SDL_INLINE __m512i
+SDL_ConvertClamped_AVX512F(const __m512 x, const __m512 offset, const __m512 scale, const int shift)
+{
+    const __m512 clamped = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-1.0f)), _mm512_set1_ps(1.0f));
+    return _mm512_slli_epi32(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_add_ps(clamped, offset), scale)), shift);
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_S8_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = (const Sint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby128 = _mm512_set1_ps(DIVBY128);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using AVX-512)");
+
+    while (i >= 64) {   /* 64 * 8-bit */
+        const __m512i ints1 = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 64]));
+        const __m512i ints2 = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 48]));
+        const __m512i ints3 = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 32]));
+        const __m512i ints4 = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 16]));
+        _mm512_storeu_ps(&dst[i - 16], _mm512_mul_ps(_mm512_cvtepi32_ps(ints4), divby128));
+        _mm512_storeu_ps(&dst[i - 32], _mm512_mul_ps(_mm512_cvtepi32_ps(ints3), divby128));
+        _mm512_storeu_ps(&dst[i - 48], _mm512_mul_ps(_mm512_cvtepi32_ps(ints2), divby128));
+        _mm512_storeu_ps(&dst[i - 64], _mm512_mul_ps(_mm512_cvtepi32_ps(ints1), divby128));
+        i -= 64;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = ((float) src[i]) * DIVBY128;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_U8_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = (const Uint8 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby128 = _mm512_set1_ps(DIVBY128);
+    const __m512 minus1 = _mm512_set1_ps(-1.0f);
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using AVX-512)");
+
+    while (i >= 64) {   /* 64 * 8-bit */
+        const __m512i ints1 = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 64]));
+        const __m512i ints2 = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 48]));
+        const __m512i ints3 = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 32]));
+        const __m512i ints4 = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *) &src[i - 16]));
+        _mm512_storeu_ps(&dst[i - 16], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints4), divby128), minus1));
+        _mm512_storeu_ps(&dst[i - 32], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints3), divby128), minus1));
+        _mm512_storeu_ps(&dst[i - 48], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints2), divby128), minus1));
+        _mm512_storeu_ps(&dst[i - 64], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints1), divby128), minus1));
+        i -= 64;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = (((float) src[i]) * DIVBY128) - 1.0f;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_S16_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby32768 = _mm512_set1_ps(DIVBY32768);
+    int i = cvt->len_cvt / sizeof (Sint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using AVX-512)");
+
+    while (i >= 32) {   /* 32 * 16-bit */
+        const __m512i ints1 = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *) &src[i - 32]));
+        const __m512i ints2 = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *) &src[i - 16]));
+        _mm512_storeu_ps(&dst[i - 16], _mm512_mul_ps(_mm512_cvtepi32_ps(ints2), divby32768));
+        _mm512_storeu_ps(&dst[i - 32], _mm512_mul_ps(_mm512_cvtepi32_ps(ints1), divby32768));
+        i -= 32;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = ((float) src[i]) * DIVBY32768;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_U16_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby32768 = _mm512_set1_ps(DIVBY32768);
+    const __m512 minus1 = _mm512_set1_ps(-1.0f);
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using AVX-512)");
+
+    while (i >= 32) {   /* 32 * 16-bit */
+        const __m512i ints1 = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) &src[i - 32]));
+        const __m512i ints2 = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) &src[i - 16]));
+        _mm512_storeu_ps(&dst[i - 16], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints2), divby32768), minus1));
+        _mm512_storeu_ps(&dst[i - 32], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(ints1), divby32768), minus1));
+        i -= 32;
+    }
+
+    while (i) {
+        i--;
+        dst[i] = (((float) src[i]) * DIVBY32768) - 1.0f;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_S32_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby8388607 = _mm512_set1_ps(DIVBY8388607);
+    const int count = cvt->len_cvt / sizeof (Sint32);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * sint32 */
+        /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+        const __m512i ints1 = _mm512_srai_epi32(_mm512_loadu_si512((const void *) &src[i]), 8);
+        const __m512i ints2 = _mm512_srai_epi32(_mm512_loadu_si512((const void *) &src[i + 16]), 8);
+        _mm512_storeu_ps(&dst[i], _mm512_mul_ps(_mm512_cvtepi32_ps(ints1), divby8388607));
+        _mm512_storeu_ps(&dst[i + 16], _mm512_mul_ps(_mm512_cvtepi32_ps(ints2), divby8388607));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = ((float) (src[i] >> 8)) * DIVBY8388607;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S8_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 mulby127 = _mm512_set1_ps(127.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m512i ints1 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i]), zero, mulby127, 0);
+        const __m512i ints2 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i + 16]), zero, mulby127, 0);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm512_cvtepi32_epi8(ints1));
+        _mm_storeu_si128((__m128i *) &dst[i + 16], _mm512_cvtepi32_epi8(ints2));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S8_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_U8_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 mulby127 = _mm512_set1_ps(127.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m512i ints1 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i]), one, mulby127, 0);
+        const __m512i ints2 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i + 16]), one, mulby127, 0);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm512_cvtepi32_epi8(ints1));
+        _mm_storeu_si128((__m128i *) &dst[i + 16], _mm512_cvtepi32_epi8(ints2));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_U8_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S16_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 mulby32767 = _mm512_set1_ps(32767.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m512i ints1 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i]), zero, mulby32767, 0);
+        const __m512i ints2 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i + 16]), zero, mulby32767, 0);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm512_cvtepi32_epi16(ints1));
+        _mm256_storeu_si256((__m256i *) &dst[i + 16], _mm512_cvtepi32_epi16(ints2));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S16_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_U16_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 mulby32767 = _mm512_set1_ps(32767.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m512i ints1 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i]), one, mulby32767, 0);
+        const __m512i ints2 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i + 16]), one, mulby32767, 0);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm512_cvtepi32_epi16(ints1));
+        _mm256_storeu_si256((__m256i *) &dst[i + 16], _mm512_cvtepi32_epi16(ints2));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_U16_Sample(src[i]);
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS);
+    }
+}
+
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx512f")))
+#endif
+static void SDLCALL
+SDL_Convert_F32_to_S32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 mulby8388607 = _mm512_set1_ps(8388607.0f);
+    const int count = cvt->len_cvt / sizeof (float);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using AVX-512)");
+
+    for (i = 0; i + 32 <= count; i += 32) {   /* 32 * float32 */
+        const __m512i ints1 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i]), zero, mulby8388607, 8);
+        const __m512i ints2 = SDL_ConvertClamped_AVX512F(_mm512_loadu_ps(&src[i + 16]), zero, mulby8388607, 8);
+        _mm512_storeu_si512((void *) &dst[i], ints1);
+        _mm512_storeu_si512((void *) &dst[i + 16], ints2);
+    }
+
+    for (; i < count; i++) {
+        dst[i] = SDL_Convert_F32_to_S32_Sample(src[i]);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
+    }
+}
+#endif
+
+
 #if HAVE_NEON_INTRINSICS
 static void SDLCALL
 SDL_Convert_S8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
@@ -1403,6 +2152,20 @@ void SDL_ChooseAudioConverters(void)
         SDL_Convert_F32_to_S32 = SDL_Convert_F32_to_S32_##fntype; \
         converters_chosen = SDL_TRUE
 
+#if HAVE_AVX512F_INTRINSICS
+    if (SDL_HasAVX512F()) {
+        SET_CONVERTER_FUNCS(AVX512F);
+        return;
+    }
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        SET_CONVERTER_FUNCS(AVX2);
+        return;
+    }
+#endif
+
 #if HAVE_SSE2_INTRINSICS
     if (SDL_HasSSE2()) {
         SET_CONVERTER_FUNCS(SSE2);
@@ -27,6 +27,30 @@
 #include "SDL_audio.h"
 #include "SDL_sysaudio.h"
 
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+#if defined __clang__
+# if (!__has_attribute(target))
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX2__)
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+#elif defined __GNUC__
+# if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+#endif
+
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
  * Changed to use 0xFE instead of 0xFF for better sound quality.
@@ -86,6 +110,1118 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
 
+/* Mix (len) bytes of a format that has a SIMD version below, one sample at a
+   time. The SIMD versions leave whatever doesn't fill a register to these. */
+static void
+SDL_MixAudio_S16LSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    Sint16 src1, src2;
+    int dst_sample;
+    const int max_audioval = ((1 << (16 - 1)) - 1);
+    const int min_audioval = -(1 << (16 - 1));
+
+    len /= 2;
+    while (len--) {
+        src1 = ((src[1]) << 8 | src[0]);
+        ADJUST_VOLUME(src1, volume);
+        src2 = ((dst[1]) << 8 | dst[0]);
+        src += 2;
+        dst_sample = src1 + src2;
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        dst[0] = dst_sample & 0xFF;
+        dst_sample >>= 8;
+        dst[1] = dst_sample & 0xFF;
+        dst += 2;
+    }
+}
+
+static void
+SDL_MixAudio_S16MSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    Sint16 src1, src2;
+    int dst_sample;
+    const int max_audioval = ((1 << (16 - 1)) - 1);
+    const int min_audioval = -(1 << (16 - 1));
+
+    len /= 2;
+    while (len--) {
+        src1 = ((src[0]) << 8 | src[1]);
+        ADJUST_VOLUME(src1, volume);
+        src2 = ((dst[0]) << 8 | dst[1]);
+        src += 2;
+        dst_sample = src1 + src2;
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        dst[1] = dst_sample & 0xFF;
+        dst_sample >>= 8;
+        dst[0] = dst_sample & 0xFF;
+        dst += 2;
+    }
+}
+
+static void
+SDL_MixAudio_S32LSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const Uint32 *src32 = (Uint32 *) src;
+    Uint32 *dst32 = (Uint32 *) dst;
+    Sint64 src1, src2;
+    Sint64 dst_sample;
+    const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
+    const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
+
+    len /= 4;
+    while (len--) {
+        src1 = (Sint64) ((Sint32) SDL_SwapLE32(*src32));
+        src32++;
+        ADJUST_VOLUME(src1, volume);
+        src2 = (Sint64) ((Sint32) SDL_SwapLE32(*dst32));
+        dst_sample = src1 + src2;
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        *(dst32++) = SDL_SwapLE32((Uint32) ((Sint32) dst_sample));
+    }
+}
+
+static void
+SDL_MixAudio_S32MSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const Uint32 *src32 = (Uint32 *) src;
+    Uint32 *dst32 = (Uint32 *) dst;
+    Sint64 src1, src2;
+    Sint64 dst_sample;
+    const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
+    const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
+
+    len /= 4;
+    while (len--) {
+        src1 = (Sint64) ((Sint32) SDL_SwapBE32(*src32));
+        src32++;
+        ADJUST_VOLUME(src1, volume);
+        src2 = (Sint64) ((Sint32) SDL_SwapBE32(*dst32));
+        dst_sample = src1 + src2;
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        *(dst32++) = SDL_SwapBE32((Uint32) ((Sint32) dst_sample));
+    }
+}
+
+static void
+SDL_MixAudio_F32LSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float fvolume = (float) volume;
+    const float *src32 = (float *) src;
+    float *dst32 = (float *) dst;
+    float src1, src2;
+    double dst_sample;
+    /* !!! FIXME: are these right? */
+    const double max_audioval = 3.402823466e+38F;
+    const double min_audioval = -3.402823466e+38F;
+
+    len /= 4;
+    while (len--) {
+        src1 = ((SDL_SwapFloatLE(*src32) * fvolume) * fmaxvolume);
+        src2 = SDL_SwapFloatLE(*dst32);
+        src32++;
+
+        dst_sample = ((double) src1) + ((double) src2);
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        *(dst32++) = SDL_SwapFloatLE((float) dst_sample);
+    }
+}
+
+static void
+SDL_MixAudio_F32MSB_Scalar(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float fvolume = (float) volume;
+    const float *src32 = (float *) src;
+    float *dst32 = (float *) dst;
+    float src1, src2;
+    double dst_sample;
+    /* !!! FIXME: are these right? */
+    const double max_audioval = 3.402823466e+38F;
+    const double min_audioval = -3.402823466e+38F;
+
+    len /= 4;
+    while (len--) {
+        src1 = ((SDL_SwapFloatBE(*src32) * fvolume) * fmaxvolume);
+        src2 = SDL_SwapFloatBE(*dst32);
+        src32++;
+
+        dst_sample = ((double) src1) + ((double) src2);
+        if (dst_sample > max_audioval) {
+            dst_sample = max_audioval;
+        } else if (dst_sample < min_audioval) {
+            dst_sample = min_audioval;
+        }
+        *(dst32++) = SDL_SwapFloatBE((float) dst_sample);
+    }
+}
+
+
+/* SDL_MixAudioMulti() sums every source into a wider accumulator and clips
+   once, starting (offset) bytes in, after whatever a SIMD mixer did. */
+static void
+SDL_MixAudioMulti_U8_Scalar(Uint8 * dst, const Uint8 ** srcs, const int * volumes,
+                            int num_srcs, Uint32 offset, Uint32 len)
+{
+    Uint32 i;
+    int j;
+
+    for (i = offset; i < len; i++) {
+        int dst_sample = dst[i];
+        for (j = 0; j < num_srcs; j++) {
+            int src_sample = srcs[j][i];
+            ADJUST_VOLUME_U8(src_sample, volumes[j]);
+            dst_sample += src_sample - 128;
+        }
+        /* mix8 clips dst plus one source, more sources can go past either end of it */
+        dst[i] = mix8[SDL_clamp(dst_sample + 128, 0, (int) SDL_arraysize(mix8) - 1)];
+    }
+}
+
+#define MIX_NOSWAP(x) (x)
+
+#define MIX_MULTI_SCALAR_FUNC(fmt, type, swaptype, acctype, swap, min_audioval, max_audioval) \
+    static void \
+    SDL_MixAudioMulti_##fmt##_Scalar(Uint8 * dst, const Uint8 ** srcs, const int * volumes, \
+                                     int num_srcs, Uint32 offset, Uint32 len) \
+    { \
+        type *dst_samples = (type *) (dst + offset); \
+        const Uint32 count = (len - offset) / sizeof (type); \
+        Uint32 i; \
+        int j; \
+        for (i = 0; i < count; i++) { \
+            acctype dst_sample = (type) swap((swaptype) dst_samples[i]); \
+            for (j = 0; j < num_srcs; j++) { \
+                acctype src_sample = (type) swap(((const swaptype *) (srcs[j] + offset))[i]); \
+                ADJUST_VOLUME(src_sample, volumes[j]); \
+                dst_sample += src_sample; \
+            } \
+            if (dst_sample > (max_audioval)) { \
+                dst_sample = (max_audioval); \
+            } else if (dst_sample < (min_audioval)) { \
+                dst_sample = (min_audioval); \
+            } \
+            dst_samples[i] = (type) swap((swaptype) (type) dst_sample); \
+        } \
+    }
+
+MIX_MULTI_SCALAR_FUNC(S8, Sint8, Sint8, int, MIX_NOSWAP, -(1 << (8 - 1)), ((1 << (8 - 1)) - 1))
+MIX_MULTI_SCALAR_FUNC(S16LSB, Sint16, Uint16, int, SDL_SwapLE16, -(1 << (16 - 1)), ((1 << (16 - 1)) - 1))
+MIX_MULTI_SCALAR_FUNC(S16MSB, Sint16, Uint16, int, SDL_SwapBE16, -(1 << (16 - 1)), ((1 << (16 - 1)) - 1))
+MIX_MULTI_SCALAR_FUNC(U16LSB, Uint16, Uint16, int, SDL_SwapLE16, 0, 0xFFFF)
+MIX_MULTI_SCALAR_FUNC(U16MSB, Uint16, Uint16, int, SDL_SwapBE16, 0, 0xFFFF)
+MIX_MULTI_SCALAR_FUNC(S32LSB, Sint32, Uint32, Sint64, SDL_SwapLE32, -(((Sint64) 1) << (32 - 1)), ((((Sint64) 1) << (32 - 1)) - 1))
+MIX_MULTI_SCALAR_FUNC(S32MSB, Sint32, Uint32, Sint64, SDL_SwapBE32, -(((Sint64) 1) << (32 - 1)), ((((Sint64) 1) << (32 - 1)) - 1))
+MIX_MULTI_SCALAR_FUNC(F32LSB, float, float, float, SDL_SwapFloatLE, -3.402823466e+38F, 3.402823466e+38F)
+MIX_MULTI_SCALAR_FUNC(F32MSB, float, float, float, SDL_SwapFloatBE, -3.402823466e+38F, 3.402823466e+38F)
+
+#undef MIX_MULTI_SCALAR_FUNC
+#undef MIX_NOSWAP
+
+
+/* The SIMD mixers work on native byte order samples (plus byteswapped S16,
+   which is cheap to do in a register), give the same results as the scalar
+   code above, and return the number of bytes they mixed. They assume
+   0 < volume <= SDL_MIX_MAXVOLUME, SDL_MixAudioFormat() checks for that.
+   The SDL_MixAudioMulti() ones allow 0 too, and skip those sources.
+   ADJUST_VOLUME truncates toward zero, so the integer versions bias negative
+   products by (SDL_MIX_MAXVOLUME - 1) before shifting them down by 7. */
+typedef Uint32 (*SDL_MixAudioFunc)(Uint8 * dst, const Uint8 * src, Uint32 len, int volume);
+
+static SDL_MixAudioFunc SDL_MixAudio_S16LSB = NULL;
+static SDL_MixAudioFunc SDL_MixAudio_S16MSB = NULL;
+static SDL_MixAudioFunc SDL_MixAudio_S32LSB = NULL;
+static SDL_MixAudioFunc SDL_MixAudio_S32MSB = NULL;
+static SDL_MixAudioFunc SDL_MixAudio_F32LSB = NULL;
+static SDL_MixAudioFunc SDL_MixAudio_F32MSB = NULL;
+
+typedef Uint32 (*SDL_MixAudioMultiFunc)(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len);
+
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_S16LSB = NULL;
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_S16MSB = NULL;
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_S32LSB = NULL;
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_S32MSB = NULL;
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_F32LSB = NULL;
+static SDL_MixAudioMultiFunc SDL_MixAudioMulti_F32MSB = NULL;
+
+#define MIX_MAXVOLUME_BITS 7  /* SDL_MIX_MAXVOLUME == (1 << 7) */
+
+#if HAVE_SSE2_INTRINSICS
+static SDL_INLINE __m128i
+SDL_MixSwapS16_SSE2(const __m128i x)
+{
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+/* Sign extend eight S16 samples to 32 bits, adjusting their volume on the way. */
+static SDL_INLINE void
+SDL_MixWidenS16_SSE2(const __m128i x, const int volume, __m128i *lo, __m128i *hi)
+{
+    if (volume == SDL_MIX_MAXVOLUME) {
+        *lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        *hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    } else {
+        const __m128i vol = _mm_set1_epi16((Sint16) volume);
+        const __m128i plo = _mm_mullo_epi16(x, vol);
+        const __m128i phi = _mm_mulhi_epi16(x, vol);
+        __m128i p0 = _mm_unpacklo_epi16(plo, phi);
+        __m128i p1 = _mm_unpackhi_epi16(plo, phi);
+        p0 = _mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 32 - MIX_MAXVOLUME_BITS));
+        p1 = _mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 32 - MIX_MAXVOLUME_BITS));
+        *lo = _mm_srai_epi32(p0, MIX_MAXVOLUME_BITS);
+        *hi = _mm_srai_epi32(p1, MIX_MAXVOLUME_BITS);
+    }
+}
+
+static SDL_INLINE __m128i
+SDL_MixVolumeS16_SSE2(const __m128i x, const int volume)
+{
+    __m128i lo, hi;
+    SDL_MixWidenS16_SSE2(x, volume, &lo, &hi);
+    return _mm_packs_epi32(lo, hi);
+}
+
+static SDL_INLINE Uint32
+SDL_MixAudio_S16_SSE2_Impl(Uint8 * dst, const Uint8 * src, Uint32 len, int volume, const SDL_bool swap)
+{
+    Uint32 i;
+
+    /* Just use unaligned loads, if the memory at runtime is
+       aligned it'll be just as fast on modern processors */
+    for (i = 0; (i + 16) <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        if (swap) {
+            s = SDL_MixSwapS16_SSE2(s);
+            d = SDL_MixSwapS16_SSE2(d);
+        }
+        if (volume != SDL_MIX_MAXVOLUME) {
+            s = SDL_MixVolumeS16_SSE2(s, volume);
+        }
+        d = _mm_adds_epi16(d, s);
+        if (swap) {
+            d = SDL_MixSwapS16_SSE2(d);
+        }
+        _mm_storeu_si128((__m128i *) (dst + i), d);
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S16_SSE2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_SSE2_Impl(dst, src, len, volume, SDL_FALSE);
+}
+
+static Uint32
+SDL_MixAudio_S16Swapped_SSE2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_SSE2_Impl(dst, src, len, volume, SDL_TRUE);
+}
+
+static Uint32
+SDL_MixAudio_S32_SSE2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    /* Doubles hold every (sample * volume) exactly, and truncate toward zero
+       on the way back, just like ADJUST_VOLUME. */
+    const __m128d scale = _mm_set1_pd(((double) volume) / ((double) SDL_MIX_MAXVOLUME));
+    const __m128i maxval = _mm_set1_epi32(0x7FFFFFFF);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i sum, overflow, saturated;
+        if (volume != SDL_MIX_MAXVOLUME) {
+            const __m128d lo = _mm_mul_pd(_mm_cvtepi32_pd(s), scale);
+            const __m128d hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(s, s)), scale);
+            s = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+        }
+        /* SSE2 has no saturating 32-bit add; an add overflowed if the sum's
+           sign differs from both inputs', then it pins toward d's sign. */
+        sum = _mm_add_epi32(d, s);
+        overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(d, sum), _mm_xor_si128(s, sum)), 31);
+        saturated = _mm_xor_si128(_mm_srai_epi32(d, 31), maxval);
+        sum = _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, sum));
+        _mm_storeu_si128((__m128i *) (dst + i), sum);
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_SSE2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const __m128 fvolume = _mm_set1_ps((float) volume);
+    const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 maxval = _mm_set1_ps(3.402823466e+38F);
+    const __m128 minval = _mm_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128 s = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps((const float *) (src + i)), fvolume), fmaxvolume);
+        const __m128 d = _mm_add_ps(_mm_loadu_ps((const float *) (dst + i)), s);
+        _mm_storeu_ps((float *) (dst + i), _mm_min_ps(_mm_max_ps(d, minval), maxval));
+    }
+    return i;
+}
+static SDL_INLINE Uint32
+SDL_MixAudioMulti_S16_SSE2_Impl(Uint8 * dst, const Uint8 ** srcs, const int * volumes,
+                                int num_srcs, Uint32 len, const SDL_bool swap)
+{
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i acc0, acc1;
+        if (swap) {
+            d = SDL_MixSwapS16_SSE2(d);
+        }
+        SDL_MixWidenS16_SSE2(d, SDL_MIX_MAXVOLUME, &acc0, &acc1);
+        for (j = 0; j < num_srcs; j++) {
+            __m128i s, lo, hi;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = _mm_loadu_si128((const __m128i *) (srcs[j] + i));
+            if (swap) {
+                s = SDL_MixSwapS16_SSE2(s);
+            }
+            SDL_MixWidenS16_SSE2(s, volumes[j], &lo, &hi);
+            acc0 = _mm_add_epi32(acc0, lo);
+            acc1 = _mm_add_epi32(acc1, hi);
+        }
+        d = _mm_packs_epi32(acc0, acc1);
+        if (swap) {
+            d = SDL_MixSwapS16_SSE2(d);
+        }
+        _mm_storeu_si128((__m128i *) (dst + i), d);
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudioMulti_S16_SSE2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_SSE2_Impl(dst, srcs, volumes, num_srcs, len, SDL_FALSE);
+}
+
+static Uint32
+SDL_MixAudioMulti_S16Swapped_SSE2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_SSE2_Impl(dst, srcs, volumes, num_srcs, len, SDL_TRUE);
+}
+
+static Uint32
+SDL_MixAudioMulti_S32_SSE2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    /* Each volume-adjusted sample is an integer, so doubles add them up
+       exactly until there are millions of sources. */
+    const __m128d maxval = _mm_set1_pd(2147483647.0);
+    const __m128d minval = _mm_set1_pd(-2147483648.0);
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128d acc0 = _mm_cvtepi32_pd(d);
+        __m128d acc1 = _mm_cvtepi32_pd(_mm_unpackhi_epi64(d, d));
+        for (j = 0; j < num_srcs; j++) {
+            __m128i s;
+            __m128d lo, hi;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = _mm_loadu_si128((const __m128i *) (srcs[j] + i));
+            lo = _mm_cvtepi32_pd(s);
+            hi = _mm_cvtepi32_pd(_mm_unpackhi_epi64(s, s));
+            if (volumes[j] != SDL_MIX_MAXVOLUME) {
+                const __m128d scale = _mm_set1_pd(((double) volumes[j]) / ((double) SDL_MIX_MAXVOLUME));
+                lo = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(lo, scale)));
+                hi = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(hi, scale)));
+            }
+            acc0 = _mm_add_pd(acc0, lo);
+            acc1 = _mm_add_pd(acc1, hi);
+        }
+        acc0 = _mm_min_pd(_mm_max_pd(acc0, minval), maxval);
+        acc1 = _mm_min_pd(_mm_max_pd(acc1, minval), maxval);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi64(_mm_cvttpd_epi32(acc0), _mm_cvttpd_epi32(acc1)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudioMulti_F32_SSE2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 maxval = _mm_set1_ps(3.402823466e+38F);
+    const __m128 minval = _mm_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+    int j;
+
+    /* Four registers at a time, so each source's adds don't have to wait on
+       each other. Scaling by (volume / SDL_MIX_MAXVOLUME) in one multiply
+       rounds the same as the scalar code, as SDL_MIX_MAXVOLUME is a power of two. */
+    for (i = 0; (i + 64) <= len; i += 64) {
+        __m128 acc0 = _mm_loadu_ps((const float *) (dst + i));
+        __m128 acc1 = _mm_loadu_ps((const float *) (dst + i + 16));
+        __m128 acc2 = _mm_loadu_ps((const float *) (dst + i + 32));
+        __m128 acc3 = _mm_loadu_ps((const float *) (dst + i + 48));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const float *src = (const float *) (srcs[j] + i);
+                const __m128 scale = _mm_mul_ps(_mm_set1_ps((float) volumes[j]), fmaxvolume);
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src), scale));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src + 4), scale));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(src + 8), scale));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(src + 12), scale));
+            }
+        }
+        _mm_storeu_ps((float *) (dst + i), _mm_min_ps(_mm_max_ps(acc0, minval), maxval));
+        _mm_storeu_ps((float *) (dst + i + 16), _mm_min_ps(_mm_max_ps(acc1, minval), maxval));
+        _mm_storeu_ps((float *) (dst + i + 32), _mm_min_ps(_mm_max_ps(acc2, minval), maxval));
+        _mm_storeu_ps((float *) (dst + i + 48), _mm_min_ps(_mm_max_ps(acc3, minval), maxval));
+    }
+
+    for (; (i + 16) <= len; i += 16) {
+        __m128 acc = _mm_loadu_ps((const float *) (dst + i));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const __m128 scale = _mm_mul_ps(_mm_set1_ps((float) volumes[j]), fmaxvolume);
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps((const float *) (srcs[j] + i)), scale));
+            }
+        }
+        _mm_storeu_ps((float *) (dst + i), _mm_min_ps(_mm_max_ps(acc, minval), maxval));
+    }
+    return i;
+}
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+/* MSVC will always accept AVX intrinsics when compiling for x64 */
+#if defined(__clang__) || defined(__GNUC__)
+#define MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MIX_TARGET_AVX2
+#endif
+
+MIX_TARGET_AVX2
+static SDL_INLINE __m256i
+SDL_MixSwapS16_AVX2(const __m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi16(x, 8), _mm256_srli_epi16(x, 8));
+}
+
+/* The unpacks here and the packs that undo them both work within 128-bit
+   lanes, so (lo) and (hi) don't hold the samples in order, but packing them
+   back together puts them right again. */
+MIX_TARGET_AVX2
+static SDL_INLINE void
+SDL_MixWidenS16_AVX2(const __m256i x, const int volume, __m256i *lo, __m256i *hi)
+{
+    if (volume == SDL_MIX_MAXVOLUME) {
+        *lo = _mm256_srai_epi32(_mm256_unpacklo_epi16(x, x), 16);
+        *hi = _mm256_srai_epi32(_mm256_unpackhi_epi16(x, x), 16);
+    } else {
+        const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+        const __m256i plo = _mm256_mullo_epi16(x, vol);
+        const __m256i phi = _mm256_mulhi_epi16(x, vol);
+        __m256i p0 = _mm256_unpacklo_epi16(plo, phi);
+        __m256i p1 = _mm256_unpackhi_epi16(plo, phi);
+        p0 = _mm256_add_epi32(p0, _mm256_srli_epi32(_mm256_srai_epi32(p0, 31), 32 - MIX_MAXVOLUME_BITS));
+        p1 = _mm256_add_epi32(p1, _mm256_srli_epi32(_mm256_srai_epi32(p1, 31), 32 - MIX_MAXVOLUME_BITS));
+        *lo = _mm256_srai_epi32(p0, MIX_MAXVOLUME_BITS);
+        *hi = _mm256_srai_epi32(p1, MIX_MAXVOLUME_BITS);
+    }
+}
+
+MIX_TARGET_AVX2
+static SDL_INLINE __m256i
+SDL_MixVolumeS16_AVX2(const __m256i x, const int volume)
+{
+    __m256i lo, hi;
+    SDL_MixWidenS16_AVX2(x, volume, &lo, &hi);
+    return _mm256_packs_epi32(lo, hi);
+}
+
+MIX_TARGET_AVX2
+static SDL_INLINE Uint32
+SDL_MixAudio_S16_AVX2_Impl(Uint8 * dst, const Uint8 * src, Uint32 len, int volume, const SDL_bool swap)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        if (swap) {
+            s = SDL_MixSwapS16_AVX2(s);
+            d = SDL_MixSwapS16_AVX2(d);
+        }
+        if (volume != SDL_MIX_MAXVOLUME) {
+            s = SDL_MixVolumeS16_AVX2(s, volume);
+        }
+        d = _mm256_adds_epi16(d, s);
+        if (swap) {
+            d = SDL_MixSwapS16_AVX2(d);
+        }
+        _mm256_storeu_si256((__m256i *) (dst + i), d);
+    }
+    return i;
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudio_S16_AVX2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_AVX2_Impl(dst, src, len, volume, SDL_FALSE);
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudio_S16Swapped_AVX2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_AVX2_Impl(dst, src, len, volume, SDL_TRUE);
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudio_S32_AVX2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const __m256d scale = _mm256_set1_pd(((double) volume) / ((double) SDL_MIX_MAXVOLUME));
+    const __m256i maxval = _mm256_set1_epi32(0x7FFFFFFF);
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256i sum, overflow, saturated;
+        if (volume != SDL_MIX_MAXVOLUME) {
+            const __m256d lo = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(s)), scale);
+            const __m256d hi = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(s, 1)), scale);
+            s = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)), _mm256_cvttpd_epi32(hi), 1);
+        }
+        sum = _mm256_add_epi32(d, s);
+        overflow = _mm256_and_si256(_mm256_xor_si256(d, sum), _mm256_xor_si256(s, sum));
+        saturated = _mm256_xor_si256(_mm256_srai_epi32(d, 31), maxval);
+        sum = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(sum), _mm256_castsi256_ps(saturated), _mm256_castsi256_ps(overflow)));
+        _mm256_storeu_si256((__m256i *) (dst + i), sum);
+    }
+    return i;
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudio_F32_AVX2(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const __m256 fvolume = _mm256_set1_ps((float) volume);
+    const __m256 fmaxvolume = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 maxval = _mm256_set1_ps(3.402823466e+38F);
+    const __m256 minval = _mm256_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256 s = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps((const float *) (src + i)), fvolume), fmaxvolume);
+        const __m256 d = _mm256_add_ps(_mm256_loadu_ps((const float *) (dst + i)), s);
+        _mm256_storeu_ps((float *) (dst + i), _mm256_min_ps(_mm256_max_ps(d, minval), maxval));
+    }
+    return i;
+}
+
+MIX_TARGET_AVX2
+static SDL_INLINE Uint32
+SDL_MixAudioMulti_S16_AVX2_Impl(Uint8 * dst, const Uint8 ** srcs, const int * volumes,
+                                int num_srcs, Uint32 len, const SDL_bool swap)
+{
+    Uint32 i;
+    int j;
+
+    /* two registers at a time, for the same reason as the F32 version below. */
+    for (i = 0; (i + 64) <= len; i += 64) {
+        __m256i d0 = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256i d1 = _mm256_loadu_si256((const __m256i *) (dst + i + 32));
+        __m256i acc0, acc1, acc2, acc3;
+        if (swap) {
+            d0 = SDL_MixSwapS16_AVX2(d0);
+            d1 = SDL_MixSwapS16_AVX2(d1);
+        }
+        SDL_MixWidenS16_AVX2(d0, SDL_MIX_MAXVOLUME, &acc0, &acc1);
+        SDL_MixWidenS16_AVX2(d1, SDL_MIX_MAXVOLUME, &acc2, &acc3);
+        for (j = 0; j < num_srcs; j++) {
+            __m256i s0, s1, lo0, hi0, lo1, hi1;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s0 = _mm256_loadu_si256((const __m256i *) (srcs[j] + i));
+            s1 = _mm256_loadu_si256((const __m256i *) (srcs[j] + i + 32));
+            if (swap) {
+                s0 = SDL_MixSwapS16_AVX2(s0);
+                s1 = SDL_MixSwapS16_AVX2(s1);
+            }
+            SDL_MixWidenS16_AVX2(s0, volumes[j], &lo0, &hi0);
+            SDL_MixWidenS16_AVX2(s1, volumes[j], &lo1, &hi1);
+            acc0 = _mm256_add_epi32(acc0, lo0);
+            acc1 = _mm256_add_epi32(acc1, hi0);
+            acc2 = _mm256_add_epi32(acc2, lo1);
+            acc3 = _mm256_add_epi32(acc3, hi1);
+        }
+        d0 = _mm256_packs_epi32(acc0, acc1);
+        d1 = _mm256_packs_epi32(acc2, acc3);
+        if (swap) {
+            d0 = SDL_MixSwapS16_AVX2(d0);
+            d1 = SDL_MixSwapS16_AVX2(d1);
+        }
+        _mm256_storeu_si256((__m256i *) (dst + i), d0);
+        _mm256_storeu_si256((__m256i *) (dst + i + 32), d1);
+    }
+
+    for (; (i + 32) <= len; i += 32) {
+        __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256i acc0, acc1;
+        if (swap) {
+            d = SDL_MixSwapS16_AVX2(d);
+        }
+        SDL_MixWidenS16_AVX2(d, SDL_MIX_MAXVOLUME, &acc0, &acc1);
+        for (j = 0; j < num_srcs; j++) {
+            __m256i s, lo, hi;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = _mm256_loadu_si256((const __m256i *) (srcs[j] + i));
+            if (swap) {
+                s = SDL_MixSwapS16_AVX2(s);
+            }
+            SDL_MixWidenS16_AVX2(s, volumes[j], &lo, &hi);
+            acc0 = _mm256_add_epi32(acc0, lo);
+            acc1 = _mm256_add_epi32(acc1, hi);
+        }
+        d = _mm256_packs_epi32(acc0, acc1);
+        if (swap) {
+            d = SDL_MixSwapS16_AVX2(d);
+        }
+        _mm256_storeu_si256((__m256i *) (dst + i), d);
+    }
+    return i;
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudioMulti_S16_AVX2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_AVX2_Impl(dst, srcs, volumes, num_srcs, len, SDL_FALSE);
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudioMulti_S16Swapped_AVX2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_AVX2_Impl(dst, srcs, volumes, num_srcs, len, SDL_TRUE);
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudioMulti_S32_AVX2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    const __m256d maxval = _mm256_set1_pd(2147483647.0);
+    const __m256d minval = _mm256_set1_pd(-2147483648.0);
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256d acc0 = _mm256_cvtepi32_pd(_mm256_castsi256_si128(d));
+        __m256d acc1 = _mm256_cvtepi32_pd(_mm256_extracti128_si256(d, 1));
+        for (j = 0; j < num_srcs; j++) {
+            __m256i s;
+            __m256d lo, hi;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = _mm256_loadu_si256((const __m256i *) (srcs[j] + i));
+            lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(s));
+            hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(s, 1));
+            if (volumes[j] != SDL_MIX_MAXVOLUME) {
+                const __m256d scale = _mm256_set1_pd(((double) volumes[j]) / ((double) SDL_MIX_MAXVOLUME));
+                lo = _mm256_round_pd(_mm256_mul_pd(lo, scale), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                hi = _mm256_round_pd(_mm256_mul_pd(hi, scale), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            }
+            acc0 = _mm256_add_pd(acc0, lo);
+            acc1 = _mm256_add_pd(acc1, hi);
+        }
+        acc0 = _mm256_min_pd(_mm256_max_pd(acc0, minval), maxval);
+        acc1 = _mm256_min_pd(_mm256_max_pd(acc1, minval), maxval);
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(acc0)), _mm256_cvttpd_epi32(acc1), 1));
+    }
+    return i;
+}
+
+MIX_TARGET_AVX2
+static Uint32
+SDL_MixAudioMulti_F32_AVX2(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    const __m256 fmaxvolume = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 maxval = _mm256_set1_ps(3.402823466e+38F);
+    const __m256 minval = _mm256_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 128) <= len; i += 128) {
+        __m256 acc0 = _mm256_loadu_ps((const float *) (dst + i));
+        __m256 acc1 = _mm256_loadu_ps((const float *) (dst + i + 32));
+        __m256 acc2 = _mm256_loadu_ps((const float *) (dst + i + 64));
+        __m256 acc3 = _mm256_loadu_ps((const float *) (dst + i + 96));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const float *src = (const float *) (srcs[j] + i);
+                const __m256 scale = _mm256_mul_ps(_mm256_set1_ps((float) volumes[j]), fmaxvolume);
+                acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(src), scale));
+                acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(src + 8), scale));
+                acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(src + 16), scale));
+                acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(src + 24), scale));
+            }
+        }
+        _mm256_storeu_ps((float *) (dst + i), _mm256_min_ps(_mm256_max_ps(acc0, minval), maxval));
+        _mm256_storeu_ps((float *) (dst + i + 32), _mm256_min_ps(_mm256_max_ps(acc1, minval), maxval));
+        _mm256_storeu_ps((float *) (dst + i + 64), _mm256_min_ps(_mm256_max_ps(acc2, minval), maxval));
+        _mm256_storeu_ps((float *) (dst + i + 96), _mm256_min_ps(_mm256_max_ps(acc3, minval), maxval));
+    }
+
+    for (; (i + 32) <= len; i += 32) {
+        __m256 acc = _mm256_loadu_ps((const float *) (dst + i));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const __m256 scale = _mm256_mul_ps(_mm256_set1_ps((float) volumes[j]), fmaxvolume);
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps((const float *) (srcs[j] + i)), scale));
+            }
+        }
+        _mm256_storeu_ps((float *) (dst + i), _mm256_min_ps(_mm256_max_ps(acc, minval), maxval));
+    }
+    return i;
+}
+
+#undef MIX_TARGET_AVX2
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static SDL_INLINE int16x8_t
+SDL_MixSwapS16_NEON(const int16x8_t x)
+{
+    return vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(x)));
+}
+
+static SDL_INLINE int32x4_t
+SDL_MixVolumeS32x4_NEON(const int32x4_t p)
+{
+    const int32x4_t bias = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 32 - MIX_MAXVOLUME_BITS));
+    return vshrq_n_s32(vaddq_s32(p, bias), MIX_MAXVOLUME_BITS);
+}
+
+static SDL_INLINE int64x2_t
+SDL_MixVolumeS64x2_NEON(const int64x2_t p)
+{
+    const int64x2_t bias = vreinterpretq_s64_u64(vshrq_n_u64(vreinterpretq_u64_s64(vshrq_n_s64(p, 63)), 64 - MIX_MAXVOLUME_BITS));
+    return vshrq_n_s64(vaddq_s64(p, bias), MIX_MAXVOLUME_BITS);
+}
+
+/* Sign extend four S16 or two S32 samples to twice the width, adjusting
+   their volume on the way. */
+static SDL_INLINE int32x4_t
+SDL_MixWidenS16_NEON(const int16x4_t x, const int volume)
+{
+    if (volume == SDL_MIX_MAXVOLUME) {
+        return vmovl_s16(x);
+    }
+    return SDL_MixVolumeS32x4_NEON(vmull_n_s16(x, (int16_t) volume));
+}
+
+static SDL_INLINE int64x2_t
+SDL_MixWidenS32_NEON(const int32x2_t x, const int volume)
+{
+    if (volume == SDL_MIX_MAXVOLUME) {
+        return vmovl_s32(x);
+    }
+    return SDL_MixVolumeS64x2_NEON(vmull_n_s32(x, volume));
+}
+
+static SDL_INLINE Uint32
+SDL_MixAudio_S16_NEON_Impl(Uint8 * dst, const Uint8 * src, Uint32 len, int volume, const SDL_bool swap)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        int16x8_t s = vreinterpretq_s16_u8(vld1q_u8(src + i));
+        int16x8_t d = vreinterpretq_s16_u8(vld1q_u8(dst + i));
+        if (swap) {
+            s = SDL_MixSwapS16_NEON(s);
+            d = SDL_MixSwapS16_NEON(d);
+        }
+        if (volume != SDL_MIX_MAXVOLUME) {
+            const int32x4_t p0 = SDL_MixWidenS16_NEON(vget_low_s16(s), volume);
+            const int32x4_t p1 = SDL_MixWidenS16_NEON(vget_high_s16(s), volume);
+            s = vcombine_s16(vmovn_s32(p0), vmovn_s32(p1));
+        }
+        d = vqaddq_s16(d, s);
+        if (swap) {
+            d = SDL_MixSwapS16_NEON(d);
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_s16(d));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S16_NEON(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_NEON_Impl(dst, src, len, volume, SDL_FALSE);
+}
+
+static Uint32
+SDL_MixAudio_S16Swapped_NEON(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    return SDL_MixAudio_S16_NEON_Impl(dst, src, len, volume, SDL_TRUE);
+}
+
+static Uint32
+SDL_MixAudio_S32_NEON(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        int32x4_t s = vreinterpretq_s32_u8(vld1q_u8(src + i));
+        const int32x4_t d = vreinterpretq_s32_u8(vld1q_u8(dst + i));
+        if (volume != SDL_MIX_MAXVOLUME) {
+            const int64x2_t lo = SDL_MixWidenS32_NEON(vget_low_s32(s), volume);
+            const int64x2_t hi = SDL_MixWidenS32_NEON(vget_high_s32(s), volume);
+            s = vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_s32(vqaddq_s32(d, s)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_NEON(Uint8 * dst, const Uint8 * src, Uint32 len, int volume)
+{
+    const float fvolume = (float) volume;
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float32x4_t maxval = vdupq_n_f32(3.402823466e+38F);
+    const float32x4_t minval = vdupq_n_f32(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const float32x4_t s = vmulq_n_f32(vmulq_n_f32(vreinterpretq_f32_u8(vld1q_u8(src + i)), fvolume), fmaxvolume);
+        const float32x4_t d = vaddq_f32(vreinterpretq_f32_u8(vld1q_u8(dst + i)), s);
+        vst1q_u8(dst + i, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(d, minval), maxval)));
+    }
+    return i;
+}
+static SDL_INLINE Uint32
+SDL_MixAudioMulti_S16_NEON_Impl(Uint8 * dst, const Uint8 ** srcs, const int * volumes,
+                                int num_srcs, Uint32 len, const SDL_bool swap)
+{
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        int16x8_t d = vreinterpretq_s16_u8(vld1q_u8(dst + i));
+        int32x4_t acc0, acc1;
+        if (swap) {
+            d = SDL_MixSwapS16_NEON(d);
+        }
+        acc0 = vmovl_s16(vget_low_s16(d));
+        acc1 = vmovl_s16(vget_high_s16(d));
+        for (j = 0; j < num_srcs; j++) {
+            int16x8_t s;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = vreinterpretq_s16_u8(vld1q_u8(srcs[j] + i));
+            if (swap) {
+                s = SDL_MixSwapS16_NEON(s);
+            }
+            acc0 = vaddq_s32(acc0, SDL_MixWidenS16_NEON(vget_low_s16(s), volumes[j]));
+            acc1 = vaddq_s32(acc1, SDL_MixWidenS16_NEON(vget_high_s16(s), volumes[j]));
+        }
+        d = vcombine_s16(vqmovn_s32(acc0), vqmovn_s32(acc1));
+        if (swap) {
+            d = SDL_MixSwapS16_NEON(d);
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_s16(d));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudioMulti_S16_NEON(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_NEON_Impl(dst, srcs, volumes, num_srcs, len, SDL_FALSE);
+}
+
+static Uint32
+SDL_MixAudioMulti_S16Swapped_NEON(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    return SDL_MixAudioMulti_S16_NEON_Impl(dst, srcs, volumes, num_srcs, len, SDL_TRUE);
+}
+
+static Uint32
+SDL_MixAudioMulti_S32_NEON(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const int32x4_t d = vreinterpretq_s32_u8(vld1q_u8(dst + i));
+        int64x2_t acc0 = vmovl_s32(vget_low_s32(d));
+        int64x2_t acc1 = vmovl_s32(vget_high_s32(d));
+        for (j = 0; j < num_srcs; j++) {
+            int32x4_t s;
+            if (volumes[j] == 0) {
+                continue;
+            }
+            s = vreinterpretq_s32_u8(vld1q_u8(srcs[j] + i));
+            acc0 = vaddq_s64(acc0, SDL_MixWidenS32_NEON(vget_low_s32(s), volumes[j]));
+            acc1 = vaddq_s64(acc1, SDL_MixWidenS32_NEON(vget_high_s32(s), volumes[j]));
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_s32(vcombine_s32(vqmovn_s64(acc0), vqmovn_s64(acc1))));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudioMulti_F32_NEON(Uint8 * dst, const Uint8 ** srcs, const int * volumes, int num_srcs, Uint32 len)
+{
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float32x4_t maxval = vdupq_n_f32(3.402823466e+38F);
+    const float32x4_t minval = vdupq_n_f32(-3.402823466e+38F);
+    Uint32 i;
+    int j;
+
+    for (i = 0; (i + 64) <= len; i += 64) {
+        float32x4_t acc0 = vreinterpretq_f32_u8(vld1q_u8(dst + i));
+        float32x4_t acc1 = vreinterpretq_f32_u8(vld1q_u8(dst + i + 16));
+        float32x4_t acc2 = vreinterpretq_f32_u8(vld1q_u8(dst + i + 32));
+        float32x4_t acc3 = vreinterpretq_f32_u8(vld1q_u8(dst + i + 48));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const Uint8 *src = srcs[j] + i;
+                const float scale = ((float) volumes[j]) * fmaxvolume;
+                acc0 = vmlaq_n_f32(acc0, vreinterpretq_f32_u8(vld1q_u8(src)), scale);
+                acc1 = vmlaq_n_f32(acc1, vreinterpretq_f32_u8(vld1q_u8(src + 16)), scale);
+                acc2 = vmlaq_n_f32(acc2, vreinterpretq_f32_u8(vld1q_u8(src + 32)), scale);
+                acc3 = vmlaq_n_f32(acc3, vreinterpretq_f32_u8(vld1q_u8(src + 48)), scale);
+            }
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(acc0, minval), maxval)));
+        vst1q_u8(dst + i + 16, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(acc1, minval), maxval)));
+        vst1q_u8(dst + i + 32, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(acc2, minval), maxval)));
+        vst1q_u8(dst + i + 48, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(acc3, minval), maxval)));
+    }
+
+    for (; (i + 16) <= len; i += 16) {
+        float32x4_t acc = vreinterpretq_f32_u8(vld1q_u8(dst + i));
+        for (j = 0; j < num_srcs; j++) {
+            if (volumes[j] != 0) {
+                const float32x4_t s = vreinterpretq_f32_u8(vld1q_u8(srcs[j] + i));
+                acc = vmlaq_n_f32(acc, s, ((float) volumes[j]) * fmaxvolume);
+            }
+        }
+        vst1q_u8(dst + i, vreinterpretq_u8_f32(vminq_f32(vmaxq_f32(acc, minval), maxval)));
+    }
+    return i;
+}
+#endif
+
+#undef MIX_MAXVOLUME_BITS
+
+static void
+SDL_ChooseMixers(void)
+{
+    static SDL_bool mixers_chosen = SDL_FALSE;
+
+    if (mixers_chosen) {
+        return;
+    }
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define SET_MIXER_FUNCS(fntype) \
+        SDL_MixAudio_S16LSB = SDL_MixAudio_S16_##fntype; \
+        SDL_MixAudio_S16MSB = SDL_MixAudio_S16Swapped_##fntype; \
+        SDL_MixAudio_S32LSB = SDL_MixAudio_S32_##fntype; \
+        SDL_MixAudio_F32LSB = SDL_MixAudio_F32_##fntype; \
+        SDL_MixAudioMulti_S16LSB = SDL_MixAudioMulti_S16_##fntype; \
+        SDL_MixAudioMulti_S16MSB = SDL_MixAudioMulti_S16Swapped_##fntype; \
+        SDL_MixAudioMulti_S32LSB = SDL_MixAudioMulti_S32_##fntype; \
+        SDL_MixAudioMulti_F32LSB = SDL_MixAudioMulti_F32_##fntype; \
+        mixers_chosen = SDL_TRUE
+#else
+#define SET_MIXER_FUNCS(fntype) \
+        SDL_MixAudio_S16MSB = SDL_MixAudio_S16_##fntype; \
+        SDL_MixAudio_S16LSB = SDL_MixAudio_S16Swapped_##fntype; \
+        SDL_MixAudio_S32MSB = SDL_MixAudio_S32_##fntype; \
+        SDL_MixAudio_F32MSB = SDL_MixAudio_F32_##fntype; \
+        SDL_MixAudioMulti_S16MSB = SDL_MixAudioMulti_S16_##fntype; \
+        SDL_MixAudioMulti_S16LSB = SDL_MixAudioMulti_S16Swapped_##fntype; \
+        SDL_MixAudioMulti_S32MSB = SDL_MixAudioMulti_S32_##fntype; \
+        SDL_MixAudioMulti_F32MSB = SDL_MixAudioMulti_F32_##fntype; \
+        mixers_chosen = SDL_TRUE
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        SET_MIXER_FUNCS(AVX2);
+        return;
+    }
+#endif
+
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        SET_MIXER_FUNCS(SSE2);
+        return;
+    }
+#endif
+
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        SET_MIXER_FUNCS(NEON);
+        return;
+    }
+#endif
+
+#undef SET_MIXER_FUNCS
+
+    /* No SIMD mixers here, the scalar ones do all the work */
+    mixers_chosen = SDL_TRUE;
+}
+
+/* Let the SIMD mixer for this format (if any) do what it can, and finish
+   with the scalar one. */
+#define MIX_SAMPLES(fmt) { \
+        Uint32 done = 0; \
+        if (SDL_MixAudio_##fmt && (volume > 0) && (volume <= SDL_MIX_MAXVOLUME)) { \
+            done = SDL_MixAudio_##fmt(dst, src, len, volume); \
+        } \
+        SDL_MixAudio_##fmt##_Scalar(dst + done, src + done, len - done, volume); \
+    }
+
 void
 SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
                    Uint32 len, int volume)
@@ -94,6 +1230,8 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         return;
     }
 
+    SDL_ChooseMixers();
+
     switch (format) {
 
     case AUDIO_U8:
@@ -138,57 +1276,11 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         break;
 
     case AUDIO_S16LSB:
-        {
-            Sint16 src1, src2;
-            int dst_sample;
-            const int max_audioval = ((1 << (16 - 1)) - 1);
-            const int min_audioval = -(1 << (16 - 1));
-
-            len /= 2;
-            while (len--) {
-                src1 = ((src[1]) << 8 | src[0]);
-                ADJUST_VOLUME(src1, volume);
-                src2 = ((dst[1]) << 8 | dst[0]);
-                src += 2;
-                dst_sample = src1 + src2;
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                dst[0] = dst_sample & 0xFF;
-                dst_sample >>= 8;
-                dst[1] = dst_sample & 0xFF;
-                dst += 2;
-            }
-        }
+        MIX_SAMPLES(S16LSB);
         break;
 
     case AUDIO_S16MSB:
-        {
-            Sint16 src1, src2;
-            int dst_sample;
-            const int max_audioval = ((1 << (16 - 1)) - 1);
-            const int min_audioval = -(1 << (16 - 1));
-
-            len /= 2;
-            while (len--) {
-                src1 = ((src[0]) << 8 | src[1]);
-                ADJUST_VOLUME(src1, volume);
-                src2 = ((dst[0]) << 8 | dst[1]);
-                src += 2;
-                dst_sample = src1 + src2;
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                dst[1] = dst_sample & 0xFF;
-                dst_sample >>= 8;
-                dst[0] = dst_sample & 0xFF;
-                dst += 2;
-            }
-        }
+        MIX_SAMPLES(S16MSB);
         break;
 
     case AUDIO_U16LSB:
@@ -240,113 +1332,19 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         break;
 
     case AUDIO_S32LSB:
-        {
-            const Uint32 *src32 = (Uint32 *) src;
-            Uint32 *dst32 = (Uint32 *) dst;
-            Sint64 src1, src2;
-            Sint64 dst_sample;
-            const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
-            const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
-
-            len /= 4;
-            while (len--) {
-                src1 = (Sint64) ((Sint32) SDL_SwapLE32(*src32));
-                src32++;
-                ADJUST_VOLUME(src1, volume);
-                src2 = (Sint64) ((Sint32) SDL_SwapLE32(*dst32));
-                dst_sample = src1 + src2;
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                *(dst32++) = SDL_SwapLE32((Uint32) ((Sint32) dst_sample));
-            }
-        }
+        MIX_SAMPLES(S32LSB);
         break;
 
     case AUDIO_S32MSB:
-        {
-            const Uint32 *src32 = (Uint32 *) src;
-            Uint32 *dst32 = (Uint32 *) dst;
-            Sint64 src1, src2;
-            Sint64 dst_sample;
-            const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
-            const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
-
-            len /= 4;
-            while (len--) {
-                src1 = (Sint64) ((Sint32) SDL_SwapBE32(*src32));
-                src32++;
-                ADJUST_VOLUME(src1, volume);
-                src2 = (Sint64) ((Sint32) SDL_SwapBE32(*dst32));
-                dst_sample = src1 + src2;
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                *(dst32++) = SDL_SwapBE32((Uint32) ((Sint32) dst_sample));
-            }
-        }
+        MIX_SAMPLES(S32MSB);
         break;
 
     case AUDIO_F32LSB:
-        {
-            const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
-            const float fvolume = (float) volume;
-            const float *src32 = (float *) src;
-            float *dst32 = (float *) dst;
-            float src1, src2;
-            double dst_sample;
-            /* !!! FIXME: are these right? */
-            const double max_audioval = 3.402823466e+38F;
-            const double min_audioval = -3.402823466e+38F;
-
-            len /= 4;
-            while (len--) {
-                src1 = ((SDL_SwapFloatLE(*src32) * fvolume) * fmaxvolume);
-                src2 = SDL_SwapFloatLE(*dst32);
-                src32++;
-
-                dst_sample = ((double) src1) + ((double) src2);
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                *(dst32++) = SDL_SwapFloatLE((float) dst_sample);
-            }
-        }
+        MIX_SAMPLES(F32LSB);
         break;
 
     case AUDIO_F32MSB:
-        {
-            const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
-            const float fvolume = (float) volume;
-            const float *src32 = (float *) src;
-            float *dst32 = (float *) dst;
-            float src1, src2;
-            double dst_sample;
-            /* !!! FIXME: are these right? */
-            const double max_audioval = 3.402823466e+38F;
-            const double min_audioval = -3.402823466e+38F;
-
-            len /= 4;
-            while (len--) {
-                src1 = ((SDL_SwapFloatBE(*src32) * fvolume) * fmaxvolume);
-                src2 = SDL_SwapFloatBE(*dst32);
-                src32++;
-
-                dst_sample = ((double) src1) + ((double) src2);
-                if (dst_sample > max_audioval) {
-                    dst_sample = max_audioval;
-                } else if (dst_sample < min_audioval) {
-                    dst_sample = min_audioval;
-                }
-                *(dst32++) = SDL_SwapFloatBE((float) dst_sample);
-            }
-        }
+        MIX_SAMPLES(F32MSB);
         break;
 
     default:                   /* If this happens... FIXME! */
@@ -355,4 +1353,97 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
     }
 }
 
+#undef MIX_SAMPLES
+
+#define MIX_MULTI_SAMPLES(fmt) { \
+        Uint32 done = 0; \
+        if (SDL_MixAudioMulti_##fmt) { \
+            done = SDL_MixAudioMulti_##fmt(dst, srcs, volumes, num_srcs, len); \
+        } \
+        SDL_MixAudioMulti_##fmt##_Scalar(dst, srcs, volumes, num_srcs, done, len); \
+    }
+
+void
+SDL_MixAudioMulti(Uint8 * dst, const Uint8 ** srcs, const int * volumes,
+                  int num_srcs, SDL_AudioFormat format, Uint32 len)
+{
+    int i;
+
+    if (num_srcs < 0) {
+        SDL_InvalidParamError("num_srcs");
+        return;
+    }
+    if (num_srcs == 0) {
+        return;
+    }
+    if (!dst) {
+        SDL_InvalidParamError("dst");
+        return;
+    }
+    if (!srcs || !volumes) {
+        SDL_InvalidParamError(!srcs ? "srcs" : "volumes");
+        return;
+    }
+    for (i = 0; i < num_srcs; i++) {
+        if (!srcs[i]) {
+            SDL_InvalidParamError("srcs");
+            return;
+        }
+        if ((volumes[i] < 0) || (volumes[i] > SDL_MIX_MAXVOLUME)) {
+            SDL_InvalidParamError("volumes");
+            return;
+        }
+    }
+
+    SDL_ChooseMixers();
+
+    switch (format) {
+    case AUDIO_U8:
+        SDL_MixAudioMulti_U8_Scalar(dst, srcs, volumes, num_srcs, 0, len);
+        break;
+
+    case AUDIO_S8:
+        SDL_MixAudioMulti_S8_Scalar(dst, srcs, volumes, num_srcs, 0, len);
+        break;
+
+    case AUDIO_S16LSB:
+        MIX_MULTI_SAMPLES(S16LSB);
+        break;
+
+    case AUDIO_S16MSB:
+        MIX_MULTI_SAMPLES(S16MSB);
+        break;
+
+    case AUDIO_U16LSB:
+        SDL_MixAudioMulti_U16LSB_Scalar(dst, srcs, volumes, num_srcs, 0, len);
+        break;
+
+    case AUDIO_U16MSB:
+        SDL_MixAudioMulti_U16MSB_Scalar(dst, srcs, volumes, num_srcs, 0, len);
+        break;
+
+    case AUDIO_S32LSB:
+        MIX_MULTI_SAMPLES(S32LSB);
+        break;
+
+    case AUDIO_S32MSB:
+        MIX_MULTI_SAMPLES(S32MSB);
+        break;
+
+    case AUDIO_F32LSB:
+        MIX_MULTI_SAMPLES(F32LSB);
+        break;
+
+    case AUDIO_F32MSB:
+        MIX_MULTI_SAMPLES(F32MSB);
+        break;
+
+    default:
+        SDL_SetError("SDL_MixAudioMulti(): unknown audio format");
+        return;
+    }
+}
+
+#undef MIX_MULTI_SAMPLES
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -62,6 +62,9 @@ extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
    The system preallocates enough packets for 2 callbacks' worth of data. */
 #define SDL_AUDIOBUFFERQUEUE_PACKETLEN (8 * 1024)
 
+/* The most buffers SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS can ask for. */
+#define SDL_AUDIO_CAPTURE_RING_MAX_SLOTS 1024
+
 typedef struct SDL_AudioDriverImpl
 {
     void (*DetectDevices) (void);
@@ -163,8 +166,44 @@ struct SDL_AudioDevice
     SDL_Thread *thread;
     SDL_threadID threadid;
 
-    /* Queued buffers (if app not using callback). */
-    SDL_DataQueue *buffer_queue;
+    /* Queued buffers (if app not using callback). The device thread is one
+       end of this queue and never locks; app threads on the other end
+       serialize among themselves with buffer_queue_lock. */
+    SDL_LockFreeDataQueue *buffer_queue;
+    SDL_mutex *buffer_queue_lock;
+
+    /* Capture ring (SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS), used instead of
+       buffer_queue. capture_ring_slots buffers of callbackspec.size bytes;
+       the device thread bumps capture_ring_head after filling one, the app
+       bumps capture_ring_tail after reading one. Both counters only grow
+       and wrap around; the rest is app-side, under buffer_queue_lock. */
+    Uint8 *capture_ring;
+    Uint64 *capture_ring_timestamps;
+    Uint32 capture_ring_slots;
+    SDL_atomic_t capture_ring_head;
+    SDL_atomic_t capture_ring_tail;
+    Uint32 capture_ring_offset;  /* bytes of the tail slot already dequeued. */
+    SDL_bool capture_ring_acquired;
+
+    /* Filled in by the device thread, read by SDL_GetAudioDeviceStats(). */
+    SDL_AudioDeviceStats stats;
+    SDL_SpinLock stats_lock;
+    Uint64 stats_last_wakeup;  /* SDL_GetPerformanceCounterNS(), 0 before the first one. */
+
+    /* When the device thread waits on its own instead of on the device, it
+       sleeps until wait_deadline, which moves ahead by exactly one buffer
+       each time (wait_remainder keeps the fraction of a tick). */
+    Uint64 wait_deadline;  /* performance counter, 0 before the first wait. */
+    Uint64 wait_remainder;
+
+    /* Adaptive callback size (SDL_HINT_AUDIO_ADAPTIVE_PERIOD), in sample
+       frames; period is 0 when it's off. Device thread only. */
+    Uint32 period;
+    Uint32 period_min;
+    Uint32 period_max;
+    Uint32 period_calm;  /* callbacks in a row that would fit in half the period. */
+    Uint64 period_jitter_ns;  /* smoothed wake-up jitter. */
+    SDL_bool period_underrun;  /* the device ran dry since the last callback. */
 
     /* * * */
     /* Data private to this driver */
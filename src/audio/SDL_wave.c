@@ -35,8 +35,11 @@
 
 #include "SDL_hints.h"
 #include "SDL_audio.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_wave.h"
 #include "SDL_audio_c.h"
+#include "../thread/SDL_systhread.h"
 
 /* Reads the value stored at the location of the f1 pointer, multiplies it
  * with the second argument and then stores the result to f1.
@@ -331,6 +334,129 @@ WaveAdjustToFactValue(WaveFile *file, Sint64 sampleframes)
     return sampleframes;
 }
 
+/* Decodes one complete ADPCM block (header and data) from state->block. */
+typedef int (*ADPCM_DecodeBlockFunc)(ADPCM_DecoderState *state);
+
+/* Don't bother with threads unless each one gets at least this many blocks. */
+#define ADPCM_MIN_BLOCKS_PER_THREAD 256
+
+typedef struct ADPCM_DecodeJob
+{
+    ADPCM_DecoderState state;
+    ADPCM_DecodeBlockFunc decodeblock;
+    size_t blockcount;
+    int result;
+    SDL_Thread *thread;
+} ADPCM_DecodeJob;
+
+static int
+ADPCM_DecodeBlockRange(ADPCM_DecoderState *state, ADPCM_DecodeBlockFunc decodeblock, size_t blockcount)
+{
+    while (blockcount-- > 0) {
+        state->block.data = state->input.data + state->input.pos;
+        state->block.size = state->blocksize;
+        state->block.pos = 0;
+        if (decodeblock(state) < 0) {
+            return -1;
+        }
+        state->input.pos += state->blocksize;
+    }
+    return 0;
+}
+
+static int SDLCALL
+ADPCM_DecodeJobThread(void *data)
+{
+    ADPCM_DecodeJob *job = (ADPCM_DecodeJob *)data;
+    job->result = ADPCM_DecodeBlockRange(&job->state, job->decodeblock, job->blockcount);
+    return 0;
+}
+
+/* ADPCM blocks don't depend on each other. If there are enough of them, this
+ * splits the leading complete blocks into contiguous ranges and decodes them
+ * on worker threads, each with its own channel state, straight into their
+ * final place in the output. The state is then advanced past those blocks so
+ * the serial loop only has to deal with what's left, like a truncated block at
+ * the end.
+ */
+static void
+ADPCM_DecodeBlocksThreaded(ADPCM_DecoderState *state, ADPCM_DecodeBlockFunc decodeblock, size_t cstatesize, int threads)
+{
+#if !SDL_THREADS_DISABLED
+    const size_t framesperblock = state->samplesperblock;
+    size_t blocks = (state->input.size - state->input.pos) / state->blocksize;
+    size_t first = 0;
+    ADPCM_DecodeJob *jobs;
+    Uint8 *cstates;
+    int i, jobcount, result = 0;
+
+    if ((Uint64)blocks * framesperblock > (Uint64)state->framesleft) {
+        blocks = (size_t)(state->framesleft / framesperblock);
+    }
+    if ((size_t)threads > blocks / ADPCM_MIN_BLOCKS_PER_THREAD) {
+        threads = (int)(blocks / ADPCM_MIN_BLOCKS_PER_THREAD);
+    }
+    if (threads < 2) {
+        return;
+    }
+    jobcount = threads;
+
+    jobs = (ADPCM_DecodeJob *)SDL_calloc(jobcount, sizeof(ADPCM_DecodeJob));
+    cstates = (Uint8 *)SDL_calloc(jobcount, cstatesize * state->channels);
+    if (jobs == NULL || cstates == NULL) {
+        /* Not fatal, the serial loop can still do all the work. */
+        SDL_free(jobs);
+        SDL_free(cstates);
+        return;
+    }
+
+    for (i = 0; i < jobcount; i++) {
+        ADPCM_DecodeJob *job = &jobs[i];
+        job->blockcount = blocks / jobcount + ((size_t)i < blocks % jobcount ? 1 : 0);
+        job->decodeblock = decodeblock;
+        job->state = *state;
+        job->state.cstate = cstates + i * cstatesize * state->channels;
+        job->state.input.pos += first * state->blocksize;
+        job->state.output.pos += first * framesperblock * state->channels;
+        job->state.framesleft = (Sint64)(job->blockcount * framesperblock);
+        first += job->blockcount;
+    }
+
+    /* The calling thread takes the first range and any that didn't get a thread. */
+    for (i = 1; i < jobcount; i++) {
+        jobs[i].thread = SDL_CreateThreadInternal(ADPCM_DecodeJobThread, "SDLWaveDecode", 0, &jobs[i]);
+    }
+    for (i = 0; i < jobcount; i++) {
+        if (jobs[i].thread == NULL) {
+            ADPCM_DecodeJobThread(&jobs[i]);
+        }
+    }
+    for (i = 0; i < jobcount; i++) {
+        if (jobs[i].thread != NULL) {
+            SDL_WaitThread(jobs[i].thread, NULL);
+        }
+    }
+
+    /* Errors are per thread. If a range failed, leave the state alone so the
+     * serial loop runs into the same error on this thread and reports it.
+     */
+    for (i = 0; i < jobcount; i++) {
+        if (jobs[i].result < 0) {
+            result = -1;
+        }
+    }
+
+    if (result == 0) {
+        state->input.pos += blocks * state->blocksize;
+        state->output.pos += blocks * framesperblock * state->channels;
+        state->framesleft -= (Sint64)(blocks * framesperblock);
+    }
+
+    SDL_free(jobs);
+    SDL_free(cstates);
+#endif
+}
+
 static int
 MS_ADPCM_CalculateSampleFrames(WaveFile *file, size_t datalength)
 {
@@ -490,16 +616,17 @@ MS_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
+static const Uint16 MS_ADPCM_adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
+
+static SDL_INLINE Sint16
 MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sample2, Uint8 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
     const Uint16 max_deltaval = 65535;
-    const Uint16 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
     Sint32 new_sample;
     Sint32 errordelta;
     Uint32 delta = cstate->delta;
@@ -513,7 +640,7 @@ MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sam
     } else if (new_sample > max_audioval) {
         new_sample = max_audioval;
     }
-    delta = (delta * adaptive[nybble]) / 256;
+    delta = (delta * MS_ADPCM_adaptive[nybble]) / 256;
     if (delta < 16) {
         delta = 16;
     } else if (delta > max_deltaval) {
@@ -591,49 +718,76 @@ MS_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
 static int
 MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 {
-    Uint16 nybble = 0;
-    Sint16 sample1, sample2;
     const Uint32 channels = state->channels;
-    Uint32 c;
     MS_ADPCM_ChannelState *cstate = (MS_ADPCM_ChannelState *)state->cstate;
+    /* The low nibble belongs to the second channel in stereo, or to the next
+     * sample frame in mono.
+     */
+    MS_ADPCM_ChannelState *lowcstate = cstate + (channels - 1);
+    const Uint8 *blockdata = state->block.data;
+    Sint16 *output = state->output.data;
+    int retval = 0;
+    Uint8 byte;
 
     size_t blockpos = state->block.pos;
     size_t blocksize = state->block.size;
 
     size_t outpos = state->output.pos;
+    size_t samplesleft;
 
     Sint64 blockframesleft = state->samplesperblock - 2;
     if (blockframesleft > state->framesleft) {
         blockframesleft = state->framesleft;
     }
+    if (blockframesleft < 0) {
+        /* The header already provided more frames than needed. */
+        blockframesleft = 0;
+    }
+    samplesleft = (size_t)blockframesleft * channels;
 
-    while (blockframesleft > 0) {
-        for (c = 0; c < channels; c++) {
-            if (nybble & 0x4000) {
-                nybble <<= 4;
-            } else if (blockpos < blocksize) {
-                nybble = state->block.data[blockpos++] | 0x4000;
-            } else {
-                /* Out of input data. Drop the incomplete frame and return. */
-                state->output.pos = outpos - c;
-                return -1;
-            }
+    /* Every byte holds two samples, high nibble first. Previous samples may
+     * come from the block header.
+     */
+    while (samplesleft >= 2) {
+        if (blockpos >= blocksize) {
+            /* Out of input data. Stop with complete sample frames. */
+            retval = -1;
+            break;
+        }
+        byte = blockdata[blockpos++];
 
-            /* Load previous samples which may come from the block header. */
-            sample1 = state->output.data[outpos - channels];
-            sample2 = state->output.data[outpos - channels * 2];
+        output[outpos] = MS_ADPCM_ProcessNibble(cstate, output[outpos - channels], output[outpos - channels * 2], byte >> 4);
+        outpos++;
+        output[outpos] = MS_ADPCM_ProcessNibble(lowcstate, output[outpos - channels], output[outpos - channels * 2], byte & 0x0f);
+        outpos++;
+        samplesleft -= 2;
+    }
 
-            sample1 = MS_ADPCM_ProcessNibble(cstate + c, sample1, sample2, (nybble >> 4) & 0x0f);
-            state->output.data[outpos++] = sample1;
+    /* Mono block with an odd number of sample frames. */
+    if (retval == 0 && samplesleft == 1) {
+        if (blockpos >= blocksize) {
+            retval = -1;
+        } else {
+            byte = blockdata[blockpos++];
+            output[outpos] = MS_ADPCM_ProcessNibble(cstate, output[outpos - 1], output[outpos - 2], byte >> 4);
+            outpos++;
         }
-
-        state->framesleft--;
-        blockframesleft--;
     }
 
+    state->framesleft -= (Sint64)((outpos - state->output.pos) / channels);
+    state->block.pos = blockpos;
     state->output.pos = outpos;
 
-    return 0;
+    return retval;
+}
+
+static int
+MS_ADPCM_DecodeBlock(ADPCM_DecoderState *state)
+{
+    if (MS_ADPCM_DecodeBlockHeader(state) < 0) {
+        return -1;
+    }
+    return MS_ADPCM_DecodeBlockData(state);
 }
 
 static int
@@ -685,13 +839,18 @@ MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 
     state.output.pos = 0;
     state.output.size = outputsize / sizeof(Sint16);
-    state.output.data = (Sint16 *)SDL_malloc(outputsize);
+    /* A block header always provides two sample frames, even if the fact
+     * chunk only leaves room for one. Allocate a spare frame for that.
+     */
+    state.output.data = (Sint16 *)SDL_malloc(outputsize + state.framesize);
     if (state.output.data == NULL) {
         return SDL_OutOfMemory();
     }
 
     state.cstate = cstate;
 
+    ADPCM_DecodeBlocksThreaded(&state, MS_ADPCM_DecodeBlock, sizeof(MS_ADPCM_ChannelState), file->decodethreads);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -736,6 +895,97 @@ MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     return 0;
 }
 
+/* Sample deltas and the next step index for every step index and nibble,
+ * built once by IMA_ADPCM_InitTables. The block decoder then needs just two
+ * lookups and a clamp per sample.
+ */
+static Sint32 IMA_ADPCM_deltas[89 * 16];
+static Uint8 IMA_ADPCM_nextindex[89 * 16];
+
+static void
+IMA_ADPCM_InitTables(void)
+{
+    static SDL_SpinLock lock;
+    static SDL_bool initialized = SDL_FALSE;
+    const Sint8 index_table_4b[16] = {
+        -1, -1, -1, -1,
+        2, 4, 6, 8,
+        -1, -1, -1, -1,
+        2, 4, 6, 8
+    };
+    const Uint16 step_table[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+        22385, 24623, 27086, 29794, 32767
+    };
+    Sint32 index, nybble;
+
+    SDL_AtomicLock(&lock);
+    if (!initialized) {
+        for (index = 0; index < 89; index++) {
+            const Uint32 step = step_table[index];
+            for (nybble = 0; nybble < 16; nybble++) {
+                Sint32 delta, nextindex;
+
+                /* This calculation uses shifts and additions because
+                 * multiplications were much slower back then. Sadly, this
+                 * can't just be replaced with an actual multiplication now as
+                 * the old algorithm drops some bits. The closest approximation
+                 * I could find is something like this:
+                 * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
+                 */
+                delta = step >> 3;
+                if (nybble & 0x04)
+                    delta += step;
+                if (nybble & 0x02)
+                    delta += step >> 1;
+                if (nybble & 0x01)
+                    delta += step >> 2;
+                if (nybble & 0x08)
+                    delta = -delta;
+
+                /* Clamp index into valid range. */
+                nextindex = index + index_table_4b[nybble];
+                if (nextindex > 88) {
+                    nextindex = 88;
+                } else if (nextindex < 0) {
+                    nextindex = 0;
+                }
+
+                IMA_ADPCM_deltas[index * 16 + nybble] = delta;
+                IMA_ADPCM_nextindex[index * 16 + nybble] = (Uint8)nextindex;
+            }
+        }
+        initialized = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&lock);
+}
+
+static SDL_INLINE Sint32
+IMA_ADPCM_ProcessNibble(Uint8 *index, Sint32 lastsample, Uint8 nybble)
+{
+    const Sint32 max_audioval = 32767;
+    const Sint32 min_audioval = -32768;
+    const size_t entry = (size_t)*index * 16 + nybble;
+    Sint32 sample = lastsample + IMA_ADPCM_deltas[entry];
+
+    *index = IMA_ADPCM_nextindex[entry];
+
+    /* Clamp output sample */
+    if (sample > max_audioval) {
+        sample = max_audioval;
+    } else if (sample < min_audioval) {
+        sample = min_audioval;
+    }
+
+    return sample;
+}
+
 static int
 IMA_ADPCM_CalculateSampleFrames(WaveFile *file, size_t datalength)
 {
@@ -853,73 +1103,9 @@ IMA_ADPCM_Init(WaveFile *file, size_t datalength)
         return -1;
     }
 
-    return 0;
-}
-
-static Sint16
-IMA_ADPCM_ProcessNibble(Sint8 *cindex, Sint16 lastsample, Uint8 nybble)
-{
-    const Sint32 max_audioval = 32767;
-    const Sint32 min_audioval = -32768;
-    const Sint8 index_table_4b[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Uint16 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
-    Uint32 step;
-    Sint32 sample, delta;
-    Sint8 index = *cindex;
-
-    /* Clamp index into valid range. */
-    if (index > 88) {
-        index = 88;
-    } else if (index < 0) {
-        index = 0;
-    }
-
-    /* explicit cast to avoid gcc warning about using 'char' as array index */
-    step = step_table[(size_t)index];
-
-    /* Update index value */
-    *cindex = index + index_table_4b[nybble];
+    IMA_ADPCM_InitTables();
 
-    /* This calculation uses shifts and additions because multiplications were
-     * much slower back then. Sadly, this can't just be replaced with an actual
-     * multiplication now as the old algorithm drops some bits. The closest
-     * approximation I could find is something like this:
-     * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
-     */
-    delta = step >> 3;
-    if (nybble & 0x04)
-        delta += step;
-    if (nybble & 0x02)
-        delta += step >> 1;
-    if (nybble & 0x01)
-        delta += step >> 2;
-    if (nybble & 0x08)
-        delta = -delta;
-
-    sample = lastsample + delta;
-
-    /* Clamp output sample */
-    if (sample > max_audioval) {
-        sample = max_audioval;
-    } else if (sample < min_audioval) {
-        sample = min_audioval;
-    }
-
-    return (Sint16)sample;
+    return 0;
 }
 
 static int
@@ -998,27 +1184,34 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 
     /* Each channel has their nibbles packed into 32-bit blocks. These blocks
      * are interleaved and make up the data part of the ADPCM block. This loop
-     * decodes the samples as they come from the input data and puts them at
-     * the appropriate places in the output data.
+     * decodes the samples as they come from the input data, two per byte with
+     * the low nibble first, and puts them at the appropriate places in the
+     * output data.
      */
     while (blockframesleft > 0) {
         const size_t subblocksamples = blockframesleft < 8 ? (size_t)blockframesleft : 8;
 
         for (c = 0; c < channels; c++) {
-            Uint8 nybble = 0;
+            Sint16 *output = state->output.data + outpos + c;
             /* Load previous sample which may come from the block header. */
-            Sint16 sample = state->output.data[outpos + c - channels];
+            Sint32 sample = output[-(Sint32)channels];
+            Sint8 *cindex = (Sint8 *)state->cstate + c;
+            Uint8 index = (Uint8)(*cindex > 88 ? 88 : (*cindex < 0 ? 0 : *cindex));
 
-            for (i = 0; i < subblocksamples; i++) {
-                if (i & 1) {
-                    nybble >>= 4;
-                } else {
-                    nybble = state->block.data[blockpos++];
-                }
+            for (i = 0; i + 1 < subblocksamples; i += 2) {
+                const Uint8 nybbles = state->block.data[blockpos++];
 
-                sample = IMA_ADPCM_ProcessNibble((Sint8 *)state->cstate + c, sample, nybble & 0x0f);
-                state->output.data[outpos + c + i * channels] = sample;
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, nybbles & 0x0f);
+                output[i * channels] = (Sint16)sample;
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, nybbles >> 4);
+                output[(i + 1) * channels] = (Sint16)sample;
             }
+            if (i < subblocksamples) {
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, state->block.data[blockpos++] & 0x0f);
+                output[i * channels] = (Sint16)sample;
+            }
+
+            *cindex = (Sint8)index;
         }
 
         outpos += channels * subblocksamples;
@@ -1032,6 +1225,15 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     return retval;
 }
 
+static int
+IMA_ADPCM_DecodeBlock(ADPCM_DecoderState *state)
+{
+    if (IMA_ADPCM_DecodeBlockHeader(state) < 0) {
+        return -1;
+    }
+    return IMA_ADPCM_DecodeBlockData(state);
+}
+
 static int
 IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
@@ -1090,6 +1292,8 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     }
     state.cstate = cstate;
 
+    ADPCM_DecodeBlocksThreaded(&state, IMA_ADPCM_DecodeBlock, sizeof(Sint8), file->decodethreads);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1165,8 +1369,11 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Expands sample_count companded samples at the start of buf to 16-bit samples
+ * in the same buffer. buf must have room for sample_count * 2 bytes.
+ */
 static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+LAW_ExpandInPlace(Uint16 encoding, Uint8 *buf, size_t sample_count)
 {
 #ifdef SDL_WAVE_LAW_LUT
     const Sint16 alaw_lut[256] = {
@@ -1207,45 +1414,9 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     };
 #endif
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
+    Uint8 *src = buf;
     Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (src == NULL) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
+    size_t i;
 
     dst = (Sint16 *)src;
 
@@ -1253,7 +1424,7 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
      * inform the caller about the byte order.
      */
     i = sample_count;
-    switch (file->format.encoding) {
+    switch (encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
         while (i--) {
@@ -1298,10 +1469,59 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (src == NULL) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    if (LAW_ExpandInPlace(file->format.encoding, src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1352,12 +1572,37 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static int
+/* Shifts sample_count 24-bit samples at the start of ptr to 32 bits in the same
+ * buffer. ptr must have room for sample_count * 4 bytes.
+ */
+static void
+PCM_ExpandSint24InPlace(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
+static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1630,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24InPlace(ptr, sample_count);
 
     return 0;
 }
@@ -1507,6 +1738,22 @@ WaveGetFactChunkHint()
     return FactNoHint;
 }
 
+static int
+WaveGetDecodeThreadsHint()
+{
+    const char *hint = SDL_GetHint(SDL_HINT_WAVE_DECODE_THREADS);
+    int threads = 0;
+
+    if (hint != NULL) {
+        threads = SDL_atoi(hint);
+    }
+    if (threads <= 0) {
+        threads = SDL_GetCPUCount();
+    }
+
+    return threads;
+}
+
 static void
 WaveFreeChunkData(WaveChunk *chunk)
 {
@@ -1783,8 +2030,12 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Parses the chunks of a WAVE file up to and including the format. On success,
+ * file->chunk describes the data chunk (without reading its data) and
+ * endposition is set to the position after the RIFF data.
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveParseHeaders(SDL_RWops *src, WaveFile *file, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1792,7 +2043,6 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     char *envchunkcountlimit;
     Sint64 RIFFstart, RIFFend, lastchunkpos;
     SDL_bool RIFFlengthknown = SDL_FALSE;
-    WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
     WaveChunk RIFFchunk;
     WaveChunk fmtchunk;
@@ -1997,9 +2247,79 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
+    /* Report the end position back to the cleanup code. */
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
     *chunk = datachunk;
 
+    return 0;
+}
+
+/* Sets up the SDL_AudioSpec for the decoded data. All unsupported formats were
+ * filtered out by the checks in WaveParseHeaders.
+ */
+static int
+WaveSetupSpec(WaveFile *file, SDL_AudioSpec *spec)
+{
+    WaveFormat *format = &file->format;
+
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Gets shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    spec->silence = SDL_SilenceValueForFormat(spec->format);
+
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveParseHeaders(src, file, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2043,52 +2363,11 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
+    if (WaveSetupSpec(file, spec) < 0) {
+        return -1;
     }
 
-    spec->silence = SDL_SilenceValueForFormat(spec->format);
-
-    /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2122,6 +2401,7 @@ SDL_LoadWAV_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec, Uint8 **audio_b
     file.riffhint = WaveGetRiffSizeHint();
     file.trunchint = WaveGetTruncationHint();
     file.facthint = WaveGetFactChunkHint();
+    file.decodethreads = WaveGetDecodeThreadsHint();
 
     result = WaveLoad(src, &file, spec, audio_buf, audio_len);
     if (result < 0) {
@@ -2152,4 +2432,362 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Streaming support. The headers are parsed when the stream is opened, but the
+ * data chunk is only read on demand. PCM and companded data get read straight
+ * into the caller's buffer and expanded in place; ADPCM is decoded one block
+ * at a time with the same block decoders WaveLoad uses.
+ */
+struct SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    size_t framesize;       /* Size of a decoded sample frame in bytes. */
+    Sint64 frameposition;   /* Sample frame the next read starts at. */
+    Sint64 srcposition;     /* Current position in src, or -1 if unknown. */
+
+    /* ADPCM only. input holds one encoded block, output the decoded block. */
+    ADPCM_DecoderState state;
+    Sint64 block;           /* Index of the block in output, or -1 if none. */
+    size_t blockframes;     /* Number of sample frames in output. */
+};
+
+static int
+WaveCalculateSampleFrames(WaveFile *file, size_t datalength)
+{
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+        return MS_ADPCM_CalculateSampleFrames(file, datalength);
+    case IMA_ADPCM_CODE:
+        return IMA_ADPCM_CalculateSampleFrames(file, datalength);
+    default:
+        file->sampleframes = WaveAdjustToFactValue(file, datalength / file->format.blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+        return 0;
+    }
+}
+
+static int
+WAVStreamSeekSource(SDL_WAVStream *stream, Sint64 position)
+{
+    if (stream->srcposition != position) {
+        if (SDL_RWseek(stream->src, position, RW_SEEK_SET) != position) {
+            stream->srcposition = -1;
+            return SDL_SetError("Could not seek data of WAVE data chunk");
+        }
+        stream->srcposition = position;
+    }
+    return 0;
+}
+
+/* The data source ended before the data chunk did. */
+static int
+WAVStreamTruncate(SDL_WAVStream *stream, Sint64 sampleframes)
+{
+    if (stream->file.trunchint == TruncVeryStrict || stream->file.trunchint == TruncStrict) {
+        return SDL_SetError("Truncated data chunk");
+    }
+    if (sampleframes < stream->file.sampleframes) {
+        stream->file.sampleframes = sampleframes;
+    }
+    return 0;
+}
+
+static int
+WAVStreamDecodeBlock(SDL_WAVStream *stream, Sint64 block)
+{
+    WaveFile *file = &stream->file;
+    ADPCM_DecoderState *state = &stream->state;
+    const Sint64 firstframe = block * (Sint64)state->samplesperblock;
+    const Sint64 offset = block * (Sint64)state->blocksize;
+    size_t blocksize = state->blocksize;
+    int result;
+
+    stream->block = -1;
+    stream->blockframes = 0;
+
+    if (offset >= file->chunk.length) {
+        return WAVStreamTruncate(stream, firstframe);
+    } else if (offset + blocksize > file->chunk.length) {
+        blocksize = (size_t)(file->chunk.length - offset);
+    }
+
+    if (WAVStreamSeekSource(stream, file->chunk.position + offset) < 0) {
+        return -1;
+    }
+    blocksize = SDL_RWread(stream->src, state->input.data, 1, blocksize);
+    stream->srcposition += blocksize;
+
+    if (blocksize < state->blockheadersize) {
+        return WAVStreamTruncate(stream, firstframe);
+    }
+
+    state->block.data = state->input.data;
+    state->block.size = blocksize;
+    state->block.pos = 0;
+    state->output.pos = 0;
+    state->framesleft = file->sampleframes - firstframe;
+
+    if (file->format.encoding == MS_ADPCM_CODE) {
+        result = MS_ADPCM_DecodeBlockHeader(state);
+        if (result == -1) {
+            return -1;
+        }
+        result = MS_ADPCM_DecodeBlockData(state);
+    } else {
+        result = IMA_ADPCM_DecodeBlockHeader(state);
+        if (result == 0) {
+            result = IMA_ADPCM_DecodeBlockData(state);
+        }
+    }
+
+    stream->blockframes = state->output.pos / state->channels;
+    if (result == -1) {
+        /* Unexpected end. Keep the partial block only if the hint says so. */
+        if (file->trunchint != TruncDropFrame) {
+            stream->blockframes = 0;
+        }
+        if (WAVStreamTruncate(stream, firstframe + stream->blockframes) < 0) {
+            return -1;
+        }
+    }
+    if ((Sint64)stream->blockframes > file->sampleframes - firstframe) {
+        stream->blockframes = (size_t)(file->sampleframes - firstframe);
+    }
+    stream->block = block;
+
+    return 0;
+}
+
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVStream *stream;
+    WaveFile *file;
+    ADPCM_DecoderState *state;
+    Sint64 endposition, srcsize;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    stream = (SDL_WAVStream *)SDL_calloc(1, sizeof(SDL_WAVStream));
+    if (stream == NULL) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    stream->src = src;
+    stream->freesrc = freesrc;
+    stream->srcposition = -1;
+    stream->block = -1;
+
+    file = &stream->file;
+    file->riffhint = WaveGetRiffSizeHint();
+    file->trunchint = WaveGetTruncationHint();
+    file->facthint = WaveGetFactChunkHint();
+
+    if (WaveParseHeaders(src, file, &endposition) < 0 || WaveSetupSpec(file, spec) < 0) {
+        SDL_CloseWAVStream(stream);
+        return NULL;
+    }
+
+    /* If the size of the data source is known, a truncated data chunk can be
+     * handled up front, the same way WaveLoad does it.
+     */
+    srcsize = SDL_RWsize(src);
+    if (srcsize >= 0 && file->chunk.position + file->chunk.length > srcsize) {
+        const Sint64 available = srcsize > file->chunk.position ? srcsize - file->chunk.position : 0;
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        } else if (WaveCalculateSampleFrames(file, (size_t)available) < 0) {
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        }
+    }
+
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        state = &stream->state;
+        state->channels = file->format.channels;
+        state->blocksize = file->format.blockalign;
+        state->blockheadersize = (size_t)state->channels * (file->format.encoding == MS_ADPCM_CODE ? 7 : 4);
+        state->samplesperblock = file->format.samplesperblock;
+        state->framesize = state->channels * sizeof(Sint16);
+        state->ddata = file->decoderdata;
+        state->framestotal = file->sampleframes;
+
+        state->input.size = state->blocksize;
+        state->input.data = (Uint8 *)SDL_malloc(state->input.size);
+        state->output.size = state->samplesperblock * state->channels;
+        state->output.data = (Sint16 *)SDL_malloc(state->output.size * sizeof(Sint16));
+        if (file->format.encoding == MS_ADPCM_CODE) {
+            state->cstate = SDL_calloc(state->channels, sizeof(MS_ADPCM_ChannelState));
+        } else {
+            state->cstate = SDL_calloc(state->channels, sizeof(Sint8));
+        }
+        if (state->input.data == NULL || state->output.data == NULL || state->cstate == NULL) {
+            SDL_OutOfMemory();
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        }
+        stream->framesize = state->framesize;
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        stream->framesize = (size_t)file->format.channels * sizeof(Sint16);
+        break;
+    default:
+        if (file->format.encoding == PCM_CODE && file->format.bitspersample == 24) {
+            stream->framesize = (size_t)file->format.channels * sizeof(Sint32);
+        } else {
+            stream->framesize = file->format.blockalign;
+        }
+        break;
+    }
+
+    return stream;
+}
+
+int
+SDL_ReadWAVStream(SDL_WAVStream *stream, void *buf, int frames)
+{
+    WaveFile *file;
+    Uint8 *dst = (Uint8 *)buf;
+    int total = 0;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    file = &stream->file;
+    if (frames > file->sampleframes - stream->frameposition) {
+        frames = (int)(file->sampleframes - stream->frameposition);
+    }
+
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE: {
+        ADPCM_DecoderState *state = &stream->state;
+        while (total < frames) {
+            const Sint64 block = stream->frameposition / (Sint64)state->samplesperblock;
+            const size_t blockpos = (size_t)(stream->frameposition % (Sint64)state->samplesperblock);
+            size_t count;
+
+            if (block != stream->block && WAVStreamDecodeBlock(stream, block) < 0) {
+                return -1;
+            } else if (blockpos >= stream->blockframes) {
+                /* Data got truncated. */
+                break;
+            }
+
+            count = stream->blockframes - blockpos;
+            if (count > (size_t)(frames - total)) {
+                count = (size_t)(frames - total);
+            }
+            SDL_memcpy(dst, state->output.data + blockpos * state->channels, count * stream->framesize);
+            dst += count * stream->framesize;
+            total += (int)count;
+            stream->frameposition += count;
+        }
+        break;
+    }
+    default:
+        if (frames > 0) {
+            const Sint64 position = file->chunk.position + stream->frameposition * file->format.blockalign;
+            size_t count;
+
+            if (WAVStreamSeekSource(stream, position) < 0) {
+                return -1;
+            }
+            count = SDL_RWread(stream->src, dst, file->format.blockalign, frames);
+            if (count < (size_t)frames) {
+                stream->srcposition = -1;
+                if (WAVStreamTruncate(stream, stream->frameposition + count) < 0) {
+                    return -1;
+                }
+            } else {
+                stream->srcposition = position + (Sint64)count * file->format.blockalign;
+            }
+
+            if (file->format.encoding == ALAW_CODE || file->format.encoding == MULAW_CODE) {
+                if (LAW_ExpandInPlace(file->format.encoding, dst, count * file->format.channels) < 0) {
+                    return -1;
+                }
+            } else if (file->format.encoding == PCM_CODE && file->format.bitspersample == 24) {
+                PCM_ExpandSint24InPlace(dst, count * file->format.channels);
+            }
+            total = (int)count;
+            stream->frameposition += count;
+        }
+        break;
+    }
+
+    return total;
+}
+
+int
+SDL_SeekWAVStream(SDL_WAVStream *stream, Sint64 frame)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (frame < 0) {
+        return SDL_InvalidParamError("frame");
+    }
+
+    /* The data source is only touched by the next read. */
+    if (frame > stream->file.sampleframes) {
+        frame = stream->file.sampleframes;
+    }
+    stream->frameposition = frame;
+
+    return 0;
+}
+
+Sint64
+SDL_GetWAVStreamLength(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+    return stream->file.sampleframes;
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    }
+    WaveFreeChunkData(&stream->file.chunk);
+    SDL_free(stream->file.decoderdata);
+    SDL_free(stream->state.input.data);
+    SDL_free(stream->state.output.data);
+    SDL_free(stream->state.cstate);
+    SDL_free(stream);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
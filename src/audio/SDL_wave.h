@@ -144,6 +144,7 @@ typedef struct WaveFile
     WaveRiffSizeHint riffhint;
     WaveTruncationHint trunchint;
     WaveFactChunkHint facthint;
+    int decodethreads;   /* Maximum number of threads for block decoding. */
 } WaveFile;
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -31,6 +31,8 @@
 #include "SDL_rwops.h"
 #include "SDL_timer.h"
 #include "SDL_audio.h"
+#include "SDL_hints.h"
+#include "SDL_endian.h"
 #include "../SDL_audio_c.h"
 #include "SDL_diskaudio.h"
 
@@ -42,33 +44,58 @@
 #define DISKDEFAULT_INFILE      "sdlaudio-in.raw"
 #define DISKENVR_IODELAY      "SDL_DISKAUDIODELAY"
 
+/* output is collected into blocks of about this size before being written. */
+#define DISK_WRITE_BLOCK_SIZE  (64 * 1024)
+
+#define WAV_HEADER_SIZE  44
+
 /* This function waits until it is possible to write a full sound buffer */
 static void
 DISKAUDIO_WaitDevice(_THIS)
 {
-    SDL_Delay(_this->hidden->io_delay);
+    /* even when free-running, a paused device only gets silence; don't fill the disk with it. */
+    if (!_this->hidden->freerun || SDL_AtomicGet(&_this->paused)) {
+        SDL_Delay(_this->hidden->io_delay);
+    } else {
+        SDL_Delay(0);  /* just yield, so threads waiting on the device lock get a turn. */
+    }
+}
+
+static SDL_bool
+DISKAUDIO_FlushOutput(_THIS)
+{
+    struct SDL_PrivateAudioData *h = _this->hidden;
+    const size_t written = h->mixbuf_used ? SDL_RWwrite(h->io, h->mixbuf, 1, h->mixbuf_used) : 0;
+    const SDL_bool retval = (written == h->mixbuf_used) ? SDL_TRUE : SDL_FALSE;
+
+#ifdef DEBUG_AUDIO
+    fprintf(stderr, "Wrote %d bytes of audio data\n", (int) written);
+#endif
+
+    h->wav_data_len += written;
+    h->mixbuf_used = 0;
+    return retval;
 }
 
 static void
 DISKAUDIO_PlayDevice(_THIS)
 {
-    const size_t written = SDL_RWwrite(_this->hidden->io,
-                                       _this->hidden->mixbuf,
-                                       1, _this->spec.size);
+    struct SDL_PrivateAudioData *h = _this->hidden;
 
-    /* If we couldn't write, assume fatal error for now */
-    if (written != _this->spec.size) {
-        SDL_OpenedAudioDeviceDisconnected(_this);
+    /* the buffer was rendered in place, so just keep it. */
+    h->mixbuf_used += _this->spec.size;
+    if ((h->mixbuf_used + _this->spec.size) > h->mixbuf_len) {
+        /* If we couldn't write, assume fatal error for now */
+        if (!DISKAUDIO_FlushOutput(_this)) {
+            SDL_OpenedAudioDeviceDisconnected(_this);
+        }
     }
-#ifdef DEBUG_AUDIO
-    fprintf(stderr, "Wrote %d bytes of audio data\n", written);
-#endif
 }
 
 static Uint8 *
 DISKAUDIO_GetDeviceBuf(_THIS)
 {
-    return (_this->hidden->mixbuf);
+    return (_this->hidden->mixbuf + _this->hidden->mixbuf_used);
 }
 
 static int
@@ -77,7 +104,9 @@ DISKAUDIO_CaptureFromDevice(_THIS, void *buffer, int buflen)
     struct SDL_PrivateAudioData *h = _this->hidden;
     const int origbuflen = buflen;
 
-    SDL_Delay(h->io_delay);
+    if (!h->freerun) {
+        SDL_Delay(h->io_delay);
+    }
 
     if (h->io) {
         const size_t br = SDL_RWread(h->io, buffer, 1, buflen);
@@ -102,10 +131,40 @@ DISKAUDIO_FlushCapture(_THIS)
 }
 
 
+static SDL_bool
+DISKAUDIO_WriteWavHeader(_THIS)
+{
+    SDL_RWops *io = _this->hidden->io;
+    const Uint16 bits = SDL_AUDIO_BITSIZE(_this->spec.format);
+    const Uint16 blockalign = (bits / 8) * _this->spec.channels;
+    const Uint32 datalen = (Uint32) SDL_min(_this->hidden->wav_data_len, (Uint64) (SDL_MAX_UINT32 - (WAV_HEADER_SIZE - 8)));
+    size_t ok = 1;
+
+    ok &= SDL_RWwrite(io, "RIFF", 4, 1);
+    ok &= SDL_WriteLE32(io, datalen + (WAV_HEADER_SIZE - 8));
+    ok &= SDL_RWwrite(io, "WAVEfmt ", 8, 1);
+    ok &= SDL_WriteLE32(io, 16);
+    ok &= SDL_WriteLE16(io, SDL_AUDIO_ISFLOAT(_this->spec.format) ? 0x0003 : 0x0001);  /* IEEE float or PCM */
+    ok &= SDL_WriteLE16(io, _this->spec.channels);
+    ok &= SDL_WriteLE32(io, _this->spec.freq);
+    ok &= SDL_WriteLE32(io, _this->spec.freq * blockalign);
+    ok &= SDL_WriteLE16(io, blockalign);
+    ok &= SDL_WriteLE16(io, bits);
+    ok &= SDL_RWwrite(io, "data", 4, 1);
+    ok &= SDL_WriteLE32(io, datalen);
+    return ok ? SDL_TRUE : SDL_FALSE;
+}
+
 static void
 DISKAUDIO_CloseDevice(_THIS)
 {
     if (_this->hidden->io != NULL) {
+        if (_this->hidden->mixbuf) {  /* playback: write out what's left. */
+            DISKAUDIO_FlushOutput(_this);
+            if (_this->hidden->wav && (SDL_RWseek(_this->hidden->io, 0, RW_SEEK_SET) == 0)) {
+                DISKAUDIO_WriteWavHeader(_this);  /* now with the real sizes. */
+            }
+        }
         SDL_RWclose(_this->hidden->io);
     }
     SDL_free(_this->hidden->mixbuf);
@@ -131,6 +190,7 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     /* handle != NULL means "user specified the placeholder name on the fake detected device list" */
     const char *fname = get_filename(iscapture, handle ? NULL : devname);
     const char *envr = SDL_getenv(DISKENVR_IODELAY);
+    const size_t fnamelen = SDL_strlen(fname);
 
     _this->hidden = (struct SDL_PrivateAudioData *)
         SDL_malloc(sizeof(*_this->hidden));
@@ -144,6 +204,22 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     } else {
         _this->hidden->io_delay = ((_this->spec.samples * 1000) / _this->spec.freq);
     }
+    _this->hidden->freerun = SDL_GetHintBoolean(SDL_HINT_AUDIO_DISK_FREERUN, SDL_FALSE);
+
+    /* Playback to a .wav file gets a header, so stick to formats WAV can hold. */
+    if (!iscapture && (fnamelen >= 4) && (SDL_strcasecmp(fname + fnamelen - 4, ".wav") == 0)) {
+        _this->hidden->wav = SDL_TRUE;
+        if (SDL_AUDIO_BITSIZE(_this->spec.format) == 8) {
+            _this->spec.format = AUDIO_U8;
+        } else if (SDL_AUDIO_BITSIZE(_this->spec.format) == 16) {
+            _this->spec.format = AUDIO_S16LSB;
+        } else if (SDL_AUDIO_ISFLOAT(_this->spec.format)) {
+            _this->spec.format = AUDIO_F32LSB;
+        } else {
+            _this->spec.format = AUDIO_S32LSB;
+        }
+        SDL_CalculateAudioSpec(&_this->spec);
+    }
 
     /* Open the audio device */
     _this->hidden->io = SDL_RWFromFile(fname, iscapture ? "rb" : "wb");
@@ -151,13 +227,19 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
         return -1;
     }
 
-    /* Allocate mixing buffer */
+    /* Allocate mixing buffer; it holds as many device buffers as fit in a write block. */
     if (!iscapture) {
-        _this->hidden->mixbuf = (Uint8 *) SDL_malloc(_this->spec.size);
+        _this->hidden->mixbuf_len = _this->spec.size * SDL_max(1, DISK_WRITE_BLOCK_SIZE / _this->spec.size);
+        _this->hidden->mixbuf = (Uint8 *) SDL_malloc(_this->hidden->mixbuf_len);
         if (_this->hidden->mixbuf == NULL) {
             return SDL_OutOfMemory();
         }
-        SDL_memset(_this->hidden->mixbuf, _this->spec.silence, _this->spec.size);
+        SDL_memset(_this->hidden->mixbuf, _this->spec.silence, _this->hidden->mixbuf_len);
+
+        /* sizes are placeholders until we close. */
+        if (_this->hidden->wav && !DISKAUDIO_WriteWavHeader(_this)) {
+            return -1;
+        }
     }
 
     SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO,
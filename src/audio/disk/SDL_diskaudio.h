@@ -34,7 +34,12 @@ struct SDL_PrivateAudioData
     /* The file descriptor for the audio device */
     SDL_RWops *io;
     Uint32 io_delay;
-    Uint8 *mixbuf;
+    SDL_bool freerun;  /* don't pace anything, render as fast as we can. */
+    Uint8 *mixbuf;  /* output collects here and is written in big blocks. */
+    Uint32 mixbuf_len;
+    Uint32 mixbuf_used;
+    SDL_bool wav;  /* output has a WAV header that gets patched on close. */
+    Uint64 wav_data_len;
 };
 
 #endif /* SDL_diskaudio_h_ */
@@ -855,3 +855,21 @@
 #define SDL_GameControllerHasRumbleTriggers SDL_GameControllerHasRumbleTriggers_REAL
 #define SDL_hid_ble_scan SDL_hid_ble_scan_REAL
 #define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_GetPerformanceCounterNS SDL_GetPerformanceCounterNS_REAL
+#define SDL_PeepEventsTimestamped SDL_PeepEventsTimestamped_REAL
+#define SDL_AudioStreamSetResampleQuality SDL_AudioStreamSetResampleQuality_REAL
+#define SDL_MixAudioMulti SDL_MixAudioMulti_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_ReadWAVStream SDL_ReadWAVStream_REAL
+#define SDL_SeekWAVStream SDL_SeekWAVStream_REAL
+#define SDL_GetWAVStreamLength SDL_GetWAVStreamLength_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_AcquireCapturedAudio SDL_AcquireCapturedAudio_REAL
+#define SDL_ReleaseCapturedAudio SDL_ReleaseCapturedAudio_REAL
+#define SDL_RenderGetCommandCounts SDL_RenderGetCommandCounts_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
+#define SDL_RenderCopyBatch SDL_RenderCopyBatch_REAL
+#define SDL_RenderCopyBatchEx SDL_RenderCopyBatchEx_REAL
+#define SDL_GetEventQueueStats SDL_GetEventQueueStats_REAL
@@ -924,3 +924,21 @@ SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumble,(SDL_GameController *a),(a)
 SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumbleTriggers,(SDL_GameController *a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_hid_ble_scan,(SDL_bool a),(a),)
 SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetPerformanceCounterNS,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_PeepEventsTimestamped,(SDL_Event *a, Uint64 *b, int c, SDL_eventaction d, Uint32 e, Uint32 f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetResampleQuality,(SDL_AudioStream *a, SDL_AudioResampleQuality b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_MixAudioMulti,(Uint8 *a, const Uint8 **b, const int *c, int d, SDL_AudioFormat e, Uint32 f),(a,b,c,d,e,f),)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_ReadWAVStream,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_SeekWAVStream,(SDL_WAVStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_GetWAVStreamLength,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_AcquireCapturedAudio,(SDL_AudioDeviceID a, SDL_CapturedAudio *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_ReleaseCapturedAudio,(SDL_AudioDeviceID a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetCommandCounts,(SDL_Renderer *a, Uint32 *b, Uint32 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopyBatch,(SDL_Renderer *a, SDL_Texture *b, const SDL_Rect *c, const SDL_FRect *d, int e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopyBatchEx,(SDL_Renderer *a, SDL_Texture *b, const SDL_Rect *c, const SDL_FRect *d, const double *e, const SDL_FPoint *f, const SDL_RendererFlip *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_GetEventQueueStats,(SDL_EventQueueStats *a),(a),return)
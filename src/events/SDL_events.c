@@ -71,6 +71,7 @@ static Uint32 SDL_userevents = SDL_USEREVENT;
 typedef struct _SDL_EventEntry
 {
     SDL_Event event;
+    Uint64 timestamp_ns;
     SDL_SysWMmsg msg;
     struct _SDL_EventEntry *prev;
     struct _SDL_EventEntry *next;
@@ -82,18 +83,57 @@ typedef struct _SDL_SysWMEntry
     struct _SDL_SysWMEntry *next;
 } SDL_SysWMEntry;
 
+/* Private data -- lock-free event ring, used instead of the linked list
+   when SDL_HINT_EVENT_QUEUE_LOCKFREE is set.
+
+   Producers claim entries with a CAS on enqueue_pos and never touch the
+   queue lock. Consumers still serialize on SDL_EventQ.lock, so only one
+   thread at a time walks the committed entries and advances dequeue_pos.
+   Producers hold a reference in SDL_EventQ.ring_producers while they use
+   the ring, so SDL_StopEventLoop() can wait for them before freeing it.
+ */
+#define SDL_EVENT_RING_ENTRIES  8192    /* The number of entries must be a power of 2 */
+#define SDL_EVENT_RING_MASK     (SDL_EVENT_RING_ENTRIES-1)
+
+typedef struct
+{
+    SDL_atomic_t sequence;
+    SDL_bool removed;
+    SDL_SysWMmsg *msg;
+    Uint64 timestamp_ns;
+    SDL_Event event;
+} SDL_EventRingEntry;
+
+typedef struct
+{
+    char cache_pad1[SDL_CACHELINE_SIZE];
+
+    SDL_atomic_t enqueue_pos;
+
+    char cache_pad2[SDL_CACHELINE_SIZE-sizeof(SDL_atomic_t)];
+
+    SDL_atomic_t dequeue_pos;
+
+    char cache_pad3[SDL_CACHELINE_SIZE-sizeof(SDL_atomic_t)];
+
+    SDL_EventRingEntry entries[SDL_EVENT_RING_ENTRIES];
+} SDL_EventRing;
+
 static struct
 {
     SDL_mutex *lock;
     SDL_atomic_t active;
     SDL_atomic_t count;
-    int max_events_seen;
+    SDL_atomic_t max_events_seen;
+    int coalesced_events;
     SDL_EventEntry *head;
     SDL_EventEntry *tail;
     SDL_EventEntry *free;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
-} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
+    SDL_EventRing *ring;
+    SDL_atomic_t ring_producers;
+} SDL_EventQ = { NULL, { 1 }, { 0 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL, NULL, { 0 } };
 
 
 #if !SDL_JOYSTICK_DISABLED
@@ -158,6 +198,15 @@ SDL_EventLoggingChanged(void *userdata, const char *name, const char *oldValue,
     SDL_DoEventLogging = (hint && *hint) ? SDL_clamp(SDL_atoi(hint), 0, 2) : 0;
 }
 
+/* SDL_FALSE (default) means every event is queued, SDL_TRUE means high frequency motion events are merged */
+static SDL_bool SDL_DoEventCoalescing = SDL_FALSE;
+
+static void SDLCALL
+SDL_EventCoalescingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_DoEventCoalescing = SDL_GetStringBoolean(hint, SDL_FALSE);
+}
+
 static void
 SDL_LogEvent(const SDL_Event *event)
 {
@@ -447,7 +496,9 @@ SDL_StopEventLoop(void)
 
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
-                SDL_EventQ.max_events_seen);
+                SDL_AtomicGet(&SDL_EventQ.max_events_seen));
+        SDL_Log("SDL EVENT QUEUE: Events coalesced: %d\n",
+                SDL_EventQ.coalesced_events);
     }
 
     /* Clean out EventQ */
@@ -471,14 +522,33 @@ SDL_StopEventLoop(void)
         SDL_free(wmmsg);
         wmmsg = next;
     }
+    if (SDL_EventQ.ring) {
+        SDL_EventRing *ring = SDL_EventQ.ring;
+        unsigned queue_pos, enqueue_pos;
+
+        /* Producers don't take the lock; they see the queue is inactive
+           when they start, but the ones already adding have to finish. */
+        while (SDL_AtomicGet(&SDL_EventQ.ring_producers) > 0) {
+            SDL_Delay(1);
+        }
+
+        queue_pos = (unsigned)SDL_AtomicGet(&ring->dequeue_pos);
+        enqueue_pos = (unsigned)SDL_AtomicGet(&ring->enqueue_pos);
+        for ( ; queue_pos != enqueue_pos; ++queue_pos) {
+            SDL_free(ring->entries[queue_pos & SDL_EVENT_RING_MASK].msg);
+        }
+        SDL_free(ring);
+    }
 
     SDL_AtomicSet(&SDL_EventQ.count, 0);
-    SDL_EventQ.max_events_seen = 0;
+    SDL_AtomicSet(&SDL_EventQ.max_events_seen, 0);
+    SDL_EventQ.coalesced_events = 0;
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
     SDL_EventQ.free = NULL;
     SDL_EventQ.wmmsg_used = NULL;
     SDL_EventQ.wmmsg_free = NULL;
+    SDL_EventQ.ring = NULL;
 
     /* Clear disabled event state */
     for (i = 0; i < SDL_arraysize(SDL_disabled_events); ++i) {
@@ -531,6 +601,23 @@ SDL_StartEventLoop(void)
     }
 #endif /* !SDL_THREADS_DISABLED */
 
+    /* The queue implementation can only be switched while nothing is queued */
+    if (!SDL_EventQ.ring && !SDL_EventQ.head &&
+        SDL_GetHintBoolean(SDL_HINT_EVENT_QUEUE_LOCKFREE, SDL_FALSE)) {
+        SDL_EventRing *ring = (SDL_EventRing *)SDL_calloc(1, sizeof(*ring));
+        int i;
+
+        if (ring == NULL) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < SDL_EVENT_RING_ENTRIES; ++i) {
+            SDL_AtomicSet(&ring->entries[i].sequence, i);
+        }
+        SDL_AtomicSet(&ring->enqueue_pos, 0);
+        SDL_AtomicSet(&ring->dequeue_pos, 0);
+        SDL_EventQ.ring = ring;
+    }
+
     /* Process most event types */
     SDL_EventState(SDL_TEXTINPUT, SDL_DISABLE);
     SDL_EventState(SDL_TEXTEDITING, SDL_DISABLE);
@@ -546,13 +633,168 @@ SDL_StartEventLoop(void)
 }
 
 
+/* Returns SDL_TRUE if newer events of this type make older ones from the same source redundant */
+static SDL_bool
+SDL_IsCoalescableEvent(Uint32 type)
+{
+    switch (type) {
+    case SDL_MOUSEMOTION:
+    case SDL_FINGERMOTION:
+    case SDL_JOYAXISMOTION:
+    case SDL_CONTROLLERAXISMOTION:
+    case SDL_SENSORUPDATE:
+    case SDL_CONTROLLERSENSORUPDATE:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* Returns SDL_TRUE if both events are of the same type and come from the same device, axis or finger */
+static SDL_bool
+SDL_IsSameEventSource(const SDL_Event *a, const SDL_Event *b)
+{
+    if (a->type != b->type) {
+        return SDL_FALSE;
+    }
+
+    switch (a->type) {
+    case SDL_MOUSEMOTION:
+        return (a->motion.windowID == b->motion.windowID && a->motion.which == b->motion.which);
+    case SDL_FINGERMOTION:
+        return (a->tfinger.touchId == b->tfinger.touchId && a->tfinger.fingerId == b->tfinger.fingerId &&
+                a->tfinger.windowID == b->tfinger.windowID);
+    case SDL_JOYAXISMOTION:
+        return (a->jaxis.which == b->jaxis.which && a->jaxis.axis == b->jaxis.axis);
+    case SDL_CONTROLLERAXISMOTION:
+        return (a->caxis.which == b->caxis.which && a->caxis.axis == b->caxis.axis);
+    case SDL_SENSORUPDATE:
+        return (a->sensor.which == b->sensor.which);
+    case SDL_CONTROLLERSENSORUPDATE:
+        return (a->csensor.which == b->csensor.which && a->csensor.sensor == b->csensor.sensor);
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* How many queued events we'll look back through for one to merge with */
+#define SDL_MAX_COALESCE_DISTANCE   16
+
+/* Merge an event into a queued event from the same source */
+static void
+SDL_MergeEvent(SDL_Event *queued, const SDL_Event *event)
+{
+    if (event->type == SDL_MOUSEMOTION) {
+        const Sint32 xrel = queued->motion.xrel;
+        const Sint32 yrel = queued->motion.yrel;
+        *queued = *event;
+        queued->motion.xrel += xrel;
+        queued->motion.yrel += yrel;
+    } else if (event->type == SDL_FINGERMOTION) {
+        const float dx = queued->tfinger.dx;
+        const float dy = queued->tfinger.dy;
+        *queued = *event;
+        queued->tfinger.dx += dx;
+        queued->tfinger.dy += dy;
+    } else {
+        /* Axis and sensor events carry absolute values, the newest one wins */
+        *queued = *event;
+    }
+    ++SDL_EventQ.coalesced_events;
+}
+
+/* Merge an event into a queued event from the same source -- called with the queue locked
+
+   We only look back through other motion events, anything else (like a
+   button press) is a barrier that the motion can't be moved across.
+ */
+static SDL_bool
+SDL_CoalesceEvent(const SDL_Event *event, Uint64 timestamp_ns)
+{
+    SDL_EventEntry *entry;
+    int distance = 0;
+
+    if (!SDL_IsCoalescableEvent(event->type)) {
+        return SDL_FALSE;
+    }
+
+    for (entry = SDL_EventQ.tail; entry && distance < SDL_MAX_COALESCE_DISTANCE; entry = entry->prev, ++distance) {
+        if (!SDL_IsCoalescableEvent(entry->event.type)) {
+            break;
+        }
+        if (SDL_IsSameEventSource(&entry->event, event)) {
+            SDL_MergeEvent(&entry->event, event);
+            entry->timestamp_ns = timestamp_ns;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Merge an event into an event in the lock-free ring -- called with the queue locked
+
+   Consumers hold the lock too, so the published entries stay put while we
+   look at them. An entry another producer is still filling is a barrier,
+   just like an event that can't be merged.
+ */
+static SDL_bool
+SDL_CoalesceEventRing(const SDL_Event *event, Uint64 timestamp_ns)
+{
+    SDL_EventRing *ring = SDL_EventQ.ring;
+    const unsigned queue_pos = (unsigned)SDL_AtomicGet(&ring->dequeue_pos);
+    unsigned pos = (unsigned)SDL_AtomicGet(&ring->enqueue_pos);
+    int distance = 0;
+
+    if (!SDL_IsCoalescableEvent(event->type)) {
+        return SDL_FALSE;
+    }
+
+    for ( ; pos != queue_pos && distance < SDL_MAX_COALESCE_DISTANCE; ++distance) {
+        SDL_EventRingEntry *entry = &ring->entries[--pos & SDL_EVENT_RING_MASK];
+
+        if ((unsigned)SDL_AtomicGet(&entry->sequence) != pos + 1) {
+            break;
+        }
+        if (!SDL_IsCoalescableEvent(entry->event.type)) {
+            break;
+        }
+        if (SDL_IsSameEventSource(&entry->event, event)) {
+            SDL_MergeEvent(&entry->event, event);
+            entry->timestamp_ns = timestamp_ns;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Count an event that was just queued, and remember the most we've seen */
+static void
+SDL_CountQueuedEvent(void)
+{
+    const int count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
+    int max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+
+    while (count > max_events_seen) {
+        if (SDL_AtomicCAS(&SDL_EventQ.max_events_seen, max_events_seen, count)) {
+            break;
+        }
+        max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    }
+}
+
 /* Add an event to the event queue -- called with the queue locked */
 static int
-SDL_AddEvent(SDL_Event * event)
+SDL_AddEvent(SDL_Event * event, Uint64 timestamp_ns)
 {
     SDL_EventEntry *entry;
     const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
+
+    if (SDL_DoEventCoalescing && SDL_CoalesceEvent(event, timestamp_ns)) {
+        if (SDL_DoEventLogging) {
+            SDL_LogEvent(event);
+        }
+        return 1;
+    }
 
     if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
         SDL_SetError("Event queue is full (%d events)", initial_count);
@@ -574,6 +816,7 @@ SDL_AddEvent(SDL_Event * event)
     }
 
     entry->event = *event;
+    entry->timestamp_ns = timestamp_ns;
     if (event->type == SDL_SYSWMEVENT) {
         entry->msg = *event->syswm.msg;
         entry->event.syswm.msg = &entry->msg;
@@ -592,10 +835,7 @@ SDL_AddEvent(SDL_Event * event)
         entry->next = NULL;
     }
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
-    }
+    SDL_CountQueuedEvent();
 
     return 1;
 }
@@ -626,6 +866,167 @@ SDL_CutEvent(SDL_EventEntry *entry)
     SDL_AtomicAdd(&SDL_EventQ.count, -1);
 }
 
+/* Add an event to the lock-free ring -- called without the queue lock */
+static int
+SDL_AddEventRing(SDL_Event * event, Uint64 timestamp_ns)
+{
+    SDL_EventRing *ring = SDL_EventQ.ring;
+    SDL_EventRingEntry *entry;
+    SDL_SysWMmsg *msg = NULL;
+    unsigned queue_pos;
+    unsigned entry_seq;
+    int delta;
+
+    if (event->type == SDL_SYSWMEVENT) {
+        msg = (SDL_SysWMmsg *)SDL_malloc(sizeof(*msg));
+        if (!msg) {
+            return 0;
+        }
+        *msg = *event->syswm.msg;
+    }
+
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
+
+    queue_pos = (unsigned)SDL_AtomicGet(&ring->enqueue_pos);
+    for ( ; ; ) {
+        entry = &ring->entries[queue_pos & SDL_EVENT_RING_MASK];
+        entry_seq = (unsigned)SDL_AtomicGet(&entry->sequence);
+
+        delta = (int)(entry_seq - queue_pos);
+        if (delta == 0) {
+            /* The entry and the queue position match, try to increment the queue position */
+            if (SDL_AtomicCAS(&ring->enqueue_pos, (int)queue_pos, (int)(queue_pos+1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* We ran into an entry that still needs to be dequeued */
+            SDL_free(msg);
+            SDL_SetError("Event queue is full (%d events)", SDL_EVENT_RING_ENTRIES);
+            return 0;
+        } else {
+            /* Another producer claimed this entry, get the new queue position */
+            queue_pos = (unsigned)SDL_AtomicGet(&ring->enqueue_pos);
+        }
+    }
+
+    /* We own the entry, fill it and publish it to the consumers */
+    entry->event = *event;
+    entry->msg = msg;
+    if (msg) {
+        entry->event.syswm.msg = msg;
+    }
+    entry->timestamp_ns = timestamp_ns;
+    entry->removed = SDL_FALSE;
+    SDL_CountQueuedEvent();  /* before a consumer can take it out again */
+    SDL_AtomicSet(&entry->sequence, (int)(queue_pos + 1));
+
+    return 1;
+}
+
+/* Remove the entries marked as removed in [queue_pos, end_pos) from the ring -- called with the queue locked
+
+   The surviving entries slide toward end_pos, so the freed entries are always
+   at the front of the ring and can be handed straight back to the producers.
+ */
+static void
+SDL_CutEventRing(unsigned queue_pos, unsigned end_pos)
+{
+    SDL_EventRing *ring = SDL_EventQ.ring;
+    unsigned src, dst = end_pos;
+
+    for (src = end_pos; src-- != queue_pos; ) {
+        SDL_EventRingEntry *entry = &ring->entries[src & SDL_EVENT_RING_MASK];
+        if (entry->removed) {
+            SDL_free(entry->msg);
+            entry->msg = NULL;
+        } else if (--dst != src) {
+            SDL_EventRingEntry *target = &ring->entries[dst & SDL_EVENT_RING_MASK];
+            target->event = entry->event;
+            target->msg = entry->msg;
+            target->timestamp_ns = entry->timestamp_ns;
+            target->removed = SDL_FALSE;
+            entry->msg = NULL;
+        }
+    }
+
+    for (src = queue_pos; src != dst; ++src) {
+        SDL_AtomicSet(&ring->entries[src & SDL_EVENT_RING_MASK].sequence, (int)(src + SDL_EVENT_RING_ENTRIES));
+    }
+    SDL_AtomicSet(&ring->dequeue_pos, (int)dst);
+    SDL_AtomicAdd(&SDL_EventQ.count, -(int)(dst - queue_pos));
+}
+
+/* Copy a wmmsg somewhere safe -- called with the queue locked
+
+   For now we'll guarantee it's valid at least until the next call to SDL_PeepEvents()
+ */
+static SDL_SysWMmsg *
+SDL_StashSysWMMsg(const SDL_SysWMmsg *msg)
+{
+    SDL_SysWMEntry *wmmsg;
+
+    if (SDL_EventQ.wmmsg_free) {
+        wmmsg = SDL_EventQ.wmmsg_free;
+        SDL_EventQ.wmmsg_free = wmmsg->next;
+    } else {
+        wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
+        if (!wmmsg) {
+            return NULL;
+        }
+    }
+    wmmsg->msg = *msg;
+    wmmsg->next = SDL_EventQ.wmmsg_used;
+    SDL_EventQ.wmmsg_used = wmmsg;
+    return &wmmsg->msg;
+}
+
+/* Take a peep at the lock-free ring -- called with the queue locked */
+static int
+SDL_PeepEventRing(SDL_Event * events, Uint64 * timestamps, int numevents, SDL_eventaction action,
+                  Uint32 minType, Uint32 maxType)
+{
+    SDL_EventRing *ring = SDL_EventQ.ring;
+    const unsigned queue_pos = (unsigned)SDL_AtomicGet(&ring->dequeue_pos);
+    unsigned pos, cut_pos = queue_pos;
+    int used = 0;
+
+    for (pos = queue_pos; !events || used < numevents; ++pos) {
+        SDL_EventRingEntry *entry = &ring->entries[pos & SDL_EVENT_RING_MASK];
+        Uint32 type;
+
+        if ((unsigned)SDL_AtomicGet(&entry->sequence) != pos + 1) {
+            /* We ran into an entry that hasn't been published yet */
+            break;
+        }
+
+        type = entry->event.type;
+        if (minType <= type && type <= maxType) {
+            if (events) {
+                events[used] = entry->event;
+                if (type == SDL_SYSWMEVENT) {
+                    events[used].syswm.msg = SDL_StashSysWMMsg(entry->msg);
+                }
+                if (timestamps) {
+                    timestamps[used] = entry->timestamp_ns;
+                }
+
+                if (action == SDL_GETEVENT) {
+                    entry->removed = SDL_TRUE;
+                    cut_pos = pos + 1;
+                }
+            }
+            ++used;
+        }
+    }
+
+    if (cut_pos != queue_pos) {
+        SDL_CutEventRing(queue_pos, cut_pos);
+    }
+    return used;
+}
+
 static int
 SDL_SendWakeupEvent()
 {
@@ -648,9 +1049,9 @@ SDL_SendWakeupEvent()
 }
 
 /* Lock the event queue, take a peep at it, and unlock it */
-int
-SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
-               Uint32 minType, Uint32 maxType)
+static int
+SDL_PeepEventsInternal(SDL_Event * events, Uint64 * timestamps, int numevents, SDL_eventaction action,
+                       Uint32 minType, Uint32 maxType)
 {
     int i, used;
 
@@ -662,12 +1063,51 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
         }
         return (-1);
     }
-    /* Lock the event queue */
+    /* The lock-free ring doesn't need the lock to add events */
     used = 0;
+    if (SDL_EventQ.ring && action == SDL_ADDEVENT) {
+        const Uint64 now = timestamps ? 0 : SDL_GetPerformanceCounterNS();
+
+        /* Hold the ring while we use it, and check again that we haven't
+           quit: SDL_StopEventLoop() waits for us only after it clears the
+           active flag. */
+        SDL_AtomicIncRef(&SDL_EventQ.ring_producers);
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+            SDL_AtomicDecRef(&SDL_EventQ.ring_producers);
+            return (-1);
+        }
+        for (i = 0; i < numevents; ++i) {
+            const Uint64 timestamp_ns = timestamps ? timestamps[i] : now;
+
+            /* Merging needs the lock, but only motion events pay for it */
+            if (SDL_DoEventCoalescing && SDL_IsCoalescableEvent(events[i].type) &&
+                SDL_EventQ.lock && SDL_LockMutex(SDL_EventQ.lock) == 0) {
+                const SDL_bool merged = SDL_CoalesceEventRing(&events[i], timestamp_ns);
+                SDL_UnlockMutex(SDL_EventQ.lock);
+                if (merged) {
+                    if (SDL_DoEventLogging) {
+                        SDL_LogEvent(&events[i]);
+                    }
+                    ++used;
+                    continue;
+                }
+            }
+            used += SDL_AddEventRing(&events[i], timestamp_ns);
+        }
+        SDL_AtomicDecRef(&SDL_EventQ.ring_producers);
+
+        if (used > 0) {
+            SDL_SendWakeupEvent();
+        }
+        return (used);
+    }
+
+    /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         if (action == SDL_ADDEVENT) {
+            const Uint64 now = timestamps ? 0 : SDL_GetPerformanceCounterNS();
             for (i = 0; i < numevents; ++i) {
-                used += SDL_AddEvent(&events[i]);
+                used += SDL_AddEvent(&events[i], timestamps ? timestamps[i] : now);
             }
         } else {
             SDL_EventEntry *entry, *next;
@@ -686,6 +1126,10 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                 SDL_EventQ.wmmsg_used = NULL;
             }
 
+            if (SDL_EventQ.ring) {
+                used = SDL_PeepEventRing(events, timestamps, numevents, action, minType, maxType);
+            }
+
             for (entry = SDL_EventQ.head; entry && (!events || used < numevents); entry = next) {
                 next = entry->next;
                 type = entry->event.type;
@@ -693,20 +1137,11 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                     if (events) {
                         events[used] = entry->event;
                         if (entry->event.type == SDL_SYSWMEVENT) {
-                            /* We need to copy the wmmsg somewhere safe.
-                               For now we'll guarantee it's valid at least until
-                               the next call to SDL_PeepEvents()
-                             */
-                            if (SDL_EventQ.wmmsg_free) {
-                                wmmsg = SDL_EventQ.wmmsg_free;
-                                SDL_EventQ.wmmsg_free = wmmsg->next;
-                            } else {
-                                wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
-                            }
-                            wmmsg->msg = *entry->event.syswm.msg;
-                            wmmsg->next = SDL_EventQ.wmmsg_used;
-                            SDL_EventQ.wmmsg_used = wmmsg;
-                            events[used].syswm.msg = &wmmsg->msg;
+                            /* We need to copy the wmmsg somewhere safe. */
+                            events[used].syswm.msg = SDL_StashSysWMMsg(entry->event.syswm.msg);
+                        }
+                        if (timestamps) {
+                            timestamps[used] = entry->timestamp_ns;
                         }
 
                         if (action == SDL_GETEVENT) {
@@ -731,6 +1166,20 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
     return (used);
 }
 
+int
+SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
+               Uint32 minType, Uint32 maxType)
+{
+    return SDL_PeepEventsInternal(events, NULL, numevents, action, minType, maxType);
+}
+
+int
+SDL_PeepEventsTimestamped(SDL_Event * events, Uint64 * timestamps, int numevents, SDL_eventaction action,
+                          Uint32 minType, Uint32 maxType)
+{
+    return SDL_PeepEventsInternal(events, timestamps, numevents, action, minType, maxType);
+}
+
 SDL_bool
 SDL_HasEvent(Uint32 type)
 {
@@ -773,6 +1222,22 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
         Uint32 type;
+        if (SDL_EventQ.ring) {
+            SDL_EventRing *ring = SDL_EventQ.ring;
+            const unsigned queue_pos = (unsigned)SDL_AtomicGet(&ring->dequeue_pos);
+            unsigned pos, cut_pos = queue_pos;
+            for (pos = queue_pos; (unsigned)SDL_AtomicGet(&ring->entries[pos & SDL_EVENT_RING_MASK].sequence) == pos + 1; ++pos) {
+                SDL_EventRingEntry *ring_entry = &ring->entries[pos & SDL_EVENT_RING_MASK];
+                type = ring_entry->event.type;
+                if (minType <= type && type <= maxType) {
+                    ring_entry->removed = SDL_TRUE;
+                    cut_pos = pos + 1;
+                }
+            }
+            if (cut_pos != queue_pos) {
+                SDL_CutEventRing(queue_pos, cut_pos);
+            }
+        }
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             type = entry->event.type;
@@ -825,6 +1290,55 @@ SDL_PollEvent(SDL_Event * event)
     return SDL_WaitEventTimeout(event, 0);
 }
 
+int
+SDL_PollEvents(SDL_Event * events, int numevents)
+{
+    int i, used;
+
+    if (!events) {
+        return SDL_InvalidParamError("events");
+    }
+    if (numevents <= 0) {
+        return 0;
+    }
+
+    SDL_PumpEvents();
+
+    used = SDL_PeepEvents(events, numevents, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+    /* We only pumped once, so any poll sentinels left over from SDL_PollEvent() are meaningless */
+    for (i = 0; i < used; ) {
+        if (events[i].type == SDL_POLLSENTINEL) {
+            --used;
+            if (i < used) {
+                SDL_memmove(&events[i], &events[i+1], (used - i) * sizeof(events[i]));
+            }
+        } else {
+            ++i;
+        }
+    }
+    return used;
+}
+
+int
+SDL_GetEventQueueStats(SDL_EventQueueStats * stats)
+{
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    if (SDL_EventQ.lock && SDL_LockMutex(SDL_EventQ.lock) < 0) {
+        return SDL_SetError("Couldn't lock event queue");
+    }
+    stats->queued_events = SDL_AtomicGet(&SDL_EventQ.count);
+    stats->max_queued_events = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    stats->coalesced_events = SDL_EventQ.coalesced_events;
+    if (SDL_EventQ.lock) {
+        SDL_UnlockMutex(SDL_EventQ.lock);
+    }
+    return 0;
+}
+
 static SDL_bool
 SDL_events_need_periodic_poll() {
     SDL_bool need_periodic_poll = SDL_FALSE;
@@ -1019,6 +1533,12 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
 
 int
 SDL_PushEvent(SDL_Event * event)
+{
+    return SDL_PushEventTimestamped(event, SDL_GetPerformanceCounterNS());
+}
+
+int
+SDL_PushEventTimestamped(SDL_Event * event, Uint64 timestamp_ns)
 {
     event->common.timestamp = SDL_GetTicks();
 
@@ -1062,7 +1582,7 @@ SDL_PushEvent(SDL_Event * event)
         }
     }
 
-    if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
+    if (SDL_PeepEventsInternal(event, &timestamp_ns, 1, SDL_ADDEVENT, 0, 0) <= 0) {
         return -1;
     }
 
@@ -1166,6 +1686,21 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        if (SDL_EventQ.ring) {
+            SDL_EventRing *ring = SDL_EventQ.ring;
+            const unsigned queue_pos = (unsigned)SDL_AtomicGet(&ring->dequeue_pos);
+            unsigned pos, cut_pos = queue_pos;
+            for (pos = queue_pos; (unsigned)SDL_AtomicGet(&ring->entries[pos & SDL_EVENT_RING_MASK].sequence) == pos + 1; ++pos) {
+                SDL_EventRingEntry *ring_entry = &ring->entries[pos & SDL_EVENT_RING_MASK];
+                if (!filter(userdata, &ring_entry->event)) {
+                    ring_entry->removed = SDL_TRUE;
+                    cut_pos = pos + 1;
+                }
+            }
+            if (cut_pos != queue_pos) {
+                SDL_CutEventRing(queue_pos, cut_pos);
+            }
+        }
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             if (!filter(userdata, &entry->event)) {
@@ -1305,8 +1840,10 @@ SDL_EventsInit(void)
     SDL_AddHintCallback(SDL_HINT_AUTO_UPDATE_SENSORS, SDL_AutoUpdateSensorsChanged, NULL);
 #endif
     SDL_AddHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_AddHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     SDL_AddHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
     if (SDL_StartEventLoop() < 0) {
+        SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
         SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
         return -1;
     }
@@ -1322,6 +1859,7 @@ SDL_EventsQuit(void)
     SDL_QuitQuit();
     SDL_StopEventLoop();
     SDL_DelHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
+    SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
 #if !SDL_JOYSTICK_DISABLED
     SDL_DelHintCallback(SDL_HINT_AUTO_UPDATE_JOYSTICKS, SDL_AutoUpdateJoysticksChanged, NULL);
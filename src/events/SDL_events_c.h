@@ -43,6 +43,9 @@ extern int SDL_StartEventLoop(void);
 extern void SDL_StopEventLoop(void);
 extern void SDL_QuitInterrupt(void);
 
+/* Push an event stamped with the SDL_GetPerformanceCounterNS() time it was produced */
+extern int SDL_PushEventTimestamped(SDL_Event * event, Uint64 timestamp_ns);
+
 extern int SDL_SendAppEvent(SDL_EventType eventType);
 extern int SDL_SendSysWMEvent(SDL_SysWMmsg * message);
 extern int SDL_SendKeymapChangedEvent(void);
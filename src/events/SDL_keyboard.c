@@ -671,6 +671,7 @@ SDL_SetKeyboardFocus(SDL_Window * window)
 static int
 SDL_SendKeyboardKeyInternal(Uint8 source, Uint8 state, SDL_Scancode scancode)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     SDL_Keyboard *keyboard = &SDL_keyboard;
     int posted;
     SDL_Keymod modifier;
@@ -789,7 +790,7 @@ SDL_SendKeyboardKeyInternal(Uint8 source, Uint8 state, SDL_Scancode scancode)
         event.key.keysym.sym = keycode;
         event.key.keysym.mod = keyboard->modstate;
         event.key.windowID = keyboard->focus ? keyboard->focus->id : 0;
-        posted = (SDL_PushEvent(&event) > 0);
+        posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
     }
 
     /* If the keyboard is grabbed and the grabbed window is in full-screen,
@@ -317,6 +317,7 @@ GetScaledMouseDelta(float scale, int value, float *accum)
 static int
 SDL_PrivateSendMouseMotion(SDL_Window * window, SDL_MouseID mouseID, int relative, int x, int y)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     SDL_Mouse *mouse = SDL_GetMouse();
     int posted;
     int xrel;
@@ -470,7 +471,7 @@ SDL_PrivateSendMouseMotion(SDL_Window * window, SDL_MouseID mouseID, int relativ
         event.motion.y = mouse->y;
         event.motion.xrel = xrel;
         event.motion.yrel = yrel;
-        posted = (SDL_PushEvent(&event) > 0);
+        posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
     }
     if (relative) {
         mouse->last_x = mouse->x;
@@ -528,6 +529,7 @@ static SDL_MouseClickState *GetMouseClickState(SDL_Mouse *mouse, Uint8 button)
 static int
 SDL_PrivateSendMouseButton(SDL_Window * window, SDL_MouseID mouseID, Uint8 state, Uint8 button, int clicks)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     SDL_Mouse *mouse = SDL_GetMouse();
     int posted;
     Uint32 type;
@@ -625,7 +627,7 @@ SDL_PrivateSendMouseButton(SDL_Window * window, SDL_MouseID mouseID, Uint8 state
         event.button.clicks = (Uint8) SDL_min(clicks, 255);
         event.button.x = mouse->x;
         event.button.y = mouse->y;
-        posted = (SDL_PushEvent(&event) > 0);
+        posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
     }
 
     /* We do this after dispatching event so button releases can lose focus */
@@ -652,6 +654,7 @@ SDL_SendMouseButton(SDL_Window * window, SDL_MouseID mouseID, Uint8 state, Uint8
 int
 SDL_SendMouseWheel(SDL_Window * window, SDL_MouseID mouseID, float x, float y, SDL_MouseWheelDirection direction)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     SDL_Mouse *mouse = SDL_GetMouse();
     int posted;
     int integral_x, integral_y;
@@ -714,7 +717,7 @@ SDL_SendMouseWheel(SDL_Window * window, SDL_MouseID mouseID, float x, float y, S
         event.wheel.preciseX = x;
         event.wheel.preciseY = y;
         event.wheel.direction = (Uint32)direction;
-        posted = (SDL_PushEvent(&event) > 0);
+        posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
     }
     return posted;
 }
@@ -23,6 +23,7 @@
 /* General touch handling code for SDL */
 
 #include "SDL_events.h"
+#include "SDL_timer.h"
 #include "SDL_events_c.h"
 #include "../video/SDL_sysvideo.h"
 
@@ -241,6 +242,7 @@ int
 SDL_SendTouch(SDL_TouchID id, SDL_FingerID fingerid, SDL_Window * window,
               SDL_bool down, float x, float y, float pressure)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     int posted;
     SDL_Finger *finger;
     SDL_Mouse *mouse;
@@ -322,7 +324,7 @@ SDL_SendTouch(SDL_TouchID id, SDL_FingerID fingerid, SDL_Window * window,
             event.tfinger.dy = 0;
             event.tfinger.pressure = pressure;
             event.tfinger.windowID = window ? SDL_GetWindowID(window) : 0;
-            posted = (SDL_PushEvent(&event) > 0);
+            posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
         }
     } else {
         if (!finger) {
@@ -343,7 +345,7 @@ SDL_SendTouch(SDL_TouchID id, SDL_FingerID fingerid, SDL_Window * window,
             event.tfinger.dy = 0;
             event.tfinger.pressure = pressure;
             event.tfinger.windowID = window ? SDL_GetWindowID(window) : 0;
-            posted = (SDL_PushEvent(&event) > 0);
+            posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
         }
 
         SDL_DelFinger(touch, fingerid);
@@ -355,6 +357,7 @@ int
 SDL_SendTouchMotion(SDL_TouchID id, SDL_FingerID fingerid, SDL_Window * window,
                     float x, float y, float pressure)
 {
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
     SDL_Touch *touch;
     SDL_Finger *finger;
     SDL_Mouse *mouse;
@@ -431,7 +434,7 @@ SDL_SendTouchMotion(SDL_TouchID id, SDL_FingerID fingerid, SDL_Window * window,
         event.tfinger.dy = yrel;
         event.tfinger.pressure = pressure;
         event.tfinger.windowID = window ? SDL_GetWindowID(window) : 0;
-        posted = (SDL_PushEvent(&event) > 0);
+        posted = (SDL_PushEventTimestamped(&event, timestamp) > 0);
     }
     return posted;
 }
@@ -1369,6 +1369,9 @@ void SDL_PrivateJoystickRemoved(SDL_JoystickID device_instance)
 int
 SDL_PrivateJoystickAxis(SDL_Joystick *joystick, Uint8 axis, Sint16 value)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int posted;
     SDL_JoystickAxisInfo *info;
 
@@ -1424,7 +1427,7 @@ SDL_PrivateJoystickAxis(SDL_Joystick *joystick, Uint8 axis, Sint16 value)
         event.jaxis.which = joystick->instance_id;
         event.jaxis.axis = axis;
         event.jaxis.value = value;
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -1433,6 +1436,9 @@ SDL_PrivateJoystickAxis(SDL_Joystick *joystick, Uint8 axis, Sint16 value)
 int
 SDL_PrivateJoystickHat(SDL_Joystick *joystick, Uint8 hat, Uint8 value)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int posted;
 
     /* Make sure we're not getting garbage or duplicate events */
@@ -1464,7 +1470,7 @@ SDL_PrivateJoystickHat(SDL_Joystick *joystick, Uint8 hat, Uint8 value)
         event.jhat.which = joystick->instance_id;
         event.jhat.hat = hat;
         event.jhat.value = value;
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -1474,6 +1480,9 @@ int
 SDL_PrivateJoystickBall(SDL_Joystick *joystick, Uint8 ball,
                         Sint16 xrel, Sint16 yrel)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int posted;
 
     /* Make sure we're not getting garbage events */
@@ -1500,7 +1509,7 @@ SDL_PrivateJoystickBall(SDL_Joystick *joystick, Uint8 ball,
         event.jball.ball = ball;
         event.jball.xrel = xrel;
         event.jball.yrel = yrel;
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -1509,6 +1518,9 @@ SDL_PrivateJoystickBall(SDL_Joystick *joystick, Uint8 ball,
 int
 SDL_PrivateJoystickButton(SDL_Joystick *joystick, Uint8 button, Uint8 state)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int posted;
 #if !SDL_EVENTS_DISABLED
     SDL_Event event;
@@ -1552,7 +1564,7 @@ SDL_PrivateJoystickButton(SDL_Joystick *joystick, Uint8 button, Uint8 state)
         event.jbutton.which = joystick->instance_id;
         event.jbutton.button = button;
         event.jbutton.state = state;
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -2704,6 +2716,9 @@ SDL_JoystickPowerLevel SDL_JoystickCurrentPowerLevel(SDL_Joystick *joystick)
 
 int SDL_PrivateJoystickTouchpad(SDL_Joystick *joystick, int touchpad, int finger, Uint8 state, float x, float y, float pressure)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     SDL_JoystickTouchpadInfo *touchpad_info;
     SDL_JoystickTouchpadFingerInfo *finger_info;
     int posted;
@@ -2788,7 +2803,7 @@ int SDL_PrivateJoystickTouchpad(SDL_Joystick *joystick, int touchpad, int finger
         event.ctouchpad.x = x;
         event.ctouchpad.y = y;
         event.ctouchpad.pressure = pressure;
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -2796,6 +2811,9 @@ int SDL_PrivateJoystickTouchpad(SDL_Joystick *joystick, int touchpad, int finger
 
 int SDL_PrivateJoystickSensor(SDL_Joystick *joystick, SDL_SensorType type, const float *data, int num_values)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int i;
     int posted = 0;
 
@@ -2824,7 +2842,7 @@ int SDL_PrivateJoystickSensor(SDL_Joystick *joystick, SDL_SensorType type, const
                     num_values = SDL_min(num_values, SDL_arraysize(event.csensor.data));
                     SDL_memset(event.csensor.data, 0, sizeof(event.csensor.data));
                     SDL_memcpy(event.csensor.data, data, num_values*sizeof(*data));
-                    posted = SDL_PushEvent(&event) == 1;
+                    posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
                 }
 #endif /* !SDL_EVENTS_DISABLED */
             }
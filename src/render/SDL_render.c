@@ -24,8 +24,10 @@
 
 #include "SDL_hints.h"
 #include "SDL_render.h"
+#include "SDL_timer.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../thread/SDL_systhread.h"
 #include "../video/SDL_pixels_c.h"
 
 #if defined(__ANDROID__)
@@ -227,37 +229,580 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 #endif
 }
 
+/* How many groups of draws a draw may move back past to join one that
+   shares its state. */
+#define REORDER_MAX_LOOKBACK 16
+
+/* Draws that end up next to each other in the queue and get merged. */
+typedef struct SDL_RenderCommandGroup
+{
+    SDL_RenderCommand *head;
+    SDL_RenderCommand *tail;
+    size_t count;
+    size_t vertsize;
+    SDL_FRect bounds;
+} SDL_RenderCommandGroup;
+
+static SDL_bool
+CanMergeRenderCommands(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    if (a->data.draw.texture == b->data.draw.texture &&
+        a->data.draw.blend == b->data.draw.blend &&
+        a->data.draw.r == b->data.draw.r &&
+        a->data.draw.g == b->data.draw.g &&
+        a->data.draw.b == b->data.draw.b &&
+        a->data.draw.a == b->data.draw.a) {
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
+static SDL_bool
+RenderBoundsOverlap(const SDL_FRect *a, const SDL_FRect *b)
+{
+    if (a->x + a->w <= b->x || b->x + b->w <= a->x ||
+        a->y + a->h <= b->y || b->y + b->h <= a->y) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Where the vertices of the queue being recorded start; the offsets that
+   SDL_AllocateRenderVertices() hands out are from here. */
+static SDL_INLINE Uint8 *
+GetRenderVertices(SDL_Renderer *renderer)
+{
+    return ((Uint8 *) renderer->vertex_data) + renderer->vertex_data_base;
+}
+
+/* Regroups a run of geometry commands whose vertices sit back to back in
+   vertex_data, and merges each group into its first command. A draw only
+   moves back past draws it doesn't overlap, so the result looks the same.
+   Returns the last command of the run once it's done. */
+static SDL_RenderCommand *
+ReorderRenderCommandRun(SDL_Renderer *renderer, SDL_RenderCommand *prev, SDL_RenderCommand *first, SDL_RenderCommand *last, int count)
+{
+    SDL_RenderCommand *end = last->next;
+    SDL_RenderCommand *cmd;
+    SDL_RenderCommand *next;
+    SDL_RenderCommandGroup *groups;
+    const size_t base = first->data.draw.first;
+    const size_t runsize = (last->data.draw.first + last->data.draw.vertsize) - base;
+    SDL_bool moved = SDL_FALSE;
+    int num_groups = 0;
+    size_t offset;
+    int i;
+
+    /* Get all the memory up front, nothing below may fail once the
+       commands start getting relinked. */
+    if (renderer->reorder_groups_allocated < count) {
+        groups = (SDL_RenderCommandGroup *) SDL_realloc(renderer->reorder_groups, count * sizeof (*groups));
+        if (!groups) {
+            return last;
+        }
+        renderer->reorder_groups = groups;
+        renderer->reorder_groups_allocated = count;
+    }
+    if (renderer->reorder_vertices_allocated < runsize) {
+        void *ptr = SDL_realloc(renderer->reorder_vertices, runsize);
+        if (!ptr) {
+            return last;
+        }
+        renderer->reorder_vertices = ptr;
+        renderer->reorder_vertices_allocated = runsize;
+    }
+    groups = renderer->reorder_groups;
+
+    for (cmd = first, i = 0; i < count; cmd = next, ++i) {
+        SDL_RenderCommandGroup *group;
+        int target = -1;
+        int j;
+
+        next = cmd->next;
+
+        for (j = num_groups - 1; j >= 0 && j >= num_groups - REORDER_MAX_LOOKBACK; --j) {
+            if (CanMergeRenderCommands(groups[j].head, cmd)) {
+                target = j;
+                break;
+            }
+            if (RenderBoundsOverlap(&groups[j].bounds, &cmd->data.draw.bounds)) {
+                break;
+            }
+        }
+
+        /* Every draw but the last one of a run fills its space up to the
+           next one, so it's a multiple of whatever alignment the backend
+           asked for. The last one isn't, and moving it back would shift
+           everything after it off that alignment. */
+        if (target >= 0 && target != num_groups - 1 && i == count - 1) {
+            target = -1;
+        }
+
+        if (target < 0) {
+            group = &groups[num_groups++];
+            group->head = cmd;
+            group->tail = cmd;
+            group->count = cmd->data.draw.count;
+            group->vertsize = cmd->data.draw.vertsize;
+            group->bounds = cmd->data.draw.bounds;
+        } else {
+            const SDL_FRect *a = &groups[target].bounds;
+            const SDL_FRect *b = &cmd->data.draw.bounds;
+            const float minx = SDL_min(a->x, b->x);
+            const float miny = SDL_min(a->y, b->y);
+            const float maxx = SDL_max(a->x + a->w, b->x + b->w);
+            const float maxy = SDL_max(a->y + a->h, b->y + b->h);
+
+            group = &groups[target];
+            group->tail->next = cmd;
+            group->tail = cmd;
+            group->count += cmd->data.draw.count;
+            group->vertsize += cmd->data.draw.vertsize;
+            group->bounds.x = minx;
+            group->bounds.y = miny;
+            group->bounds.w = maxx - minx;
+            group->bounds.h = maxy - miny;
+            if (target != num_groups - 1) {
+                moved = SDL_TRUE;
+            }
+        }
+    }
+
+    if (num_groups == count) {
+        return last;  /* nothing to merge, the list wasn't touched. */
+    }
+
+    /* Lay the vertices out in the new order, so each group's are contiguous. */
+    if (moved) {
+        Uint8 *dst = (Uint8 *) renderer->reorder_vertices;
+        const Uint8 *src = GetRenderVertices(renderer);
+        for (i = 0; i < num_groups; ++i) {
+            for (cmd = groups[i].head; ; cmd = cmd->next) {
+                SDL_memcpy(dst, src + cmd->data.draw.first, cmd->data.draw.vertsize);
+                dst += cmd->data.draw.vertsize;
+                if (cmd == groups[i].tail) {
+                    break;
+                }
+            }
+        }
+        SDL_memcpy(GetRenderVertices(renderer) + base, renderer->reorder_vertices, runsize);
+    }
+
+    /* Keep the first command of each group, give the rest back to the pool. */
+    offset = base;
+    for (i = 0; i < num_groups; ++i) {
+        SDL_RenderCommandGroup *group = &groups[i];
+        if (group->head != group->tail) {
+            cmd = group->head->next;
+            for (;;) {
+                const SDL_bool done = (cmd == group->tail);
+                next = cmd->next;
+                cmd->next = renderer->render_commands_pool;
+                renderer->render_commands_pool = cmd;
+                if (done) {
+                    break;
+                }
+                cmd = next;
+            }
+        }
+
+        cmd = group->head;
+        cmd->data.draw.first = offset;
+        cmd->data.draw.count = group->count;
+        cmd->data.draw.vertsize = group->vertsize;
+        cmd->data.draw.bounds = group->bounds;
+        offset += group->vertsize;
+
+        if (i == 0) {
+            if (prev) {
+                prev->next = cmd;
+            } else {
+                renderer->render_commands = cmd;
+            }
+        } else {
+            groups[i - 1].head->next = cmd;
+        }
+    }
+
+    last = groups[num_groups - 1].head;
+    last->next = end;
+    if (end == NULL) {
+        renderer->render_commands_tail = last;
+    }
+    renderer->stats.submitted_commands -= (Uint32) (count - num_groups);
+    return last;
+}
+
+static void
+ReorderRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand *prev = NULL;
+    SDL_RenderCommand *cmd = renderer->render_commands;
+
+    while (cmd) {
+        SDL_RenderCommand *last = cmd;
+        if (cmd->command == SDL_RENDERCMD_GEOMETRY && cmd->data.draw.vertsize) {
+            int count = 1;
+            while (last->next &&
+                   last->next->command == SDL_RENDERCMD_GEOMETRY &&
+                   last->next->data.draw.vertsize &&
+                   last->next->data.draw.first == last->data.draw.first + last->data.draw.vertsize) {
+                last = last->next;
+                ++count;
+            }
+            if (count > 1) {
+                last = ReorderRenderCommandRun(renderer, prev, cmd, last, count);
+            }
+        }
+        prev = last;
+        cmd = last->next;
+    }
+}
+
+/* Offsets in the arena where a queue may start, so the alignment that
+   SDL_AllocateRenderVertices() gives offsets holds for addresses too. */
+static size_t
+AlignRenderVertices(const size_t offset)
+{
+    const size_t alignment = SDL_SIMDGetAlignment();
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/* How many bytes the queue being recorded may use from where it starts:
+   up to the end of the block, or up to the render thread's bytes if it
+   wrapped around in front of them. */
+static size_t
+GetRenderVerticesRoom(SDL_Renderer *renderer)
+{
+    const size_t base = renderer->vertex_data_base;
+
+    if (renderer->vertex_data_busy && renderer->vertex_data_busy_start >= base) {
+        return renderer->vertex_data_busy_start - base;
+    }
+    return (renderer->vertex_data_allocation > base) ? (renderer->vertex_data_allocation - base) : 0;
+}
+
+/* Picks where the next queue starts. With nothing on the render thread
+   that's the start of the block. Otherwise it's right after the render
+   thread's bytes, or back at the start if the largest queue so far
+   wouldn't fit there but fits in front of them, so a steady frame never
+   has to move once recorded. */
+static void
+PlaceRenderVertices(SDL_Renderer *renderer)
+{
+    size_t base = 0;
+
+    if (renderer->vertex_data_busy) {
+        base = AlignRenderVertices(renderer->vertex_data_busy_end);
+        if ((base + renderer->vertex_data_flush_max > renderer->vertex_data_allocation) &&
+            (renderer->vertex_data_flush_max <= renderer->vertex_data_busy_start)) {
+            base = 0;
+        }
+    }
+    renderer->vertex_data_base = base;
+}
+
+static void
+NoteRenderVerticesInUse(SDL_Renderer *renderer)
+{
+    size_t in_use = renderer->vertex_data_used;
+
+    if (renderer->vertex_data_busy) {
+        in_use += renderer->vertex_data_busy_end - renderer->vertex_data_busy_start;
+    }
+    renderer->vertex_data_high_water = SDL_max(renderer->vertex_data_high_water, in_use);
+}
+
+static void
+CountRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+    const SDL_RenderCommand *cmd;
+    Uint32 count = 0;
+
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = cmd->next) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT: stats->viewport_commands++; break;
+            case SDL_RENDERCMD_SETCLIPRECT: stats->cliprect_commands++; break;
+            case SDL_RENDERCMD_SETDRAWCOLOR: stats->color_commands++; break;
+            case SDL_RENDERCMD_CLEAR: stats->clear_commands++; break;
+            case SDL_RENDERCMD_DRAW_POINTS: stats->point_commands++; break;
+            case SDL_RENDERCMD_DRAW_LINES: stats->line_commands++; break;
+            case SDL_RENDERCMD_FILL_RECTS: stats->rect_commands++; break;
+            case SDL_RENDERCMD_COPY: stats->copy_commands++; break;
+            case SDL_RENDERCMD_COPY_EX: stats->copy_ex_commands++; break;
+            case SDL_RENDERCMD_GEOMETRY: stats->geometry_commands++; break;
+            case SDL_RENDERCMD_NO_OP: break;
+        }
+        count++;
+    }
+
+    stats->commands += count;
+    stats->submitted_commands += count;
+    stats->vertex_bytes += renderer->vertex_data_used;
+    stats->vertex_bytes_max = SDL_max(stats->vertex_bytes_max, renderer->vertex_data_used);
+    renderer->vertex_data_flush_max = SDL_max(renderer->vertex_data_flush_max, renderer->vertex_data_used);
+    NoteRenderVerticesInUse(renderer);
+    stats->flushes++;
+}
+
+/* Counts the queue for the statistics and reorders it, if enabled, before
+   it is run. */
+static void
+PrepareRenderCommands(SDL_Renderer *renderer)
+{
+    CountRenderCommands(renderer);
+
+    if (renderer->reorder_commands) {
+        ReorderRenderCommands(renderer);
+    }
+
+    DebugLogRenderCommands(renderer->render_commands);
+}
+
+/* Moves a finished render command queue to the unused pool so we can reuse
+   them next time. */
+static void
+RecycleRenderCommands(SDL_Renderer *renderer, SDL_RenderCommand *commands, SDL_RenderCommand *tail)
+{
+    if (tail != NULL) {
+        tail->next = renderer->render_commands_pool;
+        renderer->render_commands_pool = commands;
+    }
+}
+
+/* Starts a new, empty queue once the last one was handed to the backend. */
+static void
+ResetRenderCommands(SDL_Renderer *renderer)
+{
+    renderer->render_commands_tail = NULL;
+    renderer->render_commands = NULL;
+    renderer->vertex_data_used = 0;
+    PlaceRenderVertices(renderer);
+    renderer->render_command_generation++;
+    renderer->color_queued = SDL_FALSE;
+    renderer->viewport_queued = SDL_FALSE;
+    renderer->cliprect_queued = SDL_FALSE;
+}
+
+#if !SDL_THREADS_DISABLED
+static int SDLCALL
+RenderThread(void *data)
+{
+    SDL_Renderer *renderer = (SDL_Renderer *) data;
+    Uint64 start;
+
+    for (;;) {
+        SDL_SemWait(renderer->render_thread_start);
+        if (SDL_AtomicGet(&renderer->render_thread_quit)) {
+            break;
+        }
+
+        start = SDL_GetPerformanceCounterNS();
+        renderer->async_retval = renderer->RunCommandQueue(renderer, renderer->async_commands,
+                                                           renderer->async_vertex_data, renderer->async_vertex_data_used);
+        renderer->async_command_queue_ns = SDL_GetPerformanceCounterNS() - start;
+
+        /* Shown as soon as it's drawn. Backends only set async_capable when
+           their present is safe to call from here. */
+        renderer->async_present_ns = 0;
+        if (renderer->async_present) {
+            start = SDL_GetPerformanceCounterNS();
+            renderer->RenderPresent(renderer);
+            renderer->async_present_ns = SDL_GetPerformanceCounterNS() - start;
+        }
+
+        SDL_SemPost(renderer->render_thread_done);
+    }
+    return 0;
+}
+
+static void
+StartRenderThread(SDL_Renderer *renderer)
+{
+    renderer->render_thread_start = SDL_CreateSemaphore(0);
+    renderer->render_thread_done = SDL_CreateSemaphore(0);
+    if (renderer->render_thread_start && renderer->render_thread_done) {
+        renderer->render_thread = SDL_CreateThreadInternal(RenderThread, "SDLRender", 0, renderer);
+    }
+    if (!renderer->render_thread) {
+        /* Not fatal, everything gets drawn on the app's thread. */
+        if (renderer->render_thread_start) {
+            SDL_DestroySemaphore(renderer->render_thread_start);
+            renderer->render_thread_start = NULL;
+        }
+        if (renderer->render_thread_done) {
+            SDL_DestroySemaphore(renderer->render_thread_done);
+            renderer->render_thread_done = NULL;
+        }
+    }
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+/* Presents on the app's thread, for a frame that had nothing left for the
+   render thread to draw. */
+static void
+PresentRenderFrame(SDL_Renderer *renderer)
+{
+    const Uint64 start = SDL_GetPerformanceCounterNS();
+    renderer->RenderPresent(renderer);
+    renderer->stats.present_ns += SDL_GetPerformanceCounterNS() - start;
+}
+
+/* Waits until the render thread is done with the queue it was handed, and
+   takes its commands and vertices back for reuse. This is only needed
+   before touching what the queue drew with or into; the frame was already
+   presented if it was meant to be. Returns what running the queue did. */
+static int
+WaitRenderThread(SDL_Renderer *renderer)
+{
+    if (!renderer->render_thread_busy) {
+        return 0;
+    }
+
+    SDL_SemWait(renderer->render_thread_done);
+    renderer->render_thread_busy = SDL_FALSE;
+
+    renderer->stats.command_queue_ns += renderer->async_command_queue_ns;
+    renderer->stats.present_ns += renderer->async_present_ns;
+
+    /* Its vertices are free to be recorded over now. */
+    NoteRenderVerticesInUse(renderer);
+    renderer->vertex_data_busy = SDL_FALSE;
+    if (renderer->vertex_data_retired) {
+        SDL_SIMDFree(renderer->vertex_data_retired);
+        renderer->vertex_data_retired = NULL;
+    }
+
+    RecycleRenderCommands(renderer, renderer->async_commands, renderer->async_commands_tail);
+    renderer->async_commands_tail = NULL;
+    renderer->async_commands = NULL;
+    renderer->async_vertex_data = NULL;
+    renderer->async_vertex_data_used = 0;
+    return renderer->async_retval;
+}
+
+/* Hands the queue and its vertices to the render thread, and records the
+   next frame into the rest of the arena. With present set, the render
+   thread presents the frame right after drawing it. Returns what running
+   the previous queue did. */
+static int
+SubmitRenderCommands(SDL_Renderer *renderer, SDL_bool present)
+{
+    int retval;
+
+    retval = WaitRenderThread(renderer);
+
+    if (renderer->render_commands == NULL) {  /* nothing to draw, at most a present */
+        SDL_assert(renderer->vertex_data_used == 0);
+        if (present) {
+            PresentRenderFrame(renderer);
+        }
+        return retval;
+    }
+
+    PrepareRenderCommands(renderer);
+
+    /* Anything the backend has to ask the window system for, like the window
+       surface after a resize, has to be done here on the app's thread. */
+    if (renderer->PrepareCommandQueue && renderer->PrepareCommandQueue(renderer) < 0) {
+        /* Nothing to draw into; drop the queue like a failed flush would. */
+        RecycleRenderCommands(renderer, renderer->render_commands, renderer->render_commands_tail);
+        ResetRenderCommands(renderer);
+        if (present) {
+            PresentRenderFrame(renderer);
+        }
+        return -1;
+    }
+
+    /* Drawing into a target counts as using it. */
+    if (renderer->target) {
+        renderer->target->last_command_generation = renderer->render_command_generation;
+    }
+
+    renderer->async_commands = renderer->render_commands;
+    renderer->async_commands_tail = renderer->render_commands_tail;
+    renderer->async_generation = renderer->render_command_generation;
+    renderer->async_present = present;
+
+    renderer->async_vertex_data = GetRenderVertices(renderer);
+    renderer->async_vertex_data_used = renderer->vertex_data_used;
+    renderer->vertex_data_busy = SDL_TRUE;
+    renderer->vertex_data_busy_start = renderer->vertex_data_base;
+    renderer->vertex_data_busy_end = renderer->vertex_data_base + renderer->vertex_data_used;
+
+    ResetRenderCommands(renderer);
+
+    renderer->render_thread_busy = SDL_TRUE;
+    SDL_SemPost(renderer->render_thread_start);
+    return retval;
+}
+
+static void
+StopRenderThread(SDL_Renderer *renderer)
+{
+    if (!renderer->render_thread) {
+        return;
+    }
+
+    WaitRenderThread(renderer);
+    SDL_AtomicSet(&renderer->render_thread_quit, 1);
+    SDL_SemPost(renderer->render_thread_start);
+    SDL_WaitThread(renderer->render_thread, NULL);
+    renderer->render_thread = NULL;
+
+    SDL_DestroySemaphore(renderer->render_thread_start);
+    SDL_DestroySemaphore(renderer->render_thread_done);
+    renderer->render_thread_start = NULL;
+    renderer->render_thread_done = NULL;
+}
+
 static int
 FlushRenderCommands(SDL_Renderer *renderer)
 {
+    Uint64 start;
     int retval;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
 
+    if (renderer->render_thread) {
+        /* Whoever flushes is about to touch what the queue draws with, so
+           the queue has to be finished before we return. */
+        retval = SubmitRenderCommands(renderer, SDL_FALSE);
+        if (WaitRenderThread(renderer) < 0) {
+            retval = -1;
+        }
+        return retval;
+    }
+
     if (renderer->render_commands == NULL) {  /* nothing to do! */
         SDL_assert(renderer->vertex_data_used == 0);
         return 0;
     }
 
-    DebugLogRenderCommands(renderer->render_commands);
+    PrepareRenderCommands(renderer);
 
-    retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    start = SDL_GetPerformanceCounterNS();
+    retval = renderer->RunCommandQueue(renderer, renderer->render_commands, GetRenderVertices(renderer), renderer->vertex_data_used);
+    renderer->stats.command_queue_ns += SDL_GetPerformanceCounterNS() - start;
 
-    /* Move the whole render command queue to the unused pool so we can reuse them next time. */
-    if (renderer->render_commands_tail != NULL) {
-        renderer->render_commands_tail->next = renderer->render_commands_pool;
-        renderer->render_commands_pool = renderer->render_commands;
-        renderer->render_commands_tail = NULL;
-        renderer->render_commands = NULL;
-    }
-    renderer->vertex_data_used = 0;
-    renderer->render_command_generation++;
-    renderer->color_queued = SDL_FALSE;
-    renderer->viewport_queued = SDL_FALSE;
-    renderer->cliprect_queued = SDL_FALSE;
+    RecycleRenderCommands(renderer, renderer->render_commands, renderer->render_commands_tail);
+    ResetRenderCommands(renderer);
     return retval;
 }
 
+/* The render thread may still be drawing with the texture, or reading its
+   state, like the scale mode, for the frame it was handed. */
+static int
+WaitRenderThreadIfTextureNeeded(SDL_Texture *texture)
+{
+    SDL_Renderer *renderer = texture->renderer;
+    if (renderer->render_thread_busy && texture->last_command_generation == renderer->async_generation) {
+        return WaitRenderThread(renderer);
+    }
+    return 0;
+}
+
 static int
 FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
 {
@@ -266,7 +811,7 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
         /* the current command queue depends on this texture, flush the queue now before it changes */
         return FlushRenderCommands(renderer);
     }
-    return 0;
+    return WaitRenderThreadIfTextureNeeded(texture);
 }
 
 static SDL_INLINE int
@@ -281,6 +826,70 @@ SDL_RenderFlush(SDL_Renderer * renderer)
     return FlushRenderCommands(renderer);
 }
 
+/* Makes room for a queue that needs more than it has where it is. If the
+   render thread's bytes aren't in the way, the queue moves back to the
+   start of the block. Otherwise the arena moves to a bigger block, which
+   only happens while a program's largest frames are still growing, or
+   never if SDL_HINT_RENDER_VERTEX_ARENA_SIZE covers them. The old block
+   stays around until the render thread is done with it. Either way only
+   the bytes in use are copied, where realloc() would copy the whole old
+   block. */
+static int
+GrowRenderVertices(SDL_Renderer *renderer, const size_t needed)
+{
+    const size_t current_allocation = renderer->vertex_data ? renderer->vertex_data_allocation : 1024;
+    size_t newsize = current_allocation * 2;
+    void *ptr;
+
+    if (renderer->vertex_data_base != 0) {
+        const size_t room = renderer->vertex_data_busy ? renderer->vertex_data_busy_start : renderer->vertex_data_allocation;
+        if (needed <= room) {
+            SDL_memmove(renderer->vertex_data, GetRenderVertices(renderer), renderer->vertex_data_used);
+            renderer->vertex_data_base = 0;
+            return 0;
+        }
+    }
+
+    while (newsize < needed) {
+        newsize *= 2;
+    }
+
+    ptr = SDL_SIMDAlloc(newsize);
+    if (ptr == NULL) {
+        return SDL_OutOfMemory();
+    }
+    if (renderer->vertex_data_used) {
+        SDL_memcpy(ptr, GetRenderVertices(renderer), renderer->vertex_data_used);
+    }
+    if (renderer->vertex_data_busy) {
+        SDL_assert(renderer->vertex_data_retired == NULL);
+        renderer->vertex_data_retired = renderer->vertex_data;
+        renderer->vertex_data_busy = SDL_FALSE;  /* nothing of the new block is. */
+    } else {
+        SDL_SIMDFree(renderer->vertex_data);
+    }
+
+    renderer->vertex_data = ptr;
+    renderer->vertex_data_base = 0;
+    renderer->vertex_data_allocation = newsize;
+    renderer->stats.vertex_arena_grows++;
+    return 0;
+}
+
+static void
+ReserveRenderVertices(SDL_Renderer *renderer)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_VERTEX_ARENA_SIZE);
+    const int size = hint ? SDL_atoi(hint) : 0;
+
+    if (size > 0 && !renderer->vertex_data) {
+        renderer->vertex_data = SDL_SIMDAlloc((size_t) size);
+        if (renderer->vertex_data) {
+            renderer->vertex_data_allocation = (size_t) size;
+        }
+    }
+}
+
 void *
 SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset)
 {
@@ -290,22 +899,10 @@ SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const
     const size_t aligner = (alignment && ((current_offset & (alignment - 1)) != 0)) ? (alignment - (current_offset & (alignment - 1))) : 0;
     const size_t aligned = current_offset + aligner;
 
-    if (renderer->vertex_data_allocation < needed) {
-        const size_t current_allocation = renderer->vertex_data ? renderer->vertex_data_allocation : 1024;
-        size_t newsize = current_allocation * 2;
-        void *ptr;
-        while (newsize < needed) {
-            newsize *= 2;
-        }
-
-        ptr = SDL_realloc(renderer->vertex_data, newsize);
-
-        if (ptr == NULL) {
-            SDL_OutOfMemory();
+    if (GetRenderVerticesRoom(renderer) < needed) {
+        if (GrowRenderVertices(renderer, needed) < 0) {
             return NULL;
         }
-        renderer->vertex_data = ptr;
-        renderer->vertex_data_allocation = newsize;
     }
 
     if (offset) {
@@ -314,7 +911,7 @@ SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const
 
     renderer->vertex_data_used += aligner + numbytes;
 
-    return ((Uint8 *) renderer->vertex_data) + aligned;
+    return GetRenderVertices(renderer) + aligned;
 }
 
 static SDL_RenderCommand *
@@ -487,6 +1084,7 @@ PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_RenderCommandType cmdtype, SD
             cmd->data.draw.a = color->a;
             cmd->data.draw.blend = blendMode;
             cmd->data.draw.texture = texture;
+            cmd->data.draw.vertsize = 0;
         }
     }
     return cmd;
@@ -624,6 +1222,81 @@ QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
     return retval;
 }
 
+static int
+QueueCmdCopyBatch(SDL_Renderer *renderer, SDL_Texture * texture,
+                  const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
+{
+    SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY, texture);
+    int retval = -1;
+    if (cmd != NULL) {
+        retval = renderer->QueueCopyBatch(renderer, cmd, texture, srcrects, dstrects, count);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        }
+    }
+    return retval;
+}
+
+static int
+QueueCmdCopyExBatch(SDL_Renderer *renderer, SDL_Texture * texture,
+                    const SDL_Rect * srcquads, const SDL_FRect * dstrects,
+                    const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                    int count)
+{
+    SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY_EX, texture);
+    int retval = -1;
+    if (cmd != NULL) {
+        retval = renderer->QueueCopyExBatch(renderer, cmd, texture, srcquads, dstrects, angles, centers, flips, count);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        }
+    }
+    return retval;
+}
+
+/* Notes which bytes of vertex_data a geometry command got and the area it
+   covers, so ReorderRenderCommands() knows what it may move and merge. */
+static void
+SetGeometryBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, const size_t used,
+        const float *xy, int xy_stride, int num_vertices,
+        float scale_x, float scale_y)
+{
+    const size_t first = cmd->data.draw.first;
+    float minx = 0.0f, miny = 0.0f, maxx = 0.0f, maxy = 0.0f;
+    int i;
+
+    /* Backends that keep vertices elsewhere don't get reordered. */
+    if (first < used || first >= renderer->vertex_data_used) {
+        return;
+    }
+
+    for (i = 0; i < num_vertices; ++i) {
+        const float *pos = (const float *) ((const Uint8 *) xy + i * xy_stride);
+        const float x = pos[0] * scale_x;
+        const float y = pos[1] * scale_y;
+        if (x != x || y != y) {
+            return;  /* NaN, no telling where this goes. */
+        }
+        if (i == 0) {
+            minx = maxx = x;
+            miny = maxy = y;
+        } else {
+            minx = SDL_min(minx, x);
+            miny = SDL_min(miny, y);
+            maxx = SDL_max(maxx, x);
+            maxy = SDL_max(maxy, y);
+        }
+    }
+
+    /* Pad by a pixel, so draws that only share an edge count as overlapping,
+       however the backend rounds them. */
+    cmd->data.draw.vertsize = renderer->vertex_data_used - first;
+    cmd->data.draw.bounds.x = minx - 1.0f;
+    cmd->data.draw.bounds.y = miny - 1.0f;
+    cmd->data.draw.bounds.w = (maxx - minx) + 2.0f;
+    cmd->data.draw.bounds.h = (maxy - miny) + 2.0f;
+}
+
 static int
 QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
         const float *xy, int xy_stride,
@@ -637,6 +1310,7 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
     int retval = -1;
     cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
     if (cmd != NULL) {
+        const size_t used = renderer->vertex_data_used;
         retval = renderer->QueueGeometry(renderer, cmd, texture,
                 xy, xy_stride,
                 color, color_stride, uv, uv_stride,
@@ -644,6 +1318,8 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
                 scale_x, scale_y);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reorder_commands) {
+            SetGeometryBounds(renderer, cmd, used, xy, xy_stride, num_vertices, scale_x, scale_y);
         }
     }
     return retval;
@@ -651,6 +1327,29 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
+static void
+RecordTextureUpload(SDL_Texture *texture, const SDL_Rect *rect)
+{
+    SDL_RenderStats *stats = &texture->renderer->stats;
+    Uint64 bytes;
+
+    switch (texture->format) {
+        case SDL_PIXELFORMAT_YV12:
+        case SDL_PIXELFORMAT_IYUV:
+        case SDL_PIXELFORMAT_NV12:
+        case SDL_PIXELFORMAT_NV21:
+            /* A full resolution Y plane, plus two quarter resolution chroma planes' worth */
+            bytes = ((Uint64) rect->w * rect->h) + 2 * ((Uint64) ((rect->w + 1) / 2) * ((rect->h + 1) / 2));
+            break;
+        default:
+            bytes = (Uint64) rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
+            break;
+    }
+
+    stats->texture_uploads++;
+    stats->texture_upload_bytes += bytes;
+}
+
 int
 SDL_GetNumRenderDrivers(void)
 {
@@ -694,6 +1393,8 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
     if (event->type == SDL_WINDOWEVENT) {
         SDL_Window *window = SDL_GetWindowFromID(event->window.windowID);
         if (window == renderer->window) {
+            WaitRenderThread(renderer);  /* the backend may drop what the render thread draws to */
+
             if (renderer->WindowEvent) {
                 renderer->WindowEvent(renderer, &event->window);
             }
@@ -820,6 +1521,7 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
 
         if (renderer->GetOutputSize) {
             int w, h;
+            WaitRenderThread(renderer);
             renderer->GetOutputSize(renderer, &w, &h);
             physical_w = (float) w;
             physical_h = (float) h;
@@ -988,6 +1690,13 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
     }
 
     renderer->batching = batching;
+    renderer->reorder_commands = batching && SDL_GetHintBoolean(SDL_HINT_RENDER_REORDER_COMMANDS, SDL_FALSE);
+    ReserveRenderVertices(renderer);
+#if !SDL_THREADS_DISABLED
+    if (batching && renderer->async_capable && SDL_GetHintBoolean(SDL_HINT_RENDER_ASYNC_SUBMIT, SDL_FALSE)) {
+        StartRenderThread(renderer);
+    }
+#endif
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -1054,6 +1763,7 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
 
     if (renderer) {
         VerifyDrawQueueFunctions(renderer);
+        ReserveRenderVertices(renderer);
         renderer->magic = &renderer_magic;
         renderer->target_mutex = SDL_CreateMutex();
         renderer->scale.x = 1.0f;
@@ -1094,6 +1804,7 @@ SDL_GetRendererOutputSize(SDL_Renderer * renderer, int *w, int *h)
     if (renderer->target) {
         return SDL_QueryTexture(renderer->target, NULL, NULL, w, h);
     } else if (renderer->GetOutputSize) {
+        WaitRenderThread(renderer);
         return renderer->GetOutputSize(renderer, w, h);
     } else if (renderer->window) {
         SDL_GetWindowSize(renderer->window, w, h);
@@ -1567,6 +2278,7 @@ SDL_SetTextureScaleMode(SDL_Texture * texture, SDL_ScaleMode scaleMode)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    WaitRenderThreadIfTextureNeeded(texture);
     renderer->SetTextureScaleMode(renderer, texture, scaleMode);
     texture->scaleMode = scaleMode;
     if (texture->native) {
@@ -1730,6 +2442,7 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        RecordTextureUpload(texture, &real_rect);
         return renderer->UpdateTexture(renderer, texture, &real_rect, pixels, pitch);
     }
 }
@@ -1898,6 +2611,7 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            RecordTextureUpload(texture, &real_rect);
             return renderer->UpdateTextureYUV(renderer, texture, &real_rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1958,6 +2672,7 @@ int SDL_UpdateNVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            RecordTextureUpload(texture, &real_rect);
             return renderer->UpdateTextureNV(renderer, texture, &real_rect, Yplane, Ypitch, UVplane, UVpitch);
         } else {
             return SDL_Unsupported();
@@ -2027,6 +2742,7 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        texture->locked_rect = *rect;  /* for the upload statistics. */
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -2128,6 +2844,7 @@ SDL_UnlockTexture(SDL_Texture * texture)
         SDL_UnlockTextureNative(texture);
     } else {
         SDL_Renderer *renderer = texture->renderer;
+        RecordTextureUpload(texture, &texture->locked_rect);
         renderer->UnlockTexture(renderer, texture);
     }
 
@@ -2190,6 +2907,7 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         SDL_UnlockMutex(renderer->target_mutex);
         return -1;
     }
+    renderer->stats.target_changes++;
 
     if (texture) {
         renderer->viewport.x = 0.0f;
@@ -3283,6 +4001,103 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     return SDL_RenderCopyF(renderer, texture, srcrect, pdstfrect);
 }
 
+/* Texture coordinates for the corners of srcrect, going around the quad in
+   the same order as GetCopyQuad() and GetCopyExQuad(). */
+static void
+GetCopyQuadUV(const SDL_Texture *texture, const SDL_Rect *srcrect, float uv[8])
+{
+    const float minu = (float) (srcrect->x) / (float) texture->w;
+    const float minv = (float) (srcrect->y) / (float) texture->h;
+    const float maxu = (float) (srcrect->x + srcrect->w) / (float) texture->w;
+    const float maxv = (float) (srcrect->y + srcrect->h) / (float) texture->h;
+
+    uv[0] = minu;
+    uv[1] = minv;
+    uv[2] = maxu;
+    uv[3] = minv;
+    uv[4] = maxu;
+    uv[5] = maxv;
+    uv[6] = minu;
+    uv[7] = maxv;
+}
+
+static void
+GetCopyQuad(const SDL_FRect *dstrect, float xy[8])
+{
+    const float minx = dstrect->x;
+    const float miny = dstrect->y;
+    const float maxx = dstrect->x + dstrect->w;
+    const float maxy = dstrect->y + dstrect->h;
+
+    xy[0] = minx;
+    xy[1] = miny;
+    xy[2] = maxx;
+    xy[3] = miny;
+    xy[4] = maxx;
+    xy[5] = maxy;
+    xy[6] = minx;
+    xy[7] = maxy;
+}
+
+/* center is relative to dstrect, as SDL_RenderCopyExF() takes it */
+static void
+GetCopyExQuad(const SDL_FRect *dstrect, const double angle, const SDL_FPoint *center,
+              const SDL_RendererFlip flip, float xy[8])
+{
+    float minx, miny, maxx, maxy;
+    float centerx, centery;
+
+    float s_minx, s_miny, s_maxx, s_maxy;
+    float c_minx, c_miny, c_maxx, c_maxy;
+
+    const float radian_angle = (float)((M_PI * angle) / 180.0);
+    const float s = SDL_sinf(radian_angle);
+    const float c = SDL_cosf(radian_angle);
+
+    centerx = center->x + dstrect->x;
+    centery = center->y + dstrect->y;
+
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        minx = dstrect->x + dstrect->w;
+        maxx = dstrect->x;
+    } else {
+        minx = dstrect->x;
+        maxx = dstrect->x + dstrect->w;
+    }
+
+    if (flip & SDL_FLIP_VERTICAL) {
+        miny = dstrect->y + dstrect->h;
+        maxy = dstrect->y;
+    } else {
+        miny = dstrect->y;
+        maxy = dstrect->y + dstrect->h;
+    }
+
+    /* apply rotation with 2x2 matrix ( c -s )
+     *                                ( s  c ) */
+    s_minx = s * (minx - centerx);
+    s_miny = s * (miny - centery);
+    s_maxx = s * (maxx - centerx);
+    s_maxy = s * (maxy - centery);
+    c_minx = c * (minx - centerx);
+    c_miny = c * (miny - centery);
+    c_maxx = c * (maxx - centerx);
+    c_maxy = c * (maxy - centery);
+
+    /* (minx, miny) */
+    xy[0] = (c_minx - s_miny) + centerx;
+    xy[1] = (s_minx + c_miny) + centery;
+    /* (maxx, miny) */
+    xy[2] = (c_maxx - s_miny) + centerx;
+    xy[3] = (s_maxx + c_miny) + centery;
+    /* (maxx, maxy) */
+    xy[4] = (c_maxx - s_maxy) + centerx;
+    xy[5] = (s_maxx + c_maxy) + centery;
+    /* (minx, maxy) */
+    xy[6] = (c_minx - s_maxy) + centerx;
+    xy[7] = (s_minx + c_maxy) + centery;
+}
+
 int
 SDL_RenderCopyF(SDL_Renderer * renderer, SDL_Texture * texture,
                 const SDL_Rect * srcrect, const SDL_FRect * dstrect)
@@ -3342,36 +4157,9 @@ SDL_RenderCopyF(SDL_Renderer * renderer, SDL_Texture * texture,
         const int indices[6] = {0, 1, 2, 0, 2, 3};
         const int num_indices = 6;
         const int size_indices = 4;
-        float minu, minv, maxu, maxv;
-        float minx, miny, maxx, maxy;
-
-        minu = (float) (real_srcrect.x) / (float) texture->w;
-        minv = (float) (real_srcrect.y) / (float) texture->h;
-        maxu = (float) (real_srcrect.x + real_srcrect.w) / (float) texture->w;
-        maxv = (float) (real_srcrect.y + real_srcrect.h) / (float) texture->h;
-
-        minx = real_dstrect.x;
-        miny = real_dstrect.y;
-        maxx = real_dstrect.x + real_dstrect.w;
-        maxy = real_dstrect.y + real_dstrect.h;
-
-        uv[0] = minu;
-        uv[1] = minv;
-        uv[2] = maxu;
-        uv[3] = minv;
-        uv[4] = maxu;
-        uv[5] = maxv;
-        uv[6] = minu;
-        uv[7] = maxv;
-
-        xy[0] = minx;
-        xy[1] = miny;
-        xy[2] = maxx;
-        xy[3] = miny;
-        xy[4] = maxx;
-        xy[5] = maxy;
-        xy[6] = minx;
-        xy[7] = maxy;
+
+        GetCopyQuadUV(texture, &real_srcrect, uv);
+        GetCopyQuad(&real_dstrect, xy);
 
         retval = QueueCmdGeometry(renderer, texture,
                 xy, xy_stride, &texture->color, 0 /* color_stride */, uv, uv_stride,
@@ -3490,73 +4278,9 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
         const int indices[6] = {0, 1, 2, 0, 2, 3};
         const int num_indices = 6;
         const int size_indices = 4;
-        float minu, minv, maxu, maxv;
-        float minx, miny, maxx, maxy;
-        float centerx, centery;
-
-        float s_minx, s_miny, s_maxx, s_maxy;
-        float c_minx, c_miny, c_maxx, c_maxy;
-
-        const float radian_angle = (float)((M_PI * angle) / 180.0);
-        const float s = SDL_sinf(radian_angle);
-        const float c = SDL_cosf(radian_angle);
-
-        minu = (float) (real_srcrect.x) / (float) texture->w;
-        minv = (float) (real_srcrect.y) / (float) texture->h;
-        maxu = (float) (real_srcrect.x + real_srcrect.w) / (float) texture->w;
-        maxv = (float) (real_srcrect.y + real_srcrect.h) / (float) texture->h;
 
-        centerx = real_center.x + real_dstrect.x;
-        centery = real_center.y + real_dstrect.y;
-
-        if (flip & SDL_FLIP_HORIZONTAL) {
-            minx = real_dstrect.x + real_dstrect.w;
-            maxx = real_dstrect.x;
-        } else {
-            minx = real_dstrect.x;
-            maxx = real_dstrect.x + real_dstrect.w;
-        }
-
-        if (flip & SDL_FLIP_VERTICAL) {
-            miny = real_dstrect.y + real_dstrect.h;
-            maxy = real_dstrect.y;
-        } else {
-            miny = real_dstrect.y;
-            maxy = real_dstrect.y + real_dstrect.h;
-        }
-
-        uv[0] = minu;
-        uv[1] = minv;
-        uv[2] = maxu;
-        uv[3] = minv;
-        uv[4] = maxu;
-        uv[5] = maxv;
-        uv[6] = minu;
-        uv[7] = maxv;
-
-        /* apply rotation with 2x2 matrix ( c -s )
-         *                                ( s  c ) */
-        s_minx = s * (minx - centerx);
-        s_miny = s * (miny - centery);
-        s_maxx = s * (maxx - centerx);
-        s_maxy = s * (maxy - centery);
-        c_minx = c * (minx - centerx);
-        c_miny = c * (miny - centery);
-        c_maxx = c * (maxx - centerx);
-        c_maxy = c * (maxy - centery);
-
-        /* (minx, miny) */
-        xy[0] = (c_minx - s_miny) + centerx;
-        xy[1] = (s_minx + c_miny) + centery;
-        /* (maxx, miny) */
-        xy[2] = (c_maxx - s_miny) + centerx;
-        xy[3] = (s_maxx + c_miny) + centery;
-        /* (maxx, maxy) */
-        xy[4] = (c_maxx - s_maxy) + centerx;
-        xy[5] = (s_maxx + c_maxy) + centery;
-        /* (minx, maxy) */
-        xy[6] = (c_minx - s_maxy) + centerx;
-        xy[7] = (s_minx + c_maxy) + centery;
+        GetCopyQuadUV(texture, &real_srcrect, uv);
+        GetCopyExQuad(&real_dstrect, angle, &real_center, flip, xy);
 
         retval = QueueCmdGeometry(renderer, texture,
                 xy, xy_stride, &texture->color, 0 /* color_stride */, uv, uv_stride,
@@ -3578,6 +4302,272 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+/* Copies that SDL_RenderCopyExF() would hand straight to SDL_RenderCopyF() */
+#define IS_PLAIN_COPY(angles, flips, i) \
+    ((!(flips) || (flips)[i] == SDL_FLIP_NONE) && \
+     (!(angles) || (int)((angles)[i]/360) == (angles)[i]/360))
+
+static void *
+GetBatchData(SDL_Renderer *renderer, int count, size_t itemsize)
+{
+    size_t needed;
+
+    if ((size_t) count > SDL_MAX_SINT32 / itemsize) {
+        SDL_InvalidParamError("count");
+        return NULL;
+    }
+
+    needed = count * itemsize;
+    if (renderer->batch_data_allocated < needed) {
+        void *ptr = SDL_realloc(renderer->batch_data, needed);
+        if (!ptr) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        renderer->batch_data = ptr;
+        renderer->batch_data_allocated = needed;
+    }
+    return renderer->batch_data;
+}
+
+/* Works out the source rectangle of copy i and whether it is drawn at all,
+   the same way SDL_RenderCopyF() and SDL_RenderCopyExF() do. */
+static SDL_bool
+GetBatchCopy(SDL_Texture *texture, const SDL_Rect *srcrects, const SDL_FRect *dstrects,
+             const SDL_FRect *viewport, SDL_bool plain, int i, SDL_Rect *real_srcrect)
+{
+    real_srcrect->x = 0;
+    real_srcrect->y = 0;
+    real_srcrect->w = texture->w;
+    real_srcrect->h = texture->h;
+    if (srcrects && !SDL_IntersectRect(&srcrects[i], real_srcrect, real_srcrect)) {
+        return SDL_FALSE;
+    }
+    if (plain && !SDL_HasIntersectionF(&dstrects[i], viewport)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Builds one geometry command out of all the copies, for backends that
+   draw copies as geometry anyway. */
+static int
+RenderCopyBatchGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                        const SDL_Rect *srcrects, const SDL_FRect *dstrects,
+                        const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                        int count, const SDL_FRect *viewport)
+{
+    const size_t quadsize = (8 + 8) * sizeof (float) + 6 * sizeof (int);
+    float *xy, *uv;
+    int *indices;
+    int i, num_quads = 0;
+
+    xy = (float *) GetBatchData(renderer, count, quadsize);
+    if (!xy) {
+        return -1;
+    }
+    uv = xy + 8 * count;
+    indices = (int *) (uv + 8 * count);
+
+    if (texture->native) {
+        texture = texture->native;
+    }
+
+    for (i = 0; i < count; i++) {
+        const SDL_bool plain = IS_PLAIN_COPY(angles, flips, i);
+        const int base = 4 * num_quads;
+        int *quad_indices = indices + 6 * num_quads;
+        SDL_Rect real_srcrect;
+
+        if (!GetBatchCopy(texture, srcrects, dstrects, viewport, plain, i, &real_srcrect)) {
+            continue;
+        }
+
+        GetCopyQuadUV(texture, &real_srcrect, uv + 8 * num_quads);
+        if (plain) {
+            GetCopyQuad(&dstrects[i], xy + 8 * num_quads);
+        } else {
+            SDL_FPoint real_center;
+            if (centers) {
+                real_center = centers[i];
+            } else {
+                real_center.x = dstrects[i].w / 2.0f;
+                real_center.y = dstrects[i].h / 2.0f;
+            }
+            GetCopyExQuad(&dstrects[i], angles ? angles[i] : 0.0, &real_center,
+                          flips ? flips[i] : SDL_FLIP_NONE, xy + 8 * num_quads);
+        }
+
+        quad_indices[0] = base;
+        quad_indices[1] = base + 1;
+        quad_indices[2] = base + 2;
+        quad_indices[3] = base;
+        quad_indices[4] = base + 2;
+        quad_indices[5] = base + 3;
+        num_quads++;
+    }
+
+    if (num_quads == 0) {
+        return 0;
+    }
+
+    texture->last_command_generation = renderer->render_command_generation;
+
+    return QueueCmdGeometry(renderer, texture,
+            xy, 2 * sizeof (float), &texture->color, 0 /* color_stride */, uv, 2 * sizeof (float),
+            4 * num_quads,
+            indices, 6 * num_quads, sizeof (int),
+            renderer->scale.x, renderer->scale.y);
+}
+
+/* Queues runs of plain copies and runs of rotated or flipped ones, for
+   backends with their own copy commands. */
+static int
+RenderCopyBatchCopies(SDL_Renderer *renderer, SDL_Texture *texture,
+                      const SDL_Rect *srcrects, const SDL_FRect *dstrects,
+                      const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                      int count, const SDL_FRect *viewport)
+{
+    const size_t copysize = sizeof (double) + sizeof (SDL_Rect) + sizeof (SDL_FRect) +
+                            sizeof (SDL_FPoint) + sizeof (SDL_RendererFlip);
+    double *real_angles;
+    SDL_Rect *real_srcrects;
+    SDL_FRect *real_dstrects;
+    SDL_FPoint *real_centers;
+    SDL_RendererFlip *real_flips;
+    int i = 0, retval = 0;
+
+    real_angles = (double *) GetBatchData(renderer, count, copysize);
+    if (!real_angles) {
+        return -1;
+    }
+    real_srcrects = (SDL_Rect *) (real_angles + count);
+    real_dstrects = (SDL_FRect *) (real_srcrects + count);
+    real_centers = (SDL_FPoint *) (real_dstrects + count);
+    real_flips = (SDL_RendererFlip *) (real_centers + count);
+
+    if (texture->native) {
+        texture = texture->native;
+    }
+
+    while (i < count && retval == 0) {
+        const SDL_bool plain = IS_PLAIN_COPY(angles, flips, i);
+        int j, n = 0;
+
+        for (; i < count && IS_PLAIN_COPY(angles, flips, i) == plain; i++) {
+            SDL_FRect *real_dstrect = &real_dstrects[n];
+            SDL_FPoint *real_center = &real_centers[n];
+
+            if (!GetBatchCopy(texture, srcrects, dstrects, viewport, plain, i, &real_srcrects[n])) {
+                continue;
+            }
+
+            *real_dstrect = dstrects[i];
+            if (centers) {
+                *real_center = centers[i];
+            } else {
+                real_center->x = real_dstrect->w / 2.0f;
+                real_center->y = real_dstrect->h / 2.0f;
+            }
+
+            real_dstrect->x *= renderer->scale.x;
+            real_dstrect->y *= renderer->scale.y;
+            real_dstrect->w *= renderer->scale.x;
+            real_dstrect->h *= renderer->scale.y;
+
+            real_center->x *= renderer->scale.x;
+            real_center->y *= renderer->scale.y;
+
+            real_angles[n] = angles ? angles[i] : 0.0;
+            real_flips[n] = flips ? flips[i] : SDL_FLIP_NONE;
+            n++;
+        }
+
+        if (n == 0) {
+            continue;
+        }
+
+        texture->last_command_generation = renderer->render_command_generation;
+
+        if (plain && renderer->QueueCopyBatch) {
+            retval = QueueCmdCopyBatch(renderer, texture, real_srcrects, real_dstrects, n);
+        } else if (!plain && renderer->QueueCopyExBatch) {
+            retval = QueueCmdCopyExBatch(renderer, texture, real_srcrects, real_dstrects,
+                                         real_angles, real_centers, real_flips, n);
+        } else {
+            for (j = 0; j < n && retval == 0; j++) {
+                if (plain) {
+                    retval = QueueCmdCopy(renderer, texture, &real_srcrects[j], &real_dstrects[j]);
+                } else {
+                    retval = QueueCmdCopyEx(renderer, texture, &real_srcrects[j], &real_dstrects[j],
+                                            real_angles[j], &real_centers[j], real_flips[j]);
+                }
+            }
+        }
+    }
+    return retval;
+}
+
+int
+SDL_RenderCopyBatch(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
+{
+    return SDL_RenderCopyBatchEx(renderer, texture, srcrects, dstrects, NULL, NULL, NULL, count);
+}
+
+int
+SDL_RenderCopyBatchEx(SDL_Renderer * renderer, SDL_Texture * texture,
+                      const SDL_Rect * srcrects, const SDL_FRect * dstrects,
+                      const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                      int count)
+{
+    SDL_FRect viewport;
+    int retval;
+    int i;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (renderer != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+    if (!dstrects) {
+        return SDL_InvalidParamError("dstrects");
+    }
+    if (count < 0) {
+        return SDL_InvalidParamError("count");
+    }
+    if (!renderer->QueueCopyEx && !renderer->QueueGeometry) {
+        for (i = 0; i < count; i++) {
+            if (!IS_PLAIN_COPY(angles, flips, i)) {
+                return SDL_SetError("Renderer does not support RenderCopyEx");
+            }
+        }
+    }
+
+#if DONT_DRAW_WHILE_HIDDEN
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+#endif
+
+    if (count == 0) {
+        return 0;
+    }
+
+    RenderGetViewportSize(renderer, &viewport);
+
+    if (renderer->QueueCopy == NULL) {
+        retval = RenderCopyBatchGeometry(renderer, texture, srcrects, dstrects,
+                                         angles, centers, flips, count, &viewport);
+    } else {
+        retval = RenderCopyBatchCopies(renderer, texture, srcrects, dstrects,
+                                       angles, centers, flips, count, &viewport);
+    }
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int
 SDL_RenderGeometry(SDL_Renderer *renderer,
                                SDL_Texture *texture,
@@ -4094,21 +5084,45 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                       format, pixels, pitch);
 }
 
+static void
+EndRenderStatsFrame(SDL_Renderer *renderer)
+{
+    renderer->stats.vertex_arena_size = renderer->vertex_data_allocation;
+    renderer->stats.vertex_arena_high_water = renderer->vertex_data_high_water;
+    renderer->last_stats = renderer->stats;
+    SDL_zero(renderer->stats);
+}
+
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
-    CHECK_RENDERER_MAGIC(renderer, );
+    Uint64 start;
 
-    FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
+    CHECK_RENDERER_MAGIC(renderer, );
 
 #if DONT_DRAW_WHILE_HIDDEN
     /* Don't present while we're hidden */
     if (renderer->hidden) {
+        FlushRenderCommands(renderer);
+        EndRenderStatsFrame(renderer);
         return;
     }
 #endif
 
+    if (renderer->render_thread) {
+        /* The render thread draws and presents while the next frame is recorded. */
+        SubmitRenderCommands(renderer, SDL_TRUE);
+        EndRenderStatsFrame(renderer);
+        return;
+    }
+
+    FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
+
+    start = SDL_GetPerformanceCounterNS();
     renderer->RenderPresent(renderer);
+    renderer->stats.present_ns += SDL_GetPerformanceCounterNS() - start;
+
+    EndRenderStatsFrame(renderer);
 }
 
 void
@@ -4163,6 +5177,8 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    StopRenderThread(renderer);
+
     if (renderer->render_commands_tail != NULL) {
         renderer->render_commands_tail->next = renderer->render_commands_pool;
         cmd = renderer->render_commands;
@@ -4180,7 +5196,11 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
         cmd = next;
     }
 
-    SDL_free(renderer->vertex_data);
+    SDL_SIMDFree(renderer->vertex_data);
+    SDL_SIMDFree(renderer->vertex_data_retired);
+    SDL_free(renderer->reorder_groups);
+    SDL_free(renderer->reorder_vertices);
+    SDL_free(renderer->batch_data);
 
     /* Free existing textures for this renderer */
     while (renderer->textures) {
@@ -4355,6 +5375,32 @@ SDL_GetBlendModeAlphaOperation(SDL_BlendMode blendMode)
     return (SDL_BlendOperation)(((Uint32)blendMode >> 16) & 0xF);
 }
 
+int
+SDL_RenderGetCommandCounts(SDL_Renderer * renderer, Uint32 *queued, Uint32 *submitted)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (queued) {
+        *queued = renderer->last_stats.commands;
+    }
+    if (submitted) {
+        *submitted = renderer->last_stats.submitted_commands;
+    }
+    return 0;
+}
+
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats *stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    *stats = renderer->last_stats;
+    return 0;
+}
+
 int
 SDL_RenderSetVSync(SDL_Renderer * renderer, int vsync)
 {
@@ -26,6 +26,7 @@
 #include "SDL_render.h"
 #include "SDL_events.h"
 #include "SDL_mutex.h"
+#include "SDL_thread.h"
 #include "SDL_yuv_sw_c.h"
 
 /* The SDL 2D rendering system */
@@ -97,6 +98,11 @@ typedef struct SDL_RenderCommand
             Uint8 r, g, b, a;
             SDL_BlendMode blend;
             SDL_Texture *texture;
+            /* Filled in for geometry when reordering commands: the bytes at
+               first that belong to this draw (0 if unknown), and the area it
+               covers before the viewport is applied. */
+            size_t vertsize;
+            SDL_FRect bounds;
         } draw;
         struct {
             size_t first;
@@ -136,12 +142,19 @@ struct SDL_Renderer
     int (*QueueCopyEx) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                         const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                         const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+    int (*QueueCopyBatch) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                           const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count);
+    int (*QueueCopyExBatch) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                             const SDL_Rect * srcquads, const SDL_FRect * dstrects,
+                             const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                             int count);
     int (*QueueGeometry) (SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
                           const float *xy, int xy_stride, const SDL_Color *color, int color_stride, const float *uv, int uv_stride,
                           int num_vertices, const void *indices, int num_indices, int size_indices,
                           float scale_x, float scale_y);
 
     int (*RunCommandQueue) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
+    int (*PrepareCommandQueue) (SDL_Renderer * renderer);  /* app thread, before RunCommandQueue runs on the render thread */
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, const void *pixels,
                           int pitch);
@@ -228,6 +241,7 @@ struct SDL_Renderer
 
     SDL_bool always_batch;
     SDL_bool batching;
+    SDL_bool async_capable;  /* RunCommandQueue and RenderPresent may run on another thread */
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -240,9 +254,55 @@ struct SDL_Renderer
     SDL_bool viewport_queued;
     SDL_bool cliprect_queued;
 
+    /* SDL_HINT_RENDER_REORDER_COMMANDS, and scratch space for it. */
+    SDL_bool reorder_commands;
+    struct SDL_RenderCommandGroup *reorder_groups;
+    int reorder_groups_allocated;
+    void *reorder_vertices;
+    size_t reorder_vertices_allocated;
+
+    /* Scratch space for SDL_RenderCopyBatch() and SDL_RenderCopyBatchEx(). */
+    void *batch_data;
+    size_t batch_data_allocated;
+
+    /* SDL_HINT_RENDER_ASYNC_SUBMIT: a thread that runs one flushed command
+       queue, with its vertices still in the arena, while the next one is
+       recorded. */
+    SDL_Thread *render_thread;
+    SDL_sem *render_thread_start;
+    SDL_sem *render_thread_done;
+    SDL_atomic_t render_thread_quit;
+    SDL_bool render_thread_busy;
+    SDL_RenderCommand *async_commands;
+    SDL_RenderCommand *async_commands_tail;
+    void *async_vertex_data;
+    size_t async_vertex_data_used;
+    Uint32 async_generation;
+    SDL_bool async_present;
+    int async_retval;
+    Uint64 async_command_queue_ns;
+    Uint64 async_present_ns;
+
+    /* Statistics for the frame in progress and for the last presented one. */
+    SDL_RenderStats stats;
+    SDL_RenderStats last_stats;
+
+    /* The vertex arena, one SDL_SIMDAlloc() block kept between flushes and
+       used as a ring. The queue being recorded starts at vertex_data_base.
+       A queue handed to the render thread keeps its bytes, from
+       vertex_data_busy_start to vertex_data_busy_end, until it's drawn; if
+       the block has to be replaced before then, the old one waits in
+       vertex_data_retired. */
     void *vertex_data;
+    size_t vertex_data_base;
     size_t vertex_data_used;
     size_t vertex_data_allocation;
+    SDL_bool vertex_data_busy;
+    size_t vertex_data_busy_start;
+    size_t vertex_data_busy_end;
+    void *vertex_data_retired;
+    size_t vertex_data_flush_max;   /* most used by a single flush so far. */
+    size_t vertex_data_high_water;  /* most in use at once so far. */
 
     void *driverdata;
 };
@@ -278,7 +338,9 @@ extern SDL_BlendOperation SDL_GetBlendModeAlphaOperation(SDL_BlendMode blendMode
 
 /* drivers call this during their Queue*() methods to make space in a array that are used
    for a vertex buffer during RunCommandQueue(). Pointers returned here are only valid until
-   the next call, because it might be in an array that gets realloc()'d. */
+   the next call, because the array might move to a bigger block. The array itself is aligned
+   to SDL_SIMDGetAlignment(), so an alignment up to that holds for the returned pointer too,
+   not just for the offset. */
 extern void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset);
 
 extern int SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect, SDL_Surface * dst, SDL_Rect * dstrect, SDL_ScaleMode scaleMode);
@@ -25,6 +25,9 @@
 #include "../SDL_sysrender.h"
 #include "SDL_render_sw_c.h"
 #include "SDL_hints.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "../../thread/SDL_systhread.h"
 
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
@@ -37,6 +40,9 @@
 
 /* SDL surface based renderer implementation */
 
+/* Width and height of the screen tiles used with SDL_HINT_RENDER_SOFTWARE_THREADS */
+#define SW_TILE_SIZE 64
+
 typedef struct
 {
     const SDL_Rect *viewport;
@@ -44,10 +50,59 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+/* A command, or a run of its copies or triangles, that touches a tile */
+typedef struct
+{
+    const SDL_RenderCommand *cmd;
+    SDL_Rect cliprect;  /* in surface coordinates, already clipped to the surface */
+    int first;          /* first copy or triangle, for SDL_RENDERCMD_COPY and SDL_RENDERCMD_GEOMETRY */
+    int count;
+    int texture;        /* index into SW_RenderData::tile_textures, -1 for none */
+} SW_TileEntry;
+
+typedef struct
+{
+    SW_TileEntry *entries;
+    int num_entries;
+    int max_entries;
+    int saved_entries;
+} SW_Tile;
+
+struct SW_RenderData;
+
+/* Each worker draws through its own surfaces aliasing the target and the
+   textures, so clip rects and blit mappings are never shared. */
 typedef struct
+{
+    struct SW_RenderData *data;
+    SDL_Thread *thread;
+    SDL_Surface *surface;
+    SDL_Surface **sources;
+    int max_sources;
+} SW_TileWorker;
+
+typedef struct SW_RenderData
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+
+    /* Tiled rendering, see SDL_HINT_RENDER_SOFTWARE_THREADS. workers[0] is
+       the thread running the command queue, the others have their own. */
+    int num_workers;
+    SW_TileWorker *workers;
+    SDL_sem *tiles_start;
+    SDL_sem *tiles_done;
+    SDL_atomic_t tiles_next;
+    SDL_atomic_t tiles_quit;
+    SW_Tile *tiles;
+    int max_tiles;
+    int tiles_x;
+    int tiles_y;
+    SDL_bool tiles_binned;
+    SDL_Texture **tile_textures;
+    int num_tile_textures;
+    int max_tile_textures;
+    void *tile_vertices;
 } SW_RenderData;
 
 
@@ -202,21 +257,31 @@ SW_QueueSetViewport(SDL_Renderer * renderer, SDL_RenderCommand *cmd)
     return 0;  /* nothing to do in this backend. */
 }
 
+/* Vertices are queued already moved by the viewport they're drawn in, the
+   same one SDL_RENDERCMD_SETVIEWPORT gets, so drawing only ever reads them. */
+static void
+SW_GetViewportOffset(SDL_Renderer * renderer, int *x, int *y)
+{
+    *x = (int)SDL_floor(renderer->viewport.x);
+    *y = (int)SDL_floor(renderer->viewport.y);
+}
+
 static int
 SW_QueueDrawPoints(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FPoint * points, int count)
 {
     SDL_Point *verts = (SDL_Point *) SDL_AllocateRenderVertices(renderer, count * sizeof (SDL_Point), 0, &cmd->data.draw.first);
-    int i;
+    int i, x, y;
 
     if (!verts) {
         return -1;
     }
 
     cmd->data.draw.count = count;
+    SW_GetViewportOffset(renderer, &x, &y);
 
     for (i = 0; i < count; i++, verts++, points++) {
-        verts->x = (int)points->x;
-        verts->y = (int)points->y;
+        verts->x = (int)points->x + x;
+        verts->y = (int)points->y + y;
     }
 
     return 0;
@@ -226,17 +291,18 @@ static int
 SW_QueueFillRects(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FRect * rects, int count)
 {
     SDL_Rect *verts = (SDL_Rect *) SDL_AllocateRenderVertices(renderer, count * sizeof (SDL_Rect), 0, &cmd->data.draw.first);
-    int i;
+    int i, x, y;
 
     if (!verts) {
         return -1;
     }
 
     cmd->data.draw.count = count;
+    SW_GetViewportOffset(renderer, &x, &y);
 
     for (i = 0; i < count; i++, verts++, rects++) {
-        verts->x = (int)rects->x;
-        verts->y = (int)rects->y;
+        verts->x = (int)rects->x + x;
+        verts->y = (int)rects->y + y;
         verts->w = SDL_max((int)rects->w, 1);
         verts->h = SDL_max((int)rects->h, 1);
     }
@@ -244,29 +310,42 @@ SW_QueueFillRects(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FRe
     return 0;
 }
 
+/* Copies are queued as srcrect, dstrect pairs */
 static int
-SW_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
-             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+SW_QueueCopyBatch(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                  const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
 {
-    SDL_Rect *verts = (SDL_Rect *) SDL_AllocateRenderVertices(renderer, 2 * sizeof (SDL_Rect), 0, &cmd->data.draw.first);
+    SDL_Rect *verts = (SDL_Rect *) SDL_AllocateRenderVertices(renderer, count * 2 * sizeof (SDL_Rect), 0, &cmd->data.draw.first);
+    int i, x, y;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
+    cmd->data.draw.count = count;
+    SW_GetViewportOffset(renderer, &x, &y);
 
-    SDL_memcpy(verts, srcrect, sizeof (SDL_Rect));
-    verts++;
+    for (i = 0; i < count; i++) {
+        SDL_memcpy(verts, &srcrects[i], sizeof (SDL_Rect));
+        verts++;
 
-    verts->x = (int)dstrect->x;
-    verts->y = (int)dstrect->y;
-    verts->w = (int)dstrect->w;
-    verts->h = (int)dstrect->h;
+        verts->x = (int)dstrects[i].x + x;
+        verts->y = (int)dstrects[i].y + y;
+        verts->w = (int)dstrects[i].w;
+        verts->h = (int)dstrects[i].h;
+        verts++;
+    }
 
     return 0;
 }
 
+static int
+SW_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+{
+    return SW_QueueCopyBatch(renderer, cmd, texture, srcrect, dstrect, 1);
+}
+
 typedef struct CopyExData
 {
     SDL_Rect srcrect;
@@ -277,31 +356,44 @@ typedef struct CopyExData
 } CopyExData;
 
 static int
-SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
-               const SDL_Rect * srcrect, const SDL_FRect * dstrect,
-               const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
+SW_QueueCopyExBatch(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                    const SDL_Rect * srcrects, const SDL_FRect * dstrects,
+                    const double *angles, const SDL_FPoint *centers, const SDL_RendererFlip *flips,
+                    int count)
 {
-    CopyExData *verts = (CopyExData *) SDL_AllocateRenderVertices(renderer, sizeof (CopyExData), 0, &cmd->data.draw.first);
+    CopyExData *verts = (CopyExData *) SDL_AllocateRenderVertices(renderer, count * sizeof (CopyExData), 0, &cmd->data.draw.first);
+    int i, x, y;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
-
-    SDL_memcpy(&verts->srcrect, srcrect, sizeof (SDL_Rect));
-
-    verts->dstrect.x = (int)dstrect->x;
-    verts->dstrect.y = (int)dstrect->y;
-    verts->dstrect.w = (int)dstrect->w;
-    verts->dstrect.h = (int)dstrect->h;
-    verts->angle = angle;
-    SDL_memcpy(&verts->center, center, sizeof (SDL_FPoint));
-    verts->flip = flip;
+    cmd->data.draw.count = count;
+    SW_GetViewportOffset(renderer, &x, &y);
+
+    for (i = 0; i < count; i++, verts++) {
+        SDL_memcpy(&verts->srcrect, &srcrects[i], sizeof (SDL_Rect));
+
+        verts->dstrect.x = (int)dstrects[i].x + x;
+        verts->dstrect.y = (int)dstrects[i].y + y;
+        verts->dstrect.w = (int)dstrects[i].w;
+        verts->dstrect.h = (int)dstrects[i].h;
+        verts->angle = angles[i];
+        SDL_memcpy(&verts->center, &centers[i], sizeof (SDL_FPoint));
+        verts->flip = flips[i];
+    }
 
     return 0;
 }
 
+static int
+SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+               const SDL_Rect * srcrect, const SDL_FRect * dstrect,
+               const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
+{
+    return SW_QueueCopyExBatch(renderer, cmd, texture, srcrect, dstrect, &angle, center, &flip, 1);
+}
+
 static int
 SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * texture,
                 const SDL_Rect * srcrect, const SDL_Rect * final_rect,
@@ -549,7 +641,7 @@ SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *te
         int num_vertices, const void *indices, int num_indices, int size_indices,
         float scale_x, float scale_y)
 {
-    int i;
+    int i, x, y;
     int count = indices ? num_indices : num_vertices;
     void *verts;
     int sz = texture ? sizeof (GeometryCopyData) : sizeof (GeometryFillData);
@@ -560,6 +652,7 @@ SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *te
     }
 
     cmd->data.draw.count = count;
+    SW_GetViewportOffset(renderer, &x, &y);
     size_indices = indices ? size_indices : 0;
 
     if (texture) {
@@ -587,8 +680,8 @@ SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *te
             ptr->src.x = (int)(uv_[0] * texture->w);
             ptr->src.y = (int)(uv_[1] * texture->h);
 
-            ptr->dst.x = (int)(xy_[0] * scale_x);
-            ptr->dst.y = (int)(xy_[1] * scale_y);
+            ptr->dst.x = (int)(xy_[0] * scale_x) + x;
+            ptr->dst.y = (int)(xy_[1] * scale_y) + y;
             trianglepoint_2_fixedpoint(&ptr->dst);
 
             ptr->color = col_;
@@ -615,8 +708,8 @@ SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *te
             xy_ = (float *)((char*)xy + j * xy_stride);
             col_ = *(SDL_Color *)((char*)color + j * color_stride);
 
-            ptr->dst.x = (int)(xy_[0] * scale_x);
-            ptr->dst.y = (int)(xy_[1] * scale_y);
+            ptr->dst.x = (int)(xy_[0] * scale_x) + x;
+            ptr->dst.y = (int)(xy_[1] * scale_y) + y;
             trianglepoint_2_fixedpoint(&ptr->dst);
 
             ptr->color = col_;
@@ -651,92 +744,529 @@ PrepTextureForCopy(const SDL_RenderCommand *cmd)
     SDL_SetSurfaceBlendMode(surface, blend);
 }
 
+static void
+GetDrawClipRect(const SW_DrawStateCache *drawstate, SDL_Rect *clip_rect)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const SDL_Rect *cliprect = drawstate->cliprect;
+    SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
+
+    if (cliprect != NULL) {
+        clip_rect->x = cliprect->x + viewport->x;
+        clip_rect->y = cliprect->y + viewport->y;
+        clip_rect->w = cliprect->w;
+        clip_rect->h = cliprect->h;
+        SDL_IntersectRect(viewport, clip_rect, clip_rect);
+    } else {
+        *clip_rect = *viewport;
+    }
+}
+
 static void
 SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
 {
     if (drawstate->surface_cliprect_dirty) {
-        const SDL_Rect *viewport = drawstate->viewport;
-        const SDL_Rect *cliprect = drawstate->cliprect;
-        SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
-
-        if (cliprect != NULL) {
-            SDL_Rect clip_rect;
-            clip_rect.x = cliprect->x + viewport->x;
-            clip_rect.y = cliprect->y + viewport->y;
-            clip_rect.w = cliprect->w;
-            clip_rect.h = cliprect->h;
-            SDL_IntersectRect(viewport, &clip_rect, &clip_rect);
-            SDL_SetClipRect(surface, &clip_rect);
-        } else {
-            SDL_SetClipRect(surface, drawstate->viewport);
-        }
+        SDL_Rect clip_rect;
+        GetDrawClipRect(drawstate, &clip_rect);
+        SDL_SetClipRect(surface, &clip_rect);
         drawstate->surface_cliprect_dirty = SDL_FALSE;
     }
 }
 
+static void
+SW_RunCommand(SDL_Renderer * renderer, SDL_Surface *surface, SW_DrawStateCache *drawstate, SDL_RenderCommand *cmd, void *vertices)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_SETDRAWCOLOR: {
+            break;  /* Not used in this backend. */
+        }
+
+        case SDL_RENDERCMD_SETVIEWPORT: {
+            drawstate->viewport = &cmd->data.viewport.rect;
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_SETCLIPRECT: {
+            drawstate->cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_CLEAR: {
+            const Uint8 r = cmd->data.color.r;
+            const Uint8 g = cmd->data.color.g;
+            const Uint8 b = cmd->data.color.b;
+            const Uint8 a = cmd->data.color.a;
+            /* By definition the clear ignores the clip rect */
+            SDL_SetClipRect(surface, NULL);
+            SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_DRAW_LINES: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Rect *verts = (const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY: {
+            SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            SDL_Texture *texture = cmd->data.draw.texture;
+            SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+            int i;
+
+            SetDrawState(surface, drawstate);
+
+            PrepTextureForCopy(cmd);
+
+            for (i = 0; i < count; i++, verts += 2) {
+                SDL_Rect srcrect = verts[0];
+                SDL_Rect dstrect = verts[1];  /* the blit clips these, keep the queued ones intact. */
+
+                if ( srcrect.w == dstrect.w && srcrect.h == dstrect.h ) {
+                    SDL_BlitSurface(src, &srcrect, surface, &dstrect);
+                } else {
+                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+                     * to avoid potentially frequent RLE encoding/decoding.
+                     */
+                    SDL_SetSurfaceRLE(surface, 0);
+                    SDL_PrivateUpperBlitScaled(src, &srcrect, surface, &dstrect, texture->scaleMode);
+                }
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY_EX: {
+            CopyExData *copydata = (CopyExData *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            int i;
+
+            SetDrawState(surface, drawstate);
+            PrepTextureForCopy(cmd);
+
+            for (i = 0; i < count; i++, copydata++) {
+                SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
+                                &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_GEOMETRY: {
+            int i;
+            SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            SDL_Texture *texture = cmd->data.draw.texture;
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+
+            SetDrawState(surface, drawstate);
+
+            if (texture) {
+                SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+
+                GeometryCopyData *ptr = (GeometryCopyData *) verts;
+
+                PrepTextureForCopy(cmd);
+
+                for (i = 0; i < count; i += 3, ptr += 3) {
+                    SDL_SW_BlitTriangle(
+                            src,
+                            &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
+                            surface,
+                            &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
+                            ptr[0].color, ptr[1].color, ptr[2].color);
+                }
+            } else {
+                GeometryFillData *ptr = (GeometryFillData *) verts;
+
+                for (i = 0; i < count; i += 3, ptr += 3) {
+                    SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
+                }
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_NO_OP:
+            break;
+    }
+}
+
+#if !SDL_THREADS_DISABLED
+
+/* Tiled rendering splits the target into SW_TILE_SIZE squares, bins every
+ * drawing command into the tiles it touches, and lets the workers draw
+ * whole tiles, each clipped to its square. Clipping only changes which
+ * pixels get written for everything binned here, so the result is the
+ * same as drawing the commands in order on one thread. Commands where the
+ * clip rect changes the math (scaled and rotated copies, sloped lines) or
+ * whose source has no pixels right now (RLE encoded textures) draw on the
+ * target directly, after the tiles binned so far.
+ */
+
+static SDL_bool
+SW_CanRenderTiled(SW_RenderData *data, SDL_Surface *surface)
+{
+    return (data->num_workers > 1 && !surface->format->palette && !SDL_MUSTLOCK(surface)) ? SDL_TRUE : SDL_FALSE;
+}
+
 static int
-SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+SW_GetTileTexture(SW_RenderData *data, SDL_Texture *texture)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SW_DrawStateCache drawstate;
+    int i;
 
-    if (!surface) {
-        return -1;
+    for (i = data->num_tile_textures - 1; i >= 0; i--) {
+        if (data->tile_textures[i] == texture) {
+            return i;
+        }
     }
 
-    drawstate.viewport = NULL;
-    drawstate.cliprect = NULL;
-    drawstate.surface_cliprect_dirty = SDL_TRUE;
+    if (data->num_tile_textures == data->max_tile_textures) {
+        const int max_tile_textures = data->max_tile_textures ? (data->max_tile_textures * 2) : 8;
+        SDL_Texture **tile_textures = (SDL_Texture **) SDL_realloc(data->tile_textures, max_tile_textures * sizeof (SDL_Texture *));
+        if (!tile_textures) {
+            return -1;
+        }
+        data->tile_textures = tile_textures;
+        data->max_tile_textures = max_tile_textures;
+    }
 
-    while (cmd) {
-        switch (cmd->command) {
-            case SDL_RENDERCMD_SETDRAWCOLOR: {
-                break;  /* Not used in this backend. */
+    data->tile_textures[data->num_tile_textures] = texture;
+    return data->num_tile_textures++;
+}
+
+/* Adds an entry to every tile that bounds touches. bounds must be inside
+   the target. Either every tile gets it or, when out of memory, none. */
+static SDL_bool
+SW_BinEntry(SW_RenderData *data, const SDL_RenderCommand *cmd, const SDL_Rect *cliprect,
+            const SDL_Rect *bounds, int first, int texture)
+{
+    const int x0 = bounds->x / SW_TILE_SIZE;
+    const int y0 = bounds->y / SW_TILE_SIZE;
+    const int x1 = (bounds->x + bounds->w - 1) / SW_TILE_SIZE;
+    const int y1 = (bounds->y + bounds->h - 1) / SW_TILE_SIZE;
+    int x, y;
+
+    for (y = y0; y <= y1; y++) {
+        for (x = x0; x <= x1; x++) {
+            SW_Tile *tile = &data->tiles[y * data->tiles_x + x];
+            if (tile->num_entries == tile->max_entries) {
+                const int max_entries = tile->max_entries ? (tile->max_entries * 2) : 64;
+                SW_TileEntry *entries = (SW_TileEntry *) SDL_realloc(tile->entries, max_entries * sizeof (SW_TileEntry));
+                if (!entries) {
+                    return SDL_FALSE;
+                }
+                tile->entries = entries;
+                tile->max_entries = max_entries;
             }
+        }
+    }
 
-            case SDL_RENDERCMD_SETVIEWPORT: {
-                drawstate.viewport = &cmd->data.viewport.rect;
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
+    for (y = y0; y <= y1; y++) {
+        for (x = x0; x <= x1; x++) {
+            SW_Tile *tile = &data->tiles[y * data->tiles_x + x];
+            SW_TileEntry *entry = tile->num_entries ? &tile->entries[tile->num_entries - 1] : NULL;
+
+            /* Copies or triangles that follow each other in a tile share an entry. */
+            if (entry && entry->cmd == cmd && entry->first + entry->count == first) {
+                entry->count++;
+                continue;
             }
 
-            case SDL_RENDERCMD_SETCLIPRECT: {
-                drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
+            entry = &tile->entries[tile->num_entries++];
+            entry->cmd = cmd;
+            entry->cliprect = *cliprect;
+            entry->first = first;
+            entry->count = 1;
+            entry->texture = texture;
+        }
+    }
+
+    data->tiles_binned = SDL_TRUE;
+    return SDL_TRUE;
+}
+
+/* Bins the copies or triangles of a command one by one, since a batch of
+   them tends to cover the whole target. Takes them all back on failure. */
+static SDL_bool
+SW_BinEach(SW_RenderData *data, const SDL_RenderCommand *cmd, void *vertices, const SDL_Rect *cliprect, int texture)
+{
+    const int count = (int) cmd->data.draw.count;
+    const int num_items = (cmd->command == SDL_RENDERCMD_COPY) ? count : (count / 3);
+    const int num_tiles = data->tiles_x * data->tiles_y;
+    SDL_Rect bounds;
+    int i;
+
+    for (i = 0; i < num_tiles; i++) {
+        data->tiles[i].saved_entries = data->tiles[i].num_entries;
+    }
+
+    for (i = 0; i < num_items; i++) {
+        if (cmd->command == SDL_RENDERCMD_COPY) {
+            bounds = ((const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first))[i * 2 + 1];
+        } else {
+            const SDL_Point *d0, *d1, *d2;
+            if (cmd->data.draw.texture) {
+                const GeometryCopyData *ptr = ((const GeometryCopyData *) (((Uint8 *) vertices) + cmd->data.draw.first)) + i * 3;
+                d0 = &ptr[0].dst;
+                d1 = &ptr[1].dst;
+                d2 = &ptr[2].dst;
+            } else {
+                const GeometryFillData *ptr = ((const GeometryFillData *) (((Uint8 *) vertices) + cmd->data.draw.first)) + i * 3;
+                d0 = &ptr[0].dst;
+                d1 = &ptr[1].dst;
+                d2 = &ptr[2].dst;
+            }
+            SDL_SW_TriangleBounds(d0, d1, d2, &bounds);
+        }
+
+        if (SDL_IntersectRect(&bounds, cliprect, &bounds) &&
+            !SW_BinEntry(data, cmd, cliprect, &bounds, i, texture)) {
+            for (i = 0; i < num_tiles; i++) {
+                data->tiles[i].num_entries = data->tiles[i].saved_entries;
+            }
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Bins a command, or returns SDL_FALSE if it has to be drawn on the target
+   instead. Its vertices already have the viewport applied. */
+static SDL_bool
+SW_BinCommand(SW_RenderData *data, SDL_Surface *surface, const SW_DrawStateCache *drawstate, SDL_RenderCommand *cmd, void *vertices)
+{
+    const int count = (int) cmd->data.draw.count;
+    SDL_Rect surface_rect, cliprect, bounds;
+    int texture = -1;
+    int i;
+
+    surface_rect.x = 0;
+    surface_rect.y = 0;
+    surface_rect.w = surface->w;
+    surface_rect.h = surface->h;
+
+    switch (cmd->command) {
+        case SDL_RENDERCMD_CLEAR:
+            /* By definition the clear ignores the clip rect */
+            return SW_BinEntry(data, cmd, &surface_rect, &surface_rect, 0, -1);
+
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_FILL_RECTS:
+            break;
+
+        case SDL_RENDERCMD_DRAW_LINES: {
+            const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            /* Clipping a sloped line changes its slope. */
+            for (i = 1; i < count; i++) {
+                if (verts[i].x != verts[i - 1].x && verts[i].y != verts[i - 1].y) {
+                    return SDL_FALSE;
+                }
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY: {
+            const SDL_Rect *verts = (const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_Surface *src = (const SDL_Surface *) cmd->data.draw.texture->driverdata;
+
+            PrepTextureForCopy(cmd);
+            if (src->flags & SDL_RLEACCEL) {
+                return SDL_FALSE;
+            }
+            for (i = 0; i < count; i++, verts += 2) {
+                if (verts[0].w != verts[1].w || verts[0].h != verts[1].h) {
+                    return SDL_FALSE;
+                }
+            }
+            texture = SW_GetTileTexture(data, cmd->data.draw.texture);
+            if (texture < 0) {
+                return SDL_FALSE;
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_GEOMETRY: {
+            if (cmd->data.draw.texture) {
+                const SDL_Surface *src = (const SDL_Surface *) cmd->data.draw.texture->driverdata;
+
+                PrepTextureForCopy(cmd);
+                if (src->flags & SDL_RLEACCEL) {
+                    return SDL_FALSE;
+                }
+                texture = SW_GetTileTexture(data, cmd->data.draw.texture);
+                if (texture < 0) {
+                    return SDL_FALSE;
+                }
+            }
+            break;
+        }
+
+        default:
+            return SDL_FALSE;
+    }
+
+    GetDrawClipRect(drawstate, &cliprect);
+    if (!SDL_IntersectRect(&cliprect, &surface_rect, &cliprect)) {
+        return SDL_TRUE;  /* nothing to draw */
+    }
+
+    switch (cmd->command) {
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_DRAW_LINES: {
+            const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            int minx = SDL_MAX_SINT32, miny = SDL_MAX_SINT32, maxx = SDL_MIN_SINT32, maxy = SDL_MIN_SINT32;
+            for (i = 0; i < count; i++) {
+                minx = SDL_min(minx, verts[i].x);
+                miny = SDL_min(miny, verts[i].y);
+                maxx = SDL_max(maxx, verts[i].x);
+                maxy = SDL_max(maxy, verts[i].y);
+            }
+            bounds.x = minx;
+            bounds.y = miny;
+            bounds.w = (count > 0) ? (maxx - minx + 1) : 0;
+            bounds.h = (count > 0) ? (maxy - miny + 1) : 0;
+            break;
+        }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const SDL_Rect *verts = (const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            SDL_zero(bounds);
+            for (i = 0; i < count; i++) {
+                SDL_UnionRect(&bounds, &verts[i], &bounds);
             }
+            break;
+        }
+
+        default:
+            SDL_zero(bounds);
+            break;
+    }
+
+    if (cmd->command == SDL_RENDERCMD_COPY || cmd->command == SDL_RENDERCMD_GEOMETRY) {
+        return SW_BinEach(data, cmd, vertices, &cliprect, texture);
+    } else if (!SDL_IntersectRect(&bounds, &cliprect, &bounds)) {
+        return SDL_TRUE;  /* nothing to draw */
+    }
+    return SW_BinEntry(data, cmd, &cliprect, &bounds, 0, texture);
+}
+
+static SDL_Surface *
+SW_GetTileSource(SW_TileWorker *worker, const SW_TileEntry *entry)
+{
+    const SDL_RenderCommand *cmd = entry->cmd;
+    SDL_Surface *view;
+
+    if (!worker->sources) {
+        /* drawing serially, straight from the texture like SW_RunCommand() would */
+        PrepTextureForCopy(cmd);
+        return (SDL_Surface *) cmd->data.draw.texture->driverdata;
+    }
+
+    view = worker->sources[entry->texture];
+    if (!view) {
+        SDL_Surface *src = (SDL_Surface *) cmd->data.draw.texture->driverdata;
+        view = SDL_CreateRGBSurfaceWithFormatFrom(src->pixels, src->w, src->h, src->format->BitsPerPixel,
+                                                  src->pitch, src->format->format);
+        if (!view) {
+            return NULL;
+        }
+        worker->sources[entry->texture] = view;
+    }
+
+    /* Same state PrepTextureForCopy() gave the texture for this command */
+    SDL_SetSurfaceColorMod(view, cmd->data.draw.r, cmd->data.draw.g, cmd->data.draw.b);
+    SDL_SetSurfaceAlphaMod(view, cmd->data.draw.a);
+    SDL_SetSurfaceBlendMode(view, cmd->data.draw.blend);
+    return view;
+}
+
+static void
+SW_RenderTile(SW_RenderData *data, SW_TileWorker *worker, int index)
+{
+    const SW_Tile *tile = &data->tiles[index];
+    SDL_Surface *surface = worker->surface;
+    void *vertices = data->tile_vertices;
+    SDL_Rect tile_rect;
+    int i;
+
+    tile_rect.x = (index % data->tiles_x) * SW_TILE_SIZE;
+    tile_rect.y = (index / data->tiles_x) * SW_TILE_SIZE;
+    tile_rect.w = SW_TILE_SIZE;
+    tile_rect.h = SW_TILE_SIZE;
+
+    for (i = 0; i < tile->num_entries; i++) {
+        const SW_TileEntry *entry = &tile->entries[i];
+        const SDL_RenderCommand *cmd = entry->cmd;
+        const Uint8 r = cmd->data.draw.r;
+        const Uint8 g = cmd->data.draw.g;
+        const Uint8 b = cmd->data.draw.b;
+        const Uint8 a = cmd->data.draw.a;
+        const int count = (int) cmd->data.draw.count;
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        SDL_Rect cliprect;
+
+        SDL_IntersectRect(&entry->cliprect, &tile_rect, &cliprect);
+        SDL_SetClipRect(surface, &cliprect);
 
+        switch (cmd->command) {
             case SDL_RENDERCMD_CLEAR: {
-                const Uint8 r = cmd->data.color.r;
-                const Uint8 g = cmd->data.color.g;
-                const Uint8 b = cmd->data.color.b;
-                const Uint8 a = cmd->data.color.a;
-                /* By definition the clear ignores the clip rect */
-                SDL_SetClipRect(surface, NULL);
-                SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
+                SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, cmd->data.color.r, cmd->data.color.g,
+                                                        cmd->data.color.b, cmd->data.color.a));
                 break;
             }
 
             case SDL_RENDERCMD_DRAW_POINTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    int i;
-                    for (i = 0; i < count; i++) {
-                        verts[i].x += drawstate.viewport->x;
-                        verts[i].y += drawstate.viewport->y;
-                    }
-                }
-
+                const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
                 if (blend == SDL_BLENDMODE_NONE) {
                     SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
                 } else {
@@ -746,24 +1276,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
             }
 
             case SDL_RENDERCMD_DRAW_LINES: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    int i;
-                    for (i = 0; i < count; i++) {
-                        verts[i].x += drawstate.viewport->x;
-                        verts[i].y += drawstate.viewport->y;
-                    }
-                }
-
+                const SDL_Point *verts = (const SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
                 if (blend == SDL_BLENDMODE_NONE) {
                     SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
                 } else {
@@ -773,24 +1286,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
             }
 
             case SDL_RENDERCMD_FILL_RECTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    int i;
-                    for (i = 0; i < count; i++) {
-                        verts[i].x += drawstate.viewport->x;
-                        verts[i].y += drawstate.viewport->y;
-                    }
-                }
-
+                const SDL_Rect *verts = (const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
                 if (blend == SDL_BLENDMODE_NONE) {
                     SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
                 } else {
@@ -800,79 +1296,23 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
             }
 
             case SDL_RENDERCMD_COPY: {
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_Rect *srcrect = verts;
-                SDL_Rect *dstrect = verts + 1;
-                SDL_Texture *texture = cmd->data.draw.texture;
-                SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-
-                SetDrawState(surface, &drawstate);
-
-                PrepTextureForCopy(cmd);
-
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    dstrect->x += drawstate.viewport->x;
-                    dstrect->y += drawstate.viewport->y;
-                }
-
-                if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
-                    SDL_BlitSurface(src, srcrect, surface, dstrect);
-                } else {
-                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                     * to avoid potentially frequent RLE encoding/decoding.
-                     */
-                    SDL_SetSurfaceRLE(surface, 0);
-                    SDL_PrivateUpperBlitScaled(src, srcrect, surface, dstrect, texture->scaleMode);
-                }
-                break;
-            }
-
-            case SDL_RENDERCMD_COPY_EX: {
-                CopyExData *copydata = (CopyExData *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                SetDrawState(surface, &drawstate);
-                PrepTextureForCopy(cmd);
-
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    copydata->dstrect.x += drawstate.viewport->x;
-                    copydata->dstrect.y += drawstate.viewport->y;
+                const SDL_Rect *verts = ((const SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first)) + entry->first * 2;
+                SDL_Surface *src = SW_GetTileSource(worker, entry);
+                int j;
+                for (j = 0; src && j < entry->count; j++, verts += 2) {
+                    SDL_Rect srcrect = verts[0];
+                    SDL_Rect dstrect = verts[1];
+                    SDL_BlitSurface(src, &srcrect, surface, &dstrect);
                 }
-
-                SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
-                                &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
                 break;
             }
 
             case SDL_RENDERCMD_GEOMETRY: {
-                int i;
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const int count = (int) cmd->data.draw.count;
-                SDL_Texture *texture = cmd->data.draw.texture;
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-
-                SetDrawState(surface, &drawstate);
-
-                if (texture) {
-                    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-
-                    GeometryCopyData *ptr = (GeometryCopyData *) verts;
-
-                    PrepTextureForCopy(cmd);
-
-                    /* Apply viewport */
-                    if (drawstate.viewport->x || drawstate.viewport->y) {
-                        SDL_Point vp;
-                        vp.x = drawstate.viewport->x;
-                        vp.y = drawstate.viewport->y;
-                        trianglepoint_2_fixedpoint(&vp);
-                        for (i = 0; i < count; i++) {
-                            ptr[i].dst.x += vp.x;
-                            ptr[i].dst.y += vp.y;
-                        }
-                    }
-
-                    for (i = 0; i < count; i += 3, ptr += 3) {
+                int j;
+                if (cmd->data.draw.texture) {
+                    GeometryCopyData *ptr = ((GeometryCopyData *) (((Uint8 *) vertices) + cmd->data.draw.first)) + entry->first * 3;
+                    SDL_Surface *src = SW_GetTileSource(worker, entry);
+                    for (j = 0; src && j < entry->count; j++, ptr += 3) {
                         SDL_SW_BlitTriangle(
                                 src,
                                 &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
@@ -881,37 +1321,224 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                                 ptr[0].color, ptr[1].color, ptr[2].color);
                     }
                 } else {
-                    GeometryFillData *ptr = (GeometryFillData *) verts;
-
-                    /* Apply viewport */
-                    if (drawstate.viewport->x || drawstate.viewport->y) {
-                        SDL_Point vp;
-                        vp.x = drawstate.viewport->x;
-                        vp.y = drawstate.viewport->y;
-                        trianglepoint_2_fixedpoint(&vp);
-                        for (i = 0; i < count; i++) {
-                            ptr[i].dst.x += vp.x;
-                            ptr[i].dst.y += vp.y;
-                        }
-                    }
-
-                    for (i = 0; i < count; i += 3, ptr += 3) {
+                    GeometryFillData *ptr = ((GeometryFillData *) (((Uint8 *) vertices) + cmd->data.draw.first)) + entry->first * 3;
+                    for (j = 0; j < entry->count; j++, ptr += 3) {
                         SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
                     }
                 }
                 break;
             }
 
+            default:
+                break;
+        }
+    }
+}
+
+static void
+SW_RunTileWorker(SW_RenderData *data, SW_TileWorker *worker)
+{
+    const int num_tiles = data->tiles_x * data->tiles_y;
+    int index;
+
+    while ((index = SDL_AtomicAdd(&data->tiles_next, 1)) < num_tiles) {
+        if (data->tiles[index].num_entries) {
+            SW_RenderTile(data, worker, index);
+        }
+    }
+}
+
+static int SDLCALL
+SW_TileThread(void *ptr)
+{
+    SW_TileWorker *worker = (SW_TileWorker *) ptr;
+    SW_RenderData *data = worker->data;
+
+    for (;;) {
+        SDL_SemWait(data->tiles_start);
+        if (SDL_AtomicGet(&data->tiles_quit)) {
+            break;
+        }
+        SW_RunTileWorker(data, worker);
+        SDL_SemPost(data->tiles_done);
+    }
+    return 0;
+}
+
+static SDL_bool
+SW_PrepareTileWorker(SW_RenderData *data, SW_TileWorker *worker, SDL_Surface *surface)
+{
+    if (worker->max_sources < data->num_tile_textures) {
+        SDL_Surface **sources = (SDL_Surface **) SDL_realloc(worker->sources, data->max_tile_textures * sizeof (SDL_Surface *));
+        if (!sources) {
+            return SDL_FALSE;
+        }
+        worker->sources = sources;
+        worker->max_sources = data->max_tile_textures;
+    }
+    if (data->num_tile_textures) {
+        SDL_memset(worker->sources, 0, data->num_tile_textures * sizeof (SDL_Surface *));
+    }
+
+    worker->surface = SDL_CreateRGBSurfaceWithFormatFrom(surface->pixels, surface->w, surface->h,
+                                                         surface->format->BitsPerPixel, surface->pitch,
+                                                         surface->format->format);
+    return worker->surface ? SDL_TRUE : SDL_FALSE;
+}
+
+static void
+SW_RenderTiles(SW_RenderData *data, SDL_Surface *surface, void *vertices)
+{
+    int i, j, num_workers;
+
+    if (!data->tiles_binned) {
+        return;
+    }
+
+    for (num_workers = 0; num_workers < data->num_workers; num_workers++) {
+        if (!SW_PrepareTileWorker(data, &data->workers[num_workers], surface)) {
+            break;
+        }
+    }
+    /* Any thread can pick up the work, so it's all of them or just this one. */
+    if (num_workers < data->num_workers) {
+        num_workers = SDL_min(num_workers, 1);
+    }
+
+    if (num_workers > 0) {
+        data->tile_vertices = vertices;
+        SDL_AtomicSet(&data->tiles_next, 0);
+        for (i = 1; i < num_workers; i++) {
+            SDL_SemPost(data->tiles_start);
+        }
+        SW_RunTileWorker(data, &data->workers[0]);
+        for (i = 1; i < num_workers; i++) {
+            SDL_SemWait(data->tiles_done);
+        }
+    } else {
+        /* No memory for the views, so draw the tiles on the target and the
+           textures themselves. Only this thread touches them, like the
+           untiled path, it just has to put the target's clip rect back. */
+        SW_TileWorker serial;
+        SDL_Rect cliprect;
+
+        SDL_zero(serial);
+        serial.data = data;
+        serial.surface = surface;
+        SDL_GetClipRect(surface, &cliprect);
+        data->tile_vertices = vertices;
+        SDL_AtomicSet(&data->tiles_next, 0);
+        SW_RunTileWorker(data, &serial);
+        SDL_SetClipRect(surface, &cliprect);
+    }
+
+    /* The texture views map onto the target view, free them first. */
+    for (i = 0; i < data->num_workers; i++) {
+        SW_TileWorker *worker = &data->workers[i];
+        if (worker->surface) {
+            for (j = 0; j < data->num_tile_textures; j++) {
+                SDL_FreeSurface(worker->sources[j]);
+            }
+            SDL_FreeSurface(worker->surface);
+            worker->surface = NULL;
+        }
+    }
+
+    for (i = 0; i < data->tiles_x * data->tiles_y; i++) {
+        data->tiles[i].num_entries = 0;
+    }
+    data->num_tile_textures = 0;
+    data->tiles_binned = SDL_FALSE;
+}
+
+static int
+SW_RunCommandQueueTiled(SDL_Renderer * renderer, SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    const int tiles_x = (surface->w + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    const int tiles_y = (surface->h + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    SW_DrawStateCache drawstate;
+
+    if (tiles_x * tiles_y > data->max_tiles) {
+        SW_Tile *tiles = (SW_Tile *) SDL_realloc(data->tiles, tiles_x * tiles_y * sizeof (SW_Tile));
+        if (!tiles) {
+            return SDL_OutOfMemory();
+        }
+        SDL_memset(tiles + data->max_tiles, 0, (tiles_x * tiles_y - data->max_tiles) * sizeof (SW_Tile));
+        data->tiles = tiles;
+        data->max_tiles = tiles_x * tiles_y;
+    }
+    data->tiles_x = tiles_x;
+    data->tiles_y = tiles_y;
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+            case SDL_RENDERCMD_SETVIEWPORT:
+            case SDL_RENDERCMD_SETCLIPRECT:
             case SDL_RENDERCMD_NO_OP:
+                /* These only change the draw state, not the target. */
+                SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
+                break;
+
+            default:
+                if (!SW_BinCommand(data, surface, &drawstate, cmd, vertices)) {
+                    SW_RenderTiles(data, surface, vertices);
+                    SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
+                }
                 break;
         }
 
         cmd = cmd->next;
     }
 
+    SW_RenderTiles(data, surface, vertices);
+
+    return 0;
+}
+
+#endif /* !SDL_THREADS_DISABLED */
+
+static int
+SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_DrawStateCache drawstate;
+
+    if (!surface) {
+        return -1;
+    }
+
+#if !SDL_THREADS_DISABLED
+    if (SW_CanRenderTiled((SW_RenderData *) renderer->driverdata, surface)) {
+        return SW_RunCommandQueueTiled(renderer, surface, cmd, vertices);
+    }
+#endif
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
+        cmd = cmd->next;
+    }
+
     return 0;
 }
 
+/* Looks up the window surface, if it changed, before the queue is drawn on
+   another thread. */
+static int
+SW_PrepareCommandQueue(SDL_Renderer * renderer)
+{
+    return SW_ActivateRenderer(renderer) ? 0 : -1;
+}
+
 static int
 SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                     Uint32 format, void * pixels, int pitch)
@@ -961,11 +1588,85 @@ SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     SDL_FreeSurface(surface);
 }
 
+#if !SDL_THREADS_DISABLED
+static void
+SW_StartTileThreads(SW_RenderData *data)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+    int threads = hint ? SDL_atoi(hint) : 1;
+    int i;
+
+    if (threads <= 0) {
+        threads = SDL_GetCPUCount();
+    }
+    if (threads <= 1) {
+        return;
+    }
+
+    data->workers = (SW_TileWorker *) SDL_calloc(threads, sizeof (SW_TileWorker));
+    data->tiles_start = SDL_CreateSemaphore(0);
+    data->tiles_done = SDL_CreateSemaphore(0);
+    if (!data->workers || !data->tiles_start || !data->tiles_done) {
+        return;  /* Not fatal, everything gets drawn on this thread. */
+    }
+
+    data->workers[0].data = data;
+    data->num_workers = 1;
+    for (i = 1; i < threads; i++) {
+        SW_TileWorker *worker = &data->workers[i];
+        worker->data = data;
+        worker->thread = SDL_CreateThreadInternal(SW_TileThread, "SDLRenderTiles", 0, worker);
+        if (!worker->thread) {
+            break;
+        }
+        data->num_workers++;
+    }
+}
+
+static void
+SW_StopTileThreads(SW_RenderData *data)
+{
+    int i;
+
+    SDL_AtomicSet(&data->tiles_quit, 1);
+    for (i = 1; i < data->num_workers; i++) {
+        SDL_SemPost(data->tiles_start);
+    }
+    for (i = 1; i < data->num_workers; i++) {
+        SDL_WaitThread(data->workers[i].thread, NULL);
+    }
+    if (data->workers) {
+        for (i = 0; i < data->num_workers; i++) {
+            SDL_free(data->workers[i].sources);
+        }
+        SDL_free(data->workers);
+    }
+    if (data->tiles_start) {
+        SDL_DestroySemaphore(data->tiles_start);
+    }
+    if (data->tiles_done) {
+        SDL_DestroySemaphore(data->tiles_done);
+    }
+    if (data->tiles) {
+        for (i = 0; i < data->max_tiles; i++) {
+            SDL_free(data->tiles[i].entries);
+        }
+        SDL_free(data->tiles);
+    }
+    SDL_free(data->tile_textures);
+}
+#endif /* !SDL_THREADS_DISABLED */
+
 static void
 SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+#if !SDL_THREADS_DISABLED
+    if (data) {
+        SW_StopTileThreads(data);
+    }
+#endif
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -995,6 +1696,9 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     }
     data->surface = surface;
     data->window = surface;
+#if !SDL_THREADS_DISABLED
+    SW_StartTileThreads(data);
+#endif
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
@@ -1011,12 +1715,16 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->QueueCopyBatch = SW_QueueCopyBatch;
+    renderer->QueueCopyExBatch = SW_QueueCopyExBatch;
     renderer->QueueGeometry = SW_QueueGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
+    renderer->PrepareCommandQueue = SW_PrepareCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderPresent = SW_RenderPresent;
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
+    renderer->async_capable = SDL_TRUE;  /* drawing only touches surface memory, see SW_CreateRenderer() for presenting */
     renderer->info = SW_RenderDriver.info;
     renderer->driverdata = data;
 
@@ -1030,6 +1738,7 @@ SW_CreateRenderer(SDL_Window * window, Uint32 flags)
 {
     const char *hint;
     SDL_Surface *surface;
+    SDL_Renderer *renderer;
     SDL_bool no_hint_set;
 
     /* Set the vsync hint based on our flags, if it's not already set */
@@ -1054,7 +1763,16 @@ SW_CreateRenderer(SDL_Window * window, Uint32 flags)
     if (!surface) {
         return NULL;
     }
-    return SW_CreateRendererForSurface(surface);
+    renderer = SW_CreateRendererForSurface(surface);
+
+    /* Presenting updates the window surface from the render thread. That's
+       fine for a framebuffer the video driver provides, but not for one
+       emulated with an accelerated renderer, whose context belongs to the
+       app's thread. */
+    if (renderer && SDL_GetWindowData(window, "_SDL_WindowTextureData")) {
+        renderer->async_capable = SDL_FALSE;
+    }
+    return renderer;
 }
 
 SDL_RenderDriver SW_RenderDriver = {
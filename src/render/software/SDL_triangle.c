@@ -133,6 +133,12 @@ static void bounding_rect(const SDL_Point *a, const SDL_Point *b, const SDL_Poin
     r->h = (max_y - min_y) >> FP_BITS;
 }
 
+/* pixels a triangle given in fixed point can draw to, before clipping */
+void SDL_SW_TriangleBounds(const SDL_Point *d0, const SDL_Point *d1, const SDL_Point *d2, SDL_Rect *rect)
+{
+    bounding_rect(d0, d1, d2, rect);
+}
+
 /* Triangle rendering, using Barycentric coordinates (w0, w1, w2)
  *
  * The cross product isn't computed from scratch at each iteration,
@@ -480,6 +480,9 @@ SDL_SensorQuit(void)
 int
 SDL_PrivateSensorUpdate(SDL_Sensor *sensor, float *data, int num_values)
 {
+#if !SDL_EVENTS_DISABLED
+    const Uint64 timestamp = SDL_GetPerformanceCounterNS();
+#endif
     int posted;
 
     /* Allow duplicate events, for things like steps and heartbeats */
@@ -498,7 +501,7 @@ SDL_PrivateSensorUpdate(SDL_Sensor *sensor, float *data, int num_values)
         num_values = SDL_min(num_values, SDL_arraysize(event.sensor.data));
         SDL_memset(event.sensor.data, 0, sizeof(event.sensor.data));
         SDL_memcpy(event.sensor.data, data, num_values*sizeof(*data));
-        posted = SDL_PushEvent(&event) == 1;
+        posted = SDL_PushEventTimestamped(&event, timestamp) == 1;
     }
 #endif /* !SDL_EVENTS_DISABLED */
     return posted;
@@ -492,4 +492,15 @@ SDL_GetTicks(void)
     return (Uint32) (SDL_GetTicks64() & 0xFFFFFFFF);
 }
 
+Uint64
+SDL_GetPerformanceCounterNS(void)
+{
+    const Uint64 ns_per_second = 1000000000;
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    /* Convert the whole seconds separately so counter * ns_per_second can't overflow */
+    return ((counter / frequency) * ns_per_second) + (((counter % frequency) * ns_per_second) / frequency);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
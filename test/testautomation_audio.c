@@ -968,6 +968,1602 @@ int audio_openCloseAudioDeviceConnected()
 }
 
 
+/**
+ * \brief Checks device statistics gathered while the dummy driver plays.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ */
+int audio_getAudioDeviceStats()
+{
+    SDL_AudioDeviceStats stats;
+    SDL_AudioSpec desired;
+    SDL_AudioDeviceID id;
+    static Uint8 queued[4096];
+    Uint64 histogram_total;
+    int totalDelay;
+    int result;
+    int i;
+
+    /* The dummy driver needs no hardware, so this runs anywhere. */
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+    result = SDL_AudioInit("dummy");
+    SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+    if (result != 0) {
+        _audioSetUp(NULL);
+        return TEST_ABORTED;
+    }
+
+    /* Negative cases */
+    result = SDL_GetAudioDeviceStats(0, &stats);
+    SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(0, ...)");
+    SDLTest_AssertCheck(result < 0, "Verify return value; expected: <0 got: %d", result);
+
+    /* Callback mode */
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples = 1024;
+    desired.callback = _audio_testCallback;
+    desired.userdata = NULL;
+
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, desired, NULL, 0)");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        result = SDL_GetAudioDeviceStats(id, NULL);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(id, NULL)");
+        SDLTest_AssertCheck(result < 0, "Verify return value; expected: <0 got: %d", result);
+
+        SDL_PauseAudioDevice(id, 0);
+        totalDelay = 0;
+        do {
+            SDL_Delay(10);
+            totalDelay += 10;
+            result = SDL_GetAudioDeviceStats(id, &stats);
+        } while ((result == 0) && ((stats.callbacks < 3) || (stats.wakeups < 2)) && (totalDelay < 2000));
+        SDL_PauseAudioDevice(id, 1);
+
+        SDLTest_AssertCheck(result == 0, "Verify return value; expected: 0 got: %d", result);
+        SDLTest_AssertCheck(stats.callbacks >= 3, "Verify callback count; expected: >=3 got: %d", (int) stats.callbacks);
+        SDLTest_AssertCheck(stats.wakeups >= 2, "Verify wake-up count; expected: >=2 got: %d", (int) stats.wakeups);
+        SDLTest_AssertCheck(stats.callback_ns_max <= stats.callback_ns_total, "Verify longest callback is within the total");
+        SDLTest_AssertCheck(stats.wakeup_jitter_ns_max <= stats.wakeup_jitter_ns_total, "Verify largest jitter is within the total");
+        SDLTest_AssertCheck(stats.underruns == 0, "Verify underruns; expected: 0 got: %d", (int) stats.underruns);
+        SDLTest_AssertCheck(stats.queued_bytes == 0, "Verify queued bytes; expected: 0 got: %d", (int) stats.queued_bytes);
+
+        histogram_total = 0;
+        for (i = 0; i < SDL_AUDIO_STATS_HISTOGRAM_BUCKETS; i++) {
+            histogram_total += stats.callback_histogram[i];
+        }
+        SDLTest_AssertCheck(histogram_total == stats.callbacks, "Verify histogram covers every callback; expected: %d got: %d", (int) stats.callbacks, (int) histogram_total);
+
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+    }
+
+    /* Queue mode: queued data shows up while the device is paused. */
+    desired.callback = NULL;
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, desired, NULL, 0) without a callback");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        SDL_memset(queued, 0, sizeof(queued));
+        result = SDL_QueueAudio(id, queued, sizeof(queued));
+        SDLTest_AssertPass("Call to SDL_QueueAudio()");
+        SDLTest_AssertCheck(result == 0, "Verify return value; expected: 0 got: %d", result);
+
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats()");
+        SDLTest_AssertCheck(result == 0, "Verify return value; expected: 0 got: %d", result);
+        SDLTest_AssertCheck(stats.queued_bytes == sizeof(queued), "Verify queued bytes; expected: %d got: %d", (int) sizeof(queued), (int) stats.queued_bytes);
+        SDLTest_AssertCheck(stats.callbacks == 0, "Verify callback count while paused; expected: 0 got: %d", (int) stats.callbacks);
+
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+    }
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+/* Logs the size of every callback and whether it took 8 ms (when _audio_adaptiveSlow is set). */
+#define ADAPTIVE_TEST_CALLBACKS 2048
+static SDL_atomic_t _audio_adaptiveSlow;
+static int _audio_adaptiveLens[ADAPTIVE_TEST_CALLBACKS];
+static SDL_bool _audio_adaptiveSlowCalls[ADAPTIVE_TEST_CALLBACKS];
+static int _audio_adaptiveCalls;
+
+void SDLCALL _audio_adaptiveCallback(void *userdata, Uint8 *stream, int len)
+{
+    const SDL_bool slow = SDL_AtomicGet(&_audio_adaptiveSlow) ? SDL_TRUE : SDL_FALSE;
+
+    SDL_memset(stream, 0, len);
+    if (_audio_adaptiveCalls < ADAPTIVE_TEST_CALLBACKS) {
+        _audio_adaptiveLens[_audio_adaptiveCalls] = len / 4;
+        _audio_adaptiveSlowCalls[_audio_adaptiveCalls] = slow;
+        _audio_adaptiveCalls++;
+    }
+    if (slow) {
+        SDL_Delay(8);
+    }
+}
+
+/**
+ * \brief Checks that the adaptive callback period shrinks for a quick callback and grows for a slow one.
+ *
+ * Rather than timing anything, this checks the sequence of callback sizes:
+ * every one is a power of two steps from the requested size and within the
+ * hinted bounds, the period moves one step at a time, it only halves after
+ * 16 quick callbacks at the longer period, and it doubles right after a
+ * callback that took more than half of a period of 512 frames or less.
+ *
+ * \sa https://wiki.libsdl.org/SDL_HINT_AUDIO_ADAPTIVE_PERIOD
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ */
+int audio_adaptivePeriod()
+{
+    SDL_AudioDeviceStats stats;
+    SDL_AudioSpec desired;
+    SDL_AudioDeviceID id;
+    int totalDelay;
+    int result;
+    int run = 0;
+    int shrinks = 0;
+    int grows = 0;
+    int bad_sizes = 0;
+    int bad_steps = 0;
+    int early_shrinks = 0;
+    int late_grows = 0;
+    int i;
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+    SDL_SetHint(SDL_HINT_AUDIO_ADAPTIVE_PERIOD, "256,4096");
+    result = SDL_AudioInit("dummy");
+    SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+    if (result != 0) {
+        SDL_SetHint(SDL_HINT_AUDIO_ADAPTIVE_PERIOD, NULL);
+        _audioSetUp(NULL);
+        return TEST_ABORTED;
+    }
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 1024;
+    desired.callback = _audio_adaptiveCallback;
+    SDL_AtomicSet(&_audio_adaptiveSlow, 0);
+    _audio_adaptiveCalls = 0;
+
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertCheck(result == 0, "Verify return value; expected: 0 got: %d", result);
+        SDLTest_AssertCheck(stats.callback_samples == 1024, "Verify starting period; expected: 1024 got: %u", (unsigned int) stats.callback_samples);
+
+        /* a callback that takes no time at all should get smaller buffers... */
+        SDL_PauseAudioDevice(id, 0);
+        totalDelay = 0;
+        do {
+            SDL_Delay(10);
+            totalDelay += 10;
+            result = SDL_GetAudioDeviceStats(id, &stats);
+        } while ((result == 0) && (stats.callback_samples >= 1024) && (totalDelay < 5000));
+
+        /* ...and one that takes 8 ms needs more than 16 ms worth of audio per call. */
+        SDL_AtomicSet(&_audio_adaptiveSlow, 1);
+        totalDelay = 0;
+        do {
+            SDL_Delay(10);
+            totalDelay += 10;
+            result = SDL_GetAudioDeviceStats(id, &stats);
+        } while ((result == 0) && (stats.callback_samples < 1024) && (totalDelay < 5000));
+
+        /* pausing waits for the callback in flight, so the log is ours now. */
+        SDL_PauseAudioDevice(id, 1);
+        SDLTest_AssertPass("Call to SDL_PauseAudioDevice(id, 1)");
+        SDLTest_Log("Logged %d callbacks", _audio_adaptiveCalls);
+        SDLTest_AssertCheck(_audio_adaptiveCalls > 0 && _audio_adaptiveLens[0] == 1024, "Verify the first callback used the requested size; got: %d", (_audio_adaptiveCalls > 0) ? _audio_adaptiveLens[0] : 0);
+
+        for (i = 0; i < _audio_adaptiveCalls; i++) {
+            const int len = _audio_adaptiveLens[i];
+            if ((len < 256) || (len > 4096) || ((len & (len - 1)) != 0)) {
+                bad_sizes++;
+            }
+            run++;
+            if (i + 1 < _audio_adaptiveCalls) {
+                const int next = _audio_adaptiveLens[i + 1];
+                if (next == len / 2) {
+                    shrinks++;
+                    if (run < 16) {
+                        early_shrinks++;
+                    }
+                } else if (next == len * 2) {
+                    grows++;
+                } else if (next != len) {
+                    bad_steps++;
+                }
+                if (next != len) {
+                    run = 0;
+                }
+                if (_audio_adaptiveSlowCalls[i] && (len <= 512) && (next != len * 2)) {
+                    late_grows++;
+                }
+            }
+        }
+        SDLTest_Log("Period shrank %d times and grew %d times", shrinks, grows);
+        SDLTest_AssertCheck(bad_sizes == 0, "Verify every callback size is a power of two within 256..4096 frames; got %d that aren't", bad_sizes);
+        SDLTest_AssertCheck(bad_steps == 0, "Verify the period only moves one step at a time; got %d jumps", bad_steps);
+        SDLTest_AssertCheck(shrinks > 0, "Verify the period shrank for a quick callback; got %d halvings", shrinks);
+        SDLTest_AssertCheck(grows > 0, "Verify the period grew for a slow callback; got %d doublings", grows);
+        SDLTest_AssertCheck(early_shrinks == 0, "Verify the period only halves after 16 quick callbacks; got %d early halvings", early_shrinks);
+        SDLTest_AssertCheck(late_grows == 0, "Verify the period doubles right after a slow callback at 512 frames or less; got %d misses", late_grows);
+
+        /* the period is adapted after each callback, so the last one is at most a step away. */
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertCheck(result == 0, "Verify return value; expected: 0 got: %d", result);
+        if (_audio_adaptiveCalls > 0 && _audio_adaptiveCalls < ADAPTIVE_TEST_CALLBACKS) {
+            const int last = _audio_adaptiveLens[_audio_adaptiveCalls - 1];
+            SDLTest_AssertCheck(last == (int) stats.callback_samples || last * 2 == (int) stats.callback_samples || last == (int) stats.callback_samples * 2,
+                                "Verify the last callback is within one step of the period; period: %u got: %d", (unsigned int) stats.callback_samples, last);
+        }
+
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+    }
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    SDL_SetHint(SDL_HINT_AUDIO_ADAPTIVE_PERIOD, NULL);
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+/* Writes a rising sample counter starting at 1, then silence once enough has been rendered. */
+#define DISK_TEST_FRAMES (48000 * 10)
+static Sint16 _audio_diskCounter;
+static int _audio_diskFrames;
+
+void SDLCALL _audio_diskCallback(void *userdata, Uint8 *stream, int len)
+{
+    Sint16 *samples = (Sint16 *) stream;
+    int i;
+
+    for (i = 0; i < len / (int) sizeof (Sint16); i += 2) {
+        if (_audio_diskFrames < DISK_TEST_FRAMES) {
+            samples[i] = samples[i + 1] = _audio_diskCounter++;
+            _audio_diskFrames++;
+        } else {
+            samples[i] = samples[i + 1] = 0;
+        }
+    }
+
+    if (_audio_diskFrames >= DISK_TEST_FRAMES) {
+        SDL_Delay(1);  /* done, don't spin. */
+    }
+}
+
+/**
+ * \brief Renders ten seconds through the disk driver in freerun mode and checks the WAV it writes.
+ *
+ * \sa https://wiki.libsdl.org/SDL_HINT_AUDIO_DISK_FREERUN
+ */
+int audio_diskFreerun()
+{
+    const char *filename = "testautomation_audio_disk.wav";
+    SDL_AudioSpec desired, loaded;
+    SDL_AudioDeviceID id;
+    Uint8 *buf = NULL;
+    Uint32 buflen = 0;
+    Uint64 start;
+    Uint32 elapsed;
+    int result;
+    int mismatches = 0;
+    Uint32 first;
+    Uint32 i;
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+    SDL_setenv("SDL_DISKAUDIOFILE", filename, 1);
+    SDL_SetHint(SDL_HINT_AUDIO_DISK_FREERUN, "1");
+    result = SDL_AudioInit("disk");
+    SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+    if (result != 0) {
+        SDL_SetHint(SDL_HINT_AUDIO_DISK_FREERUN, NULL);
+        _audioSetUp(NULL);
+        return TEST_ABORTED;
+    }
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_S16LSB;
+    desired.channels = 2;
+    desired.samples = 1024;
+    desired.callback = _audio_diskCallback;
+    _audio_diskCounter = 1;
+    _audio_diskFrames = 0;
+
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        start = SDL_GetPerformanceCounter();
+        SDL_PauseAudioDevice(id, 0);
+        while (_audio_diskFrames < DISK_TEST_FRAMES) {
+            SDL_Delay(1);
+        }
+        elapsed = (Uint32) (((SDL_GetPerformanceCounter() - start) * 1000) / SDL_GetPerformanceFrequency());
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+        SDLTest_Log("Rendered %d ms of audio in %u ms", (DISK_TEST_FRAMES * 1000) / desired.freq, (unsigned int) elapsed);
+        SDLTest_AssertCheck(elapsed < 5000, "Verify rendering was faster than realtime; took %u ms", (unsigned int) elapsed);
+
+        SDLTest_AssertCheck(SDL_LoadWAV(filename, &loaded, &buf, &buflen) != NULL, "Load the written WAV file");
+        if (buf) {
+            SDLTest_AssertCheck(loaded.freq == desired.freq, "Verify frequency; expected: %d got: %d", desired.freq, loaded.freq);
+            SDLTest_AssertCheck(loaded.format == desired.format, "Verify format; expected: %d got: %d", desired.format, loaded.format);
+            SDLTest_AssertCheck(loaded.channels == desired.channels, "Verify channels; expected: %d got: %d", desired.channels, loaded.channels);
+            SDLTest_AssertCheck(buflen >= DISK_TEST_FRAMES * 4, "Verify data length; expected: >=%d got: %u", DISK_TEST_FRAMES * 4, (unsigned int) buflen);
+
+            /* the device may have written some silence before it was unpaused. */
+            for (first = 0; (first < buflen / 4) && (((Uint16 *) buf)[first * 2] == 0); first++) {
+            }
+            SDLTest_AssertCheck((first % desired.samples) == 0, "Verify data starts on a buffer boundary; got frame %u", (unsigned int) first);
+            SDLTest_AssertCheck((buflen / 4) - first >= DISK_TEST_FRAMES, "Verify every rendered frame was written");
+
+            for (i = 0; (i < DISK_TEST_FRAMES) && ((first + i) < buflen / 4); i++) {
+                const Sint16 expected = (Sint16) (i + 1);
+                const Sint16 left = (Sint16) SDL_SwapLE16(((Uint16 *) buf)[(first + i) * 2]);
+                const Sint16 right = (Sint16) SDL_SwapLE16(((Uint16 *) buf)[(first + i) * 2 + 1]);
+                if ((left != expected) || (right != expected)) {
+                    mismatches++;
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify sample data; expected: 0 mismatches got: %d", mismatches);
+            SDL_FreeWAV(buf);
+        }
+    }
+    remove(filename);
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    SDL_SetHint(SDL_HINT_AUDIO_DISK_FREERUN, NULL);
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Captures a known file through the disk driver's capture ring and reads it back in place.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AcquireCapturedAudio
+ * \sa https://wiki.libsdl.org/SDL_ReleaseCapturedAudio
+ */
+int audio_captureRing()
+{
+    const char *filename = "testautomation_audio_capture.raw";
+    const int buffers = 8;
+    const int frames = 1024;
+    SDL_AudioSpec desired;
+    SDL_AudioDeviceID id;
+    SDL_CapturedAudio captured;
+    SDL_RWops *rw;
+    Sint16 *samples;
+    Uint64 last = 0;
+    Uint64 start;
+    Uint32 dequeued;
+    int mismatches = 0;
+    int result;
+    int got = 0;
+    int i;
+
+    samples = (Sint16 *) SDL_malloc(buffers * frames * 2 * sizeof (Sint16));
+    SDLTest_AssertCheck(samples != NULL, "Allocate sample data");
+    if (!samples) {
+        return TEST_ABORTED;
+    }
+    for (i = 0; i < buffers * frames; i++) {
+        samples[i * 2] = samples[i * 2 + 1] = (Sint16) SDL_SwapLE16((Uint16) (i + 1));
+    }
+    rw = SDL_RWFromFile(filename, "wb");
+    SDLTest_AssertCheck(rw != NULL, "Create %s", filename);
+    if (!rw) {
+        SDL_free(samples);
+        return TEST_ABORTED;
+    }
+    SDL_RWwrite(rw, samples, sizeof (Sint16), buffers * frames * 2);
+    SDL_RWclose(rw);
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+    SDL_setenv("SDL_DISKAUDIOFILEIN", filename, 1);
+    SDL_SetHint(SDL_HINT_AUDIO_DISK_FREERUN, "1");
+    SDL_SetHint(SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS, "16");
+    result = SDL_AudioInit("disk");
+    SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_S16LSB;
+    desired.channels = 2;
+    desired.samples = (Uint16) frames;
+    desired.callback = NULL;
+
+    id = (result == 0) ? SDL_OpenAudioDevice(NULL, 1, &desired, NULL, 0) : 0;
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        result = SDL_ReleaseCapturedAudio(id);
+        SDLTest_AssertCheck(result < 0, "Verify releasing without acquiring fails; got: %d", result);
+        result = SDL_AcquireCapturedAudio(id, &captured);
+        SDLTest_AssertCheck(result == 0, "Verify nothing is captured while paused; got: %d", result);
+
+        SDL_PauseAudioDevice(id, 0);
+        start = SDL_GetTicks();
+        while ((SDL_GetQueuedAudioSize(id) < (Uint32) (buffers * frames * 4)) && ((SDL_GetTicks() - start) < 5000)) {
+            SDL_Delay(1);
+        }
+        SDLTest_AssertCheck(SDL_GetQueuedAudioSize(id) >= (Uint32) (buffers * frames * 4), "Verify the ring filled up; got: %u bytes", (unsigned int) SDL_GetQueuedAudioSize(id));
+
+        /* read the first half of the first buffer with a copy, the rest in place. */
+        dequeued = SDL_DequeueAudio(id, samples, frames * 2);
+        SDLTest_AssertCheck(dequeued == (Uint32) (frames * 2), "Verify SDL_DequeueAudio(); expected: %d got: %u", frames * 2, (unsigned int) dequeued);
+        for (i = 0; i < frames / 2; i++) {
+            if (SDL_SwapLE16((Uint16) samples[i * 2]) != (Uint16) (i + 1)) {
+                mismatches++;
+            }
+        }
+
+        for (got = 0; got < buffers; got++) {
+            const int first = (got == 0) ? frames / 2 : got * frames;
+            const Sint16 *data;
+            Uint32 expected_len = (got == 0) ? frames * 2 : frames * 4;
+
+            result = SDL_AcquireCapturedAudio(id, &captured);
+            if (result != 1) {
+                SDLTest_AssertCheck(result == 1, "Verify buffer %d was acquired; got: %d", got, result);
+                break;
+            }
+            if (got == 0) {
+                result = SDL_AcquireCapturedAudio(id, &captured);
+                SDLTest_AssertCheck(result < 0, "Verify acquiring twice fails; got: %d", result);
+            }
+
+            SDLTest_AssertCheck(captured.len == expected_len, "Verify buffer %d length; expected: %u got: %u", got, (unsigned int) expected_len, (unsigned int) captured.len);
+            SDLTest_AssertCheck(captured.timestamp >= last && captured.timestamp != 0, "Verify buffer %d timestamp doesn't go back in time", got);
+            last = captured.timestamp;
+
+            data = (const Sint16 *) captured.data;
+            for (i = 0; i < (int) (captured.len / 4) && i < frames; i++) {
+                const Uint16 expected = (Uint16) (first + i + 1);
+                if ((SDL_SwapLE16((Uint16) data[i * 2]) != expected) || (SDL_SwapLE16((Uint16) data[i * 2 + 1]) != expected)) {
+                    mismatches++;
+                }
+            }
+
+            result = SDL_ReleaseCapturedAudio(id);
+            SDLTest_AssertCheck(result == 0, "Verify buffer %d was released; got: %d", got, result);
+        }
+        SDLTest_AssertCheck(got == buffers, "Verify every buffer was captured; expected: %d got: %d", buffers, got);
+        SDLTest_AssertCheck(mismatches == 0, "Verify sample data; expected: 0 mismatches got: %d", mismatches);
+
+        SDL_PauseAudioDevice(id, 1);
+        SDL_ClearQueuedAudio(id);
+        SDLTest_AssertPass("Call to SDL_ClearQueuedAudio()");
+        SDLTest_AssertCheck(SDL_GetQueuedAudioSize(id) == 0, "Verify the ring is empty after clearing; got: %u bytes", (unsigned int) SDL_GetQueuedAudioSize(id));
+        result = SDL_AcquireCapturedAudio(id, &captured);
+        SDLTest_AssertCheck(result == 0, "Verify nothing is left to acquire after clearing; got: %d", result);
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+    }
+    SDL_free(samples);
+    remove(filename);
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    SDL_SetHint(SDL_HINT_AUDIO_CAPTURE_RING_BUFFERS, NULL);
+    SDL_SetHint(SDL_HINT_AUDIO_DISK_FREERUN, NULL);
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+
+/* Writes a RIFF WAVE header in front of datalen bytes of sample data and returns its size. */
+static size_t
+_audio_writeWavHeader(Uint8 *dst, Uint16 tag, Uint16 channels, Uint16 blockalign, Uint16 bits, const Uint8 *ext, Uint16 extlen, Uint32 datalen)
+{
+    const Uint32 fmtlen = 18 + extlen;
+    size_t pos = 0;
+
+#define WAVHDR_U16(v) { dst[pos++] = (Uint8) ((v) & 0xFF); dst[pos++] = (Uint8) (((v) >> 8) & 0xFF); }
+#define WAVHDR_U32(v) { WAVHDR_U16((v) & 0xFFFF); WAVHDR_U16(((v) >> 16) & 0xFFFF); }
+    SDL_memcpy(dst + pos, "RIFF", 4); pos += 4;
+    WAVHDR_U32(4 + 8 + fmtlen + 8 + datalen);
+    SDL_memcpy(dst + pos, "WAVEfmt ", 8); pos += 8;
+    WAVHDR_U32(fmtlen);
+    WAVHDR_U16(tag);
+    WAVHDR_U16(channels);
+    WAVHDR_U32(22050);
+    WAVHDR_U32(22050 * blockalign);
+    WAVHDR_U16(blockalign);
+    WAVHDR_U16(bits);
+    WAVHDR_U16(extlen);
+    SDL_memcpy(dst + pos, ext, extlen); pos += extlen;
+    SDL_memcpy(dst + pos, "data", 4); pos += 4;
+    WAVHDR_U32(datalen);
+#undef WAVHDR_U32
+#undef WAVHDR_U16
+
+    return pos;
+}
+
+/**
+ * \brief Checks that streaming WAV decoding matches SDL_LoadWAV_RW for every supported encoding.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_ReadWAVStream
+ * \sa https://wiki.libsdl.org/SDL_SeekWAVStream
+ */
+int audio_wavStream()
+{
+    const struct {
+        const char *name;
+        Uint16 tag;
+        Uint16 channels;
+        Uint16 blockalign;
+        Uint16 bits;
+        Uint16 samplesperblock;
+    } formats[] = {
+        { "PCM 16-bit stereo", 0x0001, 2, 4, 16, 0 },
+        { "PCM 24-bit mono", 0x0001, 1, 3, 24, 0 },
+        { "IEEE float stereo", 0x0003, 2, 8, 32, 0 },
+        { "mu-law stereo", 0x0007, 2, 2, 8, 0 },
+        { "MS ADPCM stereo", 0x0002, 2, 256, 4, 244 },
+        { "IMA ADPCM stereo", 0x0011, 2, 256, 4, 249 }
+    };
+    const Sint16 mscoeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    const Uint32 datalen = 256 * 40 + 100; /* Ends with a truncated ADPCM block. */
+    Uint8 ext[32];
+    Uint16 extlen;
+    Uint8 *wav, *data;
+    size_t headerlen;
+    int i;
+    Uint32 j;
+
+    wav = (Uint8 *) SDL_malloc(128 + datalen);
+    SDLTest_AssertCheck(wav != NULL, "Allocate WAV buffer");
+    if (wav == NULL) {
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        SDL_AudioSpec loadspec, streamspec;
+        SDL_WAVStream *stream;
+        Uint8 *loadbuf = NULL, *streambuf;
+        Uint32 loadlen = 0;
+        Uint32 framesize, frames, offset, seekframe;
+        Sint64 length;
+        int result;
+
+        extlen = 0;
+        if (formats[i].samplesperblock > 0) {
+            ext[extlen++] = (Uint8) (formats[i].samplesperblock & 0xFF);
+            ext[extlen++] = (Uint8) (formats[i].samplesperblock >> 8);
+            if (formats[i].tag == 0x0002) {
+                ext[extlen++] = 7;
+                ext[extlen++] = 0;
+                for (j = 0; j < 14; j++) {
+                    ext[extlen++] = (Uint8) ((Uint16) mscoeffs[j] & 0xFF);
+                    ext[extlen++] = (Uint8) ((Uint16) mscoeffs[j] >> 8);
+                }
+            }
+        }
+        headerlen = _audio_writeWavHeader(wav, formats[i].tag, formats[i].channels, formats[i].blockalign, formats[i].bits, ext, extlen, datalen);
+        data = wav + headerlen;
+        for (j = 0; j < datalen; j++) {
+            data[j] = SDLTest_RandomUint8();
+        }
+        if (formats[i].tag == 0x0002) {
+            /* The block headers must use valid coefficient indices. */
+            for (j = 0; j < datalen; j += formats[i].blockalign) {
+                data[j] %= 7;
+                data[j + 1] %= 7;
+            }
+        }
+
+        SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, (int) (headerlen + datalen)), 1, &loadspec, &loadbuf, &loadlen) != NULL,
+                            "Load %s WAV with SDL_LoadWAV_RW", formats[i].name);
+        stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, (int) (headerlen + datalen)), 1, &streamspec);
+        SDLTest_AssertPass("Call to SDL_OpenWAVStream_RW()");
+        SDLTest_AssertCheck(stream != NULL, "Validate stream; expected: non-NULL, got: %s", SDL_GetError());
+        if (loadbuf == NULL || stream == NULL) {
+            SDL_FreeWAV(loadbuf);
+            SDL_CloseWAVStream(stream);
+            continue;
+        }
+
+        SDLTest_AssertCheck(streamspec.format == loadspec.format && streamspec.channels == loadspec.channels && streamspec.freq == loadspec.freq,
+                            "Verify stream spec matches loaded spec");
+        framesize = (SDL_AUDIO_BITSIZE(loadspec.format) / 8) * loadspec.channels;
+        frames = loadlen / framesize;
+        length = SDL_GetWAVStreamLength(stream);
+        SDLTest_AssertCheck(length == frames, "Verify stream length; expected: %u got: %d", (unsigned int) frames, (int) length);
+
+        streambuf = (Uint8 *) SDL_malloc(loadlen + framesize * 333);
+        if (streambuf != NULL) {
+            /* Read everything in odd sized pieces. */
+            offset = 0;
+            do {
+                result = SDL_ReadWAVStream(stream, streambuf + offset * framesize, 333);
+                if (result > 0) {
+                    offset += result;
+                }
+            } while (result == 333);
+            SDLTest_AssertCheck(result >= 0, "Verify reads succeeded; got: %d", result);
+            SDLTest_AssertCheck(offset == frames, "Verify frames read; expected: %u got: %u", (unsigned int) frames, (unsigned int) offset);
+            SDLTest_AssertCheck(SDL_memcmp(streambuf, loadbuf, loadlen) == 0, "Verify %s stream data matches loaded data", formats[i].name);
+
+            /* Seek into the middle of a block and read back a short piece. */
+            seekframe = frames / 3 + 7;
+            result = SDL_SeekWAVStream(stream, seekframe);
+            SDLTest_AssertCheck(result == 0, "Verify seek result; expected: 0 got: %d", result);
+            result = SDL_ReadWAVStream(stream, streambuf, 100);
+            SDLTest_AssertCheck(result == 100, "Verify read after seek; expected: 100 got: %d", result);
+            SDLTest_AssertCheck(SDL_memcmp(streambuf, loadbuf + seekframe * framesize, 100 * framesize) == 0, "Verify data after seek matches loaded data");
+
+            result = SDL_SeekWAVStream(stream, frames + 1000);
+            SDLTest_AssertCheck(result == 0, "Verify seek past the end; expected: 0 got: %d", result);
+            result = SDL_ReadWAVStream(stream, streambuf, 100);
+            SDLTest_AssertCheck(result == 0, "Verify read at the end; expected: 0 got: %d", result);
+
+            SDL_free(streambuf);
+        }
+
+        SDL_CloseWAVStream(stream);
+        SDLTest_AssertPass("Call to SDL_CloseWAVStream()");
+        SDL_FreeWAV(loadbuf);
+    }
+
+    /* Negative cases */
+    SDLTest_AssertCheck(SDL_ReadWAVStream(NULL, wav, 1) == -1, "Verify SDL_ReadWAVStream(NULL) fails");
+    SDLTest_AssertCheck(SDL_SeekWAVStream(NULL, 0) == -1, "Verify SDL_SeekWAVStream(NULL) fails");
+    SDL_CloseWAVStream(NULL);
+    SDLTest_AssertPass("Call to SDL_CloseWAVStream(NULL)");
+
+    SDL_free(wav);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks that ADPCM WAV files decode the same with one thread and with several.
+ *
+ * \sa https://wiki.libsdl.org/SDL_HINT_WAVE_DECODE_THREADS
+ */
+int audio_wavDecodeThreads()
+{
+    const Sint16 mscoeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    const Uint16 tags[2] = { 0x0002, 0x0011 };
+    const Uint16 blockalign = 128;
+    /* Enough blocks for four threads, plus a truncated one at the end. */
+    const Uint32 datalen = blockalign * 1100 + 50;
+    Uint8 ext[32];
+    Uint16 extlen;
+    Uint8 *wav, *data;
+    size_t headerlen;
+    int i;
+    Uint32 j;
+
+    wav = (Uint8 *) SDL_malloc(128 + datalen);
+    SDLTest_AssertCheck(wav != NULL, "Allocate WAV buffer");
+    if (wav == NULL) {
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < SDL_arraysize(tags); i++) {
+        SDL_AudioSpec spec;
+        Uint8 *serial = NULL, *threaded = NULL;
+        Uint32 seriallen = 0, threadedlen = 0;
+
+        /* Zero samples per block, so the decoder works it out from the block size. */
+        extlen = 0;
+        ext[extlen++] = 0;
+        ext[extlen++] = 0;
+        if (tags[i] == 0x0002) {
+            ext[extlen++] = 7;
+            ext[extlen++] = 0;
+            for (j = 0; j < 14; j++) {
+                ext[extlen++] = (Uint8) ((Uint16) mscoeffs[j] & 0xFF);
+                ext[extlen++] = (Uint8) ((Uint16) mscoeffs[j] >> 8);
+            }
+        }
+        headerlen = _audio_writeWavHeader(wav, tags[i], 2, blockalign, 4, ext, extlen, datalen);
+        data = wav + headerlen;
+        for (j = 0; j < datalen; j++) {
+            data[j] = SDLTest_RandomUint8();
+        }
+        if (tags[i] == 0x0002) {
+            for (j = 0; j < datalen; j += blockalign) {
+                data[j] %= 7;
+                data[j + 1] %= 7;
+            }
+        }
+
+        SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "1");
+        SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, (int) (headerlen + datalen)), 1, &spec, &serial, &seriallen) != NULL,
+                            "Decode format 0x%04x on one thread", (unsigned int) tags[i]);
+        SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "4");
+        SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, (int) (headerlen + datalen)), 1, &spec, &threaded, &threadedlen) != NULL,
+                            "Decode format 0x%04x on four threads", (unsigned int) tags[i]);
+        if (serial != NULL && threaded != NULL) {
+            SDLTest_AssertCheck(seriallen == threadedlen, "Verify lengths match; expected: %u got: %u", (unsigned int) seriallen, (unsigned int) threadedlen);
+            SDLTest_AssertCheck(seriallen == threadedlen && SDL_memcmp(serial, threaded, seriallen) == 0, "Verify decoded data matches");
+        }
+        SDL_FreeWAV(serial);
+        SDL_FreeWAV(threaded);
+
+        if (tags[i] == 0x0002) {
+            /* A broken block header in a worker's range still reports the error. */
+            data[blockalign * 900] = 9;
+            SDL_ClearError();
+            SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, (int) (headerlen + datalen)), 1, &spec, &threaded, &threadedlen) == NULL,
+                                "Verify a bad MS ADPCM block fails to decode");
+            SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "coefficient") != NULL, "Verify error message; got: %s", SDL_GetError());
+        }
+    }
+
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, NULL);
+    SDL_free(wav);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks channel conversions that are combined with an S16 conversion against the plain formulas.
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertFusedChannels()
+{
+    const struct {
+        SDL_AudioFormat src_format;
+        Uint8 src_channels;
+        SDL_AudioFormat dst_format;
+        Uint8 dst_channels;
+    } cases[] = {
+        { AUDIO_S16SYS, 1, AUDIO_F32SYS, 2 },
+        { AUDIO_S16SYS, 1, AUDIO_S16SYS, 2 },
+        { AUDIO_S16SYS, 2, AUDIO_F32SYS, 6 },
+        { AUDIO_F32SYS, 2, AUDIO_S16SYS, 6 },
+        { AUDIO_S16SYS, 2, AUDIO_S16SYS, 6 },
+        { AUDIO_S16SYS, 6, AUDIO_S16SYS, 2 },
+        { AUDIO_F32SYS, 6, AUDIO_S16SYS, 2 },
+        { AUDIO_S16SYS, 2, AUDIO_S16SYS, 1 },
+        { AUDIO_F32SYS, 2, AUDIO_S16SYS, 1 }
+    };
+    /* Not a multiple of any block or vector size. */
+    const int frames = 1001;
+    int i, j, c;
+
+    for (i = 0; i < SDL_arraysize(cases); i++) {
+        const int srcchans = cases[i].src_channels;
+        const int dstchans = cases[i].dst_channels;
+        const int srcsize = SDL_AUDIO_BITSIZE(cases[i].src_format) / 8;
+        float *input, *expected;
+        SDL_AudioCVT cvt;
+        float maxdiff = 0.0f;
+        int result;
+
+        result = SDL_BuildAudioCVT(&cvt, cases[i].src_format, cases[i].src_channels, 48000,
+                                   cases[i].dst_format, cases[i].dst_channels, 48000);
+        SDLTest_AssertPass("Call to SDL_BuildAudioCVT(%d->%d channels)", srcchans, dstchans);
+        SDLTest_AssertCheck(result == 1, "Verify result value; expected: 1, got: %i", result);
+        if (result != 1) {
+            continue;
+        }
+
+        input = (float *) SDL_malloc(frames * srcchans * sizeof (float));
+        expected = (float *) SDL_malloc(frames * dstchans * sizeof (float));
+        cvt.len = frames * srcchans * srcsize;
+        cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+        SDLTest_AssertCheck(input != NULL && expected != NULL && cvt.buf != NULL, "Allocate conversion buffers");
+        if (input == NULL || expected == NULL || cvt.buf == NULL) {
+            SDL_free(input);
+            SDL_free(expected);
+            SDL_free(cvt.buf);
+            return TEST_ABORTED;
+        }
+
+        for (j = 0; j < frames * srcchans; j++) {
+            const Sint16 sample = SDLTest_RandomSint16();
+            if (srcsize == 2) {
+                ((Sint16 *) cvt.buf)[j] = sample;
+                input[j] = ((float) sample) / 32768.0f;
+            } else {
+                /* go a little past full scale to exercise clamping. */
+                input[j] = ((float) sample) / 30000.0f;
+                ((float *) cvt.buf)[j] = input[j];
+            }
+        }
+
+        for (j = 0; j < frames; j++) {
+            const float *in = &input[j * srcchans];
+            float *out = &expected[j * dstchans];
+            if (srcchans == 1) {
+                out[0] = out[1] = in[0];
+            } else if (srcchans == 2 && dstchans == 1) {
+                out[0] = (in[0] + in[1]) * 0.5f;
+            } else if (srcchans == 2) {
+                const float ce = (in[0] + in[1]) * 0.5f;
+                out[0] = 0.571f * (in[0] + (in[0] - 0.5f * ce));
+                out[1] = 0.571f * (in[1] + (in[1] - 0.5f * ce));
+                out[2] = ce;
+                out[3] = 0.0f;
+                out[4] = in[0];
+                out[5] = in[1];
+            } else {
+                out[0] = (in[0] + in[2] * 0.5f + in[4]) / 2.5f;
+                out[1] = (in[1] + in[2] * 0.5f + in[5]) / 2.5f;
+            }
+        }
+
+        result = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertPass("Call to SDL_ConvertAudio()");
+        SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+        SDLTest_AssertCheck(cvt.len_cvt == frames * dstchans * (int) (SDL_AUDIO_BITSIZE(cases[i].dst_format) / 8),
+                            "Verify converted length; got: %i", cvt.len_cvt);
+
+        for (j = 0; j < frames * dstchans; j++) {
+            float diff;
+            if (SDL_AUDIO_ISFLOAT(cases[i].dst_format)) {
+                diff = SDL_fabsf(((float *) cvt.buf)[j] - expected[j]) * 32768.0f;
+            } else {
+                const float clamped = SDL_max(-1.0f, SDL_min(1.0f, expected[j]));
+                diff = SDL_fabsf((float) ((Sint16 *) cvt.buf)[j] - clamped * 32767.0f);
+            }
+            maxdiff = SDL_max(maxdiff, diff);
+        }
+        c = (int) (maxdiff * 100.0f);
+        SDLTest_AssertCheck(maxdiff <= 1.01f, "Verify converted samples are within one step of the expected values; worst: %d.%02d", c / 100, c % 100);
+
+        SDL_free(input);
+        SDL_free(expected);
+        SDL_free(cvt.buf);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* Runs a conversion through SDL_ConvertAudio() in place; returns the converted length or -1 */
+static int
+_audio_convertInPlace(Uint8 *buf, int len, SDL_AudioFormat src_format, Uint8 src_channels, SDL_AudioFormat dst_format, Uint8 dst_channels)
+{
+    SDL_AudioCVT cvt;
+
+    if (SDL_BuildAudioCVT(&cvt, src_format, src_channels, 48000, dst_format, dst_channels, 48000) < 0) {
+        return -1;
+    }
+    cvt.buf = buf;
+    cvt.len = len;
+    if (SDL_ConvertAudio(&cvt) < 0) {
+        return -1;
+    }
+    return cvt.len_cvt;
+}
+
+/**
+ * \brief Checks that fused S16 channel conversions give the same samples as doing each step separately.
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertFusedUnfused()
+{
+    const int channels[][2] = { { 2, 1 }, { 1, 2 } };
+    const SDL_AudioFormat src_formats[] = { AUDIO_S16SYS, AUDIO_F32SYS };
+    /* Whole blocks for every SIMD path, so none of them finish with scalar code. */
+    const int frames = 1024;
+    int i, j, k;
+
+    for (i = 0; i < SDL_arraysize(channels); i++) {
+        for (j = 0; j < SDL_arraysize(src_formats); j++) {
+            const SDL_AudioFormat src_format = src_formats[j];
+            const Uint8 src_channels = (Uint8) channels[i][0];
+            const Uint8 dst_channels = (Uint8) channels[i][1];
+            const int len = frames * src_channels * (SDL_AUDIO_BITSIZE(src_format) / 8);
+            const int bufsize = frames * SDL_max(src_channels, dst_channels) * sizeof (float);
+            Uint8 *fused, *unfused;
+            SDL_AudioCVT cvt;
+            int fused_len, unfused_len = len;
+            int result, mismatches = 0;
+
+            result = SDL_BuildAudioCVT(&cvt, src_format, src_channels, 48000, AUDIO_S16SYS, dst_channels, 48000);
+            SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(0x%.4x, %d -> S16, %d) result; expected: 1, got: %i", src_format, src_channels, dst_channels, result);
+            SDLTest_AssertCheck(cvt.filter_index == 1, "Verify 0x%.4x, %d -> S16, %d converts in one pass; got: %i filters", src_format, src_channels, dst_channels, cvt.filter_index);
+
+            fused = (Uint8 *) SDL_malloc(bufsize);
+            unfused = (Uint8 *) SDL_malloc(bufsize);
+            SDLTest_AssertCheck(fused != NULL && unfused != NULL, "Allocate conversion buffers");
+            if (fused == NULL || unfused == NULL) {
+                SDL_free(fused);
+                SDL_free(unfused);
+                return TEST_ABORTED;
+            }
+            for (k = 0; k < frames * src_channels; k++) {
+                const Sint16 sample = SDLTest_RandomSint16();
+                if (src_format == AUDIO_F32SYS) {
+                    /* go past full scale now and then to exercise clamping */
+                    ((float *) fused)[k] = (float) sample / 30000.0f;
+                } else {
+                    ((Sint16 *) fused)[k] = sample;
+                }
+            }
+            SDL_memcpy(unfused, fused, len);
+
+            fused_len = _audio_convertInPlace(fused, len, src_format, src_channels, AUDIO_S16SYS, dst_channels);
+            if (src_format != AUDIO_F32SYS) {
+                unfused_len = _audio_convertInPlace(unfused, unfused_len, src_format, src_channels, AUDIO_F32SYS, src_channels);
+            }
+            if (unfused_len >= 0) {
+                unfused_len = _audio_convertInPlace(unfused, unfused_len, AUDIO_F32SYS, src_channels, AUDIO_F32SYS, dst_channels);
+            }
+            if (unfused_len >= 0) {
+                unfused_len = _audio_convertInPlace(unfused, unfused_len, AUDIO_F32SYS, dst_channels, AUDIO_S16SYS, dst_channels);
+            }
+            SDLTest_AssertCheck(fused_len == frames * dst_channels * (int) sizeof (Sint16), "Verify fused conversion length; got: %i", fused_len);
+            SDLTest_AssertCheck(unfused_len == fused_len, "Verify step by step conversion length; expected: %i, got: %i", fused_len, unfused_len);
+
+            if (unfused_len == fused_len && fused_len > 0) {
+                for (k = 0; k < frames * dst_channels; k++) {
+                    if (((Sint16 *) fused)[k] != ((Sint16 *) unfused)[k]) {
+                        mismatches++;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify 0x%.4x, %d -> S16, %d matches the step by step conversion; mismatches: %d", src_format, src_channels, dst_channels, mismatches);
+
+            SDL_free(fused);
+            SDL_free(unfused);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* The scalar audio type converters, which the AVX2 and AVX-512 ones must
+   match bit for bit. */
+static float
+_audio_typeToFloat(SDL_AudioFormat format, const Uint8 *buf, int i)
+{
+    switch (format) {
+    case AUDIO_S8: return ((float) ((const Sint8 *) buf)[i]) * 0.0078125f;
+    case AUDIO_U8: return (((float) buf[i]) * 0.0078125f) - 1.0f;
+    case AUDIO_S16SYS: return ((float) ((const Sint16 *) buf)[i]) * 0.000030517578125f;
+    case AUDIO_U16SYS: return (((float) ((const Uint16 *) buf)[i]) * 0.000030517578125f) - 1.0f;
+    default: return ((float) (((const Sint32 *) buf)[i] >> 8)) * 0.00000011920930376163766f;
+    }
+}
+
+static Sint64
+_audio_typeFromFloat(SDL_AudioFormat format, float sample)
+{
+    switch (format) {
+    case AUDIO_S8: return (sample >= 1.0f) ? 127 : (sample <= -1.0f) ? -128 : (Sint8) (sample * 127.0f);
+    case AUDIO_U8: return (sample >= 1.0f) ? 255 : (sample <= -1.0f) ? 0 : (Uint8) ((sample + 1.0f) * 127.0f);
+    case AUDIO_S16SYS: return (sample >= 1.0f) ? 32767 : (sample <= -1.0f) ? -32768 : (Sint16) (sample * 32767.0f);
+    case AUDIO_U16SYS: return (sample >= 1.0f) ? 65535 : (sample <= -1.0f) ? 0 : (Uint16) ((sample + 1.0f) * 32767.0f);
+    default: return (sample >= 1.0f) ? 2147483647 : (sample <= -1.0f) ? -2147483647 - 1 : ((Sint64) (Sint32) (sample * 8388607.0f)) * 256;
+    }
+}
+
+static Sint64
+_audio_typeSample(SDL_AudioFormat format, const Uint8 *buf, int i)
+{
+    switch (format) {
+    case AUDIO_S8: return ((const Sint8 *) buf)[i];
+    case AUDIO_U8: return buf[i];
+    case AUDIO_S16SYS: return ((const Sint16 *) buf)[i];
+    case AUDIO_U16SYS: return ((const Uint16 *) buf)[i];
+    default: return ((const Sint32 *) buf)[i];
+    }
+}
+
+/**
+ * \brief Checks the sample type converters against the scalar reference.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertTypeExact()
+{
+    const SDL_AudioFormat formats[] = { AUDIO_S8, AUDIO_U8, AUDIO_S16SYS, AUDIO_U16SYS, AUDIO_S32SYS };
+    /* Not a multiple of any vector size. */
+    const int samples = 1003;
+    Uint8 *input, *buf;
+    int i, j;
+
+    input = (Uint8 *) SDL_malloc(samples * sizeof (float));
+    buf = (Uint8 *) SDL_malloc(samples * sizeof (float));
+    SDLTest_AssertCheck(input != NULL && buf != NULL, "Allocate conversion buffers");
+    if (input == NULL || buf == NULL) {
+        SDL_free(input);
+        SDL_free(buf);
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        const SDL_AudioFormat format = formats[i];
+        const int size = SDL_AUDIO_BITSIZE(format) / 8;
+        const Sint64 step = (format == AUDIO_S32SYS) ? 256 : 1;
+        SDL_AudioCVT cvt;
+        int bad = 0;
+        int result;
+
+        /* To float. */
+        result = SDL_BuildAudioCVT(&cvt, format, 1, 48000, AUDIO_F32SYS, 1, 48000);
+        SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(0x%.4x -> F32) result; expected: 1, got: %i", format, result);
+        for (j = 0; j < samples * size; j++) {
+            input[j] = SDLTest_RandomUint8();
+        }
+        SDL_memcpy(buf, input, samples * size);
+        cvt.buf = buf;
+        cvt.len = samples * size;
+        result = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0, got: %i", result);
+        for (j = 0; j < samples; j++) {
+            const float expected = _audio_typeToFloat(format, input, j);
+            const float actual = ((const float *) buf)[j];
+            if (SDL_fabsf(actual - expected) > 1e-6f) {
+                bad++;
+            }
+        }
+        SDLTest_AssertCheck(bad == 0, "Verify 0x%.4x -> F32 samples match the reference; mismatches: %d", format, bad);
+
+        /* From float, going past full scale and hitting it exactly to exercise clamping. */
+        result = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 1, 48000, format, 1, 48000);
+        SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(F32 -> 0x%.4x) result; expected: 1, got: %i", format, result);
+        for (j = 0; j < samples; j++) {
+            float sample = ((float) SDLTest_RandomSint16()) / 30000.0f;
+            if ((j % 97) == 0) {
+                sample = (j & 1) ? 1.0f : -1.0f;
+            }
+            ((float *) input)[j] = sample;
+        }
+        SDL_memcpy(buf, input, samples * sizeof (float));
+        cvt.buf = buf;
+        cvt.len = samples * sizeof (float);
+        result = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0, got: %i", result);
+        bad = 0;
+        for (j = 0; j < samples; j++) {
+            const Sint64 expected = _audio_typeFromFloat(format, ((const float *) input)[j]);
+            const Sint64 actual = _audio_typeSample(format, buf, j);
+            const Sint64 diff = (actual > expected) ? (actual - expected) : (expected - actual);
+            /* The SIMD converters round, the scalar ones truncate. */
+            if (diff > step) {
+                bad++;
+            }
+        }
+        SDLTest_AssertCheck(bad == 0, "Verify F32 -> 0x%.4x samples match the reference; mismatches: %d", format, bad);
+    }
+
+    SDL_free(input);
+    SDL_free(buf);
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks that every channel conversion treats each frame the same way, whatever its position in the buffer.
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertChannelsEveryFrame()
+{
+    const int channels[] = { 1, 2, 4, 6, 7, 8 };
+    /* Not a multiple of any block or vector size. */
+    const int frames = 1001;
+    int i, j, k, c;
+
+    for (i = 0; i < SDL_arraysize(channels); i++) {
+        for (j = 0; j < SDL_arraysize(channels); j++) {
+            const int srcchans = channels[i];
+            const int dstchans = channels[j];
+            float base[8], expected[8 * 8];
+            SDL_AudioCVT cvt;
+            float maxdiff = 0.0f;
+            int result;
+
+            if (i == j) {
+                continue;
+            }
+
+            /* The conversion of a single frame, on its own. */
+            for (c = 0; c < srcchans; c++) {
+                base[c] = SDLTest_RandomUnitFloat() - 0.5f;
+            }
+            result = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, srcchans, 48000, AUDIO_F32SYS, dstchans, 48000);
+            SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(%d->%d channels) result; expected: 1, got: %i", srcchans, dstchans, result);
+            if (result != 1) {
+                continue;
+            }
+            cvt.len = srcchans * sizeof (float);
+            cvt.buf = (Uint8 *) expected;
+            SDL_memcpy(expected, base, cvt.len);
+            result = SDL_ConvertAudio(&cvt);
+            SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0, got: %i", result);
+
+            /* Every frame of a longer buffer is a multiple of that frame,
+               so it must convert to the same multiple of the output. */
+            cvt.len = frames * srcchans * sizeof (float);
+            cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+            SDLTest_AssertCheck(cvt.buf != NULL, "Allocate conversion buffer");
+            if (cvt.buf == NULL) {
+                return TEST_ABORTED;
+            }
+            for (k = 0; k < frames; k++) {
+                for (c = 0; c < srcchans; c++) {
+                    ((float *) cvt.buf)[k * srcchans + c] = base[c] * (float) ((k % 7) + 1);
+                }
+            }
+            result = SDL_ConvertAudio(&cvt);
+            SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0, got: %i", result);
+            SDLTest_AssertCheck(cvt.len_cvt == frames * dstchans * (int) sizeof (float), "Verify converted length; got: %i", cvt.len_cvt);
+
+            for (k = 0; k < frames; k++) {
+                for (c = 0; c < dstchans; c++) {
+                    const float diff = SDL_fabsf(((float *) cvt.buf)[k * dstchans + c] - expected[c] * (float) ((k % 7) + 1));
+                    maxdiff = SDL_max(maxdiff, diff);
+                }
+            }
+            c = (int) (maxdiff * 1000000.0f);
+            SDLTest_AssertCheck(maxdiff <= 0.0001f, "Verify %d->%d channel frames all match the single frame; worst: %d.%06d", srcchans, dstchans, c / 1000000, c % 1000000);
+
+            SDL_free(cvt.buf);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks that S16 channel conversions still get the one-pass channel mix.
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertChannelsS16()
+{
+    /* Upmixes that take several channel converters, and a downmix that
+       takes one. */
+    const int pairs[][2] = { { 1, 6 }, { 2, 8 }, { 1, 7 }, { 6, 2 } };
+    const int frames = 301;
+    int i, k, c;
+
+    for (i = 0; i < SDL_arraysize(pairs); i++) {
+        const int srcchans = pairs[i][0];
+        const int dstchans = pairs[i][1];
+        SDL_AudioCVT ref, cvt;
+        Sint16 *samples;
+        float *expected;
+        int result, maxdiff = 0;
+
+        result = SDL_BuildAudioCVT(&ref, AUDIO_F32SYS, srcchans, 48000, AUDIO_F32SYS, dstchans, 48000);
+        SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(F32, %d->%d channels) result; expected: 1, got: %i", srcchans, dstchans, result);
+        result = SDL_BuildAudioCVT(&cvt, AUDIO_S16SYS, srcchans, 48000, AUDIO_S16SYS, dstchans, 48000);
+        SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(S16, %d->%d channels) result; expected: 1, got: %i", srcchans, dstchans, result);
+        if (result != 1) {
+            continue;
+        }
+
+        if (srcchans > dstchans) {
+            /* A single converter, fused with both sample type conversions. */
+            SDLTest_AssertCheck(cvt.filter_index == 1, "Verify S16 %d->%d channels converts in one pass; got: %i filters", srcchans, dstchans, cvt.filter_index);
+        } else if (ref.filter_index == 1) {
+            /* The float conversion is a single matrix mix, so the S16 one
+               must be that mix between the two sample type conversions. */
+            SDLTest_AssertCheck(cvt.filter_index == 3 && cvt.filters[1] == ref.filters[0],
+                                "Verify S16 %d->%d channels mixes with the float matrix filter; got: %i filters", srcchans, dstchans, cvt.filter_index);
+        } else {
+            SDLTest_Log("No matrix channel mix for %d->%d channels on this CPU", srcchans, dstchans);
+        }
+
+        ref.len = frames * srcchans * sizeof (float);
+        cvt.len = frames * srcchans * sizeof (Sint16);
+        expected = (float *) SDL_malloc(ref.len * ref.len_mult);
+        samples = (Sint16 *) SDL_malloc(cvt.len * cvt.len_mult);
+        SDLTest_AssertCheck(expected != NULL && samples != NULL, "Allocate conversion buffers");
+        if (expected == NULL || samples == NULL) {
+            SDL_free(expected);
+            SDL_free(samples);
+            return TEST_ABORTED;
+        }
+        for (k = 0; k < frames * srcchans; k++) {
+            samples[k] = (Sint16) SDLTest_RandomIntegerInRange(-8192, 8191);
+            expected[k] = samples[k] / 32768.0f;
+        }
+        ref.buf = (Uint8 *) expected;
+        cvt.buf = (Uint8 *) samples;
+        result = SDL_ConvertAudio(&ref);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio(F32) result; expected: 0, got: %i", result);
+        result = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio(S16) result; expected: 0, got: %i", result);
+        SDLTest_AssertCheck(cvt.len_cvt == frames * dstchans * (int) sizeof (Sint16), "Verify converted length; got: %i", cvt.len_cvt);
+
+        for (k = 0; k < frames; k++) {
+            for (c = 0; c < dstchans; c++) {
+                /* Some layouts boost channels, so S16 output can clip. */
+                const float sample = SDL_clamp(expected[k * dstchans + c], -1.0f, 1.0f);
+                const int want = (int) (sample * 32767.0f);
+                maxdiff = SDL_max(maxdiff, SDL_abs(samples[k * dstchans + c] - want));
+            }
+        }
+        SDLTest_AssertCheck(maxdiff <= 1, "Verify S16 %d->%d channels matches the float conversion; worst: %d", srcchans, dstchans, maxdiff);
+
+        SDL_free(expected);
+        SDL_free(samples);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks SDL_MixAudioMulti() with one source against SDL_MixAudioFormat(), and its parameter checks.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioMulti
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioMulti()
+{
+    const SDL_AudioFormat formats[] = { AUDIO_U8, AUDIO_S8, AUDIO_U16LSB, AUDIO_U16MSB, AUDIO_S16LSB, AUDIO_S16MSB,
+                                        AUDIO_S32LSB, AUDIO_S32MSB, AUDIO_F32LSB, AUDIO_F32MSB };
+    const int volumes[] = { 1, 37, 64, SDL_MIX_MAXVOLUME };
+    const Uint32 len = 1024 + 4;  /* not a multiple of any SIMD mixer's block size */
+    Uint8 *src, *base, *expected, *dst;
+    const Uint8 *srcs[1];
+    int volume;
+    int i, v;
+    Uint32 k;
+
+    src = (Uint8 *) SDL_malloc(len);
+    base = (Uint8 *) SDL_malloc(len);
+    expected = (Uint8 *) SDL_malloc(len);
+    dst = (Uint8 *) SDL_malloc(len);
+    SDLTest_AssertCheck(src != NULL && base != NULL && expected != NULL && dst != NULL, "Allocate mix buffers");
+    if (src == NULL || base == NULL || expected == NULL || dst == NULL) {
+        SDL_free(src);
+        SDL_free(base);
+        SDL_free(expected);
+        SDL_free(dst);
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        const SDL_AudioFormat format = formats[i];
+
+        for (k = 0; k < len; k++) {
+            src[k] = (Uint8) SDLTest_RandomUint8();
+            base[k] = (Uint8) SDLTest_RandomUint8();
+        }
+        if (SDL_AUDIO_ISFLOAT(format)) {
+            /* Random bytes can be NaN, use samples in -1 .. 1 instead */
+            const SDL_bool swap = (SDL_AUDIO_ISBIGENDIAN(format) != 0) != (SDL_BYTEORDER == SDL_BIG_ENDIAN);
+            for (k = 0; k < len; k += 4) {
+                float a = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+                float b = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+                if (swap) {
+                    a = SDL_SwapFloat(a);
+                    b = SDL_SwapFloat(b);
+                }
+                SDL_memcpy(src + k, &a, sizeof (a));
+                SDL_memcpy(base + k, &b, sizeof (b));
+            }
+        }
+
+        for (v = 0; v < SDL_arraysize(volumes); v++) {
+            SDL_memcpy(expected, base, len);
+            SDL_memcpy(dst, base, len);
+            srcs[0] = src;
+            volume = volumes[v];
+            SDL_MixAudioFormat(expected, src, format, len, volume);
+            SDL_MixAudioMulti(dst, srcs, &volume, 1, format, len);
+            SDLTest_AssertCheck(SDL_memcmp(dst, expected, len) == 0,
+                                "Verify SDL_MixAudioMulti() with one source matches SDL_MixAudioFormat(); format: 0x%04x, volume: %d", format, volume);
+        }
+    }
+
+    /* Invalid parameters leave the destination alone */
+    srcs[0] = src;
+    volume = SDL_MIX_MAXVOLUME;
+    SDL_memcpy(expected, dst, len);
+    SDL_ClearError();
+    SDL_MixAudioMulti(NULL, srcs, &volume, 1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "dst") != NULL, "Verify SDL_MixAudioMulti(NULL dst) sets an error; got: '%s'", SDL_GetError());
+    SDL_ClearError();
+    SDL_MixAudioMulti(dst, NULL, &volume, 1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "srcs") != NULL, "Verify SDL_MixAudioMulti(NULL srcs) sets an error; got: '%s'", SDL_GetError());
+    SDL_ClearError();
+    SDL_MixAudioMulti(dst, srcs, NULL, 1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "volumes") != NULL, "Verify SDL_MixAudioMulti(NULL volumes) sets an error; got: '%s'", SDL_GetError());
+    SDL_ClearError();
+    SDL_MixAudioMulti(dst, srcs, &volume, -1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "num_srcs") != NULL, "Verify SDL_MixAudioMulti(num_srcs -1) sets an error; got: '%s'", SDL_GetError());
+    volume = SDL_MIX_MAXVOLUME + 1;
+    SDL_ClearError();
+    SDL_MixAudioMulti(dst, srcs, &volume, 1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "volumes") != NULL, "Verify SDL_MixAudioMulti(volume 129) sets an error; got: '%s'", SDL_GetError());
+    volume = -1;
+    SDL_ClearError();
+    SDL_MixAudioMulti(dst, srcs, &volume, 1, AUDIO_S16SYS, len);
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "volumes") != NULL, "Verify SDL_MixAudioMulti(volume -1) sets an error; got: '%s'", SDL_GetError());
+    SDLTest_AssertCheck(SDL_memcmp(dst, expected, len) == 0, "Verify invalid parameters didn't change the destination");
+
+    SDL_free(src);
+    SDL_free(base);
+    SDL_free(expected);
+    SDL_free(dst);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks SDL_AudioStreamPut() on streams that don't resample, which convert straight into the queue.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamPut
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamGet
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_streamPutSameRate()
+{
+    /* Growing, shrinking and no conversion at all */
+    const struct { SDL_AudioFormat srcfmt; Uint8 srcchans; SDL_AudioFormat dstfmt; Uint8 dstchans; } specs[] = {
+        { AUDIO_S16SYS, 2, AUDIO_F32SYS, 2 },
+        { AUDIO_F32SYS, 6, AUDIO_S16SYS, 2 },
+        { AUDIO_S16SYS, 2, AUDIO_S16SYS, 2 }
+    };
+    /* Odd sizes, so the puts don't line up with the stream's conversion blocks */
+    const int putframes[] = { 1, 7, 16, 100, 1023, 17, 2048 };
+    const int frames = 9000;
+    int i, k, p;
+
+    for (i = 0; i < SDL_arraysize(specs); i++) {
+        const int srcframesize = SDL_AUDIO_BITSIZE(specs[i].srcfmt) / 8 * specs[i].srcchans;
+        const int dstframesize = SDL_AUDIO_BITSIZE(specs[i].dstfmt) / 8 * specs[i].dstchans;
+        SDL_AudioStream *stream;
+        SDL_AudioCVT cvt;
+        Uint8 *src, *expected, *dst;
+        float maxdiff = 0.0f;
+        int result, offset, c;
+
+        stream = SDL_NewAudioStream(specs[i].srcfmt, specs[i].srcchans, 48000, specs[i].dstfmt, specs[i].dstchans, 48000);
+        SDLTest_AssertPass("Call to SDL_NewAudioStream(0x%04x, %d -> 0x%04x, %d)", specs[i].srcfmt, specs[i].srcchans, specs[i].dstfmt, specs[i].dstchans);
+        SDLTest_AssertCheck(stream != NULL, "Verify SDL_NewAudioStream() result is not NULL");
+        result = SDL_BuildAudioCVT(&cvt, specs[i].srcfmt, specs[i].srcchans, 48000, specs[i].dstfmt, specs[i].dstchans, 48000);
+        SDLTest_AssertCheck(result >= 0, "Verify SDL_BuildAudioCVT() result; got: %i", result);
+        if (stream == NULL || result < 0) {
+            SDL_FreeAudioStream(stream);
+            return TEST_ABORTED;
+        }
+
+        cvt.len = frames * srcframesize;
+        src = (Uint8 *) SDL_malloc(cvt.len);
+        expected = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+        dst = (Uint8 *) SDL_malloc(frames * dstframesize);
+        SDLTest_AssertCheck(src != NULL && expected != NULL && dst != NULL, "Allocate stream buffers");
+        if (src == NULL || expected == NULL || dst == NULL) {
+            SDL_free(src);
+            SDL_free(expected);
+            SDL_free(dst);
+            SDL_FreeAudioStream(stream);
+            return TEST_ABORTED;
+        }
+        if (SDL_AUDIO_ISFLOAT(specs[i].srcfmt)) {
+            for (k = 0; k < frames * specs[i].srcchans; k++) {
+                ((float *) src)[k] = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+            }
+        } else {
+            for (k = 0; k < cvt.len; k++) {
+                src[k] = SDLTest_RandomUint8();
+            }
+        }
+        SDL_memcpy(expected, src, cvt.len);
+        cvt.buf = expected;
+        result = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0, got: %i", result);
+
+        /* Invalid puts are refused and leave the stream empty */
+        result = SDL_AudioStreamPut(NULL, src, srcframesize);
+        SDLTest_AssertCheck(result < 0, "Verify SDL_AudioStreamPut(NULL stream) fails; got: %i", result);
+        result = SDL_AudioStreamPut(stream, NULL, srcframesize);
+        SDLTest_AssertCheck(result < 0, "Verify SDL_AudioStreamPut(NULL buf) fails; got: %i", result);
+        result = SDL_AudioStreamPut(stream, src, srcframesize + 1);
+        SDLTest_AssertCheck(result < 0, "Verify SDL_AudioStreamPut() with a partial frame fails; got: %i", result);
+        result = SDL_AudioStreamPut(stream, src, 0);
+        SDLTest_AssertCheck(result == 0, "Verify SDL_AudioStreamPut() of 0 bytes succeeds; got: %i", result);
+        result = SDL_AudioStreamAvailable(stream);
+        SDLTest_AssertCheck(result == 0, "Verify nothing was queued; got: %i bytes", result);
+
+        /* Put the same audio in pieces of different sizes */
+        for (offset = 0, p = 0; offset < frames; p++) {
+            const int amount = SDL_min(putframes[p % SDL_arraysize(putframes)], frames - offset);
+            result = SDL_AudioStreamPut(stream, src + offset * srcframesize, amount * srcframesize);
+            if (result != 0) {
+                break;
+            }
+            offset += amount;
+        }
+        SDLTest_AssertCheck(result == 0, "Verify SDL_AudioStreamPut() of %d frames in %d pieces succeeds; got: %i", frames, p, result);
+
+        result = SDL_AudioStreamAvailable(stream);
+        SDLTest_AssertCheck(result == cvt.len_cvt, "Verify the stream has as much as SDL_ConvertAudio() made; expected: %i, got: %i", cvt.len_cvt, result);
+        result = SDL_AudioStreamGet(stream, dst, frames * dstframesize);
+        SDLTest_AssertCheck(result == cvt.len_cvt, "Verify SDL_AudioStreamGet() result; expected: %i, got: %i", cvt.len_cvt, result);
+
+        if (result == cvt.len_cvt) {
+            for (k = 0; k < frames * specs[i].dstchans; k++) {
+                if (SDL_AUDIO_ISFLOAT(specs[i].dstfmt)) {
+                    maxdiff = SDL_max(maxdiff, SDL_fabsf(((float *) dst)[k] - ((float *) expected)[k]));
+                } else {
+                    maxdiff = SDL_max(maxdiff, (float) SDL_abs(((Sint16 *) dst)[k] - ((Sint16 *) expected)[k]));
+                }
+            }
+            /* The SIMD float to int converters round, the scalar ones that
+               finish each piece truncate, so integers can be one step off. */
+            c = (int) (maxdiff * 1000000.0f);
+            SDLTest_AssertCheck(maxdiff <= (SDL_AUDIO_ISFLOAT(specs[i].dstfmt) ? 0.0f : 1.0f),
+                                "Verify the stream matches SDL_ConvertAudio(); worst: %d.%06d", c / 1000000, c % 1000000);
+        }
+
+        SDL_free(src);
+        SDL_free(expected);
+        SDL_free(dst);
+        SDL_FreeAudioStream(stream);
+    }
+
+    return TEST_COMPLETED;
+}
+
+#define QUEUE_TEST_FRAMES 24000
+
+/* Queues 1 .. QUEUE_TEST_FRAMES in pieces of different sizes while the device thread plays them */
+static int SDLCALL
+_audio_queueProducer(void *arg)
+{
+    const SDL_AudioDeviceID id = *(const SDL_AudioDeviceID *) arg;
+    Uint16 samples[300];
+    int frame = 0;
+    int pieces = 0;
+
+    while (frame < QUEUE_TEST_FRAMES) {
+        int amount = SDLTest_RandomIntegerInRange(1, SDL_arraysize(samples));
+        int i;
+
+        amount = SDL_min(amount, QUEUE_TEST_FRAMES - frame);
+        for (i = 0; i < amount; i++) {
+            samples[i] = SDL_SwapLE16((Uint16) (frame + i + 1));
+        }
+        if (SDL_QueueAudio(id, samples, amount * sizeof (samples[0])) < 0) {
+            return -1;
+        }
+        frame += amount;
+
+        /* Let the device run dry now and then, so both ends of the queue move */
+        if ((++pieces % 8) == 0) {
+            SDL_Delay(1);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Queues audio on one thread while the device thread plays it, and checks nothing is lost or reordered.
+ *
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ * \sa https://wiki.libsdl.org/SDL_GetQueuedAudioSize
+ */
+int audio_queueAudioThreads()
+{
+    const char *filename = "testautomation_audio_queue.wav";
+    SDL_AudioSpec desired, loaded;
+    SDL_AudioDeviceID id;
+    SDL_Thread *thread;
+    Uint8 *buf = NULL;
+    Uint32 buflen = 0;
+    Uint64 start;
+    Uint32 i;
+    int result = -1;
+    int played = 0;
+    int mismatches = 0;
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+    SDL_setenv("SDL_DISKAUDIOFILE", filename, 1);
+    result = SDL_AudioInit("disk");
+    SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+    if (result != 0) {
+        _audioSetUp(NULL);
+        return TEST_ABORTED;
+    }
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_S16LSB;
+    desired.channels = 1;
+    desired.samples = 256;
+    desired.callback = NULL;
+
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+    SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %d", id);
+    if (id > 0) {
+        SDL_PauseAudioDevice(id, 0);
+        thread = SDL_CreateThread(_audio_queueProducer, "QueueProducer", &id);
+        SDLTest_AssertCheck(thread != NULL, "Verify SDL_CreateThread() result is not NULL");
+        if (thread) {
+            SDL_WaitThread(thread, &result);
+        }
+        SDLTest_AssertCheck(result == 0, "Verify every SDL_QueueAudio() call succeeded; got: %d", result);
+
+        start = SDL_GetTicks();
+        while ((SDL_GetQueuedAudioSize(id) > 0) && ((SDL_GetTicks() - start) < 5000)) {
+            SDL_Delay(10);
+        }
+        SDLTest_AssertCheck(SDL_GetQueuedAudioSize(id) == 0, "Verify the queue drained; got: %u bytes", (unsigned int) SDL_GetQueuedAudioSize(id));
+        /* the device may still be writing the last buffer it took out */
+        SDL_Delay(2 * (desired.samples * 1000) / desired.freq);
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+        SDLTest_AssertCheck(SDL_LoadWAV(filename, &loaded, &buf, &buflen) != NULL, "Load the written WAV file");
+        if (buf) {
+            /* Underruns show up as silence between the queued samples, which are never 0 */
+            for (i = 0; i < buflen / 2; i++) {
+                const Uint16 sample = SDL_SwapLE16(((Uint16 *) buf)[i]);
+                if (sample != 0) {
+                    if (sample != (Uint16) (played + 1)) {
+                        mismatches++;
+                    }
+                    played++;
+                }
+            }
+            SDLTest_AssertCheck(played == QUEUE_TEST_FRAMES, "Verify every queued frame was played; expected: %d got: %d", QUEUE_TEST_FRAMES, played);
+            SDLTest_AssertCheck(mismatches == 0, "Verify frames were played in order; expected: 0 mismatches got: %d", mismatches);
+            SDL_FreeWAV(buf);
+        }
+    }
+    remove(filename);
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
 
 /* ================= Test Case References ================== */
 
@@ -1022,11 +2618,53 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_getAudioDeviceStats, "audio_getAudioDeviceStats", "Checks device statistics gathered with the dummy driver.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_diskFreerun, "audio_diskFreerun", "Renders faster than realtime with the disk driver and checks the WAV file.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_wavStream, "audio_wavStream", "Streams WAV files of every supported encoding and compares them with SDL_LoadWAV_RW.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_wavDecodeThreads, "audio_wavDecodeThreads", "Decodes ADPCM WAV files on one and on several threads and compares the results.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_convertFusedChannels, "audio_convertFusedChannels", "Checks combined sample type and channel conversions against reference values.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_convertTypeExact, "audio_convertTypeExact", "Checks sample type conversions against the scalar converters.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_convertChannelsEveryFrame, "audio_convertChannelsEveryFrame", "Checks that channel conversions mix every frame of a buffer the same way.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_captureRing, "audio_captureRing", "Captures a file with the disk driver and reads it from the capture ring in place.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_adaptivePeriod, "audio_adaptivePeriod", "Checks that the adaptive callback period follows how long the callback takes.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_convertChannelsS16, "audio_convertChannelsS16", "Checks that S16 channel conversions mix in as few passes as float ones.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest26 =
+        { (SDLTest_TestCaseFp)audio_mixAudioMulti, "audio_mixAudioMulti", "Checks SDL_MixAudioMulti() with one source against SDL_MixAudioFormat().", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest27 =
+        { (SDLTest_TestCaseFp)audio_streamPutSameRate, "audio_streamPutSameRate", "Puts audio in pieces into streams that don't resample and compares it with SDL_ConvertAudio().", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest28 =
+        { (SDLTest_TestCaseFp)audio_queueAudioThreads, "audio_queueAudioThreads", "Queues audio on one thread while the device thread plays it through the lock-free queue.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest29 =
+        { (SDLTest_TestCaseFp)audio_convertFusedUnfused, "audio_convertFusedUnfused", "Checks that fused S16 channel conversions match doing each step separately.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16, &audioTest17, &audioTest18, &audioTest19, &audioTest20, &audioTest21, &audioTest22, &audioTest23, &audioTest24, &audioTest25, &audioTest26, &audioTest27, &audioTest28, &audioTest29, NULL
 };
 
 /* Audio test suite (global) */
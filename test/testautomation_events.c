@@ -174,6 +174,185 @@ events_addDelEventWatchWithUserdata(void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Test pushing and batch polling several user events.
+ *
+ * @sa http://wiki.libsdl.org/SDL_PollEvents
+ */
+int
+events_pushAndPollUserevents(void *arg)
+{
+   SDL_Event events[8];
+   int i, result;
+
+   /* Drain anything left over from previous tests */
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Push a few user events onto the queue */
+   for (i = 0; i < 4; ++i) {
+      SDL_zero(events[i]);
+      events[i].type = SDL_USEREVENT;
+      events[i].user.code = i;
+      SDL_PushEvent(&events[i]);
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   /* Poll them all at once, in order */
+   SDL_zeroa(events);
+   result = SDL_PollEvents(events, SDL_arraysize(events));
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 4, "Check result from SDL_PollEvents, expected: 4, got: %d", result);
+   for (i = 0; i < result && i < 4; ++i) {
+      SDLTest_AssertCheck(events[i].type == SDL_USEREVENT && events[i].user.code == i,
+                          "Check event %d, expected: user code %d, got: type 0x%x code %d",
+                          i, i, events[i].type, events[i].user.code);
+   }
+
+   /* The queue is empty now */
+   result = SDL_PollEvents(events, SDL_arraysize(events));
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_PollEvents on empty queue, expected: 0, got: %d", result);
+
+   /* Invalid parameters */
+   result = SDL_PollEvents(NULL, 1);
+   SDLTest_AssertCheck(result < 0, "Check result from SDL_PollEvents with NULL events, expected: <0, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Test merging of queued motion events.
+ *
+ * @sa http://wiki.libsdl.org/SDL_HINT_EVENT_COALESCING
+ * @sa http://wiki.libsdl.org/SDL_GetEventQueueStats
+ */
+int
+events_coalesceMotionEvents(void *arg)
+{
+   SDL_Event event;
+   SDL_Event events[8];
+   SDL_EventQueueStats before, after;
+   int i, result;
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, "1");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_COALESCING, \"1\")");
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   result = SDL_GetEventQueueStats(&before);
+   SDLTest_AssertPass("Call to SDL_GetEventQueueStats()");
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_GetEventQueueStats, expected: 0, got: %d", result);
+
+   /* Three motions from one mouse, interleaved with an axis, then a button barrier and one more motion */
+   for (i = 0; i < 3; ++i) {
+      SDL_zero(event);
+      event.type = SDL_MOUSEMOTION;
+      event.motion.x = 10 * (i + 1);
+      event.motion.xrel = 10;
+      event.motion.yrel = -1;
+      SDL_PushEvent(&event);
+
+      SDL_zero(event);
+      event.type = SDL_CONTROLLERAXISMOTION;
+      event.caxis.axis = SDL_CONTROLLER_AXIS_LEFTX;
+      event.caxis.value = (Sint16)(1000 * i);
+      SDL_PushEvent(&event);
+   }
+   SDL_zero(event);
+   event.type = SDL_MOUSEBUTTONDOWN;
+   event.button.button = SDL_BUTTON_LEFT;
+   SDL_PushEvent(&event);
+   SDL_zero(event);
+   event.type = SDL_MOUSEMOTION;
+   event.motion.xrel = 5;
+   SDL_PushEvent(&event);
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_PeepEvents()");
+   SDLTest_AssertCheck(result == 4, "Check result from SDL_PeepEvents, expected: 4, got: %d", result);
+   if (result == 4) {
+      SDLTest_AssertCheck(events[0].type == SDL_MOUSEMOTION, "Check first event is SDL_MOUSEMOTION, got: 0x%x", events[0].type);
+      SDLTest_AssertCheck(events[0].motion.x == 30, "Check merged x, expected: 30, got: %d", events[0].motion.x);
+      SDLTest_AssertCheck(events[0].motion.xrel == 30 && events[0].motion.yrel == -3,
+                          "Check merged xrel/yrel, expected: 30/-3, got: %d/%d", events[0].motion.xrel, events[0].motion.yrel);
+      SDLTest_AssertCheck(events[1].type == SDL_CONTROLLERAXISMOTION && events[1].caxis.value == 2000,
+                          "Check merged axis value, expected: 2000, got: %d", events[1].caxis.value);
+      SDLTest_AssertCheck(events[2].type == SDL_MOUSEBUTTONDOWN, "Check third event is SDL_MOUSEBUTTONDOWN, got: 0x%x", events[2].type);
+      SDLTest_AssertCheck(events[3].type == SDL_MOUSEMOTION && events[3].motion.xrel == 5,
+                          "Check motion after the button wasn't merged, expected xrel: 5, got: %d", events[3].motion.xrel);
+   }
+
+   result = SDL_GetEventQueueStats(&after);
+   SDLTest_AssertPass("Call to SDL_GetEventQueueStats()");
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_GetEventQueueStats, expected: 0, got: %d", result);
+   SDLTest_AssertCheck(after.coalesced_events - before.coalesced_events == 4,
+                       "Check coalesced events, expected: 4, got: %d", after.coalesced_events - before.coalesced_events);
+   SDLTest_AssertCheck(after.queued_events == 0, "Check queued events, expected: 0, got: %d", after.queued_events);
+   SDLTest_AssertCheck(after.max_queued_events >= 4, "Check max queued events, expected: >= 4, got: %d", after.max_queued_events);
+
+   result = SDL_GetEventQueueStats(NULL);
+   SDLTest_AssertPass("Call to SDL_GetEventQueueStats(NULL)");
+   SDLTest_AssertCheck(result < 0, "Check result from SDL_GetEventQueueStats(NULL), expected: <0, got: %d", result);
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, NULL);
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_COALESCING, NULL)");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Test high resolution event timestamps.
+ *
+ * @sa http://wiki.libsdl.org/SDL_PeepEventsTimestamped
+ * @sa http://wiki.libsdl.org/SDL_GetPerformanceCounterNS
+ */
+int
+events_peepEventsTimestamped(void *arg)
+{
+   SDL_Event events[4];
+   Uint64 timestamps[4];
+   Uint64 before, after;
+   int i, result;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Pushed events are stamped with the current time */
+   before = SDL_GetPerformanceCounterNS();
+   SDLTest_AssertPass("Call to SDL_GetPerformanceCounterNS()");
+   for (i = 0; i < 2; ++i) {
+      SDL_zero(events[i]);
+      events[i].type = SDL_USEREVENT;
+      events[i].user.code = i;
+      SDL_PushEvent(&events[i]);
+   }
+   after = SDL_GetPerformanceCounterNS();
+
+   result = SDL_PeepEventsTimestamped(events, timestamps, SDL_arraysize(events), SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertPass("Call to SDL_PeepEventsTimestamped(SDL_GETEVENT)");
+   SDLTest_AssertCheck(result == 2, "Check result from SDL_PeepEventsTimestamped, expected: 2, got: %d", result);
+   if (result == 2) {
+      SDLTest_AssertCheck(before <= timestamps[0] && timestamps[0] <= timestamps[1] && timestamps[1] <= after,
+                          "Check timestamps are ordered and in range, expected: %"SDL_PRIu64" <= %"SDL_PRIu64" <= %"SDL_PRIu64" <= %"SDL_PRIu64,
+                          before, timestamps[0], timestamps[1], after);
+   }
+
+   /* Added events keep the timestamps they were given */
+   for (i = 0; i < 2; ++i) {
+      SDL_zero(events[i]);
+      events[i].type = SDL_USEREVENT;
+      timestamps[i] = 1000 + i;
+   }
+   result = SDL_PeepEventsTimestamped(events, timestamps, 2, SDL_ADDEVENT, 0, 0);
+   SDLTest_AssertPass("Call to SDL_PeepEventsTimestamped(SDL_ADDEVENT)");
+   SDLTest_AssertCheck(result == 2, "Check result from SDL_PeepEventsTimestamped, expected: 2, got: %d", result);
+
+   SDL_zeroa(timestamps);
+   result = SDL_PeepEventsTimestamped(events, timestamps, SDL_arraysize(events), SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 2, "Check result from SDL_PeepEventsTimestamped, expected: 2, got: %d", result);
+   SDLTest_AssertCheck(timestamps[0] == 1000 && timestamps[1] == 1001,
+                       "Check timestamps, expected: 1000/1001, got: %"SDL_PRIu64"/%"SDL_PRIu64, timestamps[0], timestamps[1]);
+
+   return TEST_COMPLETED;
+}
+
 
 /* ================= Test References ================== */
 
@@ -187,9 +366,18 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pushAndPollUserevents, "events_pushAndPollUserevents", "Pushes and batch polls user events", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_coalesceMotionEvents, "events_coalesceMotionEvents", "Merges queued motion events from the same source", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_peepEventsTimestamped, "events_peepEventsTimestamped", "Checks high resolution event timestamps", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, NULL
 };
 
 /* Events test suite (global) */
@@ -420,6 +420,747 @@ render_testBlit(void *arg)
 }
 
 
+/**
+ * Values of the hints a scene test changes, to put back when it's done.
+ * A scene test changes up to three; pass NULL for the ones it doesn't use.
+ */
+typedef struct
+{
+   const char *names[3];
+   char *values[3];
+} _SceneHints;
+
+static void
+_saveSceneHints(_SceneHints *hints, const char *first, const char *second, const char *third)
+{
+   int i;
+
+   hints->names[0] = first;
+   hints->names[1] = second;
+   hints->names[2] = third;
+   for (i = 0; i < 3; i++) {
+      const char *value = hints->names[i] ? SDL_GetHint(hints->names[i]) : NULL;
+      hints->values[i] = value ? SDL_strdup(value) : NULL;
+   }
+}
+
+static void
+_restoreSceneHints(_SceneHints *hints)
+{
+   int i;
+
+   for (i = 0; i < 3; i++) {
+      if (hints->names[i] == NULL) {
+         continue;
+      }
+      SDL_SetHint(hints->names[i], hints->values[i]);
+      SDL_free(hints->values[i]);
+      hints->values[i] = NULL;
+   }
+}
+
+/**
+ * Creates a software renderer on a hidden window of its own for drawing a
+ * scene, with SDL_HINT_RENDER_BATCHING on. Destroy both with
+ * _destroySceneRenderer().
+ */
+static SDL_Renderer *
+_createSceneRenderer(const char *title, int w, int h, SDL_Window **win)
+{
+   SDL_Renderer *ren;
+
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+   *win = SDL_CreateWindow(title, 100, 100, w, h, SDL_WINDOW_HIDDEN);
+   SDLTest_AssertCheck(*win != NULL, "Check SDL_CreateWindow result");
+   if (*win == NULL) {
+      return NULL;
+   }
+   ren = SDL_CreateRenderer(*win, -1, SDL_RENDERER_SOFTWARE);
+   SDLTest_AssertCheck(ren != NULL, "Check SDL_CreateRenderer result");
+   if (ren == NULL) {
+      SDL_DestroyWindow(*win);
+      *win = NULL;
+   }
+   return ren;
+}
+
+static void
+_destroySceneRenderer(SDL_Renderer *ren, SDL_Window *win)
+{
+   SDL_DestroyRenderer(ren);
+   SDL_DestroyWindow(win);
+}
+
+/**
+ * Reads what the scene renderer drew into a new surface.
+ */
+static SDL_Surface *
+_readScene(SDL_Renderer *ren)
+{
+   SDL_Surface *result;
+   int w = 0, h = 0, ret;
+
+   SDL_GetRendererOutputSize(ren, &w, &h);
+   result = SDL_CreateRGBSurface(0, w, h, 32,
+                                 RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK, RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(result != NULL, "Check SDL_CreateRGBSurface result");
+   if (result != NULL) {
+      ret = SDL_RenderReadPixels(ren, NULL, RENDER_COMPARE_FORMAT, result->pixels, result->pitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   }
+   return result;
+}
+
+/**
+ * Draws a grid of triangles alternating between two blend modes, which look
+ * the same on opaque colors. The result is read into a new surface;
+ * *queued and *submitted get the command counts.
+ */
+static SDL_Surface *
+_drawReorderScene(SDL_bool reorder, Uint32 *queued, Uint32 *submitted)
+{
+   SDL_Window *win;
+   SDL_Renderer *ren;
+   SDL_Surface *result;
+   int i, j, ret;
+
+   SDL_SetHint(SDL_HINT_RENDER_REORDER_COMMANDS, reorder ? "1" : "0");
+   ren = _createSceneRenderer("render_testReorderCommands", TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, &win);
+   if (ren == NULL) {
+      return NULL;
+   }
+
+   SDL_SetRenderDrawColor(ren, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(ren);
+   for (j = 0; j < TESTRENDER_SCREEN_H; j += 10) {
+      for (i = 0; i < TESTRENDER_SCREEN_W; i += 10) {
+         SDL_Vertex verts[3];
+         SDL_zeroa(verts);
+         verts[0].position.x = (float) i;
+         verts[0].position.y = (float) j;
+         verts[1].position.x = (float) (i + 8);
+         verts[1].position.y = (float) j;
+         verts[2].position.x = (float) i;
+         verts[2].position.y = (float) (j + 8);
+         verts[0].color.r = verts[1].color.g = verts[2].color.b = 255;
+         verts[0].color.a = verts[1].color.a = verts[2].color.a = SDL_ALPHA_OPAQUE;
+         SDL_SetRenderDrawBlendMode(ren, ((i + j) % 20) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+         ret = SDL_RenderGeometry(ren, NULL, verts, 3, NULL, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometry, expected: 0, got: %i", ret);
+      }
+   }
+
+   result = _readScene(ren);
+   SDL_RenderPresent(ren);
+
+   ret = SDL_RenderGetCommandCounts(ren, queued, submitted);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetCommandCounts, expected: 0, got: %i", ret);
+
+   _destroySceneRenderer(ren, win);
+   return result;
+}
+
+/**
+ * @brief Tests that reordering render commands merges draws without changing the output.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_REORDER_COMMANDS
+ * http://wiki.libsdl.org/SDL_RenderGetCommandCounts
+ */
+int
+render_testReorderCommands(void *arg)
+{
+   SDL_Surface *reference;
+   SDL_Surface *reordered;
+   Uint32 queued = 0, submitted = 0;
+   Uint32 reorderQueued = 0, reorderSubmitted = 0;
+   _SceneHints hints;
+
+   _saveSceneHints(&hints, SDL_HINT_RENDER_BATCHING, SDL_HINT_RENDER_REORDER_COMMANDS, NULL);
+   reference = _drawReorderScene(SDL_FALSE, &queued, &submitted);
+   reordered = _drawReorderScene(SDL_TRUE, &reorderQueued, &reorderSubmitted);
+   _restoreSceneHints(&hints);
+
+   if (reference == NULL || reordered == NULL) {
+      SDL_FreeSurface(reference);
+      SDL_FreeSurface(reordered);
+      return TEST_ABORTED;
+   }
+
+   SDLTest_AssertCheck(queued == submitted, "Without reordering every command is submitted, expected: %u, got: %u", (unsigned) queued, (unsigned) submitted);
+   SDLTest_AssertCheck(reorderQueued == queued, "Reordering doesn't change what is queued, expected: %u, got: %u", (unsigned) queued, (unsigned) reorderQueued);
+   SDLTest_AssertCheck(reorderSubmitted < reorderQueued / 4, "Reordering merges the triangles, expected fewer than %u commands, got: %u", (unsigned) (reorderQueued / 4), (unsigned) reorderSubmitted);
+   SDLTest_AssertCheck(SDLTest_CompareSurfaces(reordered, reference, 0) == 0, "Reordered output matches the reference");
+
+   SDL_FreeSurface(reference);
+   SDL_FreeSurface(reordered);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests the per-frame statistics.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderGetStats
+ */
+int
+render_testGetStats(void *arg)
+{
+   SDL_RenderStats stats;
+   SDL_Texture *streaming;
+   SDL_Texture *target = NULL;
+   SDL_Rect rect;
+   Uint32 pixels[16 * 16];
+   Uint32 draws;
+   void *lockedPixels;
+   int lockedPitch;
+   int ret;
+
+   ret = SDL_RenderGetStats(renderer, NULL);
+   SDLTest_AssertCheck(ret < 0, "Validate result from SDL_RenderGetStats(NULL), expected: <0, got: %i", ret);
+
+   /* Start from a clean frame. */
+   SDL_RenderPresent(renderer);
+
+   SDL_memset(pixels, 0xFF, sizeof (pixels));
+   streaming = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   SDLTest_AssertCheck(streaming != NULL, "Verify SDL_CreateTexture() result");
+   if (streaming == NULL) {
+      return TEST_ABORTED;
+   }
+   ret = SDL_UpdateTexture(streaming, NULL, pixels, 16 * 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   rect.x = rect.y = 4;
+   rect.w = rect.h = 8;
+   ret = SDL_LockTexture(streaming, &rect, &lockedPixels, &lockedPitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+   if (ret == 0) {
+      SDL_UnlockTexture(streaming);
+   }
+
+   SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+   SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderFillRect(renderer, &rect);
+   SDL_RenderDrawLine(renderer, 0, 0, 10, 10);
+   SDL_RenderDrawPoint(renderer, 20, 20);
+   SDL_RenderCopy(renderer, streaming, NULL, &rect);
+
+   if (SDL_RenderTargetSupported(renderer)) {
+      target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, 16, 16);
+      SDLTest_AssertCheck(target != NULL, "Verify SDL_CreateTexture() result");
+      if (target != NULL) {
+         SDL_SetRenderTarget(renderer, target);
+         SDL_RenderClear(renderer);
+         SDL_SetRenderTarget(renderer, NULL);
+      }
+   }
+
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+
+   draws = stats.clear_commands + stats.point_commands + stats.line_commands + stats.rect_commands +
+           stats.copy_commands + stats.copy_ex_commands + stats.geometry_commands;
+   SDLTest_AssertCheck(stats.clear_commands == (target ? 2 : 1), "Check clear commands, expected: %i, got: %u", (target ? 2 : 1), (unsigned) stats.clear_commands);
+   SDLTest_AssertCheck(draws >= 5, "Check draw commands, expected: >=5, got: %u", (unsigned) draws);
+   SDLTest_AssertCheck(stats.commands >= draws + stats.viewport_commands + stats.cliprect_commands + stats.color_commands,
+                       "Check that every command type is part of the total of %u", (unsigned) stats.commands);
+   SDLTest_AssertCheck(stats.submitted_commands <= stats.commands, "Check submitted commands, expected: <=%u, got: %u", (unsigned) stats.commands, (unsigned) stats.submitted_commands);
+   SDLTest_AssertCheck(stats.vertex_bytes > 0, "Check vertex bytes, expected: >0, got: %u", (unsigned) stats.vertex_bytes);
+   SDLTest_AssertCheck(stats.texture_uploads == 2, "Check texture uploads, expected: 2, got: %u", (unsigned) stats.texture_uploads);
+   SDLTest_AssertCheck(stats.texture_upload_bytes == (16 * 16 + 8 * 8) * 4, "Check texture upload bytes, expected: %i, got: %u", (16 * 16 + 8 * 8) * 4, (unsigned) stats.texture_upload_bytes);
+   SDLTest_AssertCheck(stats.target_changes == (target ? 2 : 0), "Check render target changes, expected: %i, got: %u", (target ? 2 : 0), (unsigned) stats.target_changes);
+   SDLTest_AssertCheck(stats.flushes >= (target ? 2 : 1), "Check flushes, expected: >=%i, got: %u", (target ? 2 : 1), (unsigned) stats.flushes);
+   SDLTest_AssertCheck(stats.vertex_bytes_max > 0 && stats.vertex_bytes_max <= stats.vertex_bytes,
+                       "Check largest flush, expected: 1..%u, got: %u", (unsigned) stats.vertex_bytes, (unsigned) stats.vertex_bytes_max);
+   SDLTest_AssertCheck(stats.vertex_arena_high_water >= stats.vertex_bytes_max, "Check vertex high-water mark, expected: >=%u, got: %u",
+                       (unsigned) stats.vertex_bytes_max, (unsigned) stats.vertex_arena_high_water);
+   SDLTest_AssertCheck(stats.vertex_arena_size >= stats.vertex_arena_high_water, "Check vertex arena size, expected: >=%u, got: %u",
+                       (unsigned) stats.vertex_arena_high_water, (unsigned) stats.vertex_arena_size);
+
+   /* Nothing drawn since, so the next frame starts over. */
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.commands == 0 && stats.texture_uploads == 0 && stats.flushes == 0,
+                       "Check that the statistics reset on present, got %u commands, %u uploads, %u flushes",
+                       (unsigned) stats.commands, (unsigned) stats.texture_uploads, (unsigned) stats.flushes);
+
+   if (target) {
+      SDL_DestroyTexture(target);
+   }
+   SDL_DestroyTexture(streaming);
+   return TEST_COMPLETED;
+}
+
+/**
+ * Draws the same few thousand triangles for a few frames, with the vertex
+ * arena reserve and async submit set as given. *stats gets the stats of the
+ * last frame.
+ */
+static int
+_drawVertexArenaScene(const char *reserve, SDL_bool async, int frames, SDL_RenderStats *stats)
+{
+   SDL_Window *win;
+   SDL_Renderer *ren;
+   SDL_Vertex verts[3];
+   int frame, i, ret;
+
+   SDL_SetHint(SDL_HINT_RENDER_VERTEX_ARENA_SIZE, reserve);
+   SDL_SetHint(SDL_HINT_RENDER_ASYNC_SUBMIT, async ? "1" : "0");
+   ren = _createSceneRenderer("render_testVertexArena", TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, &win);
+   if (ren == NULL) {
+      return -1;
+   }
+
+   SDL_zeroa(verts);
+   verts[1].position.x = 2.0f;
+   verts[2].position.y = 2.0f;
+   for (i = 0; i < 3; i++) {
+      verts[i].color.r = verts[i].color.g = verts[i].color.b = verts[i].color.a = 255;
+   }
+   for (frame = 0; frame < frames; frame++) {
+      for (i = 0; i < 4096; i++) {
+         SDL_RenderGeometry(ren, NULL, verts, 3, NULL, 0);
+      }
+      SDL_RenderPresent(ren);
+   }
+
+   ret = SDL_RenderGetStats(ren, stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+
+   _destroySceneRenderer(ren, win);
+   return ret;
+}
+
+/**
+ * @brief Tests reserving the vertex arena up front.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_VERTEX_ARENA_SIZE
+ * http://wiki.libsdl.org/SDL_RenderGetStats
+ */
+int
+render_testVertexArena(void *arg)
+{
+   SDL_RenderStats stats;
+   _SceneHints hints;
+
+   _saveSceneHints(&hints, SDL_HINT_RENDER_BATCHING, SDL_HINT_RENDER_VERTEX_ARENA_SIZE, SDL_HINT_RENDER_ASYNC_SUBMIT);
+
+   if (_drawVertexArenaScene("0", SDL_FALSE, 1, &stats) == 0) {
+      SDLTest_AssertCheck(stats.vertex_arena_grows > 0, "Check that the arena grows by default, got: %u", (unsigned) stats.vertex_arena_grows);
+      SDLTest_AssertCheck(stats.vertex_arena_high_water == stats.vertex_bytes_max, "Check high-water mark, expected: %u, got: %u",
+                          (unsigned) stats.vertex_bytes_max, (unsigned) stats.vertex_arena_high_water);
+   }
+
+   if (_drawVertexArenaScene("1048576", SDL_FALSE, 4, &stats) == 0) {
+      SDLTest_AssertCheck(stats.vertex_arena_grows == 0, "Check that a reserved arena doesn't grow, got: %u", (unsigned) stats.vertex_arena_grows);
+      SDLTest_AssertCheck(stats.vertex_arena_size == 1048576, "Check arena size, expected: 1048576, got: %u", (unsigned) stats.vertex_arena_size);
+      SDLTest_AssertCheck(stats.vertex_arena_high_water == stats.vertex_bytes_max, "Check high-water mark, expected: %u, got: %u",
+                          (unsigned) stats.vertex_bytes_max, (unsigned) stats.vertex_arena_high_water);
+   }
+
+   /* Each frame is recorded while the one before it is drawn, in the same arena. */
+   if (_drawVertexArenaScene("1048576", SDL_TRUE, 4, &stats) == 0) {
+      SDLTest_AssertCheck(stats.vertex_arena_grows == 0, "Check that a reserved arena doesn't grow, got: %u", (unsigned) stats.vertex_arena_grows);
+      SDLTest_AssertCheck(stats.vertex_arena_size == 1048576, "Check arena size, expected: 1048576, got: %u", (unsigned) stats.vertex_arena_size);
+      SDLTest_AssertCheck(stats.vertex_arena_high_water == 2 * stats.vertex_bytes_max, "Check high-water mark, expected: %u, got: %u",
+                          (unsigned) (2 * stats.vertex_bytes_max), (unsigned) stats.vertex_arena_high_water);
+   }
+
+   _restoreSceneHints(&hints);
+   return TEST_COMPLETED;
+}
+
+/**
+ * Copies parts of the test face all over the screen, either one call at a
+ * time or with a single batch call, and reads the result into a new surface.
+ * *draws gets the number of draw commands that were queued.
+ */
+static SDL_Surface *
+_drawCopyBatchScene(SDL_Texture *tface, SDL_bool batch, SDL_bool ex, Uint32 *draws)
+{
+   SDL_Rect srcrects[24];
+   SDL_FRect dstrects[24];
+   double angles[24];
+   SDL_RendererFlip flips[24];
+   SDL_RenderStats stats;
+   SDL_Surface *result;
+   SDL_Rect rect;
+   const int num = (int) SDL_arraysize(srcrects);
+   int i, ret, tw, th;
+
+   SDL_QueryTexture(tface, NULL, NULL, &tw, &th);
+   for (i = 0; i < num; i++) {
+      /* Some copies hang off the texture or the screen, and get clipped or dropped. */
+      srcrects[i].x = (i % 5) * tw / 4 - tw / 8;
+      srcrects[i].y = (i % 3) * th / 3;
+      srcrects[i].w = tw / 2;
+      srcrects[i].h = th / 2;
+      dstrects[i].x = (float) ((i % 6) * (TESTRENDER_SCREEN_W / 5) - 8);
+      dstrects[i].y = (float) ((i / 6) * (TESTRENDER_SCREEN_H / 4));
+      dstrects[i].w = (float) (srcrects[i].w * ((i % 4) ? 1 : 2));
+      dstrects[i].h = (float) srcrects[i].h;
+      angles[i] = (i % 3) * 45.0;
+      flips[i] = (SDL_RendererFlip) (i % 4);
+   }
+
+   _clearScreen();
+
+   if (batch && ex) {
+      ret = SDL_RenderCopyBatchEx(renderer, tface, srcrects, dstrects, angles, NULL, flips, num);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyBatchEx, expected: 0, got: %i", ret);
+   } else if (batch) {
+      ret = SDL_RenderCopyBatch(renderer, tface, srcrects, dstrects, num);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyBatch, expected: 0, got: %i", ret);
+   } else {
+      for (i = 0; i < num; i++) {
+         if (ex) {
+            ret = SDL_RenderCopyExF(renderer, tface, &srcrects[i], &dstrects[i], angles[i], NULL, flips[i]);
+         } else {
+            ret = SDL_RenderCopyF(renderer, tface, &srcrects[i], &dstrects[i]);
+         }
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyF/SDL_RenderCopyExF, expected: 0, got: %i", ret);
+      }
+   }
+
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = TESTRENDER_SCREEN_W;
+   rect.h = TESTRENDER_SCREEN_H;
+   result = SDL_CreateRGBSurface(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 32,
+                                 RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK, RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(result != NULL, "Check SDL_CreateRGBSurface result");
+   if (result != NULL) {
+      ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, result->pixels, result->pitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   }
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   *draws = stats.copy_commands + stats.copy_ex_commands + stats.geometry_commands;
+   return result;
+}
+
+/**
+ * @brief Tests that batched copies draw the same as one copy per call.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderCopyBatch
+ * http://wiki.libsdl.org/SDL_RenderCopyBatchEx
+ */
+int
+render_testCopyBatch(void *arg)
+{
+   SDL_Texture *tface;
+   SDL_Surface *reference, *batched;
+   Uint32 draws = 0, batchDraws = 0;
+   int ex, ret;
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL, "Verify _loadTestFace() result");
+   if (tface == NULL) {
+      return TEST_ABORTED;
+   }
+
+   for (ex = 0; ex <= 1; ex++) {
+      reference = _drawCopyBatchScene(tface, SDL_FALSE, (SDL_bool) ex, &draws);
+      batched = _drawCopyBatchScene(tface, SDL_TRUE, (SDL_bool) ex, &batchDraws);
+      if (reference != NULL && batched != NULL) {
+         ret = SDLTest_CompareSurfaces(batched, reference, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+         SDLTest_AssertCheck(batchDraws <= draws, "Check that batching doesn't add draws, expected: <= %u, got: %u",
+                             (unsigned) draws, (unsigned) batchDraws);
+         if (!ex) {
+            SDLTest_AssertCheck(batchDraws == 1, "Check that the batch is a single draw, expected: 1, got: %u", (unsigned) batchDraws);
+         }
+      }
+      SDL_FreeSurface(reference);
+      SDL_FreeSurface(batched);
+   }
+
+   ret = SDL_RenderCopyBatch(renderer, tface, NULL, NULL, 1);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderCopyBatch with NULL dstrects, expected: -1, got: %i", ret);
+
+   SDL_DestroyTexture(tface);
+   return TEST_COMPLETED;
+}
+
+/**
+ * Draws a few frames into a window of its own, changing and destroying
+ * textures right after each SDL_RenderPresent(), while the frame may still be
+ * drawn on the render thread. The last frame is read into a new surface.
+ */
+static SDL_Surface *
+_drawAsyncScene(SDL_bool async)
+{
+   SDL_Window *win;
+   SDL_Renderer *ren;
+   SDL_Texture *tex, *target;
+   SDL_Surface *result;
+   Uint32 pixels[16 * 16];
+   SDL_Rect rect;
+   int frame, i, ret;
+
+   SDL_SetHint(SDL_HINT_RENDER_ASYNC_SUBMIT, async ? "1" : "0");
+   ren = _createSceneRenderer("render_testAsyncSubmit", TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, &win);
+   if (ren == NULL) {
+      return NULL;
+   }
+
+   tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   target = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, 32, 32);
+   SDLTest_AssertCheck(tex != NULL && target != NULL, "Check SDL_CreateTexture results");
+
+   for (frame = 0; tex && target && frame < 8; frame++) {
+      SDL_Texture *temp;
+
+      /* The previous frame drew with this texture. */
+      for (i = 0; i < (int) SDL_arraysize(pixels); i++) {
+         pixels[i] = 0xFF000000 | ((Uint32) (frame * 0x3F1 + i * 0x10303) & 0x00FFFFFF);
+      }
+      if (frame % 2) {
+         ret = SDL_UpdateTexture(tex, NULL, pixels, 16 * 4);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+      } else {
+         void *locked;
+         int pitch;
+         ret = SDL_LockTexture(tex, NULL, &locked, &pitch);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+         if (ret == 0) {
+            for (i = 0; i < 16; i++) {
+               SDL_memcpy((Uint8 *) locked + i * pitch, &pixels[i * 16], 16 * 4);
+            }
+            SDL_UnlockTexture(tex);
+         }
+      }
+
+      ret = SDL_SetRenderTarget(ren, target);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderTarget, expected: 0, got: %i", ret);
+      SDL_SetRenderDrawColor(ren, 0, (Uint8) (frame * 30), 0, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(ren);
+      SDL_RenderCopy(ren, tex, NULL, NULL);
+      SDL_SetRenderTarget(ren, NULL);
+
+      SDL_SetRenderDrawColor(ren, (Uint8) (frame * 30), 0, 0, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(ren);
+      for (i = 0; i < 40; i++) {
+         rect.x = (i * 37 + frame * 5) % (TESTRENDER_SCREEN_W - 16);
+         rect.y = (i * 23 + frame * 3) % (TESTRENDER_SCREEN_H - 16);
+         rect.w = 16;
+         rect.h = 16;
+         SDL_RenderCopy(ren, (i % 2) ? tex : target, NULL, &rect);
+      }
+
+      temp = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+      SDLTest_AssertCheck(temp != NULL, "Check SDL_CreateTexture result");
+      if (temp != NULL) {
+         SDL_UpdateTexture(temp, NULL, pixels, 16 * 4);
+         rect.x = frame * 8;
+         rect.y = frame * 4;
+         SDL_RenderCopy(ren, temp, NULL, &rect);
+      }
+
+      SDL_RenderPresent(ren);
+
+      /* Still in use by the frame that was just presented. */
+      if (temp != NULL) {
+         SDL_DestroyTexture(temp);
+      }
+   }
+
+   result = _readScene(ren);
+
+   SDL_DestroyTexture(tex);
+   SDL_DestroyTexture(target);
+   _destroySceneRenderer(ren, win);
+   return result;
+}
+
+/**
+ * @brief Tests that drawing frames on a render thread gives the same result.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_ASYNC_SUBMIT
+ * http://wiki.libsdl.org/SDL_RenderPresent
+ */
+int
+render_testAsyncSubmit(void *arg)
+{
+   SDL_Surface *reference;
+   SDL_Surface *async;
+   _SceneHints hints;
+   int ret;
+
+   _saveSceneHints(&hints, SDL_HINT_RENDER_BATCHING, SDL_HINT_RENDER_ASYNC_SUBMIT, NULL);
+   reference = _drawAsyncScene(SDL_FALSE);
+   async = _drawAsyncScene(SDL_TRUE);
+   _restoreSceneHints(&hints);
+   if (reference != NULL && async != NULL) {
+      ret = SDLTest_CompareSurfaces(async, reference, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+   }
+   SDL_FreeSurface(reference);
+   SDL_FreeSurface(async);
+   return TEST_COMPLETED;
+}
+
+/**
+ * Draws a bit of everything the software renderer bins into tiles, plus a
+ * scaled copy and sloped lines that it draws directly, across a window of
+ * 200x150 (partial tiles on the right and bottom edges) with the given
+ * SDL_HINT_RENDER_SOFTWARE_THREADS. The result is read into a new surface.
+ */
+static SDL_Surface *
+_drawTiledScene(const char *threads)
+{
+   const int w = 200, h = 150;
+   SDL_Window *win;
+   SDL_Renderer *ren;
+   SDL_Texture *tex;
+   SDL_Surface *result;
+   Uint32 pixels[32 * 32];
+   SDL_Vertex verts[6];
+   SDL_Point points[64];
+   SDL_Rect rect;
+   int i, ret;
+
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, threads);
+   ren = _createSceneRenderer("render_testSoftwareThreads", w, h, &win);
+   if (ren == NULL) {
+      return NULL;
+   }
+
+   for (i = 0; i < (int) SDL_arraysize(pixels); i++) {
+      pixels[i] = ((Uint32) ((i * 7) & 0xFF) << 24) | ((Uint32) (i * 0x10305) & 0x00FFFFFF);
+   }
+   tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 32, 32);
+   SDLTest_AssertCheck(tex != NULL, "Check SDL_CreateTexture result");
+   if (tex != NULL) {
+      SDL_UpdateTexture(tex, NULL, pixels, 32 * 4);
+      SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+   }
+
+   SDL_SetRenderDrawColor(ren, 10, 20, 30, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(ren);
+
+   /* Opaque and blended rects over tile corners. */
+   for (i = 0; i < 12; i++) {
+      rect.x = (i * 53) % w - 10;
+      rect.y = (i * 31) % h - 10;
+      rect.w = 40 + (i * 13) % 50;
+      rect.h = 30 + (i * 17) % 40;
+      SDL_SetRenderDrawBlendMode(ren, (i % 3) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+      SDL_SetRenderDrawColor(ren, (Uint8) (i * 20), (Uint8) (255 - i * 20), (Uint8) (i * 50), (Uint8) (96 + i * 12));
+      SDL_RenderFillRect(ren, &rect);
+   }
+
+   /* Straight and sloped lines, and points. */
+   SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_ADD);
+   SDL_SetRenderDrawColor(ren, 200, 100, 50, 128);
+   SDL_RenderDrawLine(ren, 0, 64, w - 1, 64);
+   SDL_RenderDrawLine(ren, 63, 0, 63, h - 1);
+   SDL_RenderDrawLine(ren, 5, 5, w - 5, h - 20);
+   for (i = 0; i < (int) SDL_arraysize(points); i++) {
+      points[i].x = (i * 29) % w;
+      points[i].y = (i * 11) % h;
+   }
+   SDL_RenderDrawPoints(ren, points, (int) SDL_arraysize(points));
+
+   /* Colored triangles across tiles. */
+   SDL_zeroa(verts);
+   verts[0].position.x = 20.0f;   verts[0].position.y = 10.0f;
+   verts[1].position.x = 180.0f;  verts[1].position.y = 40.0f;
+   verts[2].position.x = 60.0f;   verts[2].position.y = 140.0f;
+   verts[3].position.x = 130.0f;  verts[3].position.y = 70.0f;
+   verts[4].position.x = 199.0f;  verts[4].position.y = 149.0f;
+   verts[5].position.x = 90.0f;   verts[5].position.y = 149.0f;
+   for (i = 0; i < 6; i++) {
+      verts[i].color.r = (Uint8) (i * 40);
+      verts[i].color.g = (Uint8) (255 - i * 40);
+      verts[i].color.b = 128;
+      verts[i].color.a = (Uint8) (128 + i * 20);
+   }
+   SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+   ret = SDL_RenderGeometry(ren, NULL, verts, 6, NULL, 0);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometry, expected: 0, got: %i", ret);
+
+   if (tex != NULL) {
+      /* Unscaled copies, one scaled copy, and textured triangles, inside a viewport and a clip rect. */
+      rect.x = 16;
+      rect.y = 8;
+      rect.w = w - 24;
+      rect.h = h - 16;
+      SDL_RenderSetViewport(ren, &rect);
+      rect.x = 10;
+      rect.y = 10;
+      rect.w = 140;
+      rect.h = 100;
+      SDL_RenderSetClipRect(ren, &rect);
+      for (i = 0; i < 10; i++) {
+         rect.x = (i * 37) % (w - 40);
+         rect.y = (i * 23) % (h - 40);
+         rect.w = 32;
+         rect.h = 32;
+         SDL_SetTextureColorMod(tex, 255, (Uint8) (255 - i * 20), 255);
+         SDL_RenderCopy(ren, tex, NULL, &rect);
+      }
+      rect.x = 40;
+      rect.y = 30;
+      rect.w = 70;
+      rect.h = 50;
+      SDL_RenderCopy(ren, tex, NULL, &rect);
+
+      for (i = 0; i < 6; i++) {
+         verts[i].tex_coord.x = (float) (i % 2);
+         verts[i].tex_coord.y = (float) ((i / 2) % 2);
+      }
+      ret = SDL_RenderGeometry(ren, tex, verts, 6, NULL, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometry, expected: 0, got: %i", ret);
+      SDL_RenderSetClipRect(ren, NULL);
+      SDL_RenderSetViewport(ren, NULL);
+   }
+
+   result = _readScene(ren);
+   SDL_RenderPresent(ren);
+
+   if (tex != NULL) {
+      SDL_DestroyTexture(tex);
+   }
+   _destroySceneRenderer(ren, win);
+   return result;
+}
+
+/**
+ * @brief Tests that drawing in tiles on several threads gives the same result as drawing on one.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_SOFTWARE_THREADS
+ */
+int
+render_testSoftwareThreads(void *arg)
+{
+   SDL_Surface *reference;
+   SDL_Surface *tiled;
+   _SceneHints hints;
+   int ret;
+
+   _saveSceneHints(&hints, SDL_HINT_RENDER_BATCHING, SDL_HINT_RENDER_SOFTWARE_THREADS, NULL);
+   reference = _drawTiledScene("1");
+   tiled = _drawTiledScene("4");
+   _restoreSceneHints(&hints);
+   if (reference != NULL && tiled != NULL) {
+      ret = SDLTest_CompareSurfaces(tiled, reference, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+   }
+   SDL_FreeSurface(reference);
+   SDL_FreeSurface(tiled);
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Blits doing color tests.
  *
@@ -1085,9 +1826,27 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testReorderCommands, "render_testReorderCommands", "Tests reordering and merging render commands", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testGetStats, "render_testGetStats", "Tests render statistics", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testVertexArena, "render_testVertexArena", "Tests reserving the vertex arena", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testCopyBatch, "render_testCopyBatch", "Tests batched texture copies", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testAsyncSubmit, "render_testAsyncSubmit", "Tests drawing frames on a render thread", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testSoftwareThreads, "render_testSoftwareThreads", "Tests drawing in tiles on several threads", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, NULL
 };
 
 /* Render test suite (global) */
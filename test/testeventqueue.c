@@ -0,0 +1,202 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure SDL event queue throughput with several threads pushing events
+   while the main thread drains them, the way joystick, sensor and touch
+   threads feed the queue in a real application.
+
+   Also measure how fast a frame loop can drain its events with
+   SDL_PollEvent() compared to SDL_PollEvents().
+ */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define MAX_WRITERS 64
+#define READ_BATCH  64
+#define POLL_FRAMES 2000
+
+static int num_writers = 4;
+static int events_per_writer = 250000;
+static int events_per_frame = 256;
+
+typedef struct
+{
+    int index;
+    int waits;
+    char padding[SDL_CACHELINE_SIZE-2*sizeof(int)];
+} WriterData;
+
+static int SDLCALL
+EventWriter(void *_data)
+{
+    WriterData *data = (WriterData *)_data;
+    SDL_Event event;
+    int i;
+
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    event.user.data1 = data;
+
+    for (i = 0; i < events_per_writer; ++i) {
+        event.user.code = i;
+        while (SDL_PushEvent(&event) <= 0) {
+            /* The queue is full, give the reader a chance to catch up */
+            ++data->waits;
+            SDL_Delay(0);
+        }
+    }
+    return 0;
+}
+
+static void
+RunQueueTest(const char *lockfree)
+{
+    WriterData writers[MAX_WRITERS];
+    SDL_Thread *threads[MAX_WRITERS];
+    SDL_Event events[READ_BATCH];
+    const int total = num_writers * events_per_writer;
+    int received = 0;
+    int waits = 0;
+    int i, n;
+    Uint64 start, end;
+    double seconds;
+
+    SDL_SetHint(SDL_HINT_EVENT_QUEUE_LOCKFREE, lockfree);
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    SDL_zeroa(writers);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_writers; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof (name), "EventWriter%d", i);
+        writers[i].index = i;
+        threads[i] = SDL_CreateThread(EventWriter, name, &writers[i]);
+    }
+
+    while (received < total) {
+        n = SDL_PeepEvents(events, READ_BATCH, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+        if (n < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_PeepEvents() failed: %s\n", SDL_GetError());
+            break;
+        }
+        if (n == 0) {
+            SDL_Delay(0);
+        }
+        received += n;
+    }
+    end = SDL_GetPerformanceCounter();
+
+    for (i = 0; i < num_writers; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+        waits += writers[i].waits;
+    }
+
+    seconds = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("%-10s %d writers: %d events in %.3f sec, %.0f events/sec, %d full-queue waits\n",
+            SDL_atoi(lockfree) ? "lock-free" : "mutex", num_writers, received,
+            seconds, received / seconds, waits);
+
+    SDL_Quit();
+}
+
+static void
+RunPollTest(const char *lockfree, SDL_bool batched)
+{
+    SDL_Event events[READ_BATCH];
+    SDL_Event *frame_events;
+    int frame, i, n;
+    int received = 0;
+    Uint64 start, elapsed = 0;
+    double seconds;
+
+    SDL_SetHint(SDL_HINT_EVENT_QUEUE_LOCKFREE, lockfree);
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    frame_events = (SDL_Event *)SDL_calloc(events_per_frame, sizeof(*frame_events));
+    if (!frame_events) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        exit(1);
+    }
+    for (i = 0; i < events_per_frame; ++i) {
+        frame_events[i].type = SDL_USEREVENT;
+        frame_events[i].user.code = i;
+    }
+
+    for (frame = 0; frame < POLL_FRAMES; ++frame) {
+        SDL_PeepEvents(frame_events, events_per_frame, SDL_ADDEVENT, 0, 0);
+
+        /* Only time the draining, that's what the frame loop pays for */
+        start = SDL_GetPerformanceCounter();
+        if (batched) {
+            while ((n = SDL_PollEvents(events, READ_BATCH)) > 0) {
+                received += n;
+            }
+        } else {
+            while (SDL_PollEvent(events)) {
+                ++received;
+            }
+        }
+        elapsed += SDL_GetPerformanceCounter() - start;
+    }
+
+    seconds = (double)elapsed / SDL_GetPerformanceFrequency();
+    SDL_Log("%-10s %-15s %d events/frame: %d events in %.3f sec, %.0f events/sec\n",
+            SDL_atoi(lockfree) ? "lock-free" : "mutex", batched ? "SDL_PollEvents" : "SDL_PollEvent",
+            events_per_frame, received, seconds, received / seconds);
+
+    SDL_free(frame_events);
+    SDL_Quit();
+}
+
+int
+main(int argc, char *argv[])
+{
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--writers") == 0 && argv[i+1]) {
+            num_writers = SDL_atoi(argv[++i]);
+            num_writers = SDL_clamp(num_writers, 1, MAX_WRITERS);
+        } else if (SDL_strcasecmp(argv[i], "--events") == 0 && argv[i+1]) {
+            events_per_writer = SDL_atoi(argv[++i]);
+            events_per_writer = SDL_max(events_per_writer, 1);
+        } else if (SDL_strcasecmp(argv[i], "--frame-events") == 0 && argv[i+1]) {
+            events_per_frame = SDL_atoi(argv[++i]);
+            events_per_frame = SDL_clamp(events_per_frame, 1, 8192);
+        } else {
+            SDL_Log("USAGE: %s [--writers N] [--events N] [--frame-events N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    RunQueueTest("0");
+    RunQueueTest("1");
+
+    RunPollTest("0", SDL_FALSE);
+    RunPollTest("0", SDL_TRUE);
+    RunPollTest("1", SDL_FALSE);
+    RunPollTest("1", SDL_TRUE);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
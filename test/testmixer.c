@@ -0,0 +1,318 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check SDL_MixAudioFormat() and SDL_MixAudioMulti() against themselves one
+   sample at a time (which never reaches the SIMD mixers), then measure how
+   many samples per second they mix in buffers the size a typical audio
+   callback gets, with SDL_MixAudioMulti() against one SDL_MixAudioFormat()
+   call per voice. */
+
+#include "SDL.h"
+
+#define MIX_BUFFER_BYTES 4096
+#define MIX_ITERATIONS 20000
+#define MAX_VOICES 64
+
+static const struct { SDL_AudioFormat format; const char *name; } formats[] = {
+    { AUDIO_U8, "AUDIO_U8" },
+    { AUDIO_S8, "AUDIO_S8" },
+    { AUDIO_S16LSB, "AUDIO_S16LSB" },
+    { AUDIO_S16MSB, "AUDIO_S16MSB" },
+    { AUDIO_U16LSB, "AUDIO_U16LSB" },
+    { AUDIO_U16MSB, "AUDIO_U16MSB" },
+    { AUDIO_S32LSB, "AUDIO_S32LSB" },
+    { AUDIO_S32MSB, "AUDIO_S32MSB" },
+    { AUDIO_F32LSB, "AUDIO_F32LSB" },
+    { AUDIO_F32MSB, "AUDIO_F32MSB" }
+};
+
+static const int volumes[] = { SDL_MIX_MAXVOLUME, SDL_MIX_MAXVOLUME / 2, 77, 1 };
+
+static Uint32 seed = 0x12345678;
+
+static Uint32
+Random32(void)
+{
+    seed = (seed * 1664525) + 1013904223;
+    return seed;
+}
+
+/* Integer formats get random bits, to exercise the clamping; float formats
+   get samples between -1.0 and 1.0. */
+static void
+FillBuffer(Uint8 *buf, SDL_AudioFormat format, Uint32 len)
+{
+    Uint32 i;
+
+    if (SDL_AUDIO_ISFLOAT(format)) {
+        float *fbuf = (float *) buf;
+        for (i = 0; i < len / sizeof (float); i++) {
+            const float sample = ((float) (Random32() >> 8) / 8388608.0f) - 1.0f;
+            fbuf[i] = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(sample) : SDL_SwapFloatLE(sample);
+        }
+    } else {
+        for (i = 0; i < len; i++) {
+            buf[i] = (Uint8) (Random32() >> 24);
+        }
+    }
+}
+
+static SDL_bool
+SamplesMatch(const Uint8 *a, const Uint8 *b, SDL_AudioFormat format, Uint32 len)
+{
+    Uint32 i;
+
+    if (!SDL_AUDIO_ISFLOAT(format)) {
+        return (SDL_memcmp(a, b, len) == 0) ? SDL_TRUE : SDL_FALSE;
+    }
+
+    /* the scalar mixer adds in double precision, allow for rounding. */
+    for (i = 0; i < len / sizeof (float); i++) {
+        const float fa = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(((const float *) a)[i]) : SDL_SwapFloatLE(((const float *) a)[i]);
+        const float fb = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(((const float *) b)[i]) : SDL_SwapFloatLE(((const float *) b)[i]);
+        if (SDL_fabs(fa - fb) > 1e-6) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static int
+CheckMixer(void)
+{
+    Uint8 *src = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    Uint8 *dst = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    Uint8 *expected = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    int failures = 0;
+    int f, v;
+
+    if (!src || !dst || !expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return 1;
+    }
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const SDL_AudioFormat format = formats[f].format;
+        const Uint32 samplelen = SDL_AUDIO_BITSIZE(format) / 8;
+        for (v = 0; v < SDL_arraysize(volumes); v++) {
+            /* an odd number of samples, so there's always a tail left over. */
+            const Uint32 len = ((MIX_BUFFER_BYTES / samplelen) - 3) * samplelen;
+            Uint32 i;
+
+            FillBuffer(src, format, len);
+            FillBuffer(dst, format, len);
+            SDL_memcpy(expected, dst, len);
+
+            for (i = 0; i < len; i += samplelen) {
+                SDL_MixAudioFormat(expected + i, src + i, format, samplelen, volumes[v]);
+            }
+            SDL_MixAudioFormat(dst, src, format, len, volumes[v]);
+
+            if (!SamplesMatch(dst, expected, format, len)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s at volume %d doesn't match the scalar mixer!\n", formats[f].name, volumes[v]);
+                failures++;
+            }
+        }
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_free(expected);
+    return failures ? 1 : 0;
+}
+
+static int
+CheckMultiMixer(void)
+{
+    static const int num_voices[] = { 1, 3, 8 };
+    const Uint8 *srcs[8];
+    int voice_volumes[8];
+    Uint8 *voices = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES * SDL_arraysize(voice_volumes));
+    Uint8 *dst = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    Uint8 *expected = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    int failures = 0;
+    int f, n, i;
+
+    if (!voices || !dst || !expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return 1;
+    }
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const SDL_AudioFormat format = formats[f].format;
+        const Uint32 samplelen = SDL_AUDIO_BITSIZE(format) / 8;
+        const Uint32 len = ((MIX_BUFFER_BYTES / samplelen) - 3) * samplelen;
+        for (n = 0; n < SDL_arraysize(num_voices); n++) {
+            const int voices_used = num_voices[n];
+            Uint32 j;
+
+            for (i = 0; i < voices_used; i++) {
+                srcs[i] = voices + (i * MIX_BUFFER_BYTES);
+                voice_volumes[i] = (i == 1) ? 0 : (SDL_MIX_MAXVOLUME - (i * 13));
+                FillBuffer((Uint8 *) srcs[i], format, len);
+            }
+            FillBuffer(dst, format, len);
+            SDL_memcpy(expected, dst, len);
+
+            if (voices_used == 1) {
+                SDL_MixAudioFormat(expected, srcs[0], format, len, voice_volumes[0]);
+            } else {
+                for (j = 0; j < len; j += samplelen) {
+                    const Uint8 *sample_srcs[8];
+                    for (i = 0; i < voices_used; i++) {
+                        sample_srcs[i] = srcs[i] + j;
+                    }
+                    SDL_MixAudioMulti(expected + j, sample_srcs, voice_volumes, voices_used, format, samplelen);
+                }
+            }
+            SDL_MixAudioMulti(dst, srcs, voice_volumes, voices_used, format, len);
+
+            if (!SamplesMatch(dst, expected, format, len)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_MixAudioMulti() with %s and %d voices doesn't match the %s!\n",
+                             formats[f].name, voices_used, (voices_used == 1) ? "single source mixer" : "scalar mixer");
+                failures++;
+            }
+        }
+    }
+
+    SDL_free(voices);
+    SDL_free(dst);
+    SDL_free(expected);
+    return failures ? 1 : 0;
+}
+
+static void
+RunBenchmark(void)
+{
+    Uint8 *src = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    Uint8 *dst = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    int f, v, i;
+
+    if (!src || !dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return;
+    }
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const SDL_AudioFormat format = formats[f].format;
+        const int samples = MIX_BUFFER_BYTES / (SDL_AUDIO_BITSIZE(format) / 8);
+        for (v = 0; v < 2; v++) {
+            Uint64 start;
+            double seconds;
+
+            FillBuffer(src, format, MIX_BUFFER_BYTES);
+            start = SDL_GetPerformanceCounter();
+            for (i = 0; i < MIX_ITERATIONS; i++) {
+                /* silence the destination every so often, so floats don't run off to infinity. */
+                if ((i % 64) == 0) {
+                    SDL_memset(dst, SDL_AUDIO_ISSIGNED(format) ? 0 : 0x80, MIX_BUFFER_BYTES);
+                }
+                SDL_MixAudioFormat(dst, src, format, MIX_BUFFER_BYTES, volumes[v]);
+            }
+            seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+            SDL_Log("%-12s volume %3d: %8.2f Msamples/sec\n", formats[f].name, volumes[v],
+                    ((double) samples * MIX_ITERATIONS / seconds) / 1000000.0);
+        }
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+}
+
+static void
+RunMultiBenchmark(void)
+{
+    static const SDL_AudioFormat multi_formats[] = { AUDIO_S16SYS, AUDIO_S32SYS, AUDIO_F32SYS };
+    const Uint8 *srcs[MAX_VOICES];
+    int voice_volumes[MAX_VOICES];
+    Uint8 *voices = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES * MAX_VOICES);
+    Uint8 *dst = (Uint8 *) SDL_malloc(MIX_BUFFER_BYTES);
+    int f, n, i, j;
+
+    if (!voices || !dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return;
+    }
+
+    for (f = 0; f < SDL_arraysize(multi_formats); f++) {
+        const SDL_AudioFormat format = multi_formats[f];
+        const int samples = MIX_BUFFER_BYTES / (SDL_AUDIO_BITSIZE(format) / 8);
+        const char *name = "";
+
+        for (i = 0; i < SDL_arraysize(formats); i++) {
+            if (formats[i].format == format) {
+                name = formats[i].name;
+            }
+        }
+
+        for (i = 0; i < MAX_VOICES; i++) {
+            srcs[i] = voices + (i * MIX_BUFFER_BYTES);
+            voice_volumes[i] = SDL_MIX_MAXVOLUME / 4;
+            FillBuffer((Uint8 *) srcs[i], format, MIX_BUFFER_BYTES);
+        }
+
+        for (n = 2; n <= MAX_VOICES; n *= 2) {
+            const int iterations = (MIX_ITERATIONS * 2) / n;
+            double seconds_single, seconds_multi;
+            Uint64 start;
+
+            SDL_memset(dst, 0, MIX_BUFFER_BYTES);
+            start = SDL_GetPerformanceCounter();
+            for (i = 0; i < iterations; i++) {
+                for (j = 0; j < n; j++) {
+                    SDL_MixAudioFormat(dst, srcs[j], format, MIX_BUFFER_BYTES, voice_volumes[j]);
+                }
+            }
+            seconds_single = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+            SDL_memset(dst, 0, MIX_BUFFER_BYTES);
+            start = SDL_GetPerformanceCounter();
+            for (i = 0; i < iterations; i++) {
+                SDL_MixAudioMulti(dst, srcs, voice_volumes, n, format, MIX_BUFFER_BYTES);
+            }
+            seconds_multi = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+            SDL_Log("%-12s %2d voices: %8.2f Msamples/sec one at a time, %8.2f Msamples/sec with SDL_MixAudioMulti()\n",
+                    name, n, ((double) samples * n * iterations / seconds_single) / 1000000.0,
+                    ((double) samples * n * iterations / seconds_multi) / 1000000.0);
+        }
+    }
+
+    SDL_free(voices);
+    SDL_free(dst);
+}
+
+int
+main(int argc, char **argv)
+{
+    int retval;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    retval = CheckMixer() | CheckMultiMixer();
+    if (retval == 0) {
+        RunBenchmark();
+        RunMultiBenchmark();
+    }
+
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
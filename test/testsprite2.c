@@ -35,11 +35,13 @@ static int current_alpha = 0;
 static int current_color = 0;
 static SDL_Rect *positions;
 static SDL_Rect *velocities;
+static SDL_FRect *batch_positions;
 static int sprite_w, sprite_h;
 static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
 static Uint32 next_fps_check, frames;
 static const Uint32 fps_check_delay = 5000;
 static int use_rendergeometry = 0;
+static SDL_bool use_copybatch = SDL_FALSE;
 
 /* Number of iterations to move sprites - used for visual tests. */
 /* -1: infinite random moves (default); >=0: enables N deterministic moves */
@@ -54,6 +56,7 @@ quit(int rc)
     SDL_free(sprites);
     SDL_free(positions);
     SDL_free(velocities);
+    SDL_free(batch_positions);
     SDLTest_CommonQuit(state);
     exit(rc);
 }
@@ -264,7 +267,18 @@ MoveSprites(SDL_Renderer * renderer, SDL_Texture * sprite)
     }
 
     /* Draw sprites */
-    if (use_rendergeometry == 0) {
+    if (use_copybatch) {
+        for (i = 0; i < num_sprites; ++i) {
+            position = &positions[i];
+            batch_positions[i].x = (float)position->x;
+            batch_positions[i].y = (float)position->y;
+            batch_positions[i].w = (float)position->w;
+            batch_positions[i].h = (float)position->h;
+        }
+
+        /* Blit all the sprites onto the screen with one call */
+        SDL_RenderCopyBatch(renderer, sprite, NULL, batch_positions, num_sprites);
+    } else if (use_rendergeometry == 0) {
         for (i = 0; i < num_sprites; ++i) {
             position = &positions[i];
 
@@ -526,6 +540,10 @@ main(int argc, char *argv[])
                     }
                 }
                 consumed = 2;
+            } else if (SDL_strcasecmp(argv[i], "--use-copybatch") == 0) {
+                /* Draw the sprites with SDL_RenderCopyBatch() instead of one SDL_RenderCopy() each */
+                use_copybatch = SDL_TRUE;
+                consumed = 1;
             } else if (SDL_isdigit(*argv[i])) {
                 num_sprites = SDL_atoi(argv[i]);
                 consumed = 1;
@@ -541,6 +559,7 @@ main(int argc, char *argv[])
                 "[--cyclealpha]",
                 "[--iterations N]",
                 "[--use-rendergeometry mode1|mode2]",
+                "[--use-copybatch]",
                 "[num_sprites]",
                 "[icon.bmp]",
                 NULL };
@@ -572,7 +591,8 @@ main(int argc, char *argv[])
     /* Allocate memory for the sprite info */
     positions = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
     velocities = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
-    if (!positions || !velocities) {
+    batch_positions = (SDL_FRect *) SDL_malloc(num_sprites * sizeof(SDL_FRect));
+    if (!positions || !velocities || !batch_positions) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
         quit(2);
     }
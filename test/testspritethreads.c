@@ -0,0 +1,331 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure how the software renderer scales with SDL_HINT_RENDER_SOFTWARE_THREADS,
+   drawing the testsprite2 scene offscreen, and check that every thread count
+   draws the same pixels as a single thread. */
+
+#include "SDL.h"
+
+#define WINDOW_WIDTH    1280
+#define WINDOW_HEIGHT   720
+
+static int num_sprites = 1000;
+static int num_frames = 200;
+static int use_rendergeometry = 0;
+static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+static int sprite_w, sprite_h;
+static SDL_Rect *positions;
+static SDL_Rect *velocities;
+static int current_color;
+static int cycle_direction;
+static Uint32 seed;
+
+static int
+Random(int range)
+{
+    seed = (seed * 1664525) + 1013904223;
+    return (int) ((seed >> 8) % (Uint32) range);
+}
+
+static SDL_Texture *
+LoadSprite(SDL_Renderer *renderer, const char *file)
+{
+    SDL_Surface *temp;
+    SDL_Texture *sprite;
+
+    temp = SDL_LoadBMP(file);
+    if (temp == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s", file, SDL_GetError());
+        return NULL;
+    }
+    sprite_w = temp->w;
+    sprite_h = temp->h;
+
+    /* Set transparent pixel as the pixel at (0,0) */
+    if (temp->format->palette) {
+        SDL_SetColorKey(temp, 1, *(Uint8 *) temp->pixels);
+    }
+
+    sprite = SDL_CreateTextureFromSurface(renderer, temp);
+    SDL_FreeSurface(temp);
+    if (!sprite) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(sprite, blendMode);
+    return sprite;
+}
+
+static void
+ResetSprites(void)
+{
+    int i;
+
+    seed = 0x12345678;
+    current_color = 0;
+    cycle_direction = 1;
+    for (i = 0; i < num_sprites; ++i) {
+        positions[i].x = Random(WINDOW_WIDTH - sprite_w);
+        positions[i].y = Random(WINDOW_HEIGHT - sprite_h);
+        positions[i].w = sprite_w;
+        positions[i].h = sprite_h;
+        velocities[i].x = 0;
+        velocities[i].y = 0;
+        while (!velocities[i].x && !velocities[i].y) {
+            velocities[i].x = Random(5) - 2;
+            velocities[i].y = Random(5) - 2;
+        }
+    }
+}
+
+/* The testsprite2 frame, with color cycling on */
+static void
+DrawFrame(SDL_Renderer *renderer, SDL_Texture *sprite)
+{
+    SDL_Rect viewport, temp;
+    int i;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+
+    current_color += cycle_direction;
+    if (current_color < 0 || current_color > 255) {
+        cycle_direction = -cycle_direction;
+        current_color += 2 * cycle_direction;
+    }
+    SDL_SetTextureColorMod(sprite, 255, (Uint8) current_color, (Uint8) current_color);
+
+    /* Draw a gray background */
+    SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+    SDL_RenderClear(renderer);
+
+    /* Test points */
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0x00, 0x00, 0xFF);
+    SDL_RenderDrawPoint(renderer, 0, 0);
+    SDL_RenderDrawPoint(renderer, viewport.w-1, 0);
+    SDL_RenderDrawPoint(renderer, 0, viewport.h-1);
+    SDL_RenderDrawPoint(renderer, viewport.w-1, viewport.h-1);
+
+    /* Test horizontal and vertical lines */
+    SDL_SetRenderDrawColor(renderer, 0x00, 0xFF, 0x00, 0xFF);
+    SDL_RenderDrawLine(renderer, 1, 0, viewport.w-2, 0);
+    SDL_RenderDrawLine(renderer, 1, viewport.h-1, viewport.w-2, viewport.h-1);
+    SDL_RenderDrawLine(renderer, 0, 1, 0, viewport.h-2);
+    SDL_RenderDrawLine(renderer, viewport.w-1, 1, viewport.w-1, viewport.h-2);
+
+    /* Test fill and copy */
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    temp.w = sprite_w;
+    temp.h = sprite_h;
+    for (i = 0; i < 4; ++i) {
+        temp.x = (i & 1) ? (viewport.w-sprite_w-1) : 1;
+        temp.y = (i & 2) ? (viewport.h-sprite_h-1) : 1;
+        SDL_RenderFillRect(renderer, &temp);
+        SDL_RenderCopy(renderer, sprite, NULL, &temp);
+    }
+
+    /* Test diagonal lines */
+    SDL_SetRenderDrawColor(renderer, 0x00, 0xFF, 0x00, 0xFF);
+    SDL_RenderDrawLine(renderer, sprite_w, sprite_h,
+                       viewport.w-sprite_w-2, viewport.h-sprite_h-2);
+    SDL_RenderDrawLine(renderer, viewport.w-sprite_w-2, sprite_h,
+                       sprite_w, viewport.h-sprite_h-2);
+
+    /* Move the sprites, bounce at the wall */
+    for (i = 0; i < num_sprites; ++i) {
+        SDL_Rect *position = &positions[i];
+        SDL_Rect *velocity = &velocities[i];
+        position->x += velocity->x;
+        if ((position->x < 0) || (position->x >= (viewport.w - sprite_w))) {
+            velocity->x = -velocity->x;
+            position->x += velocity->x;
+        }
+        position->y += velocity->y;
+        if ((position->y < 0) || (position->y >= (viewport.h - sprite_h))) {
+            velocity->y = -velocity->y;
+            position->y += velocity->y;
+        }
+    }
+
+    /* Draw sprites */
+    if (!use_rendergeometry) {
+        for (i = 0; i < num_sprites; ++i) {
+            SDL_RenderCopy(renderer, sprite, NULL, &positions[i]);
+        }
+    } else {
+        /* Two triangles per sprite, like testsprite2 --use-rendergeometry mode1 */
+        SDL_Vertex *verts = (SDL_Vertex *) SDL_malloc(num_sprites * sizeof (SDL_Vertex) * 6);
+        if (verts) {
+            static const float corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+            SDL_Color color;
+            int j;
+
+            SDL_GetTextureColorMod(sprite, &color.r, &color.g, &color.b);
+            SDL_GetTextureAlphaMod(sprite, &color.a);
+            for (i = 0; i < num_sprites; ++i) {
+                for (j = 0; j < 6; ++j) {
+                    SDL_Vertex *vert = &verts[i * 6 + j];
+                    vert->position.x = (float) positions[i].x + corners[j][0] * positions[i].w;
+                    vert->position.y = (float) positions[i].y + corners[j][1] * positions[i].h;
+                    vert->color = color;
+                    vert->tex_coord.x = corners[j][0];
+                    vert->tex_coord.y = corners[j][1];
+                }
+            }
+            SDL_RenderGeometry(renderer, sprite, verts, num_sprites * 6, NULL, 0);
+            SDL_free(verts);
+        }
+    }
+
+    SDL_RenderPresent(renderer);
+}
+
+/* Draws num_frames frames with the given number of threads, returns frames
+   per second and the last frame in pixels, or a negative value on error. */
+static double
+RunBenchmark(int threads, Uint32 *pixels)
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *sprite;
+    char hint[16];
+    Uint64 start;
+    double seconds = -1.0;
+    int i;
+
+    window = SDL_CreateWindow("testspritethreads", 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    if (!window) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create window: %s\n", SDL_GetError());
+        return -1.0;
+    }
+
+    SDL_snprintf(hint, sizeof (hint), "%d", threads);
+    SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, hint);
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (!renderer) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create renderer: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return -1.0;
+    }
+
+    sprite = LoadSprite(renderer, "icon.bmp");
+    if (sprite) {
+        ResetSprites();
+        start = SDL_GetPerformanceCounter();
+        for (i = 0; i < num_frames; ++i) {
+            DrawFrame(renderer, sprite);
+        }
+        seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+        if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, WINDOW_WIDTH * sizeof (Uint32)) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't read pixels: %s\n", SDL_GetError());
+            seconds = -1.0;
+        }
+        SDL_DestroyTexture(sprite);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    return (seconds > 0.0) ? (num_frames / seconds) : seconds;
+}
+
+int
+main(int argc, char **argv)
+{
+    const size_t pixels_size = WINDOW_WIDTH * WINDOW_HEIGHT * sizeof (Uint32);
+    Uint32 *serial, *threaded;
+    double serial_fps;
+    int i, threads, max_threads;
+    int retval = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--sprites") == 0 && argv[i+1]) {
+            num_sprites = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--frames") == 0 && argv[i+1]) {
+            num_frames = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--use-rendergeometry") == 0) {
+            use_rendergeometry = 1;
+        } else if (SDL_strcasecmp(argv[i], "--blend") == 0 && argv[i+1]) {
+            ++i;
+            if (SDL_strcasecmp(argv[i], "none") == 0) {
+                blendMode = SDL_BLENDMODE_NONE;
+            } else if (SDL_strcasecmp(argv[i], "add") == 0) {
+                blendMode = SDL_BLENDMODE_ADD;
+            } else if (SDL_strcasecmp(argv[i], "mod") == 0) {
+                blendMode = SDL_BLENDMODE_MOD;
+            } else {
+                blendMode = SDL_BLENDMODE_BLEND;
+            }
+        } else {
+            SDL_Log("USAGE: %s [--sprites N] [--frames N] [--use-rendergeometry] [--blend none|blend|add|mod]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (num_sprites <= 0 || num_frames <= 0) {
+        SDL_Log("Need at least one sprite and one frame\n");
+        return 1;
+    }
+
+    /* Draw offscreen if that driver is built in, otherwise take the default
+       one (SDL_VIDEODRIVER=dummy works just as well) */
+    if (SDL_VideoInit("offscreen") < 0 && SDL_VideoInit(NULL) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize video: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Log("Using the %s video driver, %d CPUs\n", SDL_GetCurrentVideoDriver(), SDL_GetCPUCount());
+
+    positions = (SDL_Rect *) SDL_malloc(num_sprites * sizeof (SDL_Rect));
+    velocities = (SDL_Rect *) SDL_malloc(num_sprites * sizeof (SDL_Rect));
+    serial = (Uint32 *) SDL_malloc(pixels_size);
+    threaded = (Uint32 *) SDL_malloc(pixels_size);
+    if (!positions || !velocities || !serial || !threaded) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        retval = 1;
+        goto done;
+    }
+
+    serial_fps = RunBenchmark(1, serial);
+    if (serial_fps < 0.0) {
+        retval = 1;
+        goto done;
+    }
+    SDL_Log("%3d threads: %8.2f frames/s\n", 1, serial_fps);
+
+    /* Go past the CPU count a little, so the tiled path always gets checked */
+    max_threads = SDL_max(SDL_GetCPUCount(), 4);
+    for (threads = 2; threads <= max_threads; threads *= 2) {
+        const double fps = RunBenchmark(threads, threaded);
+        if (fps < 0.0) {
+            retval = 1;
+            break;
+        }
+        SDL_Log("%3d threads: %8.2f frames/s, %5.2fx\n", threads, fps, fps / serial_fps);
+        if (SDL_memcmp(serial, threaded, pixels_size) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%d threads drew different pixels than one thread!\n", threads);
+            retval = 1;
+        }
+    }
+
+done:
+    SDL_free(positions);
+    SDL_free(velocities);
+    SDL_free(serial);
+    SDL_free(threaded);
+    SDL_VideoQuit();
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
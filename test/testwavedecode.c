@@ -0,0 +1,206 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure how fast SDL_LoadWAV_RW() decodes MS ADPCM and IMA ADPCM, with a
+   single thread and with the default number of decoding threads, and check
+   that both produce the same samples. Pass a .wav file to measure that file
+   instead of the generated ones. */
+
+#include "SDL.h"
+
+#define WAVE_SECONDS 300
+#define WAVE_FREQ 44100
+#define WAVE_CHANNELS 2
+#define WAVE_BLOCKALIGN 1024
+#define WAVE_ITERATIONS 3
+
+static Uint32 seed = 0x12345678;
+
+static Uint32
+Random32(void)
+{
+    seed = (seed * 1664525) + 1013904223;
+    return seed;
+}
+
+static Uint8 *
+WriteLE16(Uint8 *dst, Uint16 value)
+{
+    dst[0] = (Uint8) (value & 0xFF);
+    dst[1] = (Uint8) (value >> 8);
+    return dst + 2;
+}
+
+static Uint8 *
+WriteLE32(Uint8 *dst, Uint32 value)
+{
+    return WriteLE16(WriteLE16(dst, (Uint16) (value & 0xFFFF)), (Uint16) (value >> 16));
+}
+
+/* Builds a WAVE file with random ADPCM nibbles; the decoders don't care
+   whether the data came from an encoder. */
+static Uint8 *
+CreateADPCMWave(Uint16 formattag, Uint32 *wavelen)
+{
+    static const Sint16 mscoeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    const Uint32 headersize = (formattag == 0x0002) ? 7 : 4;
+    const Uint16 samplesperblock = (Uint16) (((WAVE_BLOCKALIGN - headersize * WAVE_CHANNELS) * 2) / WAVE_CHANNELS + ((formattag == 0x0002) ? 2 : 1));
+    const Uint32 blocks = (WAVE_SECONDS * WAVE_FREQ) / samplesperblock;
+    const Uint32 datalen = blocks * WAVE_BLOCKALIGN;
+    const Uint16 extsize = (formattag == 0x0002) ? 32 : 2;
+    const Uint32 fmtlen = 18 + extsize;
+    Uint8 *wave = (Uint8 *) SDL_malloc(12 + 8 + fmtlen + 8 + datalen);
+    Uint8 *p = wave;
+    Uint32 i, c;
+
+    if (!wave) {
+        return NULL;
+    }
+
+    SDL_memcpy(p, "RIFF", 4);
+    p = WriteLE32(p + 4, 4 + 8 + fmtlen + 8 + datalen);
+    SDL_memcpy(p, "WAVEfmt ", 8);
+    p = WriteLE32(p + 8, fmtlen);
+    p = WriteLE16(p, formattag);
+    p = WriteLE16(p, WAVE_CHANNELS);
+    p = WriteLE32(p, WAVE_FREQ);
+    p = WriteLE32(p, (WAVE_FREQ / samplesperblock) * WAVE_BLOCKALIGN);
+    p = WriteLE16(p, WAVE_BLOCKALIGN);
+    p = WriteLE16(p, 4);
+    p = WriteLE16(p, extsize);
+    p = WriteLE16(p, samplesperblock);
+    if (formattag == 0x0002) {
+        p = WriteLE16(p, 7);
+        for (i = 0; i < 14; i++) {
+            p = WriteLE16(p, (Uint16) mscoeffs[i]);
+        }
+    }
+    SDL_memcpy(p, "data", 4);
+    p = WriteLE32(p + 4, datalen);
+
+    for (i = 0; i < datalen; i++) {
+        p[i] = (Uint8) (Random32() >> 24);
+    }
+    /* MS ADPCM block headers need valid coefficient indices. */
+    if (formattag == 0x0002) {
+        for (i = 0; i < datalen; i += WAVE_BLOCKALIGN) {
+            for (c = 0; c < WAVE_CHANNELS; c++) {
+                p[i + c] %= 7;
+            }
+        }
+    }
+
+    *wavelen = (Uint32) ((p + datalen) - wave);
+    return wave;
+}
+
+/* Decodes the file a few times and reports the best run. */
+static int
+Decode(const char *name, const Uint8 *wave, Uint32 wavelen, const char *threads, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    double best = 0.0;
+    int i;
+
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, threads);
+    *audio_buf = NULL;
+    for (i = 0; i < WAVE_ITERATIONS; i++) {
+        SDL_AudioSpec spec;
+        Uint64 start;
+        double seconds;
+
+        SDL_FreeWAV(*audio_buf);
+        start = SDL_GetPerformanceCounter();
+        if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec, audio_buf, audio_len)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't decode %s: %s\n", name, SDL_GetError());
+            return -1;
+        }
+        seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        if (best == 0.0 || seconds < best) {
+            best = seconds;
+        }
+    }
+
+    SDL_Log("%-10s %-8s threads: %8.2f MB/s in, %8.2f MB/s out\n", name, threads,
+            ((double) wavelen / best) / (1024.0 * 1024.0), ((double) *audio_len / best) / (1024.0 * 1024.0));
+    return 0;
+}
+
+static int
+RunBenchmark(const char *name, const Uint8 *wave, Uint32 wavelen)
+{
+    Uint8 *serial = NULL, *threaded = NULL;
+    Uint32 serial_len = 0, threaded_len = 0;
+    int retval = 0;
+
+    if (Decode(name, wave, wavelen, "1", &serial, &serial_len) < 0 ||
+        Decode(name, wave, wavelen, "0", &threaded, &threaded_len) < 0) {
+        retval = 1;
+    } else if (serial_len != threaded_len || SDL_memcmp(serial, threaded, serial_len) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s decodes differently with more than one thread!\n", name);
+        retval = 1;
+    }
+
+    SDL_FreeWAV(serial);
+    SDL_FreeWAV(threaded);
+    return retval;
+}
+
+int
+main(int argc, char **argv)
+{
+    int retval = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d CPUs\n", SDL_GetCPUCount());
+
+    if (argc > 1) {
+        size_t wavelen = 0;
+        Uint8 *wave = (Uint8 *) SDL_LoadFile(argv[1], &wavelen);
+        if (!wave) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", argv[1], SDL_GetError());
+            retval = 1;
+        } else {
+            retval = RunBenchmark(argv[1], wave, (Uint32) wavelen);
+            SDL_free(wave);
+        }
+    } else {
+        static const struct { Uint16 formattag; const char *name; } formats[] = {
+            { 0x0002, "MS ADPCM" },
+            { 0x0011, "IMA ADPCM" }
+        };
+        int i;
+
+        for (i = 0; i < SDL_arraysize(formats); i++) {
+            Uint32 wavelen = 0;
+            Uint8 *wave = CreateADPCMWave(formats[i].formattag, &wavelen);
+            if (!wave) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+                retval = 1;
+                break;
+            }
+            retval |= RunBenchmark(formats[i].name, wave, wavelen);
+            SDL_free(wave);
+        }
+    }
+
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */